@@ -44,10 +44,10 @@ void HandleOuterVariables(phase_t * Phase,
 
 /* Target velocity calculation.
  */
-void CalculatePreferredVelocity(double *OutputVelocity,
-        double *OutputInnerState,
+void CalculatePreferredVelocity(real_t *OutputVelocity,
+        real_t *OutputInnerState,
         phase_t * Phase,
-        double ** TargetsArray,
+        real_t ** TargetsArray,
         int WhichTarget,
         const int WhichAgent,
         flocking_model_params_t * FlockingParams,
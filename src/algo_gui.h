@@ -92,7 +92,7 @@ void HandleSpecialMouseEvent(int button,
         int *cnt,
         flocking_model_params_t * FlockingParams,
         vizmode_params_t * VizParams, 
-        double *CoordTarg, double *** TargetsArray,
+        real_t *CoordTarg, real_t *** TargetsArray,
         const int Modifier);
 
 #endif
@@ -388,10 +388,13 @@ void InitializePhase(phase_t * Phase, flocking_model_params_t * FlockingParams,
             Phase->Velocities[i][2] = 0;
         }
     }
+
+    /* Working arrays of the Olfati-Saber kernel */
+    AllocateOlfati(&Olfati, Phase->NumberOfAgents);
 }
 
 // credit goes to: http://stackoverflow.com/questions/217578/how-can-i-determine-whether-a-2d-point-is-within-a-polygon/2922778#2922778
-bool PointInObstacle(obstacle_t * obstacle, double *Point) {
+bool PointInObstacle(obstacle_t * obstacle, real_t *Point) {
     bool c = false;
     int nvert = obstacle->p_count;
     int i, j = 0;
@@ -411,13 +414,13 @@ bool PointInObstacle(obstacle_t * obstacle, double *Point) {
 // sets NearestPointOfPolygon as expected from its name and returns distance from it
 // distance is negative if we are inside obstacle and positive if outside
 // so far works only for convex polygons
-double DistanceOfNearestPointOfObstacle(double *NearestPointOfPolygon,
-        obstacle_t * obstacle, double *AgentsCoordinates) {
+real_t DistanceOfNearestPointOfObstacle(real_t *NearestPointOfPolygon,
+        obstacle_t * obstacle, real_t *AgentsCoordinates) {
     int i, j;
-    int NearestVertexIndex, NearestEdgeStartPointIndex;
-    double NearestVertexDistance = 1e22, NearestEdgeDistance = 1e22;
-    double PolygonDistance, vertexdistance, edgedistance;
-    double EdgeVector[3];
+    int NearestVertexIndex = 0, NearestEdgeStartPointIndex = 0;
+    real_t NearestVertexDistance = 1e22, NearestEdgeDistance = 1e22;
+    real_t PolygonDistance, vertexdistance, edgedistance;
+    real_t EdgeVector[3];
 
     // find the nearest point of the Polygon
     for (j = 0; j < obstacle->p_count; j++) {
@@ -466,18 +469,18 @@ double DistanceOfNearestPointOfObstacle(double *NearestPointOfPolygon,
 
 // Note that this function is in 2D yet
 // Note that output is only ADDED to OutputVelocity
-void Shill_Obstacle_LinSqrt(double *OutputVelocity, phase_t * Phase,
-        obstacle_t * obstacle, const double V_Shill,
-        const double R0_Offset_Shill, const double Acc_Shill,
-        const double Slope_Shill, const int WhichAgent) {
+void Shill_Obstacle_LinSqrt(real_t *OutputVelocity, phase_t * Phase,
+        obstacle_t * obstacle, const real_t V_Shill,
+        const real_t R0_Offset_Shill, const real_t Acc_Shill,
+        const real_t Slope_Shill, const int WhichAgent) {
 
     int i;
-    double *AgentsPosition = Phase->Coordinates[WhichAgent];
-    double *AgentsVelocity = Phase->Velocities[WhichAgent];
-    static double ToArena[3];
-    static double VelDiff;
-    static double DistFromWall; // negative inside obstacle, positive outside
-    static double MaxVelDiff;
+    real_t *AgentsPosition = Phase->Coordinates[WhichAgent];
+    real_t *AgentsVelocity = Phase->Velocities[WhichAgent];
+    static real_t ToArena[3];
+    static real_t VelDiff;
+    static real_t DistFromWall; // negative inside obstacle, positive outside
+    static real_t MaxVelDiff;
 
     // get target point on obstacle wall in ToArena and distance from it in DistFromWall
     // latter will be negative if we are inside obstacle
@@ -518,10 +521,10 @@ void HandleOuterVariables(phase_t * Phase,
 
 }
 
-void CalculatePreferredVelocity(double *OutputVelocity,
-        double *OutputInnerState,
+void CalculatePreferredVelocity(real_t *OutputVelocity,
+        real_t *OutputInnerState,
         phase_t * Phase,
-        double ** TargetsArray,
+        real_t ** TargetsArray,
         int WhichTarget,
         const int WhichAgent,
         flocking_model_params_t * FlockingParams,
@@ -534,50 +537,59 @@ void CalculatePreferredVelocity(double *OutputVelocity,
     NullVect(OutputVelocity, 3);
     
     int i, j;
-    double *AgentsCoordinates;
+    real_t *AgentsCoordinates;
     AgentsCoordinates = Phase->Coordinates[WhichAgent];
-    double *AgentsVelocity;
+    real_t *AgentsVelocity;
     AgentsVelocity = Phase->Velocities[WhichAgent];
-    double velo[3];
+    real_t velo[3];
     NullVect(velo, 3);
-    static int ActualTargetID;
 
-    if (WhichTarget == 0) { ActualTargetID = 0; }
+    /* Target of the agent received from the mission planner. It is kept in
+     * inner state 1 (target ID + 1, 0 if none), inner state 0 is the arrival state
+     * of the agent (counted by FlockAggregates) */
+    int ActualTargetID = -1;
+    if (Flocking_type == 2 && WhichTarget != 0) {
+        ActualTargetID = TargetOfAgent(&Mission, Phase->RealIDs[WhichAgent]);
+    }
+    OutputInnerState[1] = ActualTargetID + 1;
+    if (ActualTargetID == -1) {
+        UpdateArrival(&FlockAggregates, &OutputInnerState[0], 0);
+    }
 
-    static double ArenaVelocity[3];
+    static real_t ArenaVelocity[3];
     NullVect(ArenaVelocity, 3);
-    static double ObstacleVelocity[3];
+    static real_t ObstacleVelocity[3];
     NullVect(ObstacleVelocity, 3);
-    static double PotentialVelocity[3];
+    static real_t PotentialVelocity[3];
     NullVect(PotentialVelocity, 3);
-    static double AttractionVelocity[3];
+    static real_t AttractionVelocity[3];
     NullVect(AttractionVelocity, 3);
-    static double GradientAcceleration[3];
+    static real_t GradientAcceleration[3];
     NullVect(GradientAcceleration, 3);
-    static double SlipVelocity[3];
+    static real_t SlipVelocity[3];
     NullVect(SlipVelocity, 3);
-    static double TargetTrackingVelocity[3];
+    static real_t TargetTrackingVelocity[3];
     NullVect(TargetTrackingVelocity, 3);
-    static double AlignOlfati[3];
+    static real_t AlignOlfati[3];
     NullVect(AlignOlfati, 3);
-    static double TrackOlfati[3];
+    static real_t TrackOlfati[3];
     NullVect(TrackOlfati, 3);
 
-    static double ActualNeighboursCoordinates[3];
+    static real_t ActualNeighboursCoordinates[3];
     NullVect(ActualNeighboursCoordinates, 3);
-    static double ActualNeighboursVelocity[3];
+    static real_t ActualNeighboursVelocity[3];
     NullVect(ActualNeighboursVelocity, 3);
-    static double DifferenceVector[3];
+    static real_t DifferenceVector[3];
     NullVect(DifferenceVector, 3);
-    static double DistanceFromNeighbour = 0.0;
-    static double DistanceFromObstVect[3];
+    static real_t DistanceFromNeighbour = 0.0;
+    static real_t DistanceFromObstVect[3];
     NullVect(DistanceFromObstVect, 3);
-    static double NormalizedAgentsVelocity[3];
-    static double TargetPosition[3];
+    static real_t NormalizedAgentsVelocity[3];
+    static real_t TargetPosition[3];
     NullVect(TargetPosition, 3);
-    static double NormalizedTargetTracking[3];
-    static double test1[3];
-    static double test2[3];
+    static real_t NormalizedTargetTracking[3];
+    static real_t test1[3];
+    static real_t test2[3];
 
 
     /* SPP term */
@@ -591,12 +603,17 @@ void CalculatePreferredVelocity(double *OutputVelocity,
 
     if (Flocking_type == 0) {
         /* Repulsion */
+        PROFILE_BEGIN(PROFILE_TERM_REPULSION);
         RepulsionLin(PotentialVelocity, Phase, V_Rep,
                 Slope_Rep, R_0, WhichAgent, (int) Dim, false);
+        PROFILE_END(PROFILE_TERM_REPULSION);
 
         /* Attraction */
+        PROFILE_BEGIN(PROFILE_TERM_ATTRACTION);
         AttractionLin(AttractionVelocity, Phase, V_Rep,
                 Slope_Att, R_0 + 500, WhichAgent, (int) Dim, false);
+        PROFILE_END(PROFILE_TERM_ATTRACTION);
+        PROFILE_COUNT(PROFILE_PAIRS, 2 * (Phase->NumberOfAgents - 1));
         
         /* Repulsion */
 
@@ -616,16 +633,21 @@ void CalculatePreferredVelocity(double *OutputVelocity,
 
 
     else if (Flocking_type == 1) {
-        /* Olfati Gradient based term for attraction//repulsion */
-        GradientBased(GradientAcceleration, Phase, Epsilon, A_Action_Function, B_Action_Function, H_Bump,
-            R_0, 3 * R_0, WhichAgent, (int) Dim);
+        /* Olfati Gradient based term for attraction//repulsion and alignment
+         * (same as GradientBased and AlignmentOlfati in one pass) */
+        PROFILE_BEGIN(PROFILE_TERM_OLFATI);
+        RefreshOlfati(&Olfati, Epsilon, A_Action_Function, B_Action_Function,
+                H_Bump, R_0, 3 * R_0, 2 * R_0);
+        OlfatiInteractions(GradientAcceleration, AlignOlfati, &Olfati, Phase,
+                WhichAgent, (int) Dim);
+        PROFILE_END(PROFILE_TERM_OLFATI);
+        PROFILE_COUNT(PROFILE_PAIRS, Phase->NumberOfAgents - 1);
         // UnitVect(GradientVelocity, GradientVelocity);
         MultiplicateWithScalar(GradientAcceleration, GradientAcceleration, 3, (int)Dim);
         // GradientBased(GradientVelocity, Phase, .1, 500, 1000, 0.2, R_0, 10000, WhichAgent, (int) Dim);
         // MultiplicateWithScalar(GradientVelocity, GradientVelocity, 100, (int) Dim);
         // GradientBased(GradientVelocity, Phase, .1, 400, 450, 0.3,
         //  R_0, 50000, WhichAgent, (int) Dim);
-        AlignmentOlfati(AlignOlfati, Phase, H_Bump, 2 * R_0, WhichAgent, (int) Dim, Epsilon);
         // MultiplicateWithScalar(AlignOlfati, AlignOlfati, 5, (int)Dim);
         // TrackingOlfati(TrackOlfati, TargetPosition, velo, Phase, WhichAgent, (int) Dim);
                          
@@ -633,19 +655,25 @@ void CalculatePreferredVelocity(double *OutputVelocity,
 
     else if (Flocking_type == 2) {
         /* Target tracking component (doesn't include repulsion so add it) */
+        PROFILE_BEGIN(PROFILE_TERM_REPULSION);
         RepulsionLin(PotentialVelocity, Phase, V_Rep,
                 Slope_Rep, R_0, WhichAgent, (int) Dim, false);
+        PROFILE_END(PROFILE_TERM_REPULSION);
+        PROFILE_COUNT(PROFILE_PAIRS, Phase->NumberOfAgents - 1);
 
 
-        if (WhichTarget != 0) {
+        if (ActualTargetID != -1) {
+            PROFILE_BEGIN(PROFILE_TERM_TARGET_TRACKING);
             TargetTracking(TargetTrackingVelocity, TargetsArray[ActualTargetID], Phase, 
                     R_0 + 300, R_0 + 4000, 5000, 10000, 
-                    Size_Neighbourhood, WhichAgent, (int)Dim);
+                    FlockAggregates.NeighbourhoodCoMs[Phase->RealIDs[WhichAgent]],
+                    WhichAgent, (int)Dim);
             MultiplicateWithScalar(TargetTrackingVelocity, TargetTrackingVelocity, 
                     V_Flock, (int)Dim);
             UnitVect(NormalizedTargetTracking, TargetTrackingVelocity);
             MultiplicateWithScalar(TargetTrackingVelocity, NormalizedTargetTracking, 
                     MIN(V_Flock, VectAbs(TargetTrackingVelocity)), (int)Dim);
+            PROFILE_END(PROFILE_TERM_TARGET_TRACKING);
         }
 
     }
@@ -658,19 +686,27 @@ void CalculatePreferredVelocity(double *OutputVelocity,
     // }
 
     /* (by now far from but better than) Viscous friction-like term */
+    PROFILE_BEGIN(PROFILE_TERM_FRICTION);
     FrictionLinSqrt(SlipVelocity, Phase, C_Frict, V_Frict, Acc_Frict,
             Slope_Frict, R_0 + R_0_Offset_Frict, WhichAgent, (int) Dim);
+    PROFILE_END(PROFILE_TERM_FRICTION);
+    PROFILE_COUNT(PROFILE_PAIRS, Phase->NumberOfAgents - 1);
 
     /* Interaction with walls of the arena (shill agents) */
+    PROFILE_BEGIN(PROFILE_TERM_WALLS);
     Shill_Wall_LinSqrt(ArenaVelocity, Phase, ArenaCenterX, ArenaCenterY,
             ArenaRadius, &(Arenas.a[(int) ArenaShape]), V_Shill, R_0_Shill,
             Acc_Shill, Slope_Shill, WhichAgent, Dim);
+    PROFILE_END(PROFILE_TERM_WALLS);
 
     /* Interaction with obstacles (shill agents) */
+    PROFILE_BEGIN(PROFILE_TERM_OBSTACLES);
     for (i = 0; i < obstacles.o_count; i++) {
         Shill_Obstacle_LinSqrt(ObstacleVelocity, Phase, &obstacles.o[i],
                 V_Shill, R_0_Shill, Acc_Shill, Slope_Shill, WhichAgent);
     }
+    PROFILE_END(PROFILE_TERM_OBSTACLES);
+    PROFILE_COUNT(PROFILE_OBSTACLE_TESTS, obstacles.o_count);
 
     VectSum(OutputVelocity, OutputVelocity, NormalizedAgentsVelocity);
 
@@ -693,36 +729,25 @@ void CalculatePreferredVelocity(double *OutputVelocity,
         VectSum(OutputVelocity, OutputVelocity, TargetTrackingVelocity);
         VectSum(OutputVelocity, OutputVelocity, SlipVelocity);
         
-        if (WhichTarget != 0) {
-            static double orig;
+        if (ActualTargetID != -1) {
             VectDifference(DifferenceVector, AgentsCoordinates, TargetsArray[ActualTargetID]);
-            if ( VectAbs(DifferenceVector) < 10000 ) {
-                Phase->InnerStates[WhichAgent][0] = 1;
-                // double orig = ActualTime;
-                // Phase->InnerStates[WhichAgent][1] = orig;
-                // orig++;
-            }
-            else {
-                // Phase->InnerStates[WhichAgent][0] = 0;
-                Phase->InnerStates[WhichAgent][1] = 0;
-                // orig = 0;
+            if (VectAbs(DifferenceVector) < MISSION_ARRIVAL_RADIUS) {
+                UpdateArrival(&FlockAggregates, &OutputInnerState[0], ActualTargetID + 1);
+            } else {
+                UpdateArrival(&FlockAggregates, &OutputInnerState[0], 0);
             }
-            
-            int cnt = 0;
-            for (i = 0; i < Phase->NumberOfAgents; i++){
-                if (Phase->InnerStates[WhichAgent][0] == 1) {
-                    cnt += 1;
-                }
-            }
-            if (cnt >= 4) {
+        }
+
+        /* In sequential missions the flock spreads out at the actual target */
+        if (Mission.Type == MISSION_SEQUENTIAL) {
+            static int SpreadAtTarget = -1;
+            if (ActualTargetID != -1 &&
+                    ArrivalsAtTarget(&FlockAggregates, ActualTargetID) >= MISSION_MIN_ARRIVALS) {
                 R_0 = FlockingParams->Params[4].Value = 15000;  // Equilibirum distance increased for spatial coverage
-                orig++;
-                if (orig > 1000) {
-                    ActualTargetID ++;
-                    R_0 = FlockingParams->Params[4].Value = 4000;
-                    orig = 0;
-                }
-                
+                SpreadAtTarget = ActualTargetID;
+            } else if (SpreadAtTarget != -1 && SpreadAtTarget != ActualTargetID) {
+                R_0 = FlockingParams->Params[4].Value = 4000;
+                SpreadAtTarget = -1;
             }
         }
     }
@@ -757,4 +782,5 @@ void CalculatePreferredVelocity(double *OutputVelocity,
 
 void DestroyPhase(phase_t * Phase, flocking_model_params_t * FlockingParams,
         sit_parameters_t * SitParams) {
+    freeOlfati(&Olfati);
 }
@@ -12,6 +12,10 @@
 #include "utilities/arenas.h"
 #include "utilities/interactions.h"
 #include "utilities/obstacles.h"
+#include "utilities/olfati.h"
+#include "utilities/aggregates.h"
+#include "utilities/mission.h"
+#include "utilities/profiler.h"
 /* Arenas structure */
 arenas_t Arenas;
 
@@ -49,6 +53,9 @@ double Epsilon;
 double A_Action_Function;
 double B_Action_Function;
 
+/* Precomputed constants of the Olfati-Saber kernel */
+olfati_t Olfati;
+
 /* Hyper parameters of the flocking */
 double Size_Neighbourhood;
 
@@ -8,6 +8,7 @@
 
 #include "algo_gui.h"
 #include "algo_spp_evol.h"
+#include "vizualizer/batch_2d.h"
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -19,6 +20,13 @@ static double EdgesOfObstacle[MAX_OBSTACLES][MAX_OBSTACLE_POINTS * 2];
 static float ArenaEdgeColor[3];
 static float ObstacleColor[3];
 
+/* Arena and obstacles of the 2D view in real coordinates, uploaded only if
+ * the arena has changed (parameters it was built for: shape, center, radius
+ * and the width of the wall)
+ */
+static vertex_batch_t StaticObjects_2D;
+static double StaticObjectsBuiltFor[5] = { -1.0, 0.0, 0.0, 0.0, 0.0 };
+
 
 /* For reseting Phases */
 void ModelSpecificReset(phase_t * Phase,
@@ -108,43 +116,76 @@ void InitializeModelSpecificColors(model_specific_color_t * ModelSpecificColors,
     CREATE_COLOR(ObstacleColor, 1.0, 0.0, 0.0);
 }
 
+/* Building the batch of the arena and the obstacles */
+static void BuildStaticObjects_2D(const double Gamma_Shill) {
+
+    int i, j;
+    static double Vertices[MAX_OBSTACLE_POINTS * 3];
+
+    if (StaticObjects_2D.Vertices == NULL) {
+        AllocateVertexBatch(&StaticObjects_2D, GL_TRIANGLES, 1024);
+    }
+    ClearVertexBatch(&StaticObjects_2D);
+
+    // arena
+    if (0.0 == ArenaShape) {
+        AddThickEdgedCircleToBatch(&StaticObjects_2D, ArenaCenterX,
+                ArenaCenterY, ArenaRadius - Gamma_Shill / 2, Gamma_Shill,
+                ArenaEdgeColor);
+    } else {
+        /* The same shapes as in DrawThickEdgedTransparentShape */
+        const double Size = 2.0 * ArenaRadius - Gamma_Shill;
+        AddShapeToBatch(&StaticObjects_2D, ArenaCenterX + Size / 2.0,
+                ArenaCenterY, Gamma_Shill, Size + Gamma_Shill, 0.0,
+                ArenaEdgeColor);
+        AddShapeToBatch(&StaticObjects_2D, ArenaCenterX,
+                ArenaCenterY - Size / 2.0, Size + Gamma_Shill, Gamma_Shill, 0.0,
+                ArenaEdgeColor);
+        AddShapeToBatch(&StaticObjects_2D, ArenaCenterX - Size / 2.0,
+                ArenaCenterY, Gamma_Shill, Size + Gamma_Shill, 0.0,
+                ArenaEdgeColor);
+        AddShapeToBatch(&StaticObjects_2D, ArenaCenterX,
+                ArenaCenterY + Size / 2.0, Size + Gamma_Shill, Gamma_Shill, 0.0,
+                ArenaEdgeColor);
+    }
+
+    // obstacles
+    for (i = 0; i < obstacles.o_count; i++) {
+        for (j = 0; j < obstacles.o[i].p_count; j++) {
+            Vertices[j * 3] = obstacles.o[i].p[j][0];
+            Vertices[j * 3 + 1] = obstacles.o[i].p[j][1];
+            Vertices[j * 3 + 2] = 0.0;
+        }
+        AddThickEdgedPolygonToBatch(&StaticObjects_2D, Vertices,
+                obstacles.o[i].p_count, Gamma_Shill, ObstacleColor);
+    }
+
+    UploadVertexBatch(&StaticObjects_2D, GL_STATIC_DRAW);
+
+}
+
 /* For drawing model-specific objects */
 void DrawModelSpecificObjects_2D(phase_t * Phase,
         flocking_model_params_t * FlockingParams,
         unit_model_params_t * UnitParams, vizmode_params_t * VizParams,
         color_config_t * Colors, sit_parameters_t * SitParams) {
-    int i;
     double Gamma_Shill = V_Shill / Slope_Shill + R_0_Shill;
 
-    // draw arena
-    if (0.0 == ArenaShape) {
-        DrawThickEdgedCircle(RealToGlCoord_2D(-VizParams->CenterX +
-                        ArenaCenterX, VizParams->MapSizeXY),
-                RealToGlCoord_2D(-VizParams->CenterY + ArenaCenterY,
-                        VizParams->MapSizeXY),
-                RealToGlCoord_2D(ArenaRadius - Gamma_Shill / 2,
-                        VizParams->MapSizeXY), RealToGlCoord_2D(Gamma_Shill,
-                        VizParams->MapSizeXY), ArenaEdgeColor);
-    } else {
-        SetupVertices(VizParams);
-        DrawThickEdgedTransparentShape(RealToGlCoord_2D(ArenaCenterX -
-                        VizParams->CenterX, VizParams->MapSizeXY),
-                RealToGlCoord_2D(ArenaCenterY - VizParams->CenterY,
-                        VizParams->MapSizeXY),
-                RealToGlCoord_2D(2.0 * ArenaRadius - Gamma_Shill,
-                        VizParams->MapSizeXY),
-                RealToGlCoord_2D(2.0 * ArenaRadius - Gamma_Shill,
-                        VizParams->MapSizeXY), RealToGlCoord_2D(Gamma_Shill,
-                        VizParams->MapSizeXY), 0.0, ArenaEdgeColor);
-    }
-
-    // draw obstacles
-    CreateObstacleVertexSet(&obstacles, VizParams);
-    for (i = 0; i < obstacles.o_count; i++) {
-        DrawThickEdgedPolygon(EdgesOfObstacle[i], obstacles.o[i].p_count,
-                RealToGlCoord_2D(Gamma_Shill, VizParams->MapSizeXY),
-                ObstacleColor);
+    /* Arena and obstacles are drawn from one buffer */
+    if (StaticObjectsBuiltFor[0] != ArenaShape
+            || StaticObjectsBuiltFor[1] != ArenaCenterX
+            || StaticObjectsBuiltFor[2] != ArenaCenterY
+            || StaticObjectsBuiltFor[3] != ArenaRadius
+            || StaticObjectsBuiltFor[4] != Gamma_Shill) {
+        BuildStaticObjects_2D(Gamma_Shill);
+        StaticObjectsBuiltFor[0] = ArenaShape;
+        StaticObjectsBuiltFor[1] = ArenaCenterX;
+        StaticObjectsBuiltFor[2] = ArenaCenterY;
+        StaticObjectsBuiltFor[3] = ArenaRadius;
+        StaticObjectsBuiltFor[4] = Gamma_Shill;
     }
+    DrawVertexBatch(&StaticObjects_2D, VizParams->CenterX, VizParams->CenterY,
+            VizParams->MapSizeXY);
 }
 
 void DrawModelSpecificObjects_3D(phase_t * Phase,
@@ -227,7 +268,7 @@ void HandleSpecialMouseEvent(int button,
         int *cnt,
         flocking_model_params_t * FlockingParams,
         vizmode_params_t * VizParams, 
-        double * CoordTarg, double *** TargetsArray,
+        real_t * CoordTarg, real_t *** TargetsArray,
         const int Modifier) {
 
     // static int count = 0;
@@ -8,6 +8,7 @@
 
 #include "algo_stat.h"
 #include "algo_spp_evol.h"
+#include "stat.h"
 
 /* Macro for saving standard deviations at the end of the simulation */
 // Place it inside the CloseModelSpecificStats function!
@@ -35,7 +36,7 @@ FILE *f_ClusterDependentParams_StDev;
 FILE *f_ClusterParams_StDev;
 FILE *f_ClusterRP_StDev;
 
-double **Adjacency;
+real_t **Adjacency;
 static int Dimension;
 bool *Visited;                  // for DFS algorithm
 
@@ -127,13 +128,13 @@ void InitializeModelSpecificStats(stat_utils_t * StatUtils) {
 
 // TODO TODO TODO: Construction of adjacency matrix is not optimal...
 // Graph should be constructed other way...
-void ConstructAdjacency(double **OutputAdjacency, phase_t * Phase,
+void ConstructAdjacency(real_t **OutputAdjacency, phase_t * Phase,
         const double CommunicationRange) {
 
     int i, j;
-    double *AgentsCoordinates;
-    double *NeighboursCoordinates;
-    static double Difference[3];
+    real_t *AgentsCoordinates;
+    real_t *NeighboursCoordinates;
+    static real_t Difference[3];
 
     for (i = 0; i < Phase->NumberOfAgents; i++) {
 
@@ -158,7 +159,7 @@ void ConstructAdjacency(double **OutputAdjacency, phase_t * Phase,
 
 }
 
-void CreateCluster(const int i, double **InputAdjacency,
+void CreateCluster(const int i, real_t **InputAdjacency,
         const int NumberOfAgents, unit_model_params_t * UnitParams) {
 
     int k;
@@ -200,13 +201,14 @@ void SaveClusterDependentParams(phase_t * Phase, sit_parameters_t * SitParams,
         unit_model_params_t * UnitParams, stat_utils_t * StatUtils) {
 
 
+    /* Scratch arrays of this step */
+    const memory_arena_mark_t Mark = ArenaMark(&StepArena);
+
     Dimension = SitParams->NumberOfAgents;
-    Visited = BooleanData(Dimension);
+    Visited = ArenaBooleanData(&StepArena, Dimension);
 
     int i, j;
-    static double AgentsCoordinates[3];
-    static double NeighboursCoordinates[3];
-    static double Difference[3];
+    static real_t Difference[3];
 
     static int NumberOfAgentsInCluster;
     static int NumberOfAgentsInithCluster;
@@ -228,13 +230,20 @@ void SaveClusterDependentParams(phase_t * Phase, sit_parameters_t * SitParams,
     
     static bool IsItInCluster;
     NumberOfAgentsInCluster = 0;
+
+    /* Unit velocities and correlation sums of each cluster
+     * (indexed by the smallest ID in the cluster) */
+    static real_t **UnitVelocities = NULL;
+    static correlation_sums_t *ClusterSums = NULL;
+    static int Capacity = 0;
+    int Representative;
     AgentsNotInCluster = 0;
     MaxClusterSize = 0;
     MinClusterSize = 0;
     NumberOfCluster = 0;
 
     if (UnitParams->communication_type.Value == 0) {
-        Adjacency = doubleMatrix(Dimension, Dimension);
+        Adjacency = ArenaRealMatrix(&StepArena, Dimension, Dimension);
         ConstructAdjacency(Adjacency, Phase, UnitParams->R_C.Value);
     }
     
@@ -244,6 +253,27 @@ void SaveClusterDependentParams(phase_t * Phase, sit_parameters_t * SitParams,
         Labels[i] = i;
     }    
 
+    if (SitParams->NumberOfAgents > Capacity) {
+        if (UnitVelocities) {
+            freeRealMatrix(UnitVelocities, Capacity, 3);
+        }
+        free(ClusterSums);
+        Capacity = SitParams->NumberOfAgents;
+        UnitVelocities = realMatrix(Capacity, 3);
+        ClusterSums = (correlation_sums_t *) malloc(Capacity *
+                sizeof(correlation_sums_t));
+        COUNT_HEAP_ALLOCATIONS(1);
+        if (!ClusterSums) {
+            fprintf(stderr, "Cluster correlation sums allocation error!\n");
+            exit(-1);
+        }
+    }
+    for (i = 0; i < SitParams->NumberOfAgents; i++) {
+        GetAgentsVelocity(UnitVelocities[i], Phase, i);
+        UnitVect(UnitVelocities[i], UnitVelocities[i]);
+        ResetCorrelationSums(&ClusterSums[i]);
+    }
+
     /* Calculating correlations only inside clusters */
     for (i = 0; i < SitParams->NumberOfAgents; i++) {
 
@@ -303,21 +333,20 @@ void SaveClusterDependentParams(phase_t * Phase, sit_parameters_t * SitParams,
             IsItInCluster = true;
         }
 
-        GetAgentsVelocity(AgentsCoordinates, Phase, i);
-        UnitVect(AgentsCoordinates, AgentsCoordinates);
+        /* The sums of the correlations are calculated from the sums of
+         * the clusters, pairs are needed only for the extremes */
+        for (Representative = 0; Visited[Representative] != true;
+                Representative++);
+        AddToCorrelationSums(&ClusterSums[Representative], UnitVelocities[i]);
 
         for (j = 0; j < i; j++) {
 
             if (i != j && Visited[j] == true) {
-                GetAgentsVelocity(NeighboursCoordinates, Phase, j);
-                UnitVect(NeighboursCoordinates, NeighboursCoordinates);
-                Temp_Corr = ScalarProduct(AgentsCoordinates, NeighboursCoordinates,
+                Temp_Corr = ScalarProduct(UnitVelocities[i], UnitVelocities[j],
                         3);
                 Temp_RP = Phase->Laplacian[i][j];
 
-                Avg_Corr += Temp_Corr;
                 Avg_RP += Temp_RP;
-                StDev_Corr += Temp_Corr * Temp_Corr;
                 StDev_RP += Temp_RP * Temp_RP;
 
                 if (Temp_Corr > Max_Corr) {
@@ -351,6 +380,13 @@ void SaveClusterDependentParams(phase_t * Phase, sit_parameters_t * SitParams,
 
     }
 
+    for (i = 0; i < SitParams->NumberOfAgents; i++) {
+        if (ClusterSums[i].NumberOfVectors > 1) {
+            Avg_Corr += SumOfPairCorrelations(&ClusterSums[i]);
+            StDev_Corr += SumOfSquaredPairCorrelations(&ClusterSums[i]);
+        }
+    }
+
     if (NumberOfAgentsInCluster > 0) {
         Avg_Corr /= NumberOfAgentsInCluster;
         StDev_Corr /= NumberOfAgentsInCluster;
@@ -420,6 +456,8 @@ void SaveClusterDependentParams(phase_t * Phase, sit_parameters_t * SitParams,
 
     }
 
+    ArenaRelease(&StepArena, Mark);
+
 }
 
 void SaveModelSpecificStats(phase_t * Phase,
@@ -438,9 +476,9 @@ void SaveModelSpecificStats(phase_t * Phase,
     avg = 0.0;
     stdev = 0.0;
 
-    double *AgentsCoordinates;
-    static double ArenaCoordinates[3];
-    static double TempCoords[3];
+    real_t *AgentsCoordinates;
+    static real_t ArenaCoordinates[3];
+    static real_t TempCoords[3];
 
     FillVect(ArenaCoordinates, ArenaCenterX, ArenaCenterY, 0.0);
 
@@ -459,7 +497,7 @@ void SaveModelSpecificStats(phase_t * Phase,
             dist = (dist > ArenaRadius ? dist - ArenaRadius : 0.0);
         } else if (1.0 == ArenaShape) { // Cube-shaped arena
 
-            static double FromSide[3];
+            static real_t FromSide[3];
 
             VectDifference(TempCoords, ArenaCoordinates, AgentsCoordinates);
 
@@ -613,9 +651,4 @@ void CloseModelSpecificStats(stat_utils_t * StatUtils, unit_model_params_t * Uni
     fclose(f_ClusterParams);
     fclose(f_ClusterRP);
 
-    if (UnitParams->communication_type.Value == 0) {
-        freeMatrix(Adjacency, Dimension, Dimension);
-    }
-    free(Visited);
-
 }
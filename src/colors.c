@@ -156,13 +156,13 @@ void LoadColorConfig(color_config_t * ColorConfigToSet, FILE * InputFile,
      * readed_Name=readed_value             
      */
     static char line[256];
-    static char templabel[10];
+    static char templabel[32];
     static bool found = false;
 
     char *start, *end;
 
-    char *readed_Name;
-    char *readed_value;
+    char *readed_Name = "";
+    char *readed_value = "";
 
     while (fgets(line, sizeof(line), InputFile) != NULL) {
 
@@ -10,7 +10,7 @@
 #include "utilities/obstacles.h"
 #include <stdlib.h>
 
-static double EyeFromCenter[3];
+static real_t EyeFromCenter[3];
 static double DistanceFromCenter;
 static double NewEyeZ;
 
@@ -47,7 +47,7 @@ void DrawCopter_2D(const double x, const double y, const double MapSizexy,
 void DrawAgentLabel_2D(phase_t * Phase, const int WhichAgent, char *Label,
         bool Display, vizmode_params_t * VizParams, const float *Color) {
 
-    double *Position;
+    real_t *Position;
     Position = Phase->Coordinates[WhichAgent];
 
     if (Display == true) {
@@ -67,12 +67,12 @@ void DrawNetworkArrow_2D(phase_t * Phase, const int FromWhichAgent,
         const int ToWhichAgent, vizmode_params_t * VizParams,
         const float *color) {
 
-    double *FromCoords;
-    double *ToCoords;
+    real_t *FromCoords;
+    real_t *ToCoords;
     FromCoords = Phase->Coordinates[FromWhichAgent];
     ToCoords = Phase->Coordinates[ToWhichAgent];
 
-    static double DifferenceVector[3];
+    static real_t DifferenceVector[3];
     VectDifference(DifferenceVector, ToCoords, FromCoords);
 
     static double ArrowCenterX;
@@ -96,10 +96,10 @@ void DrawNetworkArrow_2D(phase_t * Phase, const int FromWhichAgent,
 }
 
 /* Draws a network arrow between two positions */
-void DrawNetworkArrowBetweenPositions_2D(double *FromCoords, double *ToCoords,
+void DrawNetworkArrowBetweenPositions_2D(real_t *FromCoords, real_t *ToCoords,
         vizmode_params_t * VizParams, const float *color) {
 
-    static double DifferenceVector[3];
+    static real_t DifferenceVector[3];
     VectDifference(DifferenceVector, ToCoords, FromCoords);
 
     static double ArrowCenterX;
@@ -122,221 +122,197 @@ void DrawNetworkArrowBetweenPositions_2D(double *FromCoords, double *ToCoords,
 
 }
 
-/* Drawing sensor range network */
-void DrawSensorRangeNetwork_2D(phase_t * PhaseData,
-        unit_model_params_t * Unit_params,
-        const int WhichAgent, double ** Polygons,
-        const int Now,
+/* Drawing the communication network from the neighbour lists */
+void DrawNeighbourNetwork_2D(vertex_batch_t * Batch, phase_t * Phase,
+        const int *NeighbourLists, const int *NumberOfNeighbours,
+        const int NeighbourListCapacity, const int MaxEdges,
         vizmode_params_t * VizParams, const float *color) {
 
-        int i, j;
-
-        float Red[3];
-        Red[0] = .9; Red[1] = 0.1; Red[2] = .1;
-        float * RedColor;
-        RedColor = Red;
-        double *ActualAgentsCoordinates;
-        ActualAgentsCoordinates = PhaseData[Now].Coordinates[WhichAgent];
-        GetAgentsCoordinatesFromTimeLine(ActualAgentsCoordinates, PhaseData,
-                WhichAgent, Now);
-        bool DrawCircles = false;
-        if (DrawCircles == true){
-                DrawCircle(RealToGlCoord_2D(ActualAgentsCoordinates[0] - VizParams->CenterX , VizParams->MapSizeXY),
-                RealToGlCoord_2D(ActualAgentsCoordinates[1] - VizParams->CenterY, 
-                VizParams->MapSizeXY), RealToGlCoord_2D(Unit_params->R_C.Value, VizParams->MapSizeXY), RedColor);
+    int i, k;
+    int Stride = 1;
+    int NumberOfEdges = 0;
+    const int *List;
+    real_t *AgentsCoordinates;
+    real_t *NeighboursCoordinates;
+    double dx, dy, Length, ux, uy;
+    double TipX, TipY;
+
+    const double MinX = VizParams->CenterX - VizParams->MapSizeXY;
+    const double MaxX = VizParams->CenterX + VizParams->MapSizeXY;
+    const double MinY = VizParams->CenterY - VizParams->MapSizeXY;
+    const double MaxY = VizParams->CenterY + VizParams->MapSizeXY;
+
+    /* Arrowheads (30 cm) are left out if they would be smaller than 3 pixels */
+    const bool DrawHeads = (30.0 / VizParams->MapSizeXY *
+            VizParams->Resolution * 0.5 >= 3.0);
+
+    /* Level of detail: the lists of every "Stride"-th agent if there are
+     * too many edges */
+    if (MaxEdges > 0) {
+        for (i = 0; i < Phase->NumberOfAgents; i++) {
+            NumberOfEdges += NumberOfNeighbours[i];
         }
-        static double NeighboursCoordinates[3];
-        static double DifferenceVector[3];
-        static double AbsDistance;
-
-        static double ArrowCenterX;
-        static double ArrowCenterY;
-        static double angle;
-        static double CenterX1, CenterX2, CenterY1, CenterY2; 
-
-        for (i = 0; i < PhaseData[0].NumberOfAgents; i++) {
-
-                if (i != WhichAgent) {
-
-                        GetAgentsCoordinatesFromTimeLine(NeighboursCoordinates, PhaseData,
-                                i, Now);
-                        VectDifference(DifferenceVector, ActualAgentsCoordinates,
-                                NeighboursCoordinates);
-                        AbsDistance = VectAbs(DifferenceVector);
-                        
-                        double *ToSort;
-                        ToSort = malloc(sizeof(double) * PhaseData[0].NumberOfAgents);
-                        for (int k = 0; k < PhaseData[0].NumberOfAgents; k++) {
-                                ToSort[k] = PhaseData[Now].Laplacian[WhichAgent][k];
-                        }
-
-                        int *Indexes;
-                        Indexes = malloc(sizeof(int) * PhaseData[0].NumberOfAgents);
-                        
-                        ArgMaxSort(ToSort, PhaseData[0].NumberOfAgents, Indexes);
-
-                        bool IsLeading = false;
-                        for (int l = 0; l < Size_Neighbourhood; l++) {
-                                if (i == Indexes[l]) {
-                                        IsLeading = true;
-                                }
-                        }
-                        free(Indexes);
-                        free(ToSort);
-
-                        if ((int)(Unit_params->communication_type.Value) == 0) {
-
-                                if (AbsDistance <= Unit_params->R_C.Value && IsLeading == true) {
-                                        
-                                        ArrowCenterX =
-                                                (ActualAgentsCoordinates[0] +
-                                                NeighboursCoordinates[0]) * 0.5 - VizParams->CenterX;
-                                        ArrowCenterY =
-                                                (ActualAgentsCoordinates[1] +
-                                                NeighboursCoordinates[1]) * 0.5 - VizParams->CenterY;
-
-                                        DifferenceVector[2] = 0;
-                                        angle = -atan2(DifferenceVector[1], DifferenceVector[0]);
-
-                                        DrawThinArrow(RealToGlCoord_2D(ArrowCenterX,VizParams->MapSizeXY),
-                                                RealToGlCoord_2D(ArrowCenterY, VizParams->MapSizeXY),
-                                                RealToGlCoord_2D(VectAbs(DifferenceVector) - 60,
-                                                        VizParams->MapSizeXY), RealToGlCoord_2D(30,
-                                                        VizParams->MapSizeXY), angle, color);
-                                }
-
-                                else if (AbsDistance <= Unit_params->R_C.Value) {
-
-                                        CenterX1 = ActualAgentsCoordinates[0] - VizParams->CenterX;
-                                        CenterY1 = ActualAgentsCoordinates[1] - VizParams->CenterY;
-
-                                        CenterX2 = NeighboursCoordinates[0] - VizParams->CenterX;
-                                        CenterY2 = NeighboursCoordinates[1] - VizParams->CenterY;
-
-                                        DrawDashedLine(RealToGlCoord_2D(CenterX1,VizParams->MapSizeXY),
-                                                RealToGlCoord_2D(CenterY1, VizParams->MapSizeXY),
-                                                RealToGlCoord_2D(CenterX2,VizParams->MapSizeXY),
-                                                RealToGlCoord_2D(CenterY2, VizParams->MapSizeXY),
-                                                color);
-
-
-                                }
-                        }
-
-                        else if ((int)(Unit_params->communication_type.Value) == 1) {
-
-                                if (PhaseData[Now].Laplacian[WhichAgent][i] > Unit_params->sensitivity_thresh.Value && IsLeading == true) {
-                                        
-                                        ArrowCenterX =
-                                                (ActualAgentsCoordinates[0] +
-                                                NeighboursCoordinates[0]) * 0.5 - VizParams->CenterX;
-                                        ArrowCenterY =
-                                                (ActualAgentsCoordinates[1] +
-                                                NeighboursCoordinates[1]) * 0.5 - VizParams->CenterY;
-
-                                        DifferenceVector[2] = 0;
-                                        angle = -atan2(DifferenceVector[1], DifferenceVector[0]);
-
-                                        DrawThinArrow(RealToGlCoord_2D(ArrowCenterX,VizParams->MapSizeXY),
-                                                RealToGlCoord_2D(ArrowCenterY, VizParams->MapSizeXY),
-                                                RealToGlCoord_2D(VectAbs(DifferenceVector) - 60,
-                                                        VizParams->MapSizeXY), RealToGlCoord_2D(30,
-                                                        VizParams->MapSizeXY), angle, color);
-                                }
-
-                                else if (PhaseData[Now].Laplacian[WhichAgent][i] > Unit_params->sensitivity_thresh.Value) {
-
-                                        CenterX1 = ActualAgentsCoordinates[0] - VizParams->CenterX;
-                                        CenterY1 = ActualAgentsCoordinates[1] - VizParams->CenterY;
-
-                                        CenterX2 = NeighboursCoordinates[0] - VizParams->CenterX;
-                                        CenterY2 = NeighboursCoordinates[1] - VizParams->CenterY;
-
-                                        DrawDashedLine(RealToGlCoord_2D(CenterX1,VizParams->MapSizeXY),
-                                                RealToGlCoord_2D(CenterY1, VizParams->MapSizeXY),
-                                                RealToGlCoord_2D(CenterX2,VizParams->MapSizeXY),
-                                                RealToGlCoord_2D(CenterY2, VizParams->MapSizeXY),
-                                                color);
-
-                                }
-                        }
-
-                        else if ((int)(Unit_params->communication_type.Value) == 2) {
-
-                                if (PhaseData[Now].Laplacian[WhichAgent][i] > Unit_params->sensitivity_thresh.Value && IsLeading == true) {
-                                        
-                                        ArrowCenterX =
-                                                (ActualAgentsCoordinates[0] +
-                                                NeighboursCoordinates[0]) * 0.5 - VizParams->CenterX;
-                                        ArrowCenterY =
-                                                (ActualAgentsCoordinates[1] +
-                                                NeighboursCoordinates[1]) * 0.5 - VizParams->CenterY;
-
-                                        DifferenceVector[2] = 0;
-                                        angle = -atan2(DifferenceVector[1], DifferenceVector[0]);
-
-                                        DrawThinArrow(RealToGlCoord_2D(ArrowCenterX,VizParams->MapSizeXY),
-                                                RealToGlCoord_2D(ArrowCenterY, VizParams->MapSizeXY),
-                                                RealToGlCoord_2D(VectAbs(DifferenceVector) - 60,
-                                                        VizParams->MapSizeXY), RealToGlCoord_2D(30,
-                                                        VizParams->MapSizeXY), angle, color);
-
-                                        for (j = 0; j < obstacles.o_count; j++){
-
-                                                double **Intersections;
-                                                Intersections = malloc(sizeof(double *) * 2);
-                                                Intersections[0] = malloc(sizeof(double) * 3);
-                                                Intersections[1] = malloc(sizeof(double) * 3);
-
-                                                int NumberOfIntersections;
+        Stride = (NumberOfEdges + MaxEdges - 1) / MaxEdges;
+        if (Stride < 1) {
+            Stride = 1;
+        }
+    }
 
-                                                NumberOfIntersections = IntersectionOfSegmentAndPolygon2D(Intersections,
-                                                PhaseData[Now].Coordinates[WhichAgent], PhaseData[Now].Coordinates[i], 
-                                                Polygons[j], obstacles.o[j].p_count);
+    ClearVertexBatch(Batch);
+    for (i = 0; i < Phase->NumberOfAgents; i += Stride) {
 
-                                                if (NumberOfIntersections == 2){
+        AgentsCoordinates = Phase->Coordinates[i];
+        List = NeighbourLists + (size_t) i * NeighbourListCapacity;
 
-                                                        DrawCircle(RealToGlCoord_2D(Intersections[0][0] - VizParams->CenterX, 
-                                                        VizParams->MapSizeXY), RealToGlCoord_2D(Intersections[0][1] - VizParams->CenterY, 
-                                                        VizParams->MapSizeXY), RealToGlCoord_2D(1000, VizParams->MapSizeXY), RedColor);
+        for (k = 0; k < NumberOfNeighbours[i]; k++) {
 
-                                                        DrawCircle(RealToGlCoord_2D(Intersections[1][0] - VizParams->CenterX, 
-                                                        VizParams->MapSizeXY), RealToGlCoord_2D(Intersections[1][1] - VizParams->CenterY, 
-                                                        VizParams->MapSizeXY), RealToGlCoord_2D(1000, VizParams->MapSizeXY), RedColor);
+            NeighboursCoordinates = Phase->Coordinates[List[k]];
 
-                                                        // DrawLine(RealToGlCoord_2D(Intersections[0][0] - VizParams->CenterX, VizParams->MapSizeXY),
-                                                        // RealToGlCoord_2D(Intersections[0][1] - VizParams->CenterY, VizParams->MapSizeXY),
-                                                        // RealToGlCoord_2D(Intersections[1][0] - VizParams->CenterX, VizParams->MapSizeXY),
-                                                        // RealToGlCoord_2D(Intersections[1][1] - VizParams->CenterY, VizParams->MapSizeXY), 
-                                                        // RealToGlCoord_2D(80, VizParams->MapSizeXY), RedColor);
-                                                }
+            /* Edges outside of the view */
+            if (fmax(AgentsCoordinates[0], NeighboursCoordinates[0]) < MinX
+                    || fmin(AgentsCoordinates[0], NeighboursCoordinates[0]) > MaxX
+                    || fmax(AgentsCoordinates[1], NeighboursCoordinates[1]) < MinY
+                    || fmin(AgentsCoordinates[1], NeighboursCoordinates[1]) > MaxY) {
+                continue;
+            }
 
-                                                freeMatrix(Intersections, 2, 3);
-                                        }
-                                
-                                }
+            /* Arrow from the neighbour to the agent that perceives it,
+             * 30 cm shorter on both ends */
+            dx = AgentsCoordinates[0] - NeighboursCoordinates[0];
+            dy = AgentsCoordinates[1] - NeighboursCoordinates[1];
+            Length = hypot(dx, dy);
+            if (Length <= 60.0) {
+                continue;
+            }
+            ux = dx / Length;
+            uy = dy / Length;
+            TipX = AgentsCoordinates[0] - 30.0 * ux;
+            TipY = AgentsCoordinates[1] - 30.0 * uy;
+
+            AddVertexToBatch(Batch, NeighboursCoordinates[0] + 30.0 * ux,
+                    NeighboursCoordinates[1] + 30.0 * uy, color);
+            AddVertexToBatch(Batch, TipX, TipY, color);
+
+            if (true == DrawHeads) {
+                /* Two sides of the head, at 30 degrees from the shaft */
+                AddVertexToBatch(Batch, TipX, TipY, color);
+                AddVertexToBatch(Batch,
+                        TipX - 30.0 * (0.866 * ux - 0.5 * uy),
+                        TipY - 30.0 * (0.866 * uy + 0.5 * ux), color);
+                AddVertexToBatch(Batch, TipX, TipY, color);
+                AddVertexToBatch(Batch,
+                        TipX - 30.0 * (0.866 * ux + 0.5 * uy),
+                        TipY - 30.0 * (0.866 * uy - 0.5 * ux), color);
+            }
 
-                                else if (PhaseData[Now].Laplacian[WhichAgent][i] > Unit_params->sensitivity_thresh.Value) {
+        }
+    }
 
-                                        CenterX1 = ActualAgentsCoordinates[0] - VizParams->CenterX;
-                                        CenterY1 = ActualAgentsCoordinates[1] - VizParams->CenterY;
+    UploadVertexBatch(Batch, GL_STREAM_DRAW);
+    DrawVertexBatch(Batch, VizParams->CenterX, VizParams->CenterY,
+            VizParams->MapSizeXY);
 
-                                        CenterX2 = NeighboursCoordinates[0] - VizParams->CenterX;
-                                        CenterY2 = NeighboursCoordinates[1] - VizParams->CenterY;
+}
 
-                                        DrawDashedLine(RealToGlCoord_2D(CenterX1,VizParams->MapSizeXY),
-                                                RealToGlCoord_2D(CenterY1, VizParams->MapSizeXY),
-                                                RealToGlCoord_2D(CenterX2,VizParams->MapSizeXY),
-                                                RealToGlCoord_2D(CenterY2, VizParams->MapSizeXY),
-                                                color);
+/* Drawing the details of the communication network */
+void DrawNetworkDetails_2D(vertex_batch_t * DashedLines,
+        vertex_batch_t * Crossings, phase_t * Phase,
+        const int *NeighbourLists, const int *NumberOfNeighbours,
+        const int NeighbourListCapacity, const int CommunicationType,
+        const double R_C, const double SensitivityThreshold,
+        real_t ** Polygons, vizmode_params_t * VizParams, const float *color) {
+
+    int i, j, k, l;
+    int NumberOfIntersections;
+    bool InRange, IsNeighbour;
+    const int *List;
+    real_t *AgentsCoordinates;
+    real_t *NeighboursCoordinates;
+    static real_t IntersectionPoints[2][3];
+    real_t *Intersections[2] = { IntersectionPoints[0], IntersectionPoints[1] };
+    static float Red[3] = { .9, 0.1, .1 };
+
+    const double MinX = VizParams->CenterX - VizParams->MapSizeXY;
+    const double MaxX = VizParams->CenterX + VizParams->MapSizeXY;
+    const double MinY = VizParams->CenterY - VizParams->MapSizeXY;
+    const double MaxY = VizParams->CenterY + VizParams->MapSizeXY;
+
+    ClearVertexBatch(DashedLines);
+    ClearVertexBatch(Crossings);
+    for (i = 0; i < Phase->NumberOfAgents; i++) {
+
+        AgentsCoordinates = Phase->Coordinates[i];
+        List = NeighbourLists + (size_t) i * NeighbourListCapacity;
+
+        for (j = 0; j < Phase->NumberOfAgents; j++) {
+
+            if (j == i) {
+                continue;
+            }
+            NeighboursCoordinates = Phase->Coordinates[j];
+
+            /* Pairs outside of the view */
+            if (fmax(AgentsCoordinates[0], NeighboursCoordinates[0]) < MinX
+                    || fmin(AgentsCoordinates[0], NeighboursCoordinates[0]) > MaxX
+                    || fmax(AgentsCoordinates[1], NeighboursCoordinates[1]) < MinY
+                    || fmin(AgentsCoordinates[1], NeighboursCoordinates[1]) > MaxY) {
+                continue;
+            }
 
-                                }
+            if (0 == CommunicationType) {
+                InRange = (hypot(hypot(AgentsCoordinates[0] -
+                                        NeighboursCoordinates[0],
+                                        AgentsCoordinates[1] -
+                                        NeighboursCoordinates[1]),
+                                AgentsCoordinates[2] -
+                                NeighboursCoordinates[2]) <= R_C);
+            } else {
+                InRange = (Phase->Laplacian[i][j] > SensitivityThreshold);
+            }
+            if (false == InRange) {
+                continue;
+            }
 
-                        }
+            IsNeighbour = false;
+            for (k = 0; k < NumberOfNeighbours[i]; k++) {
+                if (List[k] == j) {
+                    IsNeighbour = true;
+                    break;
+                }
+            }
 
-                }              
+            if (false == IsNeighbour) {
+                AddVertexToBatch(DashedLines, AgentsCoordinates[0],
+                        AgentsCoordinates[1], color);
+                AddVertexToBatch(DashedLines, NeighboursCoordinates[0],
+                        NeighboursCoordinates[1], color);
+            } else if (2 == CommunicationType) {
+                for (l = 0; l < obstacles.o_count; l++) {
+                    NumberOfIntersections =
+                            IntersectionOfSegmentAndPolygon2D(Intersections,
+                            AgentsCoordinates, NeighboursCoordinates,
+                            Polygons[l], obstacles.o[l].p_count);
+                    if (NumberOfIntersections == 2) {
+                        AddCircleToBatch(Crossings, Intersections[0][0],
+                                Intersections[0][1], 1000.0, Red);
+                        AddCircleToBatch(Crossings, Intersections[1][0],
+                                Intersections[1][1], 1000.0, Red);
+                    }
+                }
+            }
 
         }
+    }
+
+    UploadVertexBatch(DashedLines, GL_STREAM_DRAW);
+    glEnable(GL_LINE_STIPPLE);
+    glLineStipple(4, 0x00FF);
+    DrawVertexBatch(DashedLines, VizParams->CenterX, VizParams->CenterY,
+            VizParams->MapSizeXY);
+    glDisable(GL_LINE_STIPPLE);
+    UploadVertexBatch(Crossings, GL_STREAM_DRAW);
+    DrawVertexBatch(Crossings, VizParams->CenterX, VizParams->CenterY,
+            VizParams->MapSizeXY);
 
 }
 
@@ -353,14 +329,14 @@ void DrawSensorRangeNetwork_3D(phase_t * PhaseData,
 
     int i;
 
-    double *ActualAgentsCoordinates;
+    real_t *ActualAgentsCoordinates;
     ActualAgentsCoordinates = PhaseData[Now].Coordinates[WhichAgent];
     GetAgentsCoordinatesFromTimeLine(ActualAgentsCoordinates, PhaseData,
             WhichAgent, Now);
 
-    static double NeighboursCoordinates[3];
+    static real_t NeighboursCoordinates[3];
     NullVect(NeighboursCoordinates, 3);
-    static double DifferenceVector[3];
+    static real_t DifferenceVector[3];
     NullVect(DifferenceVector, 3);
 
     for (i = 0; i < PhaseData[0].NumberOfAgents; i++) {
@@ -399,7 +375,7 @@ void DrawSensorRangeNetwork_3D(phase_t * PhaseData,
 
 /* 3D camera movement */
 
-void TranslateCameraOnXYPlane(vizmode_params_t * VizParams, double *Direction,
+void TranslateCameraOnXYPlane(vizmode_params_t * VizParams, real_t *Direction,
         const double StepSize) {
 
     /* Projection onto XY plane */
@@ -414,7 +390,7 @@ void TranslateCameraOnXYPlane(vizmode_params_t * VizParams, double *Direction,
 
 }
 
-void RotateCameraAroundCenter(vizmode_params_t * VizParams, double *Axis,
+void RotateCameraAroundCenter(vizmode_params_t * VizParams, real_t *Axis,
         const double angle) {
 
     /* Creating eye from center vector */
@@ -11,6 +11,7 @@
 #include <math.h>
 #include "vizualizer/objects_2d.h"
 #include "vizualizer/objects_3d.h"
+#include "vizualizer/batch_2d.h"
 #include "utilities/datastructs.h"
 #include "utilities/dynamics_utils.h"
 #include "utilities/math_utils.h"
@@ -56,17 +57,35 @@ void DrawNetworkArrow_2D(phase_t * Phase,
 
 /* Network arrow between two positions 
  */
-void DrawNetworkArrowBetweenPositions_2D(double *FromCoords,
-        double *ToCoords, vizmode_params_t * VizParams, const float *color);
-
-/* Sensor Range Newtork for agent "WhichAgent"
+void DrawNetworkArrowBetweenPositions_2D(real_t *FromCoords,
+        real_t *ToCoords, vizmode_params_t * VizParams, const float *color);
+
+/* Communication network of the flock from the neighbour lists of the
+ * perception (see flock_aggregates_t): an arrow from each neighbour to the
+ * agent that perceives it, every edge in one batch of lines.
+ * Edges outside of the view are skipped. If "MaxEdges" is positive and
+ * there are more edges, only the lists of every n-th agent are drawn.
  */
-void DrawSensorRangeNetwork_2D(phase_t * PhaseData,
-        unit_model_params_t * Unit_params,
-        const int WhichAgent, double ** Polygons,
-        const int Now,
+void DrawNeighbourNetwork_2D(vertex_batch_t * Batch, phase_t * Phase,
+        const int *NeighbourLists, const int *NumberOfNeighbours,
+        const int NeighbourListCapacity, const int MaxEdges,
         vizmode_params_t * VizParams, const float *color);
 
+/* Details of the communication network from a snapshot with the Laplacian
+ * (received powers): dashed lines between the agents in communication range
+ * that are not neighbours, and red circles where the links of the neighbours
+ * cross an obstacle (with obstacles in the communication model). In range is
+ * closer than "R_C" (communication type 0) or received power above
+ * "SensitivityThreshold". Checks every pair of agents, it is shown only if
+ * toggled on.
+ */
+void DrawNetworkDetails_2D(vertex_batch_t * DashedLines,
+        vertex_batch_t * Crossings, phase_t * Phase,
+        const int *NeighbourLists, const int *NumberOfNeighbours,
+        const int NeighbourListCapacity, const int CommunicationType,
+        const double R_C, const double SensitivityThreshold,
+        real_t ** Polygons, vizmode_params_t * VizParams, const float *color);
+
 /* 3D */
 
 /* Sensor range network for agent "WhichAgent"
@@ -81,9 +100,9 @@ void DrawSensorRangeNetwork_3D(phase_t * PhaseData,
 
 /* 3D camera movement */
 
-void TranslateCameraOnXYPlane(vizmode_params_t * VizParams, double *Direction,
+void TranslateCameraOnXYPlane(vizmode_params_t * VizParams, real_t *Direction,
         const double StepSize);
-void RotateCameraAroundCenter(vizmode_params_t * VizParams, double *Axis,
+void RotateCameraAroundCenter(vizmode_params_t * VizParams, real_t *Axis,
         const double angle);
 void ZoomOnCenter(vizmode_params_t * VizParams, const double StepSize);
 
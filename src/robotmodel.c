@@ -8,22 +8,128 @@
 
 #include "robotmodel.h"
 
-double **PreferredVelocities;
+real_t **PreferredVelocities;
 phase_t LocalActualPhase;
 phase_t LocalActualDelayedPhase;
 phase_t SteppedPhase;
 phase_t TempPhase;
 
-double *ChangedInnerStateOfActualAgent;
-static int NearObstacles[9];
+real_t *ChangedInnerStateOfActualAgent;
+/* Obstacles intersecting the convex hull of the swarm (same for every agent) */
+static int *NearObstacles;
+static int NumberOfNearObstacles = 0;
+static int MaxNearObstacles = 0;
 
 static int NumberOfNeighbours = 0;      /* Number of units observed by the actual agent */
-const double packet_loss_power = -65.0;
-const double packet_loss_ratio = .3;
+const real_t packet_loss_power = -65.0;
+const real_t packet_loss_ratio = .3;
+
+/* Obstacle mapping: rays of the actual GPS tick and the cells crossed by them */
+#define OBSTACLE_POWER_JUMP 20.0        /* dB */
+static cbp_rays_t ObstacleRays;
+static cbp_ray_batch_t ObstacleCells;
+
+/* Distances, distances inside obstacles and obstacle losses of the pairs (ComputePairGeometry) */
+static real_t **PairDistances;
+static real_t **PairDistancesInObstacles;
+static real_t **PairLosses;
 
 /* For passing debug information to CalculatePreferredVelocity function */
 agent_debug_info_t DebugInfo;
 
+/* Selecting obstacles that intersect the convex hull of the swarm or lie inside it.
+ * Only these obstacles can attenuate the signal between two agents,
+ * and the set is the same for every agent, so it is calculated once per hull update.
+ */
+void SelectObstaclesNearHull(hull_t * Hull) {
+
+    int j, k;
+    static real_t *ObstPolygon[MAX_OBSTACLE_POINTS];
+
+    NumberOfNearObstacles = 0;
+    if (Hull->NumberOfVertices == 0) {
+        return;
+    }
+
+    for (j = 0; j < obstacles.o_count; j++) {
+        if (NumberOfNearObstacles == MaxNearObstacles) {
+            break;
+        }
+        /* Disjoint bounding boxes - neither intersection nor containment is possible */
+        if (obstacles.o[j].bb_max[0] < Hull->MinX || obstacles.o[j].bb_min[0] > Hull->MaxX ||
+                obstacles.o[j].bb_max[1] < Hull->MinY || obstacles.o[j].bb_min[1] > Hull->MaxY) {
+            continue;
+        }
+        for (k = 0; k < obstacles.o[j].p_count; k++) {
+            ObstPolygon[k] = obstacles.o[j].p[k];
+        }
+        if (IntersectingPolygons(Hull->Polygon, Hull->NumberOfVertices, ObstPolygon, obstacles.o[j].p_count) == true ||
+            IsInsidePolygon(obstacles.o[j].center, Hull->VertexSet, Hull->NumberOfVertices + 1)) {
+                NearObstacles[NumberOfNearObstacles] = j;
+                NumberOfNearObstacles++;
+        }
+    }
+
+}
+
+/* Distances and obstacle penetrations of every pair of agents.
+ * The geometry is symmetric, therefore every unordered pair is tested once.
+ * Obstacles attenuate only in the model with obstacles, and only pairs which
+ * can be above the sensitivity threshold are tested.
+ */
+void ComputePairGeometry(phase_t * Phase, real_t **Polygons,
+        unit_model_params_t * UnitParams) {
+
+    int i, j, k;
+    static real_t Difference[3];
+    static real_t DistanceThrough[3];
+    static real_t IntersectionPoints[2][3];
+    real_t *Intersections[2] = { IntersectionPoints[0], IntersectionPoints[1] };
+    real_t Distance, DistanceInObstacle, Loss;
+    const bool WithObstacles = ((int) UnitParams->communication_type.Value == 2);
+
+    RefreshPathLoss(&PathLoss, UnitParams);
+
+    for (i = 0; i < Phase->NumberOfAgents; i++) {
+
+        PairDistances[i][i] = 0;
+        PairDistancesInObstacles[i][i] = 0;
+        PairLosses[i][i] = 0;
+
+        for (j = i + 1; j < Phase->NumberOfAgents; j++) {
+
+            VectDifference(Difference, Phase->Coordinates[j], Phase->Coordinates[i]);
+            Distance = VectAbs(Difference);
+            DistanceInObstacle = 0;
+            Loss = 0;
+            PROFILE_COUNT(PROFILE_PAIRS, 1);
+
+            if (true == WithObstacles && Distance <= PathLoss.CullDistance) {
+                for (k = 0; k < NumberOfNearObstacles; k++) {
+                    PROFILE_COUNT(PROFILE_OBSTACLE_TESTS, 1);
+                    int NumberOfIntersections;
+
+                    NumberOfIntersections = IntersectionOfSegmentAndPolygon2D(Intersections,
+                    Phase->Coordinates[i], Phase->Coordinates[j], Polygons[NearObstacles[k]], obstacles.o[NearObstacles[k]].p_count);
+
+                    if (NumberOfIntersections == 2) {
+                            VectDifference(DistanceThrough, Intersections[0], Intersections[1]);
+                            DistanceInObstacle = VectAbs(DistanceThrough);
+                            Loss = PathLossOfObstacle(DistanceInObstacle);
+                            break;
+                    }
+                }
+            }
+
+            PairDistances[i][j] = PairDistances[j][i] = Distance;
+            PairDistancesInObstacles[i][j] = PairDistancesInObstacles[j][i] = DistanceInObstacle;
+            PairLosses[i][j] = PairLosses[j][i] = Loss;
+
+        }
+    }
+
+}
+
 /* Calculating the phase space observed by the "WhichAgent"th unit.  */
 void CreatePhase(phase_t * LocalActualPhaseToCreate,
         phase_t * GPSPhase,
@@ -31,8 +137,6 @@ void CreatePhase(phase_t * LocalActualPhaseToCreate,
         phase_t * Phase,
         int TimeStepReal,
         phase_t * DelayedPhase,
-        double **Polygons,
-        node *Hull,
         const int WhichAgent,
         unit_model_params_t * UnitParams,
         const bool OrderByDistance) {
@@ -40,7 +144,7 @@ void CreatePhase(phase_t * LocalActualPhaseToCreate,
     int i, j, k;
     LocalActualPhaseToCreate->NumberOfAgents = Phase->NumberOfAgents;   
     LocalActualPhaseToCreate->NumberOfInnerStates = Phase->NumberOfInnerStates; // ???
-    double DepthEMA = UnitParams->depthEMA.Value;
+    real_t DepthEMA = UnitParams->depthEMA.Value;
     /* Setting up order by distance from actual unit */
 
     for (i = 0; i < Phase->NumberOfAgents; i++) {
@@ -62,84 +166,18 @@ void CreatePhase(phase_t * LocalActualPhaseToCreate,
 
     }
 
-    static double ActualAgentsPosition[3];
+    static real_t ActualAgentsPosition[3];
     GetAgentsCoordinates(ActualAgentsPosition, Phase, WhichAgent);
-    int HullLength;
-    HullLength = stack_count(Hull);
-    int cnt = 0;
-    if (Hull != NULL) {
-        double **HullPolygon;
-        double **ObstPolygon;
-        double *HullVertexSet;
-        HullVertexSet = malloc((HullLength * 2 + 2) * sizeof(double));
-        HullPolygon = doubleMatrix(HullLength, 3);
-        HullVertexSet[HullLength * 2] = Hull->data->x;
-        HullVertexSet[HullLength * 2 + 1] = Hull->data->y;
-        for (j = 0; j < HullLength; j++) {
-            HullPolygon[j][0] = Hull->data->x;
-            HullPolygon[j][1] = Hull->data->y;
-            HullPolygon[j][2] = 0;
-            HullVertexSet[j * 2] = Hull->data->x;
-            HullVertexSet[j* 2 + 1] = Hull->data->y;
-            Hull = Hull->next;
-        }
-        cnt = 0;
-        for (j = 0; j < obstacles.o_count; j++) {
-            ObstPolygon = doubleMatrix(obstacles.o[j].p_count, 2);
-            for (k = 0; k < obstacles.o[j].p_count; k++){
-                ObstPolygon[k][0] = obstacles.o[j].p[k][0];
-                ObstPolygon[k][1] = obstacles.o[j].p[k][1];   
-            }
-            if (cnt > 9) { break; }
-            if (IntersectingPolygons(HullPolygon, HullLength, ObstPolygon, obstacles.o[j].p_count) == true ||
-                IsInsidePolygon(obstacles.o[j].center, HullVertexSet, HullLength + 1)) {
-                    NearObstacles[cnt] = j;
-                    cnt++;
-            }
-            freeMatrix(ObstPolygon, obstacles.o[j].p_count, 2);
-        }
-        // printf("%d\n", cnt);
-    freeMatrix(HullPolygon, HullLength, 2);
-    free(HullVertexSet);
-    }
 
+    /* Path loss from the geometry of the pairs (see ComputePairGeometry),
+     * then the shadowing of each direction (in the order of the agents) */
+    PathLossBatch(&PathLoss, PairDistances[WhichAgent],
+            PairDistancesInObstacles[WhichAgent], PairLosses[WhichAgent],
+            LocalActualPhaseToCreate->ReceivedPower, Phase->NumberOfAgents);
     for (i = 0; i < Phase->NumberOfAgents; i++) {
+        LocalActualPhaseToCreate->ReceivedPower[i] -=
+                randomizeGaussDouble(0, PATH_LOSS_SHADOWING_STDEV);
 
-        static double NeighbourDistance[3];
-        static double NeighbourPosition[3];
-        double Distance = 0;
-        double dist_obst=0;
-        double Loss=0;
-        double Power=0;
-
-        GetAgentsCoordinates(NeighbourPosition, Phase, i);
-        VectDifference(NeighbourDistance, NeighbourPosition, ActualAgentsPosition);
-        Distance = VectAbs(NeighbourDistance);
-
-        for (j = 0; j < cnt; j++) {
-            double **Intersections;
-            Intersections = doubleMatrix(2, 3);
-            int NumberOfIntersections;
-            
-            static double DistanceThrough[3];
-
-            NumberOfIntersections = IntersectionOfSegmentAndPolygon2D(Intersections,
-            ActualAgentsPosition, NeighbourPosition, Polygons[NearObstacles[j]], obstacles.o[NearObstacles[j]].p_count);
-
-            if (NumberOfIntersections == 2) {
-                    VectDifference(DistanceThrough, Intersections[0], Intersections[1]);
-                    dist_obst = VectAbs(DistanceThrough);
-                    Loss = 40 * log10(dist_obst);
-                    break;
-            }
-            else {
-                dist_obst = 0;
-                Loss = 0;
-            }
-            freeMatrix(Intersections, 2, 3);
-        }
-        LocalActualPhaseToCreate->ReceivedPower[i] = DegradedPower(Distance, dist_obst, Loss, UnitParams);
-        
         /* EMA calculation */
 
         // if (TimeStepReal < DepthEMA) 
@@ -182,14 +220,14 @@ void CreatePhase(phase_t * LocalActualPhaseToCreate,
     /* Setting up delay and GPS inaccuracy for positions and velocities */
 
     /* Velocities */
-    static double RealVelocity[3];
+    static real_t RealVelocity[3];
     NullVect(RealVelocity, 3);
-    static double GPSVelocityToAdd[3];
+    static real_t GPSVelocityToAdd[3];
     NullVect(GPSVelocityToAdd, 3);
     /* Positions */
-    static double RealPosition[3];
+    static real_t RealPosition[3];
     NullVect(RealPosition, 3);
-    static double GPSPositionToAdd[3];
+    static real_t GPSPositionToAdd[3];
     NullVect(GPSPositionToAdd, 3);
 
     for (i = 1; i < NumberOfNeighbours; i++) {
@@ -236,14 +274,73 @@ void CreatePhase(phase_t * LocalActualPhaseToCreate,
 
 }
 
+/* Phase observed by the "WhichAgent"th unit between two GPS ticks.
+ * The force law uses only the unit's own (GPS) position, velocity and inner
+ * states there, therefore the neighbours and the power model are skipped.
+ */
+void CreateOwnPhase(phase_t * LocalActualPhaseToCreate,
+        phase_t * GPSPhase, phase_t * Phase, const int WhichAgent) {
+
+    int j;
+
+    LocalActualPhaseToCreate->NumberOfAgents = 1;
+    LocalActualPhaseToCreate->NumberOfInnerStates = Phase->NumberOfInnerStates;
+    LocalActualPhaseToCreate->RealIDs[0] = Phase->RealIDs[WhichAgent];
+
+    for (j = 0; j < 3; j++) {
+        LocalActualPhaseToCreate->Coordinates[0][j] =
+                Phase->Coordinates[WhichAgent][j] +
+                GPSPhase->Coordinates[WhichAgent][j];
+        LocalActualPhaseToCreate->Velocities[0][j] =
+                Phase->Velocities[WhichAgent][j] +
+                GPSPhase->Velocities[WhichAgent][j];
+    }
+
+    for (j = 0; j < Phase->NumberOfInnerStates; j++) {
+        LocalActualPhaseToCreate->InnerStates[0][j] =
+                Phase->InnerStates[WhichAgent][j];
+    }
+
+}
+
+/* Mapping obstacles into the CBP (on GPS ticks only).
+ * If the power received by agent j from agent k changed by more than
+ * OBSTACLE_POWER_JUMP since the previous tick, an obstacle is assumed between them,
+ * and every cell crossed by segment jk is marked as occupied in the map of agent j.
+ * Rays of every pair are collected first, then traversed and inserted at once.
+ */
+void MapObstaclesFromPowerChanges(phase_t * Phase, phase_t * PreviousTickPhase) {
+
+    int j, k;
+
+    if (Phase->CBP == NULL) {
+        return;
+    }
+
+    for (j = 0; j < Phase->NumberOfAgents; j++) {
+        for (k = 0; k < Phase->NumberOfAgents; k++) {
+            if (j != k && fabs(Phase->Laplacian[j][k] -
+                            PreviousTickPhase->Laplacian[j][k]) > OBSTACLE_POWER_JUMP) {
+                AddCBPRay(&ObstacleRays, j, Phase->Coordinates[j], Phase->Coordinates[k]);
+            }
+        }
+    }
+
+    PROFILE_COUNT(PROFILE_RAYS, ObstacleRays.Count);
+    TraverseCBPRays(&ObstacleCells, Phase->CBP, &ObstacleRays,
+            ArenaCenterX, ArenaCenterY, ArenaRadius);
+    ApplyCBPRayBatch(Phase->CBP, &ObstacleCells, 0, MTYPE_OBST);
+
+}
+
 /* Adding outer noise to final velocity vector */
 /* Diffusive noise is a more-or-less effective model of the unknown properties of the control algorithm on the robots. */
-void AddNoiseToVector(double *NoisedVector, double *NoiselessVector,
-        double *RealVelocity, unit_model_params_t * UnitParams,
-        const double DeltaT, double *WindVelocityVector) {
+void AddNoiseToVector(real_t *NoisedVector, real_t *NoiselessVector,
+        real_t *RealVelocity, unit_model_params_t * UnitParams,
+        const double DeltaT, real_t *WindVelocityVector) {
 
     int i;
-    static double NoiseToAdd[3];
+    static real_t NoiseToAdd[3];
     NullVect(NoiseToAdd, 3);
 
     /* Random noise with Gaussian distribution */
@@ -267,9 +364,9 @@ void AddNoiseToVector(double *NoisedVector, double *NoiselessVector,
 /* Calculating wind effect to add to final output acceleration */
 /* It is based on a simple Stokes-like force-law. */
 void StepWind(unit_model_params_t * UnitParams, const double DeltaT,
-        double *WindVelocityVector) {
+        real_t *WindVelocityVector) {
 
-    static double NoiseToAdd[2];
+    static real_t NoiseToAdd[2];
     NoiseToAdd[0] = randomizeGaussDouble(0.0, 1.0);
     NoiseToAdd[1] = randomizeGaussDouble(0.0, 1.0);
 
@@ -286,12 +383,12 @@ void StepWind(unit_model_params_t * UnitParams, const double DeltaT,
 
 /* Force law contains specific features of a real robot
 */
-void RealCoptForceLaw(double *OutputVelocity, double *OutputInnerState, 
-        double ** TargetsArray, int WhichTarget,
-        phase_t * Phase, double *RealVelocity, unit_model_params_t * UnitParams,
+void RealCoptForceLaw(real_t *OutputVelocity, real_t *OutputInnerState, 
+        real_t ** TargetsArray, int WhichTarget,
+        phase_t * Phase, real_t *RealVelocity, unit_model_params_t * UnitParams,
         flocking_model_params_t * FlockingParams, vizmode_params_t * VizParams,
         const double DeltaT, const int TimeStepReal, const int TimeStepLooped,
-        const int WhichAgent, double *WindVelocityVector) {
+        const int WhichAgent, real_t *WindVelocityVector) {
 
     int i;
 
@@ -300,10 +397,10 @@ void RealCoptForceLaw(double *OutputVelocity, double *OutputInnerState,
      * Therefore, Position and velocity of "WhichAgent"th unit is stored in Phase[0] - Phase[5].
      */
     
-    static double PreviousVelocity[3];
+    static real_t PreviousVelocity[3];
     GetAgentsVelocity(PreviousVelocity, Phase, 0);
 
-    static double TempTarget[3];
+    static real_t TempTarget[3];
     for (i = 0; i < Phase->NumberOfInnerStates; i++) {
         OutputInnerState[i] = Phase->InnerStates[0][i];
     }
@@ -312,9 +409,11 @@ void RealCoptForceLaw(double *OutputVelocity, double *OutputInnerState,
         /* Calculating target velocity */
         NullVect(TempTarget, 3);
 
+        PROFILE_BEGIN(PROFILE_PREFERRED_VELOCITY);
         CalculatePreferredVelocity(TempTarget, OutputInnerState, Phase, 
                 TargetsArray, WhichTarget, 0, FlockingParams, VizParams, UnitParams->t_del.Value,
                 TimeStepReal * DeltaT, &DebugInfo, (int)UnitParams->flocking_type.Value);
+        PROFILE_END(PROFILE_PREFERRED_VELOCITY);
 
         for (i = 0; i < 3; i++) {
 
@@ -341,7 +440,7 @@ void RealCoptForceLaw(double *OutputVelocity, double *OutputInnerState,
 
 }
 
-void StepTarget(double * TargetPosition,
+void StepTarget(real_t * TargetPosition,
         sit_parameters_t * SitParams, vizmode_params_t * VizParams,
         flocking_model_params_t * FlockingParams, int TimeStepReal) {
 
@@ -364,25 +463,36 @@ void Step(phase_t * OutputPhase, phase_t * GPSPhase, phase_t * GPSDelayedPhase,
         flocking_model_params_t * FlockingParams, sit_parameters_t * SitParams,
         vizmode_params_t * VizParams, int TimeStepLooped, int TimeStepReal,
         bool CountCollisions, bool * ConditionsReset, int *Collisions,
-        bool * AgentsInDanger, double *WindVelocityVector, double *Accelerations, 
-        double ** TargetsArray, double **Polygons, node **Hull, int Verbose) {
+        bool * AgentsInDanger, real_t *WindVelocityVector, real_t *Accelerations, 
+        real_t ** TargetsArray, real_t **Polygons, hull_t *Hull, int Verbose) {
             
     int i, j, k;
-    static double CheckVelocityCache[3];
+    static real_t CheckVelocityCache[3];
     NullVect(CheckVelocityCache, 3);
-    static double CheckAccelerationCache[3];
+    static real_t CheckAccelerationCache[3];
     NullVect(CheckAccelerationCache, 3);
-    static double CheckDifferenceCache[3];
+    static real_t CheckDifferenceCache[3];
     NullVect(CheckDifferenceCache, 3);
-    static double UnitVectDifference[3];
+    static real_t UnitVectDifference[3];
     NullVect(UnitVectDifference, 3);
     static double DelayStep;
     DelayStep = (UnitParams->t_del.Value / SitParams->DeltaT);
 
-    static point_xy *points;
-    if (points == NULL) {        
-        points = malloc(SitParams->NumberOfAgents * sizeof(point_xy));
-    }
+    /* Multi-rate scheduling: the preferred velocities are recalculated only on
+     * GPS ticks, so with PerceptionOnGPSTick the perception (neighbours,
+     * received powers, Laplacian) runs only there, and the statistics of the
+     * steps in between see its held results. The PID integration runs in
+     * every step. */
+    const int GPSSteps = (int) (UnitParams->t_GPS.Value / SitParams->DeltaT);
+    const bool GPSTick = (TimeStepLooped % GPSSteps == 0);
+    const bool Perception = (GPSTick || SitParams->PerceptionOnGPSTick == 0);
+    /* Resets of the phase allocate, other steps should not after the warm-up */
+    const bool Resetting = (ConditionsReset[0] || ConditionsReset[1]);
+
+    /* Scratch arrays of the previous step are released */
+    ResetArena(&StepArena);
+    HEAP_CHECK_BEGIN();
+    PROFILE_BEGIN(PROFILE_STEP);
 
     /* Getting phase of actual TimeStepfrom PhaseData */
     LocalActualPhase = PhaseData[TimeStepLooped];
@@ -391,20 +501,19 @@ void Step(phase_t * OutputPhase, phase_t * GPSPhase, phase_t * GPSDelayedPhase,
     /* Counting Collisions */
     static int PreviousColl = 0;
     if (CountCollisions == true) {
+        PROFILE_BEGIN(PROFILE_COLLISIONS);
         *Collisions +=
                 HowManyCollisions(&LocalActualPhase, AgentsInDanger,
                 CountCollisions, SitParams->Radius);
         PreviousColl = *Collisions;
+        PROFILE_END(PROFILE_COLLISIONS);
     }
 
     /* Step coordinates (with velocity of previous TimeStepLooped) */
-    static double Velocity[3];
-    static double CoordinatesToStep[3];
+    static real_t Velocity[3];
+    static real_t CoordinatesToStep[3];
     for (j = 0; j < SitParams->NumberOfAgents; j++) {
 
-        points[j].x = LocalActualPhase.Coordinates[j][0];
-        points[j].y = LocalActualPhase.Coordinates[j][1];
-
         GetAgentsVelocity(Velocity, &LocalActualPhase, j);
         GetAgentsCoordinates(CoordinatesToStep, &LocalActualPhase, j);
 
@@ -418,12 +527,16 @@ void Step(phase_t * OutputPhase, phase_t * GPSPhase, phase_t * GPSDelayedPhase,
 
     }
 
-    /* Compute the convex hull */
-    (*Hull) = convex_hull(points, LocalActualPhase.NumberOfAgents);
+    /* Compute the convex hull (on every step or only on GPS ticks) */
+    if (false == Hull->OnlyOnGPSTick || false == Hull->Valid || GPSTick) {
+        PROFILE_BEGIN(PROFILE_HULL);
+        ConvexHullOfPhase(Hull, &LocalActualPhase);
+        SelectObstaclesNearHull(Hull);
+        PROFILE_END(PROFILE_HULL);
+    }
 
     /* Step GPS coordinates and velocities (in every "t_gps"th second) */
-    if ((TimeStepLooped) % ((int) (UnitParams->t_GPS.Value /
-                            SitParams->DeltaT)) == 0) {
+    if (GPSTick) {
         StepGPSNoises(GPSPhase, UnitParams);
         StepGPSNoises(GPSDelayedPhase, UnitParams);
     }
@@ -433,11 +546,27 @@ void Step(phase_t * OutputPhase, phase_t * GPSPhase, phase_t * GPSDelayedPhase,
 
     /* "Realcopt" force law */
 
-    static double RealCoptForceVector[3];
+    static real_t RealCoptForceVector[3];
     NullVect(RealCoptForceVector, 3);
-    static double ActualRealVelocity[3];
+    static real_t ActualRealVelocity[3];
     NullVect(ActualRealVelocity, 3);
 
+    /* Targets of the agents (central planner of the missions, on GPS ticks) */
+    if (GPSTick && (int) UnitParams->flocking_type.Value == 2) {
+        PROFILE_BEGIN(PROFILE_MISSION);
+        UpdateMission(&Mission, &FlockAggregates, &LocalActualPhase,
+                TargetsArray, WhichTarget, TimeStepReal * SitParams->DeltaT,
+                GPSSteps * SitParams->DeltaT);
+        PROFILE_END(PROFILE_MISSION);
+    }
+
+    /* Geometry of the pairs, shared by the phases of every agent */
+    if (true == Perception) {
+        PROFILE_BEGIN(PROFILE_PAIR_GEOMETRY);
+        ComputePairGeometry(&LocalActualPhase, Polygons, UnitParams);
+        PROFILE_END(PROFILE_PAIR_GEOMETRY);
+    }
+
     for (j = 0; j < SitParams->NumberOfAgents; j++) {
 
         /* Constructing debug information about the actual agent */
@@ -447,36 +576,43 @@ void Step(phase_t * OutputPhase, phase_t * GPSPhase, phase_t * GPSDelayedPhase,
         GetAgentsVelocity(DebugInfo.AgentsRealVelocity, &LocalActualPhase, j);
         DebugInfo.RealPhase = &LocalActualPhase;
 
-        /* Creating phase from the viewpoint of the actual agent */
-        CreatePhase(&TempPhase, GPSPhase, GPSDelayedPhase, &LocalActualPhase,
-                TimeStepReal, &LocalActualDelayedPhase, Polygons, 
-                *Hull, j, UnitParams, 
-                (TimeStepLooped % ((int) (UnitParams->t_GPS.Value /  
-                SitParams->DeltaT)) == 0));
-                                        
-        GetAgentsVelocity(ActualRealVelocity, &LocalActualPhase, j);
-
-        // points[j].x = LocalActualPhase.Coordinates[j][0];
-        // points[j].y = LocalActualPhase.Coordinates[j][1];
-        
-        /* Fill the Laplacian and EMA Matrices in dBm */
-        for (i = 0; i < SitParams->NumberOfAgents; i++) {
-            if ( j == TempPhase.RealIDs[i]) {
-                OutputPhase->Laplacian[j][TempPhase.RealIDs[i]] = TempPhase.NumberOfAgents;
-                // OutputPhase->EMA[j][TempPhase.RealIDs[i]] = 0;
+        /* Creating phase from the viewpoint of the actual agent
+         * (between GPS ticks the Laplacian and EMA of the last tick are kept) */
+        PROFILE_BEGIN(PROFILE_CREATE_PHASE);
+        if (true == Perception) {
+            CreatePhase(&TempPhase, GPSPhase, GPSDelayedPhase, &LocalActualPhase,
+                    TimeStepReal, &LocalActualDelayedPhase,
+                    j, UnitParams, GPSTick);
+
+            /* Fill the Laplacian and EMA Matrices in dBm */
+            for (i = 0; i < SitParams->NumberOfAgents; i++) {
+                if ( j == TempPhase.RealIDs[i]) {
+                    OutputPhase->Laplacian[j][TempPhase.RealIDs[i]] = TempPhase.NumberOfAgents;
+                    // OutputPhase->EMA[j][TempPhase.RealIDs[i]] = 0;
+                }
+                else {
+                    OutputPhase->Laplacian[j][TempPhase.RealIDs[i]] = TempPhase.ReceivedPower[i];
+                    OutputPhase->EMA[j][TempPhase.RealIDs[i]] = TempPhase.EMA[j][i];
+            
+                }           
             }
-            else {
-                OutputPhase->Laplacian[j][TempPhase.RealIDs[i]] = TempPhase.ReceivedPower[i];
-                OutputPhase->EMA[j][TempPhase.RealIDs[i]] = TempPhase.EMA[j][i];
-        
-            }           
+            /* Swapping the EMA line at the begining of the matrix (quick fix to improve...) */
+            TempPhase.EMA[0] = TempPhase.EMA[j];
+
+            UpdateNeighbourhoodCoM(&FlockAggregates, &TempPhase, j, (int) Size_Neighbourhood);
+            UpdateNeighbourList(&FlockAggregates, &TempPhase, j, (int) Size_Neighbourhood);
+        } else {
+            CreateOwnPhase(&TempPhase, GPSPhase, &LocalActualPhase, j);
         }
-        /* Swapping the EMA line at the begining of the matrix (quick fix to improve...) */
-        TempPhase.EMA[0] = TempPhase.EMA[j];
+        PROFILE_END(PROFILE_CREATE_PHASE);
+
+        GetAgentsVelocity(ActualRealVelocity, &LocalActualPhase, j);
         
         /* CBP strategy (only on GPS tick) */
-        if ((TimeStepLooped) % ((int) (UnitParams->t_GPS.Value / SitParams->DeltaT)) == 0) {
+        if (OutputPhase->CBP != NULL && GPSTick) {
+            PROFILE_BEGIN(PROFILE_CBP);
             WhereInGrid(OutputPhase, SitParams->Resolution, j, ArenaCenterX, ArenaCenterY, ArenaRadius);
+            PROFILE_END(PROFILE_CBP);
 
             // for (i = 0; i < TempPhase.NumberOfAgents; i++) {
                 // if (i != j) {
@@ -512,9 +648,6 @@ void Step(phase_t * OutputPhase, phase_t * GPSPhase, phase_t * GPSDelayedPhase,
         }
     }
 
-    /* Compute the convex hull */
-    // (*Hull) = convex_hull(points, LocalActualPhase.NumberOfAgents);
-
     // for (i = 0; i < SitParams->Resolution; i++){
     //     for (j = 0; j < SitParams->Resolution; j++){
     //         printf("%f\t", OutputPhase->CBP[i][j]);
@@ -532,6 +665,7 @@ void Step(phase_t * OutputPhase, phase_t * GPSPhase, phase_t * GPSDelayedPhase,
     // }
     // printf("\n\n\n\n");
 
+    PROFILE_BEGIN(PROFILE_ACCELERATION);
     double OnePerDeltaT = 1. / SitParams->DeltaT;
     /* The acceleration saturates at a_max. We save out the acceleration magnitude values before 
     we add OuterNoise to the velocities and lose the possibility to derivate numerically */
@@ -561,7 +695,10 @@ void Step(phase_t * OutputPhase, phase_t * GPSPhase, phase_t * GPSDelayedPhase,
 
     }
 
+    PROFILE_END(PROFILE_ACCELERATION);
+
     /* Outer Noise Term - Gaussian white noise */
+    PROFILE_BEGIN(PROFILE_NOISE);
     for (j = 0; j < SitParams->NumberOfAgents; j++) {
         if (true == Noises[j]) {
             GetAgentsVelocity(CheckAccelerationCache, &LocalActualPhase, j);
@@ -572,6 +709,8 @@ void Step(phase_t * OutputPhase, phase_t * GPSPhase, phase_t * GPSDelayedPhase,
             InsertAgentsVelocity(&SteppedPhase, CheckVelocityCache, j);
         }
     }
+    PROFILE_END(PROFILE_NOISE);
+
     /* Redistribution of agents when pressing F12 */
     if (ConditionsReset[0] == true) {
         // printf("0\n");
@@ -586,6 +725,7 @@ void Step(phase_t * OutputPhase, phase_t * GPSPhase, phase_t * GPSDelayedPhase,
         //         SitParams->InitialY, SitParams->InitialZ, VizParams,
         //         FlockingParams, SitParams->Radius);
         ConditionsReset[0] = false;
+        Hull->Valid = false;
     } else if (ConditionsReset[1] == true) {
         // printf("1\n");
         if (VizParams->MapSizeXY < SitParams->InitialX
@@ -612,6 +752,7 @@ void Step(phase_t * OutputPhase, phase_t * GPSPhase, phase_t * GPSDelayedPhase,
             //         FlockingParams, SitParams->Radius);
         }
         ConditionsReset[1] = false;
+        Hull->Valid = false;
     }
     /* Insert Phase into PhaseData... */
     for (j = 0; j < SitParams->NumberOfAgents; j++) {
@@ -624,15 +765,26 @@ void Step(phase_t * OutputPhase, phase_t * GPSPhase, phase_t * GPSDelayedPhase,
         }
     }
 
+    /* Obstacle mapping from the changes of received power since the previous GPS tick */
+    if (GPSTick && TimeStepLooped + 1 >= GPSSteps) {
+        PROFILE_BEGIN(PROFILE_CBP);
+        MapObstaclesFromPowerChanges(OutputPhase,
+                &PhaseData[TimeStepLooped + 1 - GPSSteps]);
+        PROFILE_END(PROFILE_CBP);
+    }
+
+    PROFILE_END(PROFILE_STEP);
+    HEAP_CHECK_END(TimeStepReal > ARENA_WARMUP_STEPS && false == Resetting);
+
 }
 
 /* Some global variables are allocated and initialized in this function */
 void InitializePreferredVelocities(phase_t * Phase,
         flocking_model_params_t * FlockingParams, sit_parameters_t * SitParams,
-        unit_model_params_t * UnitParams, double *WindVelocityVector) {
+        unit_model_params_t * UnitParams, real_t *WindVelocityVector) {
 
     /* Preferred Velocities */
-    PreferredVelocities = doubleMatrix(SitParams->NumberOfAgents, 3);
+    PreferredVelocities = realMatrix(SitParams->NumberOfAgents, 3);
     Noises = BooleanData(SitParams->NumberOfAgents);
 
     int i, j;
@@ -645,11 +797,31 @@ void InitializePreferredVelocities(phase_t * Phase,
 
     /* Some helper dynamic arrays should be allocated here */
     AllocatePhase(&SteppedPhase, SitParams->NumberOfAgents,
-            Phase->NumberOfInnerStates, SitParams->Resolution);
+            Phase->NumberOfInnerStates);
     AllocatePhase(&TempPhase, SitParams->NumberOfAgents,
-            Phase->NumberOfInnerStates, SitParams->Resolution);
+            Phase->NumberOfInnerStates);
     ChangedInnerStateOfActualAgent =
-            (double *) calloc(Phase->NumberOfInnerStates, sizeof(double));
+            (real_t *) calloc(Phase->NumberOfInnerStates, sizeof(real_t));
+
+    /* Obstacles taken into account in the attenuation model (0 means all of them) */
+    MaxNearObstacles = SitParams->MaxNearObstacles;
+    if (MaxNearObstacles <= 0 || MaxNearObstacles > MAX_OBSTACLES) {
+        MaxNearObstacles = MAX_OBSTACLES;
+    }
+    NearObstacles = intData(MaxNearObstacles);
+
+    PairDistances = realMatrix(SitParams->NumberOfAgents, SitParams->NumberOfAgents);
+    PairDistancesInObstacles = realMatrix(SitParams->NumberOfAgents, SitParams->NumberOfAgents);
+    PairLosses = realMatrix(SitParams->NumberOfAgents, SitParams->NumberOfAgents);
+
+    AllocateFlockAggregates(&FlockAggregates, SitParams->NumberOfAgents);
+    AllocateMission(&Mission, SitParams->NumberOfAgents,
+            (mission_type_t) SitParams->MissionType, SitParams->AssignmentPeriod,
+            SitParams->TargetDwellTime);
+
+    /* Lists of the obstacle mapping (they grow if needed) */
+    AllocateCBPRays(&ObstacleRays, SitParams->NumberOfAgents);
+    AllocateCBPRayBatch(&ObstacleCells, 2 * SitParams->NumberOfAgents * SitParams->Resolution);
 
     /* Setting up wind velocity vector */
     WindVelocityVector[0] = cos(UnitParams->Wind_Angle.Value);
@@ -662,15 +834,23 @@ void freePreferredVelocities(phase_t * Phase,
         flocking_model_params_t * FlockingParams,
         sit_parameters_t * SitParams) {
 
-    freeMatrix(PreferredVelocities, SitParams->NumberOfAgents, 3);
+    freeRealMatrix(PreferredVelocities, SitParams->NumberOfAgents, 3);
     free(Noises);
 
     /* Freeing memory owned by helper arrays */
-    freePhase(&SteppedPhase, SitParams->Resolution);
-    freePhase(&TempPhase, SitParams->Resolution);
+    freePhase(&SteppedPhase);
+    freePhase(&TempPhase);
 
     if (Phase->NumberOfInnerStates != 0) {
         free(ChangedInnerStateOfActualAgent);
     }
+    free(NearObstacles);
+    freeRealMatrix(PairDistances, SitParams->NumberOfAgents, SitParams->NumberOfAgents);
+    freeRealMatrix(PairDistancesInObstacles, SitParams->NumberOfAgents, SitParams->NumberOfAgents);
+    freeRealMatrix(PairLosses, SitParams->NumberOfAgents, SitParams->NumberOfAgents);
+    freeFlockAggregates(&FlockAggregates);
+    freeMission(&Mission);
+    freeCBPRays(&ObstacleRays);
+    freeCBPRayBatch(&ObstacleCells);
 
 }
@@ -13,6 +13,8 @@
 #include "utilities/math_utils.h"
 #include "utilities/datastructs.h"
 #include "utilities/dynamics_utils.h"
+#include "utilities/hull.h"
+#include "utilities/profiler.h"
 #include "algo_spp_evol.h"
 #include "vizmode.h"
 #include "sensors.h"
@@ -28,10 +30,23 @@
 #include <string.h>
 #include <stdlib.h>
 
-void StepTarget(double * TargetPosition,
+void StepTarget(real_t * TargetPosition,
         sit_parameters_t * SitParams, vizmode_params_t * VizParams,
         flocking_model_params_t * FlockingParams, int TimeStepReal);
 
+/* Selecting obstacles near the convex hull of the swarm (once per hull update)
+ */
+void SelectObstaclesNearHull(hull_t * Hull);
+
+/* Distances and obstacle penetrations of every pair of agents (once per pair)
+ */
+void ComputePairGeometry(phase_t * Phase, real_t **Polygons,
+        unit_model_params_t * UnitParams);
+
+/* Marking obstacles in the CBP based on the changes of the received power
+ */
+void MapObstaclesFromPowerChanges(phase_t * Phase, phase_t * PreviousTickPhase);
+
 /* Step positions and velocities
  */
 void Step(phase_t * OutputPhase, phase_t * GPSPhase, phase_t * GPSDelayedPhase,
@@ -39,14 +54,14 @@ void Step(phase_t * OutputPhase, phase_t * GPSPhase, phase_t * GPSDelayedPhase,
         flocking_model_params_t * FlockingParams, sit_parameters_t * SitParams,
         vizmode_params_t * VizParams, int TimeStepLooped, int TimeStepReal,
         bool CountCollisions, bool * ConditionsReset, int *Collisions,
-        bool * AgentsInDanger, double *WindVelocityVector, double *Accelerations,
-        double ** TargetsArray, double **Polygons, node **Hull, int Verbose);
+        bool * AgentsInDanger, real_t *WindVelocityVector, real_t *Accelerations,
+        real_t ** TargetsArray, real_t **Polygons, hull_t *Hull, int Verbose);
 
 /*  Initialization and killing
  */
 void InitializePreferredVelocities(phase_t * Phase,
         flocking_model_params_t * FlockingParams, sit_parameters_t * SitParams,
-        unit_model_params_t * UnitParams, double *WindVelocityVector);
+        unit_model_params_t * UnitParams, real_t *WindVelocityVector);
 void freePreferredVelocities(phase_t * Phase,
         flocking_model_params_t * FlockingParams, sit_parameters_t * SitParams);
 
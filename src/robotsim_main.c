@@ -19,6 +19,7 @@
 /* Standard C includes */
 #include <sys/time.h>
 #include <unistd.h>
+#include <sched.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/types.h>
@@ -35,6 +36,11 @@
 
 /* Tools for OpenGL visualization and GUI */
 #ifndef SERVER_MODE
+#include <pthread.h>
+#include <stdatomic.h>
+#include "utilities/snapshot.h"
+#include "vizualizer/batch_2d.h"
+#include "vizualizer/map_texture.h"
 #include "objects_menu.h"
 #include "colors.h"
 #include "vizualizer/objects_3d.h"
@@ -48,6 +54,8 @@
 #include "algo_stat.h"
 
 /* Tools for image output */
+#include "utilities/video_out.h"
+#include "utilities/telemetry.h"
 #ifdef PNG_OUT
 #include "utilities/pngout_utils.h"
 #endif
@@ -78,16 +86,17 @@ phase_t GPSPhase;
 phase_t GPSDelayedPhase;
 
 /* For taking Wind into account */
-static double WindVelocityVector[2];
+static real_t WindVelocityVector[2];
 
 /* For comm attenuation */
-double **Polygons;
+real_t **Polygons;
 
 /* Convex hull */
-node *Hull;
+hull_t Hull;
 
 /* CBP */
 static int ***CBPObst;
+cbp_map_t CBPMap;
  
 // Temporary...
 static bool HighRes = true;
@@ -117,8 +126,8 @@ bool TrajViz = false;
 bool *AgentsInDanger;
 int Collisions;
 int NumberOfCluster;
-double TargetPosition[3];
-double **TargetsArray; // = NULL;
+real_t TargetPosition[3];
+real_t **TargetsArray; // = NULL;
 int cnt = 0;                    // Which target is on
 
 
@@ -129,6 +138,55 @@ model_specific_color_t ModelSpecificColors[MAX_NUMBER_OF_COLORS];
 FILE *f_OutPhase, *f_OutInnerStates;
 bool PNGOutVid = false;
 
+/* Headless video output of the "-novis" runs (see video_out.h) */
+video_output_t Video;
+/* Live telemetry of the "-novis" runs (see telemetry.h) */
+telemetry_t Telemetry;
+
+#ifndef SERVER_MODE
+/* Simulation thread of the visualization.
+ * The steps are calculated by "SimulationThread" while it holds
+ * "SimulationLock". The input events take the lock as well, therefore their
+ * changes are applied between two steps. The windows draw the snapshots
+ * published by the simulation ("DisplayedSnapshot"), never the live state.
+ */
+pthread_t SimulationThreadID;
+pthread_mutex_t SimulationLock = PTHREAD_MUTEX_INITIALIZER;
+static atomic_int WaitingForSimulationLock;
+snapshot_buffer_t Snapshots;
+simulation_snapshot_t *DisplayedSnapshot;
+
+/* "VizSpeedUp" steps are calculated in the time of a frame of this rate,
+ * at the maximal speed up the simulation runs as fast as it can
+ */
+#define SIMULATION_FRAME_RATE 60.0
+#define MAX_VIZ_SPEED_UP 100
+/* Every "TAIL_DECIMATION"th stored step is drawn in the tails */
+#define TAIL_DECIMATION 10
+
+/* Batches of the 2D view refilled in every frame */
+vertex_batch_t CopterSprites;
+vertex_batch_t VelocityArrows;
+vertex_batch_t NetworkEdges;
+vertex_batch_t NetworkDashedLines;
+vertex_batch_t NetworkCrossings;
+vertex_batch_t GridLines;
+
+/* Agents are labelled only if there are not more than this or if the map is zoomed in */
+#define MAX_AGENTS_WITH_LABELS 100
+/* Edges of the communication network drawn at most (level of detail) */
+#define MAX_NETWORK_EDGES 50000
+
+/* CBP map of the chart window, and its values (toggled by "l"). Values are
+ * drawn if the cells are at least this large, the grid if they are not
+ * smaller than this (pixels).
+ */
+map_texture_t ChartMap;
+bool DisplayChartLabels = false;
+#define CHART_LABEL_MIN_CELL_SIZE 30.0
+#define CHART_GRID_MIN_CELL_SIZE 4.0
+#endif
+
 /* Functions for Initializing, displaying and refreshing windows */
 
 /* Setting up Initial conditions */
@@ -194,6 +252,7 @@ void Initialize() {
 
     /* Communication network display is OFF */
     ActualVizParams.DisplayCommNetwork = false;
+    ActualVizParams.DisplayNetworkDetails = false;
     /* Hull display is OFF */
     ActualVizParams.DisplayHull = false;
 
@@ -225,6 +284,23 @@ void Initialize() {
 }
 
 #ifndef SERVER_MODE
+/* Waiting for the end of the actual step (see SimulationThread) */
+static void LockSimulation() {
+    atomic_fetch_add(&WaitingForSimulationLock, 1);
+    pthread_mutex_lock(&SimulationLock);
+    atomic_fetch_sub(&WaitingForSimulationLock, 1);
+}
+
+static void UnlockSimulation() {
+    pthread_mutex_unlock(&SimulationLock);
+}
+
+/* The simulation thread is stopped between two steps before the exit handlers
+ * (e.g. the profile) read its results */
+static void StopSimulationThread() {
+    LockSimulation();
+}
+
 /* Displaying "menu" window */
 char VizSpeedUpName[19] = "Visualization Speed";
 void DisplayMenu() {
@@ -273,91 +349,47 @@ void DisplayChart() {
 
     float occupiedColor[3] = {0, 0, 0};
     float freeColor[3] = {1, 1, 1};
-
-    // float green[3] = {0, 1, 0};
-    // float yellow[3] = {1, 1, 0};
+    float black[3] = {0, 0, 0};
 
     double step = 2.0 / Resolution;
+    /* Size of the cells in pixels */
+    const double CellSize = (double) glutGet(GLUT_WINDOW_WIDTH) / Resolution;
     glClearColor(ActualColorConfig.EraseColor[0],
             ActualColorConfig.EraseColor[1], ActualColorConfig.EraseColor[2], 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    int i,j,k;
-    double xsize = 0, ysize = 0;
-    // for (int ag = 0; ag < 1; ag++) {
-    //     for (row = 0; row < ActualSitParams.NumberOfAgents; row++) {
-    //         for (k = 0; k <100; k++) {
-    //             if (CBPObst[ag][row][k] != 0 && CBPObst[ag][row][k + 1] != 0) {
-    //                 glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-    //                 // printf("%d\n", col);
-    //                 DrawShape(-1.0 + step/2 + step * CBPObst[ag][row][k], 1.0 - step/2 - CBPObst[ag][row][k + 1] * step, step, step, 0, red);
-    //             }
-    //         }
-    //     }
-    // }
-    for (i = 0; i < Resolution; i++) {
-        xsize = 0;
-        for (j = 0; j < Resolution; j++) {
-            // TODO merge maps for display
-            double mean = 0;
-            long sampleCount = 1; 
-            if (ActualVizParams.WhichAgentIsSelected == ActualPhase.NumberOfAgents) {    
-                for (k = 0; k < ActualSitParams.NumberOfAgents; k++) {
-                    
-                    // keep this condition and u can differenciate explored zones from inexplored zones
-                    if (ActualPhase.CBP[k][i][j].count > 0) {
-                        mean += ActualPhase.CBP[k][i][j].current;
-                        sampleCount++;
-                    }
-                    
-                    if (ActualPhase.CBP[k][i][j].countObst > 0) {
-                        mean += ActualPhase.CBP[k][i][j].currentObst;
-                        sampleCount++;
-                    }
-                }
-            } else {
-                int agentId = ActualVizParams.WhichAgentIsSelected;
-                
-                // keep this condition and u can differenciate explored zones from inexplored zones
-                if (ActualPhase.CBP[agentId][i][j].count > 0) {
-                    mean += ActualPhase.CBP[agentId][i][j].current;
-                    sampleCount++;
-                }
-                if (ActualPhase.CBP[agentId][i][j].currentObst > 0) {
-                    mean += ActualPhase.CBP[agentId][i][j].currentObst;
-                    sampleCount++;
-                }
-            }
-            mean /= sampleCount;
-
-            if (mean > 0) {
-                // DrawGradientColoredCircle(-1.0 + step/2 + xsize, 1.0 - ysize - step/2, step/4, step/6, green, yellow, 25);
-
-                mean = MIN(1, mean);
-                float col[3] = {0};
-                LerpColor(occupiedColor, freeColor, col, mean);
-
-                glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-                DrawShape(-1.0 + step/2 + xsize, 1.0 - ysize - step/2, step, step, 0, col);
-            }
+    int i,j;
+    /* Maps are drawn only if the CBP is enabled */
+    if (true == DisplayedSnapshot->HasCBP) {
 
-            float black[3] = {0,0,0};
+        /* Probability of being free, unexplored cells are not colored */
+        if (ChartMap.Values == NULL) {
+            AllocateMapTexture(&ChartMap, Resolution);
+        }
+        UpdateMapTexture(&ChartMap, DisplayedSnapshot->CBP,
+                ActualColorConfig.EraseColor, occupiedColor, freeColor);
+        DrawMapTexture(&ChartMap);
 
+        /* Values of the cells, if toggled on and readable */
+        if (true == DisplayChartLabels && CellSize >= CHART_LABEL_MIN_CELL_SIZE) {
             char str[10];
-            sprintf(str, "%.2lf", mean);
-            DrawString(-1.025 + step/2 + xsize, 0.985 - ysize - step/2, GLUT_BITMAP_TIMES_ROMAN_10,
-                str, black);
-
-            xsize += step;
+            for (i = 0; i < Resolution; i++) {
+                for (j = 0; j < Resolution; j++) {
+                    sprintf(str, "%.2lf", MIN(1, DisplayedSnapshot->CBP[i * Resolution + j]));
+                    DrawString(-1.025 + step/2 + j * step, 0.985 - i * step - step/2,
+                        GLUT_BITMAP_TIMES_ROMAN_10, str, black);
+                }
+            }
         }
-        ysize += step;
     }
 
-    DrawSquare(Resolution);
+    if (CellSize >= CHART_GRID_MIN_CELL_SIZE) {
+        DrawSquare(Resolution);
+    }
 
 
     for (int i = 0; i < ActualSitParams.NumberOfAgents; i++) {
-        double* coord = ActualPhase.Coordinates[i];
+        real_t* coord = DisplayedSnapshot->Phase.Coordinates[i];
         DrawCopter_2D(coord[0] - ArenaCenterX,
                       coord[1] - ArenaCenterY,
                       ArenaRadius, 1000,
@@ -368,15 +400,85 @@ void DisplayChart() {
     glutSwapBuffers();
 }
 
-/* Displaying quadcopters */
-void DrawCopters(phase_t * Phase, phase_t * GPSPhase, const int TimeStep) {
+/* Keys of the chart window ("l" toggles the values of the cells) */
+void HandleChartKeyBoard(unsigned char key, int x, int y) {
+
+    if (key == 'l') {
+        DisplayChartLabels = !DisplayChartLabels;
+        glutPostRedisplay();
+    }
+
+}
+
+/* Grid of the 2D view in one batch. The grid does not move with the map
+ * (it is drawn around the origin of the view), its batch is rebuilt only if
+ * the zoom, the arena or the color changes.
+ */
+static void DrawGrid_2D() {
+
+    static double BuiltFor[4] = { 0.0, 0.0, 0.0, 0.0 };
+    static float BuiltColor[3] = { -1.0, -1.0, -1.0 };
+    const double MapSizeXY = ActualVizParams.MapSizeXY;
+    const float *Color = ActualColorConfig.AxisColor;
+    double LengthOfAxis, TicDensity;
+    int i, HowManyTics;
+
+    if (GridLines.Vertices == NULL) {
+        AllocateVertexBatch(&GridLines, GL_LINES, 1024);
+    }
+    if (BuiltFor[0] != MapSizeXY || BuiltFor[1] != ArenaCenterX
+            || BuiltFor[2] != ArenaCenterY || BuiltFor[3] != ArenaRadius
+            || memcmp(BuiltColor, Color, sizeof(BuiltColor)) != 0) {
+
+        /* Size of the coordinate system (in GL coordinates, the vertices
+         * are given in real coordinates: multiplied by the size of the map) */
+        LengthOfAxis = RealToGlCoord_2D(ArenaRadius, MapSizeXY);
+        TicDensity = RealToGlCoord_2D(2000.0, MapSizeXY);
+        HowManyTics = (int) LengthOfAxis / TicDensity;
+        HowManyTics = (int) HowManyTics *1.5;
+
+        ClearVertexBatch(&GridLines);
+        for (i = -HowManyTics; i < HowManyTics; i++) {
+            AddVertexToBatch(&GridLines, i * TicDensity * MapSizeXY,
+                    -HowManyTics * TicDensity * MapSizeXY, Color);
+            AddVertexToBatch(&GridLines, i * TicDensity * MapSizeXY,
+                    LengthOfAxis * MapSizeXY, Color);
+            AddVertexToBatch(&GridLines,
+                    ArenaCenterX - ArenaRadius + i * TicDensity,
+                    ArenaCenterY - ArenaRadius, Color);
+            AddVertexToBatch(&GridLines,
+                    ArenaCenterX - ArenaRadius + i * TicDensity,
+                    LengthOfAxis, Color);
+        }
+        for (i = -HowManyTics; i < HowManyTics; i++) {
+            AddVertexToBatch(&GridLines, -HowManyTics * TicDensity * MapSizeXY,
+                    i * TicDensity * MapSizeXY, Color);
+            AddVertexToBatch(&GridLines, LengthOfAxis * MapSizeXY,
+                    i * TicDensity * MapSizeXY, Color);
+        }
+        UploadVertexBatch(&GridLines, GL_STATIC_DRAW);
+
+        BuiltFor[0] = MapSizeXY;
+        BuiltFor[1] = ArenaCenterX;
+        BuiltFor[2] = ArenaCenterY;
+        BuiltFor[3] = ArenaRadius;
+        memcpy(BuiltColor, Color, sizeof(BuiltColor));
+    }
+
+    DrawVertexBatch(&GridLines, 0.0, 0.0, MapSizeXY);
+
+}
+
+/* Displaying quadcopters of a snapshot */
+void DrawCopters(simulation_snapshot_t * Snapshot) {
+
+    phase_t *Phase = &Snapshot->Phase;
 
-    static double AgentsCoordinates[3];
-    static double AgentsCoordinates_Temp[3];
-    static double AgentsGPSCoordinates[3];
-    static double AgentsVelocity[3];
+    static real_t AgentsCoordinates[3];
+    static real_t AgentsVelocity[3];
+    real_t *TailPoint;
     int i, h, z, g;
-    int HullLength;
+    double Speed;
 
     static float GhostColor[3];
     static float TempColor[3];
@@ -397,32 +499,8 @@ void DrawCopters(phase_t * Phase, phase_t * GPSPhase, const int TimeStep) {
         
 
 
-        /* Setting up size of the coordinate system */
-        LengthOfAxis = RealToGlCoord_2D(ArenaRadius, ActualVizParams.MapSizeXY);
-        TicDensity = RealToGlCoord_2D(2000.0, ActualVizParams.MapSizeXY);
-        HowManyTics = (int) LengthOfAxis / TicDensity;
-        HowManyTics = (int) HowManyTics *1.5;
-
         /* Drawing ground */
-        glColor3f(ActualColorConfig.AxisColor[0],
-                ActualColorConfig.AxisColor[1], ActualColorConfig.AxisColor[2]);
-        glBegin(GL_LINES);
-        for (i = -HowManyTics; i < HowManyTics; i++) {
-            glVertex2d(i * TicDensity, -HowManyTics * TicDensity);
-            glVertex2d(i * TicDensity, LengthOfAxis);
-            glVertex2d(RealToGlCoord_2D(ArenaCenterX - ArenaRadius + i * TicDensity, ActualVizParams.MapSizeXY), 
-                RealToGlCoord_2D(ArenaCenterY - ArenaRadius, ActualVizParams.MapSizeXY));
-            glVertex2d(RealToGlCoord_2D(ArenaCenterX - ArenaRadius + i * TicDensity, ActualVizParams.MapSizeXY),
-                RealToGlCoord_2D(LengthOfAxis, ActualVizParams.MapSizeXY));
-
-        }
-        for (i = -HowManyTics; i < HowManyTics; i++) {
-
-            glVertex2d(-HowManyTics * TicDensity, i * TicDensity);
-            glVertex2d(LengthOfAxis, i * TicDensity);
-
-        }
-        glEnd();
+        DrawGrid_2D();
 
         /* Draw target */
         if (ActualUnitParams.flocking_type.Value == 2) {
@@ -435,7 +513,7 @@ void DrawCopters(phase_t * Phase, phase_t * GPSPhase, const int TimeStep) {
                             ActualVizParams.MapSizeXY, 15000,
                             ActualColorConfig.AgentsColor[0]);
                     
-                    char TargetLabel[3];
+                    char TargetLabel[12];
                     sprintf(TargetLabel, "%d", i);
                     DrawString(RealToGlCoord_2D(TargetsArray[i][0] - ActualVizParams.CenterX + 120.0,
                         ActualVizParams.MapSizeXY),
@@ -448,33 +526,36 @@ void DrawCopters(phase_t * Phase, phase_t * GPSPhase, const int TimeStep) {
             
         }
 
-        /* Draw Tails */
-        if (true == ActualVizParams.DisplayTail) {
-            for (i = 0; i < Phase->NumberOfAgents; i++) {
-                if (ActualVizParams.LengthOfTail < Now) {
-                    for (h = 1; h < ActualVizParams.LengthOfTail; h += 10) {
-
-                        GetAgentsCoordinatesFromTimeLine(AgentsCoordinates_Temp,
-                                PhaseData, i, Now - h);
-
-                        /* Create fading color */
-                        for (z = 0; z < 3; z++) {
-                            TempColor[z] = ActualColorConfig.AgentsColor[i][z];
-                            TempColor[z] -=
-                                    h *
-                                    fabs(ActualColorConfig.AgentsColor[i][z] -
-                                    ActualColorConfig.EraseColor[z]) /
-                                    ActualVizParams.LengthOfTail;
-                        }
-
-                        DrawCopter_2D(AgentsCoordinates_Temp[0] -
-                                ActualVizParams.CenterX,
-                                AgentsCoordinates_Temp[1] -
-                                ActualVizParams.CenterY,
-                                ActualVizParams.MapSizeXY,
-                                ActualSitParams.Radius, TempColor);
-                    }
+        /* Tails, GPS ghosts and agents are collected into one batch and
+         * drawn as sprites (in this order, the later ones on top) */
+        if (CopterSprites.Vertices == NULL) {
+            AllocateVertexBatch(&CopterSprites, GL_POINTS,
+                    Phase->NumberOfAgents);
+            AllocateVertexBatch(&VelocityArrows, GL_TRIANGLES,
+                    9 * Phase->NumberOfAgents);
+        }
+        ClearVertexBatch(&CopterSprites);
+
+        /* Tails (copied from the stored timeline into the snapshot) */
+        for (i = 0; i < Phase->NumberOfAgents; i++) {
+            for (g = 0; g < Snapshot->NumberOfTailPoints; g++) {
+
+                h = 1 + g * Snapshot->TailDecimation;
+                TailPoint = &Snapshot->Tails[3 * (i *
+                                Snapshot->NumberOfTailPoints + g)];
+
+                /* Create fading color */
+                for (z = 0; z < 3; z++) {
+                    TempColor[z] = ActualColorConfig.AgentsColor[i][z];
+                    TempColor[z] -=
+                            h *
+                            fabs(ActualColorConfig.AgentsColor[i][z] -
+                            ActualColorConfig.EraseColor[z]) /
+                            Snapshot->LengthOfTail;
                 }
+
+                AddVertexToBatch(&CopterSprites, TailPoint[0], TailPoint[1],
+                        TempColor);
             }
         }
 
@@ -484,89 +565,92 @@ void DrawCopters(phase_t * Phase, phase_t * GPSPhase, const int TimeStep) {
 
             for (i = 0; i < Phase->NumberOfAgents; i++) {
 
-                GetAgentsCoordinates(AgentsGPSCoordinates, GPSPhase, i);
                 GetAgentsCoordinates(AgentsCoordinates, Phase, i);
 
                 /* Color of the ghosts is halfway between the color of the background and the color of the actual agent */
-                GhostColor[0] =
-                        fabs(ActualColorConfig.AgentsColor[i][0] -
-                        ActualColorConfig.EraseColor[0]) * 0.5 +
-                        ActualColorConfig.EraseColor[0];
-                GhostColor[1] =
-                        fabs(ActualColorConfig.AgentsColor[i][1] -
-                        ActualColorConfig.EraseColor[1]) * 0.5 +
-                        ActualColorConfig.EraseColor[1];
-                GhostColor[2] =
-                        fabs(ActualColorConfig.AgentsColor[i][2] -
-                        ActualColorConfig.EraseColor[2]) * 0.5 +
-                        ActualColorConfig.EraseColor[2];
-
-                /* Draw GPS Ghosts */
-                DrawCopter_2D(AgentsCoordinates[0] + AgentsGPSCoordinates[0] -
-                        ActualVizParams.CenterX,
-                        AgentsCoordinates[1] + AgentsGPSCoordinates[1] -
-                        ActualVizParams.CenterY, ActualVizParams.MapSizeXY,
-                        ActualSitParams.Radius, GhostColor);
-
-                /* Draw Agents */
-                if (AgentsInDanger[i] == true) {
-                    DrawCopter_2D(AgentsCoordinates[0] -
-                            ActualVizParams.CenterX,
-                            AgentsCoordinates[1] - ActualVizParams.CenterY,
-                            ActualVizParams.MapSizeXY, ActualSitParams.Radius,
-                            ActualColorConfig.AgentsInDangerColor);
-                } else {
-                    DrawCopter_2D(AgentsCoordinates[0] -
-                            ActualVizParams.CenterX,
-                            AgentsCoordinates[1] - ActualVizParams.CenterY,
-                            ActualVizParams.MapSizeXY, ActualSitParams.Radius,
-                            ActualColorConfig.AgentsColor[i]);
+                for (z = 0; z < 3; z++) {
+                    GhostColor[z] =
+                            fabs(ActualColorConfig.AgentsColor[i][z] -
+                            ActualColorConfig.EraseColor[z]) * 0.5 +
+                            ActualColorConfig.EraseColor[z];
                 }
 
+                AddVertexToBatch(&CopterSprites,
+                        AgentsCoordinates[0] + Snapshot->GPSCoordinates[i][0],
+                        AgentsCoordinates[1] + Snapshot->GPSCoordinates[i][1],
+                        GhostColor);
+
             }
 
-        } else {
+        }
 
-            for (i = 0; i < Phase->NumberOfAgents; i++) {
+        /* Agents */
+        for (i = 0; i < Phase->NumberOfAgents; i++) {
+            GetAgentsCoordinates(AgentsCoordinates, Phase, i);
+            AddVertexToBatch(&CopterSprites, AgentsCoordinates[0],
+                    AgentsCoordinates[1],
+                    (Snapshot->AgentsInDanger[i] == true ?
+                    ActualColorConfig.AgentsInDangerColor :
+                    ActualColorConfig.AgentsColor[i]));
+        }
+
+        UploadVertexBatch(&CopterSprites, GL_STREAM_DRAW);
+        if (false == DrawCopterSprites(&CopterSprites,
+                        ActualVizParams.CenterX, ActualVizParams.CenterY,
+                        ActualVizParams.MapSizeXY, ActualSitParams.Radius)) {
+            /* Zoomed in more than the size of the largest sprites */
+            for (i = 0; i < CopterSprites.NumberOfVertices; i++) {
+                DrawCopter_2D(CopterSprites.Vertices[i].x -
+                        ActualVizParams.CenterX,
+                        CopterSprites.Vertices[i].y - ActualVizParams.CenterY,
+                        ActualVizParams.MapSizeXY, ActualSitParams.Radius,
+                        &CopterSprites.Vertices[i].r);
+            }
+        }
 
+        /* Labels of the agents (if they can be read) */
+        if (ActualVizParams.DisplayGPSGhosts == false
+                && (Phase->NumberOfAgents <= MAX_AGENTS_WITH_LABELS
+                        || ActualVizParams.MapSizeXY < 3000.0)) {
+            for (i = 0; i < Phase->NumberOfAgents; i++) {
                 GetAgentsCoordinates(AgentsCoordinates, Phase, i);
-                char str[10];
+                if (fabs(AgentsCoordinates[0] - ActualVizParams.CenterX) >
+                        ActualVizParams.MapSizeXY
+                        || fabs(AgentsCoordinates[1] -
+                                ActualVizParams.CenterY) >
+                        ActualVizParams.MapSizeXY) {
+                    continue;
+                }
+                char str[12];
                 sprintf(str, "%d", i);
                 DrawAgentLabel_2D(Phase, i, str, true, &ActualVizParams, ActualColorConfig.LabelColor);
-                //DrawAgentLabel_2D(Phase, i, , true, &ActualVizParams, ActualColorConfig.LabelColor);
-                /* Draw Agents */
-                if (AgentsInDanger[i] == true) {
-                    DrawCopter_2D(AgentsCoordinates[0] -
-                            ActualVizParams.CenterX,
-                            AgentsCoordinates[1] - ActualVizParams.CenterY,
-                            ActualVizParams.MapSizeXY, ActualSitParams.Radius,
-                            ActualColorConfig.AgentsInDangerColor);
-                } else {
-                    DrawCopter_2D(AgentsCoordinates[0] -
-                            ActualVizParams.CenterX,
-                            AgentsCoordinates[1] - ActualVizParams.CenterY,
-                            ActualVizParams.MapSizeXY, ActualSitParams.Radius,
-                            ActualColorConfig.AgentsColor[i]);
-                }
-
             }
-
         }
 
-        /* Draw Velocity Arrows */
+        /* Draw Velocity Arrows (in one batch) */
+        ClearVertexBatch(&VelocityArrows);
         for (i = 0; i < Phase->NumberOfAgents; i++) {
 
             GetAgentsVelocity(AgentsVelocity, Phase, i);
             GetAgentsCoordinates(AgentsCoordinates, Phase, i);
 
-            DrawVelocityArrow_2D(AgentsCoordinates[0] - ActualVizParams.CenterX,
-                    AgentsCoordinates[1] - ActualVizParams.CenterY,
-                    AgentsVelocity[0], AgentsVelocity[1],
-                    ActualVizParams.MapSizeXY,
-                    ActualColorConfig.VelocityArrowColor);
+            /* The same arrows as DrawVelocityArrow_2D (none below 50 cm/s) */
+            Speed = sqrt(AgentsVelocity[0] * AgentsVelocity[0] +
+                    AgentsVelocity[1] * AgentsVelocity[1]);
+            if (Speed > 50.0) {
+                AddArrowToBatch(&VelocityArrows, AgentsCoordinates[0],
+                        AgentsCoordinates[1],
+                        20.0 * pow(-50.0 + Speed, 1.0 / 3.0),
+                        atan2(-AgentsVelocity[1], AgentsVelocity[0]),
+                        ActualColorConfig.VelocityArrowColor);
+            }
 
             /* Draw Velocity Labels */
-            if (ActualVizParams.MapSizeXY < 3000.0) {
+            if (ActualVizParams.MapSizeXY < 3000.0
+                    && fabs(AgentsCoordinates[0] - ActualVizParams.CenterX) <
+                    ActualVizParams.MapSizeXY
+                    && fabs(AgentsCoordinates[1] - ActualVizParams.CenterY) <
+                    ActualVizParams.MapSizeXY) {
 
                 /* If we are zoomed colse to the agents... */
                 sprintf(VelocityLabel, "%1.1f m/s",
@@ -584,6 +668,9 @@ void DrawCopters(phase_t * Phase, phase_t * GPSPhase, const int TimeStep) {
             }
 
         }
+        UploadVertexBatch(&VelocityArrows, GL_STREAM_DRAW);
+        DrawVertexBatch(&VelocityArrows, ActualVizParams.CenterX,
+                ActualVizParams.CenterY, ActualVizParams.MapSizeXY);
 
         /* Drawing wind speed */
         if (ActualUnitParams.Wind_Magn_Avg.Value > 0.0) {
@@ -616,33 +703,39 @@ void DrawCopters(phase_t * Phase, phase_t * GPSPhase, const int TimeStep) {
 
         /* Drawing communication network, if it's toggled on */
         if (ActualVizParams.DisplayCommNetwork == true) {
-            for (i = 0; i < Phase->NumberOfAgents; i++) {
-                DrawSensorRangeNetwork_2D(PhaseData,
-                        &ActualUnitParams, i, Polygons, Now,
+            if (NetworkEdges.Vertices == NULL) {
+                AllocateVertexBatch(&NetworkEdges, GL_LINES, 1024);
+            }
+            DrawNeighbourNetwork_2D(&NetworkEdges, Phase,
+                    Snapshot->NeighbourLists, Snapshot->NumberOfNeighbours,
+                    Snapshot->NeighbourListCapacity, MAX_NETWORK_EDGES,
+                    &ActualVizParams, ActualColorConfig.CommNetWorkColor);
+            if (Snapshot->HasLaplacian == true) {
+                if (NetworkDashedLines.Vertices == NULL) {
+                    AllocateVertexBatch(&NetworkDashedLines, GL_LINES, 1024);
+                    AllocateVertexBatch(&NetworkCrossings, GL_LINES, 1024);
+                }
+                DrawNetworkDetails_2D(&NetworkDashedLines, &NetworkCrossings,
+                        Phase, Snapshot->NeighbourLists,
+                        Snapshot->NumberOfNeighbours,
+                        Snapshot->NeighbourListCapacity,
+                        (int) ActualUnitParams.communication_type.Value,
+                        ActualUnitParams.R_C.Value,
+                        ActualUnitParams.sensitivity_thresh.Value, Polygons,
                         &ActualVizParams, ActualColorConfig.CommNetWorkColor);
             }
         }
 
         if (ActualVizParams.DisplayHull == true) {
-            HullLength = stack_count(Hull);
             glColor3f(ActualColorConfig.CommNetWorkColor[0], ActualColorConfig.CommNetWorkColor[1], ActualColorConfig.CommNetWorkColor[2]);
-            double HullX[HullLength];
-            double HullY[HullLength];
-            double HullSurf;
             glBegin(GL_LINE_STRIP);
-            for (g = 0; g < HullLength; g++) {
-                HullX[g] = Hull->data->x;
-                HullY[g] = Hull->data->y;
-                glVertex3f(RealToGlCoord_2D(Hull->data->x - ActualVizParams.CenterX, ActualVizParams.MapSizeXY), 
-                    RealToGlCoord_2D(Hull->data->y - ActualVizParams.CenterY, ActualVizParams.MapSizeXY), 0);
-                Hull = Hull->next;
-            }
-            glVertex3f(RealToGlCoord_2D(HullX[0] - ActualVizParams.CenterX, ActualVizParams.MapSizeXY), 
-                    RealToGlCoord_2D(HullY[0] - ActualVizParams.CenterY, ActualVizParams.MapSizeXY), 0);
+            for (g = 0; g <= Snapshot->NumberOfHullVertices; g++) {
+                glVertex3f(RealToGlCoord_2D(Snapshot->HullVertexSet[2 * g] - ActualVizParams.CenterX, ActualVizParams.MapSizeXY), 
+                    RealToGlCoord_2D(Snapshot->HullVertexSet[2 * g + 1] - ActualVizParams.CenterY, ActualVizParams.MapSizeXY), 0);
+            }
             glEnd();
 
-            HullSurf = polygonArea(HullX, HullY, HullLength);
-            // printf("%0.2f\n", HullSurf/10000);
+            // printf("%0.2f\n", Hull.Area/10000);
         }
 
         /* 3D viz mode */
@@ -696,7 +789,7 @@ void DrawCopters(phase_t * Phase, phase_t * GPSPhase, const int TimeStep) {
         }
         glEnd();
 
-        /* Drawing agents */
+        /* Drawing agents (and their tails from the snapshot) */
         for (i = 0; i < Phase->NumberOfAgents; i++) {
             GetAgentsCoordinates(AgentsCoordinates, Phase, i);
 
@@ -707,7 +800,7 @@ void DrawCopters(phase_t * Phase, phase_t * GPSPhase, const int TimeStep) {
                     ActualSitParams.Radius, ActualColorConfig.AgentsColor[i]);
 
             /* Trajectories */
-            if (true == ActualVizParams.DisplayTail) {
+            if (Snapshot->NumberOfTailPoints > 0) {
 
                 glEnable(GL_BLEND);
                 glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
@@ -715,28 +808,25 @@ void DrawCopters(phase_t * Phase, phase_t * GPSPhase, const int TimeStep) {
                 glHint(GL_LINE_SMOOTH_HINT, GL_NICEST);
                 glHint(GL_POLYGON_SMOOTH_HINT, GL_NICEST);
 
-                if (ActualVizParams.LengthOfTail < Now) {
-                    for (h = 1; h < ActualVizParams.LengthOfTail; h += 10) {
-
-                        GetAgentsCoordinatesFromTimeLine(AgentsCoordinates,
-                                PhaseData, i, Now - h);
-
-                        /* Create fading color */
-                        for (z = 0; z < 3; z++) {
-                            TempColor[z] = ActualColorConfig.AgentsColor[i][z];
-                            TempColor[z] -=
-                                    h *
-                                    fabs(ActualColorConfig.AgentsColor[i][z] -
-                                    ActualColorConfig.EraseColor[z]) /
-                                    ActualVizParams.LengthOfTail;
-                        }
-
-                        DrawCopter_3D(AgentsCoordinates[0],
-                                AgentsCoordinates[1],
-                                AgentsCoordinates[2],
-                                ActualVizParams.MapSizeXY,
-                                ActualSitParams.Radius, TempColor);
+                for (g = 0; g < Snapshot->NumberOfTailPoints; g++) {
+
+                    h = 1 + g * Snapshot->TailDecimation;
+                    TailPoint = &Snapshot->Tails[3 * (i *
+                                    Snapshot->NumberOfTailPoints + g)];
+
+                    /* Create fading color */
+                    for (z = 0; z < 3; z++) {
+                        TempColor[z] = ActualColorConfig.AgentsColor[i][z];
+                        TempColor[z] -=
+                                h *
+                                fabs(ActualColorConfig.AgentsColor[i][z] -
+                                ActualColorConfig.EraseColor[z]) /
+                                Snapshot->LengthOfTail;
                     }
+
+                    DrawCopter_3D(TailPoint[0], TailPoint[1], TailPoint[2],
+                            ActualVizParams.MapSizeXY,
+                            ActualSitParams.Radius, TempColor);
                 }
 
                 glDisable(GL_BLEND);
@@ -746,12 +836,13 @@ void DrawCopters(phase_t * Phase, phase_t * GPSPhase, const int TimeStep) {
         }
 
         /* Drawing communication network, if it's toggled on */
-        if (ActualVizParams.DisplayCommNetwork == true) {
+        if (ActualVizParams.DisplayCommNetwork == true
+                && Snapshot->HasLaplacian == true) {
             for (i = 0; i < Phase->NumberOfAgents; i++) {
-                DrawSensorRangeNetwork_3D(PhaseData, ActualUnitParams.R_C.Value,
+                DrawSensorRangeNetwork_3D(Phase, ActualUnitParams.R_C.Value,
                         ActualUnitParams.sensitivity_thresh.Value, i,
                         ActualUnitParams.t_del.Value,
-                        Now,
+                        0,
                         ActualSitParams.DeltaT,
                         ActualVizParams.MapSizeXY,
                         ActualColorConfig.CommNetWorkColor);
@@ -797,6 +888,7 @@ void DisplayTrajs() {
     static struct timeval LastTime = { 0, 0 };
     struct timeval NowTime;
     static float RealSpeed;
+    simulation_snapshot_t *Snapshot = DisplayedSnapshot;
 
     /* Clearing */
     glClearColor(ActualColorConfig.EraseColor[0],
@@ -807,18 +899,18 @@ void DisplayTrajs() {
     glLoadIdentity();
 
     /* Drawing Copters */
-    if (Now > (5.0 + ActualUnitParams.t_del.Value) / ActualSitParams.DeltaT) {
-        DrawCopters(&ActualPhase, &GPSPhase, Now);
+    if (Snapshot->Now > (5.0 + ActualUnitParams.t_del.Value) / ActualSitParams.DeltaT) {
+        DrawCopters(Snapshot);
     }
 
     /* Writing out number of collisions */
-    if (Collisions != 0 && ActualVizParams.TwoDimViz == true) {
+    if (Snapshot->Collisions != 0 && ActualVizParams.TwoDimViz == true) {
 
         /* Grammar... */
-        if (Collisions != 1) {
-            sprintf(CollisionsToWriteOut, "%d collisions!", Collisions);
+        if (Snapshot->Collisions != 1) {
+            sprintf(CollisionsToWriteOut, "%d collisions!", Snapshot->Collisions);
         } else {
-            sprintf(CollisionsToWriteOut, "%d collision!", Collisions);
+            sprintf(CollisionsToWriteOut, "%d collision!", Snapshot->Collisions);
         }
 
         DrawString(-0.95, -0.9, GLUT_BITMAP_9_BY_15, CollisionsToWriteOut,
@@ -828,19 +920,19 @@ void DisplayTrajs() {
     /* Calculate real visualization speed */
     gettimeofday(&NowTime, 0);
     RealSpeed =
-            RealSpeed * 0.9 + 0.1 * (TimeStep -
+            RealSpeed * 0.9 + 0.1 * (Snapshot->TimeStep -
             LastTimeStep) * ActualSitParams.DeltaT / (NowTime.tv_sec -
             LastTime.tv_sec + (NowTime.tv_usec - LastTime.tv_usec) / 1e6);
     LastTime = NowTime;
-    LastTimeStep = TimeStep;
+    LastTimeStep = Snapshot->TimeStep;
 
     /* Writing out Elapsed Time */
     if (true == PNGOutVid) {
         sprintf(TimeToWriteOut, "Elapsed time: %1.1f s",
-                TimeStep * ActualSitParams.DeltaT);
+                Snapshot->TimeStep * ActualSitParams.DeltaT);
     } else {
         sprintf(TimeToWriteOut, "Elapsed time: %1.1f s   Speed: %1.2f x",
-                TimeStep * ActualSitParams.DeltaT, RealSpeed);
+                Snapshot->TimeStep * ActualSitParams.DeltaT, RealSpeed);
     }
     if (ActualVizParams.TwoDimViz == true) {
         DrawString(-0.95, -0.95, GLUT_BITMAP_9_BY_15, TimeToWriteOut,
@@ -850,9 +942,9 @@ void DisplayTrajs() {
     /* Write out model specific string */
     if (ActualVizParams.TwoDimViz == true) {
         DrawString(-0.95, 0.81, GLUT_BITMAP_9_BY_15,
-                GetModelSpecificStringToDisplay(&ActualPhase,
+                GetModelSpecificStringToDisplay(&Snapshot->Phase,
                         &ActualFlockingParams, &ActualUnitParams,
-                        &ActualSitParams, TimeStep),
+                        &ActualSitParams, Snapshot->TimeStep),
                 ActualColorConfig.MenuSelectionColor);
     }
 
@@ -876,7 +968,7 @@ void DisplayTrajs() {
     if (ActualVizParams.TwoDimViz == true) {
 
         /* Communication range */
-        static double TempColor[3];
+        static real_t TempColor[3];
         FillVect(TempColor,
                 0.5 * ActualColorConfig.MenuSelectionColor[0],
                 0.5 * ActualColorConfig.MenuSelectionColor[1],
@@ -945,19 +1037,86 @@ void DisplayTrajs() {
 
 }
 
-/* Refreshing "trajectory" window */
-void UpdatePositionsToDisplay() {
+/* Calculating one step of the simulation (the caller holds "SimulationLock") */
+static void SimulateOneStep(real_t *Accelerations) {
 
-    int i, j, k;
+    const int TimeStepsToStore =
+            (int) (((STORED_TIME) / ActualSitParams.DeltaT) - 1.0);
 
-    static int TimeStepsToStore = 0;
-    /* For agent-following and CoM-following mode */
-    static double CoMCoords[3];
-    NullVect(CoMCoords, 3);
-    static double AgentsCoords[3];
-    TimeStepsToStore = (int) (((STORED_TIME) / ActualSitParams.DeltaT) - 1.0);
+    if (Now < TimeStepsToStore - 1) {
+        // StepTarget(TargetPosition, &ActualSitParams, &ActualVizParams,
+        // &ActualFlockingParams, TimeStep);
+
+        /* Calculating 1 step with the robot model */
+        Step(&ActualPhase, &GPSPhase, &GPSDelayedPhase,
+                PhaseData, &ActualUnitParams, cnt, &ActualFlockingParams,
+                &ActualSitParams, &ActualVizParams, Now, TimeStep,
+                true, ConditionsReset, &Collisions, AgentsInDanger,
+                WindVelocityVector, Accelerations, TargetsArray, Polygons, &Hull, Verbose);
+
+        HandleOuterVariables(&ActualPhase, &ActualVizParams,
+                &ActualSitParams, &ActualUnitParams,
+                TimeStep * ActualSitParams.DeltaT,
+                ActualStatUtils.OutputDirectory);
+        /* Inserting output phase of the "step" function into the
+         * globally-allocated PhaseData and InnerStatesTimeLine
+         */
+        PROFILE_BEGIN(PROFILE_DATALINE);
+        InsertPhaseToDataLine(PhaseData, &ActualPhase, Now + 1);
+        InsertInnerStatesToDataLine(PhaseData, &ActualPhase, Now + 1);
+        PROFILE_END(PROFILE_DATALINE);
+
+    } else {
+        /* Shifting Data line, if PhaseData is overloaded */
+        PROFILE_BEGIN(PROFILE_DATALINE);
+        ShiftDataLine(PhaseData,
+                (int) ((STORED_TIME / ActualSitParams.DeltaT) - 1.0),
+                (int) (20.0 / ActualSitParams.DeltaT));
+        ShiftInnerStateDataLine(PhaseData,
+                (int) ((STORED_TIME / ActualSitParams.DeltaT) - 1.0),
+                (int) (20.0 / ActualSitParams.DeltaT));
+        PROFILE_END(PROFILE_DATALINE);
+        Step(&ActualPhase, &GPSPhase, &GPSDelayedPhase, PhaseData,
+                &ActualUnitParams, cnt, &ActualFlockingParams,
+                &ActualSitParams, &ActualVizParams, Now, TimeStep, true,
+                ConditionsReset, &Collisions, AgentsInDanger,
+                WindVelocityVector, Accelerations, TargetsArray, Polygons, &Hull, Verbose);
+
+        HandleOuterVariables(&ActualPhase, &ActualVizParams,
+                &ActualSitParams, &ActualUnitParams,
+                TimeStep * ActualSitParams.DeltaT,
+                ActualStatUtils.OutputDirectory);
+
+        /* Inserting output phase of the "step" function into the
+         * globally-allocated PhaseData and InnerStatesTimeLine
+         */
+        Now = (int) ((20.0 / ActualSitParams.DeltaT) - 1.0);
 
-    bool * Visited = BooleanData(ActualSitParams.NumberOfAgents);
+        PROFILE_BEGIN(PROFILE_DATALINE);
+        InsertPhaseToDataLine(PhaseData, &ActualPhase, Now + 1);
+        InsertInnerStatesToDataLine(PhaseData, &ActualPhase, Now + 1);
+        PROFILE_END(PROFILE_DATALINE);
+
+    }
+
+    if (true == PNGOutVid) {
+
+        /* Saving trajectories */
+        WriteOutTrajectories(&ActualPhase,
+                ActualSaveModes.SaveTrajectories,
+                ActualSaveModes.SaveInnerStates,
+                TimeStep * ActualSitParams.DeltaT, f_OutPhase,
+                f_OutInnerStates);
+
+    }
+
+    Now++;
+    TimeStep++;
+
+}
+
+/* Opening and closing the output files of the trajectories while a video is recorded */
+static void HandleTrajectoryFiles() {
 
     /* Opening output files, if necessary */
     static bool FilesOpened = false;
@@ -982,132 +1141,159 @@ void UpdatePositionsToDisplay() {
         FilesOpened = true;
     }
 
-    glutSetWindow(VizWindowID);
-
-    double *Accelerations;
-    Accelerations = malloc(ActualSitParams.NumberOfAgents * sizeof(double));
+    /* Closing output trajectory and inner state files */
+    if (false == PNGOutVid && true == FilesOpened) {
+        if (true == ActualSaveModes.SaveTrajectories) {
+            fclose(f_OutPhase);
+        }
+        if (true == ActualSaveModes.SaveInnerStates) {
+            fclose(f_OutInnerStates);
+        }
+        FilesOpened = false;
+    }
 
-    if (ActualVizParams.Paused == false) {
+}
 
-        /* The "ActualVizParams.VizSpeedUp" variable defines
-         * the number of calculated steps between two "frames"
-         */
-        for (i = 0; i < ActualVizParams.VizSpeedUp; i++) {
-            if (Now < TimeStepsToStore - 1) {
-                // StepTarget(TargetPosition, &ActualSitParams, &ActualVizParams,
-                // &ActualFlockingParams, TimeStep);
+/* Copying the displayed state into the next snapshot
+ * (the caller holds "SimulationLock")
+ */
+static void PublishState() {
+
+    simulation_snapshot_t *Snapshot = SnapshotToFill(&Snapshots);
+
+    /* Clusters are counted with the scratch arrays of the steps */
+    const memory_arena_mark_t Mark = ArenaMark(&StepArena);
+    bool *Visited = ArenaBooleanData(&StepArena, ActualSitParams.NumberOfAgents);
+    Snapshot->NumberOfClusters = CountCluster(ActualPhase, Visited,
+            &ActualUnitParams, &StepArena);
+    ArenaRelease(&StepArena, Mark);
+
+    FillSnapshot(Snapshot, &ActualPhase, &GPSPhase, AgentsInDanger, &Hull,
+            &FlockAggregates, ActualPhase.CBP,
+            ActualVizParams.WhichAgentIsSelected,
+            ActualVizParams.DisplayCommNetwork
+            && (ActualVizParams.TwoDimViz == false
+                    || ActualVizParams.DisplayNetworkDetails));
+    if (true == ActualVizParams.DisplayTail) {
+        FillSnapshotTails(Snapshot, PhaseData, Now,
+                ActualVizParams.LengthOfTail, TAIL_DECIMATION);
+    } else {
+        Snapshot->NumberOfTailPoints = 0;
+    }
+    Snapshot->Now = Now;
+    Snapshot->TimeStep = TimeStep;
+    Snapshot->Collisions = Collisions;
 
-                /* Calculating 1 step with the robot model */
-                Step(&ActualPhase, &GPSPhase, &GPSDelayedPhase,
-                        PhaseData, &ActualUnitParams, cnt, &ActualFlockingParams,
-                        &ActualSitParams, &ActualVizParams, Now, TimeStep,
-                        true, ConditionsReset, &Collisions, AgentsInDanger,
-                        WindVelocityVector, Accelerations, TargetsArray, Polygons, &Hull, Verbose);
+    PublishSnapshot(&Snapshots);
 
-                HandleOuterVariables(&ActualPhase, &ActualVizParams,
-                        &ActualSitParams, &ActualUnitParams,
-                        TimeStep * ActualSitParams.DeltaT,
-                        ActualStatUtils.OutputDirectory);
-                /* Inserting output phase of the "step" function into the
-                 * globally-allocated PhaseData and InnerStatesTimeLine
-                 */
-                InsertPhaseToDataLine(PhaseData, &ActualPhase, Now + 1, ActualSitParams.Resolution);
-                InsertInnerStatesToDataLine(PhaseData, &ActualPhase, Now + 1);
-                
-                if (Now % ((int) (ActualUnitParams.t_GPS.Value / ActualSitParams.DeltaT)) == 0) {
-
-                    for (j = 0; j < ActualSitParams.NumberOfAgents; j++){
-                        static double CoordA[3];
-                        GetAgentsCoordinatesFromTimeLine(CoordA, PhaseData, j, Now + 1);
-                        for (k = 0; k < ActualSitParams.NumberOfAgents; k++){
-                            if (j != k) {
-                                if (fabs(PhaseData[Now + 1].Laplacian[j][k] - PhaseData[Now - (int) (ActualUnitParams.t_GPS.Value / ActualSitParams.DeltaT) + 1].Laplacian[j][k]) > 20) {
-                                    static double CoordB[3];
-                                    GetAgentsCoordinatesFromTimeLine(CoordB, PhaseData, k, Now + 1);
-
-                                    FastVoxelTraversal(&ActualPhase, CoordA, CoordB, j, ArenaCenterX, ArenaCenterY, ArenaRadius, ActualSitParams.Resolution);
-                                }
-                            }
-                        }
-                    }
-                }
+}
 
-            } else {
-                /* Shifting Data line, if PhaseData is overloaded */
-                ShiftDataLine(PhaseData,
-                        (int) ((STORED_TIME / ActualSitParams.DeltaT) - 1.0),
-                        (int) (20.0 / ActualSitParams.DeltaT));
-                ShiftInnerStateDataLine(PhaseData,
-                        (int) ((STORED_TIME / ActualSitParams.DeltaT) - 1.0),
-                        (int) (20.0 / ActualSitParams.DeltaT));
-                Step(&ActualPhase, &GPSPhase, &GPSDelayedPhase, PhaseData,
-                        &ActualUnitParams, cnt, &ActualFlockingParams,
-                        &ActualSitParams, &ActualVizParams, Now, TimeStep, true,
-                        ConditionsReset, &Collisions, AgentsInDanger,
-                        WindVelocityVector, Accelerations, TargetsArray, Polygons, &Hull, Verbose);
+/* Simulation thread of the visualization.
+ * The steps are calculated one by one, a snapshot is published whenever the
+ * previous one has been taken by the windows. "VizSpeedUp" steps are
+ * calculated in the time of a frame (not at all if paused), or as many as
+ * possible at the maximal speed up.
+ */
+static void *SimulationThread(void *Arg) {
 
-                HandleOuterVariables(&ActualPhase, &ActualVizParams,
-                        &ActualSitParams, &ActualUnitParams,
-                        TimeStep * ActualSitParams.DeltaT,
-                        ActualStatUtils.OutputDirectory);
+    /* Output of the steps */
+    real_t *Accelerations = realVector(ActualSitParams.NumberOfAgents);
 
-                /* Inserting output phase of the "step" function into the
-                 * globally-allocated PhaseData and InnerStatesTimeLine
-                 */
-                Now = (int) ((20.0 / ActualSitParams.DeltaT) - 1.0);
+    /* Steps calculated since "PaceStart" with the speed up "PaceSpeedUp" */
+    struct timeval PaceStart, NowTime;
+    int PaceSteps = 0;
+    int PaceSpeedUp = 0;
+    double AheadOfTime;
+    bool Paused;
 
-                InsertPhaseToDataLine(PhaseData, &ActualPhase, Now + 1, ActualSitParams.Resolution);
-                InsertInnerStatesToDataLine(PhaseData, &ActualPhase, Now + 1);
+    /* The profiled thread of the visualization (see profiler.h) */
+    ProfileThisThread(true);
 
-            }
+    while (true) {
 
-            if (true == PNGOutVid) {
+        pthread_mutex_lock(&SimulationLock);
 
-                /* Saving trajectories */
-                WriteOutTrajectories(&ActualPhase,
-                        ActualSaveModes.SaveTrajectories,
-                        ActualSaveModes.SaveInnerStates,
-                        TimeStep * ActualSitParams.DeltaT, f_OutPhase,
-                        f_OutInnerStates);
+        HandleTrajectoryFiles();
+        Paused = ActualVizParams.Paused;
+        if (false == Paused) {
+            SimulateOneStep(Accelerations);
+            PaceSteps++;
+        }
+        if (true == SnapshotNeeded(&Snapshots)) {
+            PublishState();
+        }
+        if (true == Paused || ActualVizParams.VizSpeedUp != PaceSpeedUp) {
+            PaceSpeedUp = ActualVizParams.VizSpeedUp;
+            PaceSteps = 0;
+            gettimeofday(&PaceStart, 0);
+        }
 
-            }
+        pthread_mutex_unlock(&SimulationLock);
 
-            Now++;
-            TimeStep++;
+        /* Input events waiting for the lock are let in before the next step */
+        while (atomic_load(&WaitingForSimulationLock) > 0) {
+            sched_yield();
+        }
 
+        if (true == Paused) {
+            usleep(10000);
+        } else if (PaceSpeedUp < MAX_VIZ_SPEED_UP) {
+            gettimeofday(&NowTime, 0);
+            AheadOfTime = PaceSteps / (PaceSpeedUp * SIMULATION_FRAME_RATE) -
+                    (NowTime.tv_sec - PaceStart.tv_sec +
+                    (NowTime.tv_usec - PaceStart.tv_usec) / 1e6);
+            if (AheadOfTime > 0.0) {
+                usleep((useconds_t) (AheadOfTime * 1e6));
+            }
         }
-        NumberOfCluster = CountCluster(ActualPhase, Visited, &ActualUnitParams);
-        ActualSitParams.NumberOfClusters = NumberOfCluster;
 
     }
 
-    
+    free(Accelerations);
+    return NULL;
 
-    /* Closing output trajectory and inner state files */
-    if (false == PNGOutVid && true == FilesOpened) {
-        if (true == ActualSaveModes.SaveTrajectories) {
-            fclose(f_OutPhase);
-        }
-        if (true == ActualSaveModes.SaveInnerStates) {
-            fclose(f_OutInnerStates);
-        }
-        FilesOpened = false;
+}
+
+/* Refreshing the windows, if the simulation has published a new snapshot */
+void UpdatePositionsToDisplay() {
+
+    /* For agent-following and CoM-following mode */
+    static real_t CoMCoords[3];
+    NullVect(CoMCoords, 3);
+    static real_t AgentsCoords[3];
+    simulation_snapshot_t *Snapshot = LatestSnapshot(&Snapshots);
+
+    if (Snapshot == DisplayedSnapshot) {
+        usleep(1000);
+        return;
     }
+    DisplayedSnapshot = Snapshot;
+
+    /* Scratch arrays of the frame */
+    ResetArena(&FrameArena);
 
-    /* CoM following mode, if it is toggled on */
+    NumberOfCluster = Snapshot->NumberOfClusters;
+    ActualSitParams.NumberOfClusters = NumberOfCluster;
+
+    /* CoM following mode, if it is toggled on
+     * (the center of the map is used by the steps as well) */
     if (ActualVizParams.CoMFollowing == true) {
-        GetCoM(CoMCoords, &ActualPhase);
+        GetCoM(CoMCoords, &Snapshot->Phase);
+        LockSimulation();
         ActualVizParams.CenterX = CoMCoords[0];
         ActualVizParams.CenterY = CoMCoords[1];
         ActualVizParams.CenterZ = CoMCoords[2];
+        UnlockSimulation();
         /* Agent-following mode, if it is toggled on */
     } else if (ActualVizParams.WhichAgentIsSelected !=
             ActualSitParams.NumberOfAgents) {
-        GetAgentsCoordinates(AgentsCoords, &ActualPhase,
+        GetAgentsCoordinates(AgentsCoords, &Snapshot->Phase,
                 ActualVizParams.WhichAgentIsSelected);
+        LockSimulation();
         ActualVizParams.CenterX = AgentsCoords[0];
         ActualVizParams.CenterY = AgentsCoords[1];
         ActualVizParams.CenterZ = AgentsCoords[2];
+        UnlockSimulation();
     }
 
     /* Refresh both windows */
@@ -1131,6 +1317,9 @@ void HandleKeyBoard(unsigned char key, int x, int y) {
 
     Modder = glutGetModifiers();
 
+    /* Changes are applied between two steps of the simulation thread */
+    LockSimulation();
+
     /* Backspace brings simulation back a bit */
     if (key == 8) {
         int back = MIN(MIN(Now, TimeStep), ActualVizParams.LengthOfTail);
@@ -1276,6 +1465,8 @@ void HandleKeyBoard(unsigned char key, int x, int y) {
     HandleSpecialKeyBoardEvent(key, x, y, &ActualFlockingParams,
             &ActualVizParams, &ActualSitParams, Modder);
 
+    UnlockSimulation();
+
     /* Refreshing both windows */
     glutSetWindow(MenuWindowID);
     glutPostRedisplay();
@@ -1302,12 +1493,15 @@ void HandleKeyBoardSpecial(int key, int x, int y) {
     static double Previous_MapSize = 2000.0;
     index = 0;
     static int Modder;
-    static double EyeToCenter[3];
-    static double Agent[3];
+    static real_t EyeToCenter[3];
+    static real_t Agent[3];
     NullVect(Agent, 3);
 
     Modder = glutGetModifiers();
 
+    /* Changes are applied between two steps of the simulation thread */
+    LockSimulation();
+
     /* F2 toggles the CoM-Following mode */
     if (key == GLUT_KEY_F2) {
         ActualVizParams.CoMFollowing = !ActualVizParams.CoMFollowing;
@@ -1351,11 +1545,11 @@ void HandleKeyBoardSpecial(int key, int x, int y) {
         /* Reset number of collisions and elapsed time and Targets Array */
         Collisions = 0;
         TimeStep = 0;
-        cnt = 0;
         for (i = 0; i < cnt; i ++) {
             free(TargetsArray[i]);
         }
         free(TargetsArray);
+        cnt = 0;
 
     } else if (key == GLUT_KEY_F11) {
 
@@ -1434,6 +1628,11 @@ void HandleKeyBoardSpecial(int key, int x, int y) {
         ActualVizParams.DisplayCommNetwork =
                 !ActualVizParams.DisplayCommNetwork;
         
+        /* F8 toggles the details of the network (in 2D, slow for large flocks) */
+    } else if (key == GLUT_KEY_F8) {
+        ActualVizParams.DisplayNetworkDetails =
+                !ActualVizParams.DisplayNetworkDetails;
+
         /* F1 toggles Hull display */
     } else if (key == GLUT_KEY_F1) {
         ActualVizParams.DisplayHull = !ActualVizParams.DisplayHull;
@@ -1569,6 +1768,8 @@ void HandleKeyBoardSpecial(int key, int x, int y) {
     HandleSpecialSpecKeyEvent(key, x, y, &ActualFlockingParams,
             &ActualVizParams, &ActualSitParams, Modder);
 
+    UnlockSimulation();
+
     /* Refreshing both windows */
     glutSetWindow(MenuWindowID);
     glutPostRedisplay();
@@ -1582,7 +1783,7 @@ void HandleKeyBoardSpecial(int key, int x, int y) {
 void HandleMouse2(int button, int state, int x, int y) {
 
     static int Modder = 0;
-    static double RotationAxis[3];
+    static real_t RotationAxis[3];
     Modder = glutGetModifiers();
     // printf("%f %f\n", MouseCoordToReal_2D(x, 600*400,
     //                 ActualVizParams.Resolution), MouseCoordToReal_2D(y, 600*400,
@@ -1592,9 +1793,12 @@ void HandleMouse2(int button, int state, int x, int y) {
 void HandleMouse(int button, int state, int x, int y) {
 
     static int Modder = 0;
-    static double RotationAxis[3];
+    static real_t RotationAxis[3];
     Modder = glutGetModifiers();
 
+    /* Changes are applied between two steps of the simulation thread */
+    LockSimulation();
+
     /* 2D visualization mode functions */
     if (ActualVizParams.TwoDimViz == true) {
         /* Scroll down - zoom in */
@@ -1665,6 +1869,8 @@ void HandleMouse(int button, int state, int x, int y) {
     HandleSpecialMouseEvent(button, state, x, y, &cnt, &ActualFlockingParams,
             &ActualVizParams, TargetPosition, &TargetsArray, Modder);
 
+    UnlockSimulation();
+
     /* Refreshing both windows */
     glutSetWindow(MenuWindowID);
     glutPostRedisplay();
@@ -1692,7 +1898,18 @@ void print_help(void) {
            "-i FILE     define initparams file\n"
            "-novis      do not open GUI\n"
            "-o PATH     define output directory\n"
+           "-profile    print the time spent in each stage of the simulation at exit\n"
+           "-seed N     use N as random seed instead of the current time\n"
+           "-telemetry  with -novis, publish live telemetry into shared memory /robotsim_PID\n"
+           "            (see tools/telemetry_monitor.py)\n"
+           "-targets FILE  read the targets of the missions (\"x y\" lines in cm) from FILE\n"
+           "-trace FILE write the measured stages into FILE (Chrome trace format)\n"
            "-u FILE     define unitparams file\n"
+           "-video DIR  with -novis, write frames of the 2D view as PPM images into DIR\n"
+           "-video \"|COMMAND\"  with -novis, write raw RGB24 frames into the input of COMMAND\n"
+           "            (e.g. \"|ffmpeg -f rawvideo -pix_fmt rgb24 -s 750x750 -r 30 -i - out.mp4\",\n"
+           "            the size and the rate of the frames are printed when the output starts)\n"
+           "-videoevery N  write a frame in every N steps (default: 30 frames per simulated second)\n"
            "\n"
     );
 }
@@ -1711,6 +1928,13 @@ int main(int argc, char *argv[]) {
     gettimeofday(&tv, NULL);
     srand((tv.tv_sec * 1000.0) + (tv.tv_usec / 1000.0));
 
+    /* Fixed seed for reproducible runs */
+    for (i = 0; i < argc - 1; i++) {
+        if (strcmp(argv[i], "-seed") == 0) {
+            srand(strtoul(argv[i + 1], NULL, 10));
+        }
+    }
+
     /* print help if needed */
     for (i = 0; i < argc; i++) {
         if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
@@ -1727,6 +1951,21 @@ int main(int argc, char *argv[]) {
     }
 
 
+    /* Profiling of the simulation stages ("-trace" implies "-profile") */
+    bool ProfileRequested = false;
+    char *TraceFileName = NULL;
+    for (i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-profile") == 0) {
+            ProfileRequested = true;
+        } else if (strcmp(argv[i], "-trace") == 0 && i < argc - 1) {
+            ProfileRequested = true;
+            TraceFileName = argv[i + 1];
+        }
+    }
+    if (true == ProfileRequested) {
+        InitializeProfiler(TraceFileName);
+    }
+
     /* Initializing output directories */
     char OutputFileName[512];
     ActualStatUtils.OutputDirectory = "output_default";
@@ -1737,6 +1976,32 @@ int main(int argc, char *argv[]) {
     }
 
 
+    /* Headless video output ("-video" is used only with "-novis") */
+    char *VideoTarget = NULL;
+    int VideoEvery = 0;
+    for (i = 0; i < argc - 1; i++) {
+        if (strcmp(argv[i], "-video") == 0) {
+            VideoTarget = argv[i + 1];
+        } else if (strcmp(argv[i], "-videoevery") == 0) {
+            VideoEvery = atoi(argv[i + 1]);
+        }
+    }
+
+    /* Live telemetry ("-telemetry" is used only with "-novis") */
+    bool TelemetryRequested = false;
+    for (i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-telemetry") == 0) {
+            TelemetryRequested = true;
+        }
+    }
+
+    /* Targets of the missions (Flocking_type 2), otherwise they are added with Alt + click */
+    for (i = 0; i < argc - 1; i++) {
+        if (strcmp(argv[i], "-targets") == 0) {
+            cnt = LoadTargetsFromFile(&TargetsArray, argv[i + 1]);
+        }
+    }
+
     /* Checking existence of output directory */
     //struct stat st = {0};
     struct stat st;
@@ -1827,11 +2092,13 @@ int main(int argc, char *argv[]) {
     /* Only one input file is allowed during non-vis mode! */
     if (NumberOfFlockingParamSets > 1 && ActualVizParams.VizEnabled == false) {
         fprintf(stderr,
-                "Only one parameter-set is allowed for the flocking algorithm!\n");
+                "Only one parameter-set is allowed for the flocking algorithm!\n"
+                "(Parameter sweeps can be run by tools/sweep.py)\n");
         exit(-1);
     } else if (NumberOfUnitParamSets > 1 && false == ActualVizParams.VizEnabled) {
         fprintf(stderr,
-                "Only one parameter-set is allowed for the robot model!\n");
+                "Only one parameter-set is allowed for the robot model!\n"
+                "(Parameter sweeps can be run by tools/sweep.py)\n");
         exit(-1);
     }
 
@@ -1887,11 +2154,18 @@ int main(int argc, char *argv[]) {
     /* Allocating phasespace for actual and delayed timestep */
     /* Creating inner states */
     AllocatePhase(&ActualPhase, ActualSitParams.NumberOfAgents,
-            ActualFlockingParams.NumberOfInnerStates, ActualSitParams.Resolution);
+            ActualFlockingParams.NumberOfInnerStates);
+
+    /* Allocating the CBP maps (only the actual phase has them) */
+    if (ActualSitParams.CBPEnabled != 0) {
+        AllocateCBPMap(&CBPMap, ActualSitParams.NumberOfAgents,
+                ActualSitParams.Resolution);
+        ActualPhase.CBP = &CBPMap;
+    }
 
     /* Allocating phasespace for GPS signals */
-    AllocatePhase(&GPSPhase, ActualSitParams.NumberOfAgents, 0, ActualSitParams.Resolution);
-    AllocatePhase(&GPSDelayedPhase, ActualSitParams.NumberOfAgents, 0, ActualSitParams.Resolution);
+    AllocatePhase(&GPSPhase, ActualSitParams.NumberOfAgents, 0);
+    AllocatePhase(&GPSDelayedPhase, ActualSitParams.NumberOfAgents, 0);
 
     /* Allocating a matrix containing all necessary phase data (real) */
     int TimeStepsToStore =
@@ -1899,7 +2173,7 @@ int main(int argc, char *argv[]) {
     PhaseData = (phase_t *) calloc(1 + TimeStepsToStore, sizeof(phase_t));
     for (i = 0; i < 1 + TimeStepsToStore; i++) {
         AllocatePhase(&(PhaseData[i]), ActualSitParams.NumberOfAgents,
-                ActualPhase.NumberOfInnerStates, ActualSitParams.Resolution);
+                ActualPhase.NumberOfInnerStates);
     }
     AgentsInDanger = BooleanData(ActualSitParams.NumberOfAgents);
     InitializePreferredVelocities(&ActualPhase, &ActualFlockingParams,
@@ -1911,10 +2185,18 @@ int main(int argc, char *argv[]) {
     /* Initializing positions, "conditions reset" variables and map properties */
     Initialize();
 
+    /* Allocating the convex hull of the swarm */
+    AllocateHull(&Hull, ActualSitParams.NumberOfAgents);
+    Hull.OnlyOnGPSTick = (ActualSitParams.HullOnGPSTick != 0);
+
+    /* Scratch arenas of the steps and the frames */
+    AllocateArena(&StepArena, ARENA_INITIAL_SIZE);
+    AllocateArena(&FrameArena, ARENA_INITIAL_SIZE);
+
     // Allocate obstacles positions inside Polygons object to be used in comm attenuation
-    Polygons = malloc(sizeof(double) * obstacles.o_count);
+    Polygons = malloc(sizeof(real_t *) * obstacles.o_count);
     for (i = 0; i < obstacles.o_count; i++) {
-        Polygons[i] = malloc(sizeof(double) * obstacles.o[i].p_count * 2);
+        Polygons[i] = malloc(sizeof(real_t) * obstacles.o[i].p_count * 2);
         for (j = 0; j < obstacles.o[i].p_count; j++){
             Polygons[i][2*j] = obstacles.o[i].p[j][0];
             Polygons[i][2*j+1] = obstacles.o[i].p[j][1];
@@ -1935,6 +2217,11 @@ int main(int argc, char *argv[]) {
             ActualSitParams.InitialX, ActualSitParams.InitialY,
             ActualSitParams.InitialZ);
     }
+    if (Verbose != 0) {
+        RefreshPathLoss(&PathLoss, &ActualUnitParams);
+        printf("Path loss: max. error of fast log %g dB (bound %g dB), obstacles ignored beyond %1.0f cm\n",
+            PathLoss.MeasuredError, PathLoss.AnalyticError, PathLoss.CullDistance);
+    }
     
     /* Starting main loop of GL environment */
 
@@ -1978,6 +2265,7 @@ int main(int argc, char *argv[]) {
         StatWindow = glutCreateWindow("Obstacle Probability Map");
         glutIdleFunc(UpdatePCB);
         glutDisplayFunc(DisplayChart);
+        glutKeyboardFunc(HandleChartKeyBoard);
         
 
         DisplayWindow(ActualVizParams.Resolution, ActualVizParams.Resolution, 0,
@@ -1992,6 +2280,19 @@ int main(int argc, char *argv[]) {
         glutMouseFunc(HandleMouse);
         glutPassiveMotionFunc(HandleMouseMotion);
 
+        /* Starting the simulation thread, the windows draw its snapshots */
+        AllocateSnapshotBuffer(&Snapshots, ActualSitParams.NumberOfAgents,
+                ActualSitParams.Resolution);
+        PublishState();
+        DisplayedSnapshot = LatestSnapshot(&Snapshots);
+        ProfileThisThread(false);
+        atexit(StopSimulationThread);
+        if (pthread_create(&SimulationThreadID, NULL, SimulationThread,
+                        NULL) != 0) {
+            fprintf(stderr, "Simulation thread creation error!\n");
+            exit(-1);
+        }
+
         glutMainLoop();
 #endif
         /*************************************************************/
@@ -2005,6 +2306,8 @@ int main(int argc, char *argv[]) {
                 (Now * ActualSitParams.DeltaT) - 5.0 -
                 ActualUnitParams.t_del.Value;
         double *StatData;
+        static double CoMData[3];
+        real_t CoM[3];
         ConditionsReset[0] = true;
         ConditionsReset[1] = true;
         /* Allocating and initializing average and sum stats containers */
@@ -2031,12 +2334,17 @@ int main(int argc, char *argv[]) {
         ActualStatUtils.SaveMode = ActualSaveModes.SaveModelSpecifics;
 
         /* Opening output files */
-        FILE *f_Correlation, *f_CoM, *f_Velocity, *f_HullArea,
-                *f_DistanceBetweenNeighbours, *f_DistanceBetweenUnits,
-                *f_CollisionRatio, *f_Acceleration, *f_ReceivedPowers, *f_Collisions;
-        FILE *f_Correlation_StDev, *f_CoM_StDev, *f_Velocity_StDev, *f_HullArea_StDev,
-                *f_CollisionRatio_StDev, *f_DistanceBetweenUnits_StDev,
-                *f_Acceleration_StDev, *f_ReceivedPowers_StDev, *f_DistanceBetweenNeighbours_StDev;
+        /* (NULL if the statistic is not saved) */
+        FILE *f_Correlation = NULL, *f_CoM = NULL, *f_Velocity = NULL,
+                *f_HullArea = NULL, *f_DistanceBetweenNeighbours = NULL,
+                *f_DistanceBetweenUnits = NULL, *f_CollisionRatio = NULL,
+                *f_Acceleration = NULL, *f_ReceivedPowers = NULL,
+                *f_Collisions = NULL;
+        FILE *f_Correlation_StDev = NULL, *f_CoM_StDev = NULL,
+                *f_Velocity_StDev = NULL, *f_HullArea_StDev = NULL,
+                *f_CollisionRatio_StDev = NULL, *f_DistanceBetweenUnits_StDev = NULL,
+                *f_Acceleration_StDev = NULL, *f_ReceivedPowers_StDev = NULL,
+                *f_DistanceBetweenNeighbours_StDev = NULL;
 
         /* Positions and velocities */
 
@@ -2244,14 +2552,43 @@ int main(int argc, char *argv[]) {
             }
         }
 
-        double *Accelerations;
-        Accelerations = malloc(ActualSitParams.NumberOfAgents * sizeof(double));
+        real_t *Accelerations;
+        Accelerations = malloc(ActualSitParams.NumberOfAgents * sizeof(real_t));
 
         if (FALSE != ActualSaveModes.SaveModelSpecifics) {
             InitializeModelSpecificStats(&ActualStatUtils);
         }
         RefreshFlockingParams(&ActualFlockingParams);
 
+        /* Frames are drawn and written on the thread of the video output */
+        int StepsSinceLastFrame = 0;
+        if (VideoTarget != NULL) {
+            if (VideoEvery <= 0) {
+                VideoEvery = (int) round(1.0 /
+                        (VIDEO_FRAME_RATE * ActualSitParams.DeltaT));
+                VideoEvery = MAX(VideoEvery, 1);
+            }
+            StartVideoOutput(&Video, VideoTarget, ActualVizParams.Resolution,
+                    ActualSitParams.NumberOfAgents, ActualSitParams.Radius,
+                    &obstacles);
+            StepsSinceLastFrame = VideoEvery;
+            /* Always printed: the size and the rate are needed by the
+             * command reading raw frames */
+            fprintf(stderr, "Video output: %s, %dx%d RGB24 frames, "
+                    "a frame in every %d steps (%g frames per simulated second)\n",
+                    VideoTarget, (int) ActualVizParams.Resolution,
+                    (int) ActualVizParams.Resolution, VideoEvery,
+                    1.0 / (VideoEvery * ActualSitParams.DeltaT));
+        }
+
+        if (true == TelemetryRequested) {
+            StartTelemetry(&Telemetry, ActualSitParams.NumberOfAgents,
+                    ActualSitParams.Length, ActualSitParams.DeltaT);
+            if (Verbose != 0 && true == Telemetry.Enabled) {
+                printf("Telemetry: %s\n", Telemetry.Name);
+            }
+        }
+
         while (ActualStatUtils.ElapsedTime < ActualSitParams.Length
                 && ActualVizParams.ExperimentOver == false) {
 
@@ -2266,20 +2603,26 @@ int main(int argc, char *argv[]) {
                         ConditionsReset, &Collisions, AgentsInDanger,
                         WindVelocityVector, Accelerations, TargetsArray, Polygons, &Hull, Verbose);
 
+                PROFILE_BEGIN(PROFILE_OUTER_VARIABLES);
                 HandleOuterVariables(&ActualPhase, &ActualVizParams,
                         &ActualSitParams, &ActualUnitParams,
                         ActualStatUtils.ElapsedTime,
                         ActualStatUtils.OutputDirectory);
-                InsertPhaseToDataLine(PhaseData, &ActualPhase, Now + 1, ActualSitParams.Resolution);
+                PROFILE_END(PROFILE_OUTER_VARIABLES);
+                PROFILE_BEGIN(PROFILE_DATALINE);
+                InsertPhaseToDataLine(PhaseData, &ActualPhase, Now + 1);
                 InsertInnerStatesToDataLine(PhaseData, &ActualPhase, Now + 1);
+                PROFILE_END(PROFILE_DATALINE);
 
             } else {
 
+                PROFILE_BEGIN(PROFILE_DATALINE);
                 ShiftDataLine(PhaseData,
                         TimeStepsToStore,
                         (int) (20.0 / ActualSitParams.DeltaT));
                 ShiftInnerStateDataLine(PhaseData, TimeStepsToStore,
                         (int) (20.0 / ActualSitParams.DeltaT));
+                PROFILE_END(PROFILE_DATALINE);
 
                 Step(&ActualPhase, &GPSPhase, &GPSDelayedPhase,
                         PhaseData, &ActualUnitParams, cnt, &ActualFlockingParams,
@@ -2290,16 +2633,44 @@ int main(int argc, char *argv[]) {
                         ConditionsReset, &Collisions, AgentsInDanger,
                         WindVelocityVector, Accelerations, TargetsArray, Polygons, &Hull, Verbose);
 
+                PROFILE_BEGIN(PROFILE_OUTER_VARIABLES);
                 HandleOuterVariables(&ActualPhase, &ActualVizParams,
                         &ActualSitParams, &ActualUnitParams,
                         ActualStatUtils.ElapsedTime,
                         ActualStatUtils.OutputDirectory);
+                PROFILE_END(PROFILE_OUTER_VARIABLES);
 
                 Now = (int) ((20.0 / ActualSitParams.DeltaT) - 1.0);
 
-                InsertPhaseToDataLine(PhaseData, &ActualPhase, Now + 1, ActualSitParams.Resolution);
+                PROFILE_BEGIN(PROFILE_DATALINE);
+                InsertPhaseToDataLine(PhaseData, &ActualPhase, Now + 1);
                 InsertInnerStatesToDataLine(PhaseData, &ActualPhase, Now + 1);
-
+                PROFILE_END(PROFILE_DATALINE);
+
+            }
+
+            /* Queueing a frame of the video */
+            if (VideoTarget != NULL && ++StepsSinceLastFrame >= VideoEvery
+                    && IsVideoRecording(&Video)) {
+                video_frame_t *Frame = VideoFrameToFill(&Video);
+                FillVideoFrame(Frame, &ActualPhase, AgentsInDanger);
+                Frame->ArenaShape = ArenaShape;
+                Frame->ArenaCenterX = ArenaCenterX;
+                Frame->ArenaCenterY = ArenaCenterY;
+                Frame->ArenaRadius = ArenaRadius;
+                Frame->WallWidth = V_Shill / Slope_Shill + R_0_Shill;
+                /* The arena fills the frame (if there is one) */
+                if (ArenaRadius > 0) {
+                    Frame->CenterX = ArenaCenterX;
+                    Frame->CenterY = ArenaCenterY;
+                    Frame->MapSizeXY = 1.1 * ArenaRadius;
+                } else {
+                    Frame->CenterX = ActualVizParams.CenterX;
+                    Frame->CenterY = ActualVizParams.CenterY;
+                    Frame->MapSizeXY = ActualVizParams.MapSizeXY;
+                }
+                QueueVideoFrame(&Video);
+                StepsSinceLastFrame = 0;
             }
 
             /* Reset number of collisions if we haven't passed the steady state timstamp...
@@ -2311,11 +2682,14 @@ int main(int argc, char *argv[]) {
             }
 
             /* Saving trajectories */
+            PROFILE_BEGIN(PROFILE_OUTPUT);
             WriteOutTrajectories(&ActualPhase, ActualSaveModes.SaveTrajectories,
                     ActualSaveModes.SaveInnerStates,
                     ActualStatUtils.ElapsedTime, f_OutPhase, f_OutInnerStates);
+            PROFILE_END(PROFILE_OUTPUT);
 
             /* Saving statistics */
+            PROFILE_BEGIN(PROFILE_STATISTICS);
             // TODO: Some nice method instead of cutting trees... ... ...
             if (TIMELINE == ActualSaveModes.SaveCollisions) {
                 fprintf(f_Collisions, "%lf\t%d\n", ActualStatUtils.ElapsedTime,
@@ -2383,7 +2757,7 @@ int main(int argc, char *argv[]) {
             }
 
             if (FALSE != ActualSaveModes.SaveHullArea) {
-                StatData = StatOfHullArea(Hull);
+                StatData = StatOfHullArea(&Hull);
             }
             switch (ActualSaveModes.SaveHullArea) {
             case TIMELINE:{
@@ -2425,7 +2799,11 @@ int main(int argc, char *argv[]) {
             }
 
             if (FALSE != ActualSaveModes.SaveCoM) {
-                GetCoM(StatData, &ActualPhase);
+                GetCoM(CoM, &ActualPhase);
+                for (h = 0; h < 3; h++) {
+                    CoMData[h] = CoM[h];
+                }
+                StatData = CoMData;
             }
             switch (ActualSaveModes.SaveCoM) {
             case TIMELINE:{
@@ -2525,10 +2903,33 @@ int main(int argc, char *argv[]) {
                         &ActualUnitParams, &ActualFlockingParams,
                         &ActualSitParams);
             }
+            PROFILE_END(PROFILE_STATISTICS);
 
             ActualStatUtils.ElapsedTime += ActualSitParams.DeltaT;
             Now++;
 
+            /* Sampling the telemetry (clusters are counted only for active readers) */
+            if (true == Telemetry.Enabled && TelemetrySampleDue(&Telemetry)) {
+                PublishTelemetry(&Telemetry, ActualStatUtils.ElapsedTime,
+                        Collisions,
+                        (TelemetryHasReader(&Telemetry) ?
+                                CountCluster(ActualPhase, Telemetry.Visited,
+                                        &ActualUnitParams, &StepArena) : -1),
+                        (Hull.Valid ? Hull.Area : 0.0));
+            }
+
+        }
+
+        StopTelemetry(&Telemetry);
+
+        /* Writing the remaining frames */
+        if (VideoTarget != NULL) {
+            StopVideoOutput(&Video);
+            if (Verbose != 0) {
+                printf("Video output: %d frames written%s\n",
+                        Video.NumberOfWrittenFrames,
+                        Video.Failed ? " (stopped after an error)" : "");
+            }
         }
 
         /* Closing files */
@@ -2624,18 +3025,23 @@ int main(int argc, char *argv[]) {
             free(ActualColorConfig.AgentsColor[i]);
         }
     }
-    stack_free(&Hull);
+    freeHull(&Hull);
+    freeArena(&StepArena);
+    freeArena(&FrameArena);
     free(ActualColorConfig.AgentsColor);
     free(AgentsInDanger);
-    freePhase(&ActualPhase, ActualSitParams.Resolution);
-    freePhase(&GPSPhase, ActualSitParams.Resolution);
-    freePhase(&GPSDelayedPhase, ActualSitParams.Resolution);
+    freePhase(&ActualPhase);
+    if (ActualPhase.CBP != NULL) {
+        freeCBPMap(&CBPMap);
+    }
+    freePhase(&GPSPhase);
+    freePhase(&GPSDelayedPhase);
 
     for (i = 0; i < 1 + TimeStepsToStore; i++) {
-        freePhase(&(PhaseData[i]), ActualSitParams.Resolution);
+        freePhase(&(PhaseData[i]));
     }
     free(PhaseData);
 
-    return 1;
+    return 0;
 
 }
@@ -31,14 +31,14 @@ void StepGPSNoises(phase_t * WhichPhase, unit_model_params_t * UnitParams) {
 
     /* GPS fluctuations are modelled as a random Gaussian noise with damping in a central potantial around the real position of the agent.
      */
-    static double GPSPosition[3];
+    static real_t GPSPosition[3];
     NullVect(GPSPosition, 3);
-    static double GPSVelocity[3];
+    static real_t GPSVelocity[3];
     NullVect(GPSVelocity, 3);
 
-    static double GPSNoiseToAdd[3];
-    static double Force[3];     // Central potential 
-    static double Damping[3];   // Damping which is proportional with GPS-measured velocity. 
+    static real_t GPSNoiseToAdd[3];
+    static real_t Force[3];     // Central potential 
+    static real_t Damping[3];   // Damping which is proportional with GPS-measured velocity. 
 
     int i;
 
@@ -57,11 +57,11 @@ void StepGPSNoises(phase_t * WhichPhase, unit_model_params_t * UnitParams) {
         GPSNoiseToAdd[2] = randomizeGaussDouble(0, 1);
 
         /* Quadratic potential with friction */
-        static double lambda_GPS_XY = 0.1;
-        static double lambda_GPS_Z = 0.1;
-        double D_GPS_XY =
+        static real_t lambda_GPS_XY = 0.1;
+        static real_t lambda_GPS_Z = 0.1;
+        real_t D_GPS_XY =
                 sqrt(2 * lambda_GPS_XY * UnitParams->Sigma_GPS_XY.Value) / 300;
-        double D_GPS_Z =
+        real_t D_GPS_Z =
                 sqrt(2 * lambda_GPS_Z * UnitParams->Sigma_GPS_Z.Value) / 300;
 
         /* Spring-like force */
@@ -19,12 +19,12 @@ void ResetStatistics(statistics_t * Statistics) {
     int i;
 
     for (i = 0; i < 8; i++) {
-        Statistics->Data_Acceleration_Sum[i] = 0.0;
-        Statistics->Data_Acceleration_StDev[i] = 0.0;
         Statistics->Data_Velocity_Sum[i] = 0.0;
         Statistics->Data_Velocity_StDev[i] = 0.0;
         if (3 < i)
             continue;
+        Statistics->Data_Acceleration_Sum[i] = 0.0;
+        Statistics->Data_Acceleration_StDev[i] = 0.0;
         Statistics->Data_DistanceBetweenUnits_Sum[i] = 0.0;
         Statistics->Data_DistanceBetweenUnits_StDev[i] = 0.0;
         Statistics->Data_Correlation_Sum[i] = 0.0;
@@ -56,9 +56,9 @@ double *StatOfDistanceBetweenUnits(phase_t * Phase) {
 
     static double Dist_1_2 = 0.0;
 
-    double *Coord1;
-    double *Coord2;
-    static double CoordDiff[3];
+    real_t *Coord1;
+    real_t *Coord2;
+    static real_t CoordDiff[3];
 
     static double StatData[4];
 
@@ -120,9 +120,9 @@ double *StatOfDistanceBetweenNearestNeighbours(phase_t * Phase) {
 
     static double Dist_1_2 = 0.0;
 
-    double *Coord1;
-    double *Coord2;
-    static double CoordDiff[3];
+    real_t *Coord1;
+    real_t *Coord2;
+    static real_t CoordDiff[3];
 
     static double StatData[3];
 
@@ -176,8 +176,8 @@ double *StatOfDistanceBetweenNearestNeighbours(phase_t * Phase) {
 double *StatOfVelocity(phase_t * Phase) {
 
     int i;
-    double *Velocity;
-    static double AvgVelocity[3];
+    real_t *Velocity;
+    static real_t AvgVelocity[3];
     NullVect(AvgVelocity, 3);
 
     Avg = 0.0;
@@ -234,71 +234,247 @@ double *StatOfVelocity(phase_t * Phase) {
 
 }
 
-/* Returns an array that contains the average, deviation, minimum and maximum of
- * velocity scalar products
- */
-double *StatOfCorrelation(phase_t * Phase) {
+/* Correlation sums of a set of unit velocities */
 
-    int i, j;
+void ResetCorrelationSums(correlation_sums_t * Sums) {
 
-    Avg = 0.0;
-    StDev = 0.0;
-    Min = 2e222;
-    Max = 0.0;
+    int k, l;
 
-    static double Corr_1_2;
-    Corr_1_2 = 0.0;
+    for (k = 0; k < 3; k++) {
+        Sums->Sum[k] = 0.0;
+        for (l = 0; l < 3; l++) {
+            Sums->Tensor[k][l] = 0.0;
+        }
+    }
+    Sums->SumOfNorms2 = 0.0;
+    Sums->SumOfNorms4 = 0.0;
+    Sums->NumberOfVectors = 0;
 
-    double *Vel1;
-    double *Vel2;
+}
 
-    static double velLength1;
-    static double velLength2;
-    velLength1 = 0.0;
-    velLength2 = 0.0;
+void AddToCorrelationSums(correlation_sums_t * Sums, real_t *UnitVelocity) {
 
-    static double StatData[4];
+    int k, l;
+    double Norm2 = 0.0;
 
-    for (i = 0; i < Phase->NumberOfAgents - 1; i++) {
+    for (k = 0; k < 3; k++) {
+        Sums->Sum[k] += UnitVelocity[k];
+        for (l = 0; l < 3; l++) {
+            Sums->Tensor[k][l] += UnitVelocity[k] * UnitVelocity[l];
+        }
+        Norm2 += UnitVelocity[k] * UnitVelocity[k];
+    }
+    Sums->SumOfNorms2 += Norm2;
+    Sums->SumOfNorms4 += Norm2 * Norm2;
+    Sums->NumberOfVectors++;
 
-        for (j = i + 1; j < Phase->NumberOfAgents; j++) {
+}
 
-            Vel1 = Phase->Velocities[i];
-            Vel2 = Phase->Velocities[j];
+double SumOfPairCorrelations(correlation_sums_t * Sums) {
 
-            velLength1 = VectAbs(Vel1);
-            velLength2 = VectAbs(Vel2);
+    /* sum_{i<j} u_i * u_j = (|sum u|^2 - sum |u|^2) / 2 */
+    return 0.5 * (Sums->Sum[0] * Sums->Sum[0] + Sums->Sum[1] * Sums->Sum[1] +
+            Sums->Sum[2] * Sums->Sum[2] - Sums->SumOfNorms2);
 
-            if (velLength1 != 0 && velLength2 != 0) {
-                Corr_1_2 =
-                        ScalarProduct(Vel1, Vel2,
-                        3) / (VectAbs(Vel1) * VectAbs(Vel2));
-            } else {
-                Corr_1_2 = 0.0;
+}
+
+double SumOfSquaredPairCorrelations(correlation_sums_t * Sums) {
+
+    int k, l;
+    double FrobeniusNorm2 = 0.0;
+
+    /* sum_{i<j} (u_i * u_j)^2 = (|sum u u^T|_F^2 - sum |u|^4) / 2 */
+    for (k = 0; k < 3; k++) {
+        for (l = 0; l < 3; l++) {
+            FrobeniusNorm2 += Sums->Tensor[k][l] * Sums->Tensor[k][l];
+        }
+    }
+    return 0.5 * (FrobeniusNorm2 - Sums->SumOfNorms4);
+
+}
+
+/* Sorting planar unit vectors by their angles */
+typedef struct {
+    double Angle;
+    int Index;
+} correlation_angle_t;
+
+static int CompareCorrelationAngles(const void *a, const void *b) {
+
+    double Difference = ((const correlation_angle_t *) a)->Angle -
+            ((const correlation_angle_t *) b)->Angle;
+
+    return (Difference > 0.0) - (Difference < 0.0);
+
+}
+
+static double DotOfUnitVelocities(real_t *a, real_t *b) {
+
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+
+}
+
+void CorrelationExtremes(double *MinOutput, double *MaxOutput,
+        real_t **UnitVelocities, const int NumberOfVectors) {
+
+    static correlation_angle_t *Angles = NULL;
+    static int Capacity = 0;
+    int i, j, k, n, Lower, Upper, Middle;
+    bool Planar = true;
+    double Target, Corr;
+
+    *MinOutput = 2e222;
+    *MaxOutput = -2e222;
+
+    for (i = 0; i < NumberOfVectors; i++) {
+        if (UnitVelocities[i][2] != 0.0) {
+            Planar = false;
+            break;
+        }
+    }
+
+    if (!Planar) {
+        /* Nearest and farthest directions in 3D: every pair */
+        for (i = 0; i < NumberOfVectors - 1; i++) {
+            for (j = i + 1; j < NumberOfVectors; j++) {
+                Corr = DotOfUnitVelocities(UnitVelocities[i], UnitVelocities[j]);
+                if (Corr > *MaxOutput) {
+                    *MaxOutput = Corr;
+                }
+                if (Corr < *MinOutput) {
+                    *MinOutput = Corr;
+                }
             }
+        }
+        return;
+    }
 
-            if (Corr_1_2 > Max) {
-                Max = Corr_1_2;
+    if (NumberOfVectors > Capacity) {
+        free(Angles);
+        Angles = (correlation_angle_t *) malloc(NumberOfVectors *
+                sizeof(correlation_angle_t));
+        COUNT_HEAP_ALLOCATIONS(1);
+        if (!Angles) {
+            fprintf(stderr, "Correlation angles allocation error!\n");
+            exit(-1);
+        }
+        Capacity = NumberOfVectors;
+    }
+
+    n = NumberOfVectors;
+    for (i = 0; i < n; i++) {
+        Angles[i].Angle = atan2(UnitVelocities[i][1], UnitVelocities[i][0]);
+        Angles[i].Index = i;
+    }
+    qsort(Angles, n, sizeof(correlation_angle_t), CompareCorrelationAngles);
+
+    for (i = 0; i < n; i++) {
+
+        /* The most aligned pairs are neighbours in the order of the angles
+         * (a single vector has no pair) */
+        j = (i + 1) % n;
+        if (j != i) {
+            Corr = DotOfUnitVelocities(UnitVelocities[Angles[i].Index],
+                    UnitVelocities[Angles[j].Index]);
+            if (Corr > *MaxOutput) {
+                *MaxOutput = Corr;
             }
-            if (Corr_1_2 < Min) {
-                Min = Corr_1_2;
+        }
+
+        /* The least aligned pair of each vector is next to its opposite */
+        Target = Angles[i].Angle + (Angles[i].Angle < 0.0 ? M_PI : -M_PI);
+        Lower = 0;
+        Upper = n;
+        while (Lower < Upper) {
+            Middle = (Lower + Upper) / 2;
+            if (Angles[Middle].Angle < Target) {
+                Lower = Middle + 1;
+            } else {
+                Upper = Middle;
+            }
+        }
+        for (k = Lower - 1; k <= Lower; k++) {
+            j = (k + n) % n;
+            if (j == i) {
+                continue;
             }
+            Corr = DotOfUnitVelocities(UnitVelocities[Angles[i].Index],
+                    UnitVelocities[Angles[j].Index]);
+            if (Corr < *MinOutput) {
+                *MinOutput = Corr;
+            }
+        }
 
-            Avg += Corr_1_2;
-            StDev += Corr_1_2 * Corr_1_2;
+    }
 
+}
+
+/* Returns an array that contains the average, deviation, minimum and maximum of
+ * velocity scalar products
+ */
+double *StatOfCorrelation(phase_t * Phase) {
+
+    static correlation_sums_t Sums;
+    static real_t **UnitVelocities = NULL;
+    static int Capacity = 0;
+    static double StatData[4];
+
+    int i, k;
+    int NumberOfMoving = 0;
+    double NumberOfPairs;
+    double velLength;
+    real_t *Vel;
+
+    if (Phase->NumberOfAgents > Capacity) {
+        if (UnitVelocities) {
+            freeRealMatrix(UnitVelocities, Capacity, 3);
         }
+        Capacity = Phase->NumberOfAgents;
+        UnitVelocities = realMatrix(Capacity, 3);
+    }
 
+    /* Agents at rest have zero correlation with every other agent */
+    ResetCorrelationSums(&Sums);
+    for (i = 0; i < Phase->NumberOfAgents; i++) {
+        Vel = Phase->Velocities[i];
+        velLength = VectAbs(Vel);
+        if (velLength != 0) {
+            for (k = 0; k < 3; k++) {
+                UnitVelocities[NumberOfMoving][k] = Vel[k] / velLength;
+            }
+            AddToCorrelationSums(&Sums, UnitVelocities[NumberOfMoving]);
+            NumberOfMoving++;
+        }
     }
 
-    Avg *= 2.0 / (Phase->NumberOfAgents * (Phase->NumberOfAgents - 1));
-    StDev *= 2.0 / (Phase->NumberOfAgents * (Phase->NumberOfAgents - 1));
+    NumberOfPairs = 0.5 * Phase->NumberOfAgents * (Phase->NumberOfAgents - 1);
+    if (NumberOfPairs == 0) {
+        for (k = 0; k < 4; k++) {
+            StatData[k] = 0.0;
+        }
+        return StatData;
+    }
+
+    Avg = SumOfPairCorrelations(&Sums) / NumberOfPairs;
+    StDev = SumOfSquaredPairCorrelations(&Sums) / NumberOfPairs;
     StDev -= Avg * Avg;
 
     if (StDev < 0.0) {
         StDev = 0.0;
     }
 
+    CorrelationExtremes(&Min, &Max, UnitVelocities, NumberOfMoving);
+    if (NumberOfMoving < Phase->NumberOfAgents) {
+        /* Pairs with an agent at rest */
+        if (Min > 0.0) {
+            Min = 0.0;
+        }
+    }
+    /* The maximum is not saved below zero */
+    if (Max < 0.0) {
+        Max = 0.0;
+    }
+
     StatData[0] = Avg;
     StatData[1] = sqrt(StDev);
     StatData[2] = Min;
@@ -311,28 +487,14 @@ double *StatOfCorrelation(phase_t * Phase) {
 /* Returns an array that contains the average, deviation, minimum and maximum of
  * the Hull area
  */
-double *StatOfHullArea(node *Hull) {
-
-    int HullLength, g;
-    HullLength = stack_count(Hull);
+double *StatOfHullArea(hull_t * Hull) {
 
-    double HullX[HullLength];
-    double HullY[HullLength];
-    double HullSurf;
     static double StatData[4];
-    
-    for (g = 0; g < HullLength; g++) {
-        HullX[g] = Hull->data->x;
-        HullY[g] = Hull->data->y;
-        Hull = Hull->next;
-    }
-
-    HullSurf = polygonArea(HullX, HullY, HullLength);
 
-    StatData[0] = HullSurf;
-    StatData[1] = sqrt(HullSurf);
-    StatData[2] = HullSurf;
-    StatData[3] = HullSurf;
+    StatData[0] = Hull->Area;
+    StatData[1] = sqrt(Hull->Area);
+    StatData[2] = Hull->Area;
+    StatData[3] = Hull->Area;
 
     return StatData;
 
@@ -341,7 +503,7 @@ double *StatOfHullArea(node *Hull) {
 /* Returns an array that contains the average, deviation, minimum and maximum of
  * accelerations
  */
-double *StatOfAcceleration(double *Accelerations, const double NumberOfAgents) {
+double *StatOfAcceleration(real_t *Accelerations, const double NumberOfAgents) {
 
     int i;
 
@@ -393,8 +555,8 @@ double *StatOfAcceleration(double *Accelerations, const double NumberOfAgents) {
 double RatioOfDangerousSituations(phase_t * Phase, const double RadiusOfCopter) {
 
     /* Vectors to store positions */
-    double *x_i;
-    static double x_j[3];
+    real_t *x_i;
+    static real_t x_j[3];
 
     static int NumberOfCollisions;
     NumberOfCollisions = 0;
@@ -13,6 +13,7 @@
 #include "utilities/math_utils.h"
 #include "utilities/datastructs.h"
 #include "utilities/dynamics_utils.h"
+#include "utilities/hull.h"
 
 /* This struct contains data arrays for storing general statistical properties
  */
@@ -114,15 +115,48 @@ double *StatOfVelocity(phase_t * Phase);
  */
 double *StatOfCorrelation(phase_t * Phase);
 
+/////////////////////////////////////////////////////////////////////////////////
+/* Velocity correlations in O(N) */
+
+/* Sums of the unit velocities "u" of a group of agents (zero vectors for
+ * agents at rest): sum u, sum u u^T, sum |u|^2 and sum |u|^4.
+ * The sum and the sum of squares of the scalar products of every pair
+ * in the group can be calculated from these without looping over the pairs.
+ */
+typedef struct {
+
+    double Sum[3];
+    double Tensor[3][3];
+    double SumOfNorms2;
+    double SumOfNorms4;
+    int NumberOfVectors;
+
+} correlation_sums_t;
+
+void ResetCorrelationSums(correlation_sums_t * Sums);
+void AddToCorrelationSums(correlation_sums_t * Sums, real_t *UnitVelocity);
+
+/* Sum of u_i * u_j and (u_i * u_j)^2 over the pairs i < j of the group */
+double SumOfPairCorrelations(correlation_sums_t * Sums);
+double SumOfSquaredPairCorrelations(correlation_sums_t * Sums);
+
+/* Minimum and maximum scalar product of the pairs of "NumberOfVectors"
+ * unit vectors. Planar vectors are sorted by their angles (N log N),
+ * vectors in 3D are compared pair by pair. Without pairs (less than two
+ * vectors) the outputs are left at 2e222 and -2e222.
+ */
+void CorrelationExtremes(double *MinOutput, double *MaxOutput,
+        real_t **UnitVelocities, const int NumberOfVectors);
+
 /* Returns an array that contains the average, deviation, minimum and maximum of
  * the Hull area
  */
-double *StatOfHullArea(node *HullArea);
+double *StatOfHullArea(hull_t * Hull);
 
 /* Returns an array that contains the average, deviation, minimum and maximum of
  * accelerations
  */
-double *StatOfAcceleration(double *Accelerations, const double NumberOfAgents);
+double *StatOfAcceleration(real_t *Accelerations, const double NumberOfAgents);
 
 /* Calculating a parameter that is proportional with
  * the number of collisions and dangerous situations.
@@ -0,0 +1,163 @@
+//MIT License
+//Copyright (c) 2018 Eotvos Lorand University, Budapest
+
+/* vim:set ts=4 sw=4 sts=4 et: */
+
+/*
+ * Per-step aggregates of the flock.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "aggregates.h"
+
+flock_aggregates_t FlockAggregates;
+
+void AllocateFlockAggregates(flock_aggregates_t * Aggregates,
+        const int NumberOfAgents) {
+
+    Aggregates->NumberOfAgents = NumberOfAgents;
+    Aggregates->NeighbourhoodCoMs = realMatrix(NumberOfAgents, 3);
+    Aggregates->NeighbourListCapacity = 0;
+    Aggregates->NeighbourLists = NULL;
+    Aggregates->NumberOfNeighbours = intData(NumberOfAgents);
+    Aggregates->NumberOfTargets = 0;
+    Aggregates->TargetCapacity = 0;
+    Aggregates->Arrivals = NULL;
+
+}
+
+void freeFlockAggregates(flock_aggregates_t * Aggregates) {
+
+    freeRealMatrix(Aggregates->NeighbourhoodCoMs, Aggregates->NumberOfAgents, 3);
+    free(Aggregates->NeighbourLists);
+    free(Aggregates->NumberOfNeighbours);
+    Aggregates->NeighbourLists = NULL;
+    Aggregates->NumberOfNeighbours = NULL;
+    Aggregates->NeighbourListCapacity = 0;
+    free(Aggregates->Arrivals);
+    Aggregates->Arrivals = NULL;
+    Aggregates->TargetCapacity = 0;
+    Aggregates->NumberOfTargets = 0;
+
+}
+
+void UpdateNeighbourhoodCoM(flock_aggregates_t * Aggregates,
+        phase_t * LocalPhase, const int WhichAgent,
+        const int SizeOfNeighbourhood) {
+
+    /* Agents beyond "NumberOfAgents" are left over from other agents' phases */
+    int n = SizeOfNeighbourhood;
+    if (n > LocalPhase->NumberOfAgents) {
+        n = LocalPhase->NumberOfAgents;
+    }
+    if (n < 1) {
+        n = 1;
+    }
+
+    GetNeighbourhoodSpecificCoM(Aggregates->NeighbourhoodCoMs[WhichAgent],
+            LocalPhase, n);
+
+}
+
+void UpdateNeighbourList(flock_aggregates_t * Aggregates,
+        phase_t * LocalPhase, const int WhichAgent,
+        const int SizeOfNeighbourhood) {
+
+    int i;
+    int *List;
+
+    int n = SizeOfNeighbourhood;
+    if (n > LocalPhase->NumberOfAgents) {
+        n = LocalPhase->NumberOfAgents;
+    }
+
+    if (SizeOfNeighbourhood - 1 > Aggregates->NeighbourListCapacity) {
+        Aggregates->NeighbourLists = (int *) realloc(Aggregates->NeighbourLists,
+                (size_t) Aggregates->NumberOfAgents *
+                (SizeOfNeighbourhood - 1) * sizeof(int));
+        COUNT_HEAP_ALLOCATIONS(1);
+        if (!Aggregates->NeighbourLists) {
+            fprintf(stderr, "Neighbour lists allocation error!\n");
+            exit(-1);
+        }
+        Aggregates->NeighbourListCapacity = SizeOfNeighbourhood - 1;
+        /* The stored lists do not fit the new layout */
+        for (i = 0; i < Aggregates->NumberOfAgents; i++) {
+            Aggregates->NumberOfNeighbours[i] = 0;
+        }
+    }
+
+    /* The actual agent is the first one of its local phase */
+    List = Aggregates->NeighbourLists +
+            (size_t) WhichAgent * Aggregates->NeighbourListCapacity;
+    Aggregates->NumberOfNeighbours[WhichAgent] = (n > 1 ? n - 1 : 0);
+    for (i = 1; i < n; i++) {
+        List[i - 1] = LocalPhase->RealIDs[i];
+    }
+
+}
+
+void SetNumberOfTargets(flock_aggregates_t * Aggregates,
+        const int NumberOfTargets) {
+
+    int i;
+
+    if (NumberOfTargets == Aggregates->NumberOfTargets) {
+        return;
+    }
+
+    if (NumberOfTargets > Aggregates->TargetCapacity) {
+        Aggregates->Arrivals = (int *) realloc(Aggregates->Arrivals,
+                NumberOfTargets * sizeof(int));
+        COUNT_HEAP_ALLOCATIONS(1);
+        if (!Aggregates->Arrivals) {
+            fprintf(stderr, "Arrival counters allocation error!\n");
+            exit(-1);
+        }
+        Aggregates->TargetCapacity = NumberOfTargets;
+    }
+
+    if (NumberOfTargets < Aggregates->NumberOfTargets) {
+        /* Targets have been removed */
+        for (i = 0; i < NumberOfTargets; i++) {
+            Aggregates->Arrivals[i] = 0;
+        }
+    } else {
+        for (i = Aggregates->NumberOfTargets; i < NumberOfTargets; i++) {
+            Aggregates->Arrivals[i] = 0;
+        }
+    }
+    Aggregates->NumberOfTargets = NumberOfTargets;
+
+}
+
+void UpdateArrival(flock_aggregates_t * Aggregates, real_t *ArrivalState,
+        const int NewArrivalState) {
+
+    int Previous = (int) *ArrivalState;
+
+    if (Previous == NewArrivalState) {
+        return;
+    }
+
+    /* States older than the last removal of the targets are not counted */
+    if (Previous > 0 && Previous <= Aggregates->NumberOfTargets &&
+            Aggregates->Arrivals[Previous - 1] > 0) {
+        Aggregates->Arrivals[Previous - 1]--;
+    }
+    if (NewArrivalState > 0 && NewArrivalState <= Aggregates->NumberOfTargets) {
+        Aggregates->Arrivals[NewArrivalState - 1]++;
+    }
+    *ArrivalState = NewArrivalState;
+
+}
+
+int ArrivalsAtTarget(flock_aggregates_t * Aggregates, const int WhichTarget) {
+
+    if (WhichTarget < 0 || WhichTarget >= Aggregates->NumberOfTargets) {
+        return 0;
+    }
+    return Aggregates->Arrivals[WhichTarget];
+
+}
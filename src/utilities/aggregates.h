@@ -0,0 +1,83 @@
+//MIT License
+//Copyright (c) 2018 Eotvos Lorand University, Budapest
+
+/* vim:set ts=4 sw=4 sts=4 et: */
+
+/*
+ * Per-step aggregates of the flock shared by the agents.
+ * The centre of mass of each agent's neighbourhood is stored when its phase
+ * is created (once per perception tick) together with the list of the
+ * neighbours it has perceived, and the number of agents that have
+ * arrived at each target is kept up to date from the changes of the agents'
+ * arrival states, so no agent has to loop over the others to get them.
+ */
+
+#ifndef AGGREGATES_H
+#define AGGREGATES_H
+
+#include "dynamics_utils.h"
+
+typedef struct {
+
+    int NumberOfAgents;
+
+    /* Centre of mass of the perceived neighbourhood of each agent (N x 3) */
+    real_t **NeighbourhoodCoMs;
+
+    /* Neighbours of each agent in the order of the perception (the nearest
+     * or strongest first, without the agent itself). The list of agent i
+     * starts at "i * NeighbourListCapacity".
+     */
+    int NeighbourListCapacity;
+    int *NeighbourLists;
+    int *NumberOfNeighbours;
+
+    /* Number of agents that have arrived at each target */
+    int NumberOfTargets;
+    int TargetCapacity;
+    int *Arrivals;
+
+} flock_aggregates_t;
+
+/* Aggregates of the simulated flock */
+extern flock_aggregates_t FlockAggregates;
+
+/* Allocating and freeing the arrays for "NumberOfAgents" agents */
+void AllocateFlockAggregates(flock_aggregates_t * Aggregates,
+        const int NumberOfAgents);
+void freeFlockAggregates(flock_aggregates_t * Aggregates);
+
+/* Storing the CoM of the first "SizeOfNeighbourhood" agents of the local
+ * phase "LocalPhase" (the actual agent and its nearest neighbours)
+ * as the neighbourhood CoM of agent "WhichAgent"
+ */
+void UpdateNeighbourhoodCoM(flock_aggregates_t * Aggregates,
+        phase_t * LocalPhase, const int WhichAgent,
+        const int SizeOfNeighbourhood);
+
+/* Storing the agents 1 ... "SizeOfNeighbourhood" - 1 of the local phase
+ * "LocalPhase" as the neighbour list of agent "WhichAgent" (the lists are
+ * reallocated and cleared if the size of the neighbourhood grows)
+ */
+void UpdateNeighbourList(flock_aggregates_t * Aggregates,
+        phase_t * LocalPhase, const int WhichAgent,
+        const int SizeOfNeighbourhood);
+
+/* Setting the number of targets. The counters are cleared when the targets
+ * are removed, new targets start with no arrived agents.
+ */
+void SetNumberOfTargets(flock_aggregates_t * Aggregates,
+        const int NumberOfTargets);
+
+/* Changing the arrival state of an agent
+ * ("ArrivalState" is 0 or the ID of the target it has arrived at + 1,
+ * the agents keep it in one of their inner states).
+ * Only the counters of the previous and the new target are changed.
+ */
+void UpdateArrival(flock_aggregates_t * Aggregates, real_t *ArrivalState,
+        const int NewArrivalState);
+
+/* Number of agents that have arrived at target "WhichTarget" */
+int ArrivalsAtTarget(flock_aggregates_t * Aggregates, const int WhichTarget);
+
+#endif
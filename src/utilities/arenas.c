@@ -96,14 +96,14 @@ int ParseArenaFile(const char *name, arenas_t * arenas,
 // returns 0 if WhichPoint is inside arena (CW)
 // returns 1 if NearestPoint contains closest edge point (in shadow)
 // returns 2 if NearestPoint contains closest vertex point (not in shadow)
-int NearestArenaPoint(double *NearestPoint, double *WhichPoint,
-        const arena_t * Arena, const double ArenaRadius,
-        const double ArenaCenterX, const double ArenaCenterY) {
+int NearestArenaPoint(real_t *NearestPoint, real_t *WhichPoint,
+        const arena_t * Arena, const real_t ArenaRadius,
+        const real_t ArenaCenterX, const real_t ArenaCenterY) {
     int i;
-    static double p[MAX_ARENA_VERTICES * 2 + 2];
-    static double Temp1[3];
-    static double Temp2[3];
-    double dist, mindist = 1e222;
+    static real_t p[MAX_ARENA_VERTICES * 2 + 2];
+    static real_t Temp1[3];
+    static real_t Temp2[3];
+    real_t dist, mindist = 1e222;
 
     // convert arena to polygon
     for (i = 0; i < Arena->p_count; i++) {
@@ -148,29 +148,29 @@ int NearestArenaPoint(double *NearestPoint, double *WhichPoint,
 }
 
 void
-Shill_Wall(double *OutputVelocity, phase_t * Phase,
-        const double ArenaCenterX, const double ArenaCenterY,
-        const double ArenaRadius, const arena_t * Arena,
-        const double C_Shill, const double V_Shill,
-        const double Alpha_Shill, const double Gamma_Wall,
+Shill_Wall(real_t *OutputVelocity, phase_t * Phase,
+        const real_t ArenaCenterX, const real_t ArenaCenterY,
+        const real_t ArenaRadius, const arena_t * Arena,
+        const real_t C_Shill, const real_t V_Shill,
+        const real_t Alpha_Shill, const real_t Gamma_Wall,
         const int WhichAgent, const int Dim_l) {
 
-    const double C_VelDiff = 1.0 / 100.0;
-    double *AgentsPosition;
+    const real_t C_VelDiff = 1.0 / 100.0;
+    real_t *AgentsPosition;
     AgentsPosition = Phase->Coordinates[WhichAgent];
-    double *AgentsVelocity;
+    real_t *AgentsVelocity;
     AgentsVelocity = Phase->Velocities[WhichAgent];
-    static double GoalPositionVect[3];
+    static real_t GoalPositionVect[3];
     FillVect(GoalPositionVect, ArenaCenterX, ArenaCenterY, 0.0);
 
-    static double FromGoal[3];
-    static double ToArena[3];
+    static real_t FromGoal[3];
+    static real_t ToArena[3];
     VectDifference(FromGoal, GoalPositionVect, AgentsPosition);
     if (2.0 == Dim_l) {
         FromGoal[2] = 0.0;
     }
 
-    static double ToArenaLength;
+    static real_t ToArenaLength;
 
     // SQUARE
     if (Arena->index == ARENA_SQUARE) {
@@ -258,32 +258,32 @@ Shill_Wall(double *OutputVelocity, phase_t * Phase,
 }
 
 void
-Shill_Wall_LinSqrt(double *OutputVelocity, phase_t * Phase,
-        const double ArenaCenterX, const double ArenaCenterY,
-        const double ArenaRadius, const arena_t * Arena,
-        const double V_Shill, const double R0_Offset_Shill,
-        const double Acc_Shill, const double Slope_Shill,
+Shill_Wall_LinSqrt(real_t *OutputVelocity, phase_t * Phase,
+        const real_t ArenaCenterX, const real_t ArenaCenterY,
+        const real_t ArenaRadius, const arena_t * Arena,
+        const real_t V_Shill, const real_t R0_Offset_Shill,
+        const real_t Acc_Shill, const real_t Slope_Shill,
         const int WhichAgent, const int Dim_l) {
 
     int i;
-    double *AgentsPosition;
+    real_t *AgentsPosition;
     AgentsPosition = Phase->Coordinates[WhichAgent];
-    double *AgentsVelocity;
+    real_t *AgentsVelocity;
     AgentsVelocity = Phase->Velocities[WhichAgent];
-    static double ArenaCenter[3];
+    static real_t ArenaCenter[3];
     FillVect(ArenaCenter, ArenaCenterX, ArenaCenterY, 0.0);
 
-    static double ToCenter[3];  // from pos towards center
-    static double ToArena[3];
+    static real_t ToCenter[3];  // from pos towards center
+    static real_t ToArena[3];
 
     VectDifference(ToCenter, ArenaCenter, AgentsPosition);
     if (2.0 == Dim_l) {
         ToCenter[2] = 0.0;
     }
 
-    static double VelDiff;
-    static double DistFromWall; // negative outside, positive inside
-    static double MaxVelDiff;
+    static real_t VelDiff;
+    static real_t DistFromWall; // negative outside, positive inside
+    static real_t MaxVelDiff;
 
     // SQUARE
     if (Arena->index == ARENA_SQUARE) {
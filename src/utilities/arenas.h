@@ -22,7 +22,7 @@
 typedef struct {
     int index;
     char name[MAX_ARENA_NAME_LENGTH];
-    double p[MAX_ARENA_VERTICES][3];
+    real_t p[MAX_ARENA_VERTICES][3];
     int p_count;
 } arena_t;
 
@@ -48,18 +48,18 @@ int ParseArenaFile(const char *name, arenas_t * arenas,
         bool define_circle_and_square, int Verbose);
 
 /* More-or-less general interaction with specific types of arena */
-void Shill_Wall(double *OutputVelocity, phase_t * Phase,
-        const double ArenaCenterX, const double ArenaCenterY,
-        const double ArenaSize, const arena_t * Arena,
-        const double C_Shill, const double V_Shill,
-        const double Alpha_Shill, const double Gamma_Wall,
+void Shill_Wall(real_t *OutputVelocity, phase_t * Phase,
+        const real_t ArenaCenterX, const real_t ArenaCenterY,
+        const real_t ArenaSize, const arena_t * Arena,
+        const real_t C_Shill, const real_t V_Shill,
+        const real_t Alpha_Shill, const real_t Gamma_Wall,
         const int WhichAgent, const int Dim_l);
 
-void Shill_Wall_LinSqrt(double *OutputVelocity, phase_t * Phase,
-        const double ArenaCenterX, const double ArenaCenterY,
-        const double ArenaSize, const arena_t * Arena,
-        const double V_Shill, const double R0_Offset_Shill,
-        const double Acc_Shill, const double Slope_Shill,
+void Shill_Wall_LinSqrt(real_t *OutputVelocity, phase_t * Phase,
+        const real_t ArenaCenterX, const real_t ArenaCenterY,
+        const real_t ArenaSize, const arena_t * Arena,
+        const real_t V_Shill, const real_t R0_Offset_Shill,
+        const real_t Acc_Shill, const real_t Slope_Shill,
         const int WhichAgent, const int Dim_l);
 
 #endif
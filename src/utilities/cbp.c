@@ -0,0 +1,305 @@
+//MIT License
+//Copyright (c) 2018 Eotvos Lorand University, Budapest
+
+/* vim:set ts=4 sw=4 sts=4 et: */
+
+/*
+ * Storage and fusion of the cooperative belief map (CBP) of the agents.
+ */
+
+#include "cbp.h"
+#include "datastructs.h"
+
+void AllocateCBPMap(cbp_map_t * Map, const int NumberOfAgents,
+        const int Resolution) {
+
+    size_t NumberOfCells = (size_t) NumberOfAgents * Resolution * Resolution;
+
+    Map->NumberOfAgents = NumberOfAgents;
+    Map->Resolution = Resolution;
+    Map->TilesPerRow = (Resolution + CBP_TILE_SIZE - 1) / CBP_TILE_SIZE;
+
+    /* calloc-ed zeros are log-odds of p = 0.5 */
+    Map->Cells = (cbp_cell_t *) calloc(NumberOfCells, sizeof(cbp_cell_t));
+    Map->FusedLogOdds = (float *) calloc(Resolution * Resolution, sizeof(float));
+    Map->FusedCount = (uint32_t *) calloc(Resolution * Resolution, sizeof(uint32_t));
+    Map->FusedProbability = (float *) calloc(Resolution * Resolution, sizeof(float));
+    Map->DirtyTiles = (unsigned char *) calloc(Map->TilesPerRow * Map->TilesPerRow,
+            sizeof(unsigned char));
+    if (Map->Cells == NULL || Map->FusedLogOdds == NULL || Map->FusedCount == NULL
+            || Map->FusedProbability == NULL || Map->DirtyTiles == NULL) {
+        fprintf(stderr, "CBP map allocation error!\n");
+        exit(-1);
+    }
+
+    /* Every tile is dirty at start */
+    memset(Map->DirtyTiles, 1, Map->TilesPerRow * Map->TilesPerRow);
+    RefreshFusedCBP(Map);
+
+}
+
+void freeCBPMap(cbp_map_t * Map) {
+
+    free(Map->Cells);
+    free(Map->FusedLogOdds);
+    free(Map->FusedCount);
+    free(Map->FusedProbability);
+    free(Map->DirtyTiles);
+    Map->Cells = NULL;
+
+}
+
+/* Adding "Increment" to a cell given by its index in "Cells" */
+static void AddToCBPCell(cbp_map_t * Map, const size_t Index,
+        const float Increment, const MeasurementType Type) {
+
+    size_t GridSize = (size_t) Map->Resolution * Map->Resolution;
+    int InGrid = (int) (Index % GridSize);
+    int x = InGrid % Map->Resolution;
+    int y = InGrid / Map->Resolution;
+
+    switch (Type) {
+    case MTYPE_TRAIL:
+        Map->Cells[Index].Count++;
+        Map->Cells[Index].LogOdds += Increment;
+        break;
+    case MTYPE_OBST:
+        Map->Cells[Index].CountObst++;
+        Map->Cells[Index].LogOddsObst += Increment;
+        break;
+    default:
+        return;
+    }
+
+    Map->FusedLogOdds[InGrid] += Increment;
+    Map->FusedCount[InGrid]++;
+    Map->DirtyTiles[(y / CBP_TILE_SIZE) * Map->TilesPerRow + x / CBP_TILE_SIZE] = 1;
+
+}
+
+/* Measurement is mapped linearly between the occupied and free increments */
+static float LogOddsIncrement(const real_t Measurement) {
+
+    return CBP_LOGODDS_OCCUPIED +
+            (float) Measurement * (CBP_LOGODDS_FREE - CBP_LOGODDS_OCCUPIED);
+
+}
+
+void InsertMeasurementIntoCBP(cbp_map_t * Map, const int WhichAgent,
+        const int x, const int y, const real_t Measurement,
+        const MeasurementType Type) {
+
+    AddToCBPCell(Map, CBPIndex(Map, WhichAgent, x, y),
+            LogOddsIncrement(Measurement), Type);
+
+}
+
+void RefreshFusedCBP(cbp_map_t * Map) {
+
+    int tx, ty, x, y;
+    int Resolution = Map->Resolution;
+
+    for (ty = 0; ty < Map->TilesPerRow; ty++) {
+        for (tx = 0; tx < Map->TilesPerRow; tx++) {
+            if (Map->DirtyTiles[ty * Map->TilesPerRow + tx] == 0) {
+                continue;
+            }
+            for (y = ty * CBP_TILE_SIZE; y < (ty + 1) * CBP_TILE_SIZE && y < Resolution; y++) {
+                for (x = tx * CBP_TILE_SIZE; x < (tx + 1) * CBP_TILE_SIZE && x < Resolution; x++) {
+                    Map->FusedProbability[y * Resolution + x] =
+                            CBPProbability(Map->FusedLogOdds[y * Resolution + x]);
+                }
+            }
+            Map->DirtyTiles[ty * Map->TilesPerRow + tx] = 0;
+        }
+    }
+
+}
+
+void AllocateCBPRayBatch(cbp_ray_batch_t * Batch, const int Capacity) {
+
+    Batch->Count = 0;
+    Batch->Capacity = (Capacity > 0 ? Capacity : 1);
+    Batch->Cells = (size_t *) calloc(Batch->Capacity, sizeof(size_t));
+    if (Batch->Cells == NULL) {
+        fprintf(stderr, "Ray batch allocation error!\n");
+        exit(-1);
+    }
+
+}
+
+void freeCBPRayBatch(cbp_ray_batch_t * Batch) {
+
+    free(Batch->Cells);
+    Batch->Cells = NULL;
+    Batch->Count = Batch->Capacity = 0;
+
+}
+
+void AddCellToCBPRayBatch(cbp_ray_batch_t * Batch, const size_t Cell) {
+
+    if (Batch->Count == Batch->Capacity) {
+        Batch->Capacity *= 2;
+        Batch->Cells = (size_t *) realloc(Batch->Cells,
+                Batch->Capacity * sizeof(size_t));
+        COUNT_HEAP_ALLOCATIONS(1);
+        if (Batch->Cells == NULL) {
+            fprintf(stderr, "Ray batch allocation error!\n");
+            exit(-1);
+        }
+    }
+    Batch->Cells[Batch->Count++] = Cell;
+
+}
+
+void ApplyCBPRayBatch(cbp_map_t * Map, cbp_ray_batch_t * Batch,
+        const real_t Measurement, const MeasurementType Type) {
+
+    int i;
+    float Increment = LogOddsIncrement(Measurement);
+
+    for (i = 0; i < Batch->Count; i++) {
+        AddToCBPCell(Map, Batch->Cells[i], Increment, Type);
+    }
+    Batch->Count = 0;
+
+}
+
+/* Growing an array of "Rays" to "Capacity" elements */
+#define RESIZE_RAY_ARRAY(Array, Type) \
+    Rays->Array = (Type *) realloc(Rays->Array, Rays->Capacity * sizeof(Type)); \
+    COUNT_HEAP_ALLOCATIONS(1); \
+    if (Rays->Array == NULL) { \
+        fprintf(stderr, "Ray list allocation error!\n"); \
+        exit(-1); \
+    }
+
+static void ResizeCBPRays(cbp_rays_t * Rays) {
+
+    RESIZE_RAY_ARRAY(Agent, int);
+    RESIZE_RAY_ARRAY(AX, real_t);
+    RESIZE_RAY_ARRAY(AY, real_t);
+    RESIZE_RAY_ARRAY(BX, real_t);
+    RESIZE_RAY_ARRAY(BY, real_t);
+    RESIZE_RAY_ARRAY(X, int);
+    RESIZE_RAY_ARRAY(Y, int);
+    RESIZE_RAY_ARRAY(TargetX, int);
+    RESIZE_RAY_ARRAY(TargetY, int);
+    RESIZE_RAY_ARRAY(StepX, int);
+    RESIZE_RAY_ARRAY(StepY, int);
+    RESIZE_RAY_ARRAY(tMaxX, real_t);
+    RESIZE_RAY_ARRAY(tMaxY, real_t);
+    RESIZE_RAY_ARRAY(tDeltaX, real_t);
+    RESIZE_RAY_ARRAY(tDeltaY, real_t);
+
+}
+
+void AllocateCBPRays(cbp_rays_t * Rays, const int Capacity) {
+
+    memset(Rays, 0, sizeof(cbp_rays_t));
+    Rays->Capacity = (Capacity > 0 ? Capacity : 1);
+    ResizeCBPRays(Rays);
+
+}
+
+void freeCBPRays(cbp_rays_t * Rays) {
+
+    free(Rays->Agent);
+    free(Rays->AX);
+    free(Rays->AY);
+    free(Rays->BX);
+    free(Rays->BY);
+    free(Rays->X);
+    free(Rays->Y);
+    free(Rays->TargetX);
+    free(Rays->TargetY);
+    free(Rays->StepX);
+    free(Rays->StepY);
+    free(Rays->tMaxX);
+    free(Rays->tMaxY);
+    free(Rays->tDeltaX);
+    free(Rays->tDeltaY);
+    memset(Rays, 0, sizeof(cbp_rays_t));
+
+}
+
+void AddCBPRay(cbp_rays_t * Rays, const int WhichAgent, real_t *CoordsA,
+        real_t *CoordsB) {
+
+    if (Rays->Count == Rays->Capacity) {
+        Rays->Capacity *= 2;
+        ResizeCBPRays(Rays);
+    }
+    Rays->Agent[Rays->Count] = WhichAgent;
+    Rays->AX[Rays->Count] = CoordsA[0];
+    Rays->AY[Rays->Count] = CoordsA[1];
+    Rays->BX[Rays->Count] = CoordsB[0];
+    Rays->BY[Rays->Count] = CoordsB[1];
+    Rays->Count++;
+
+}
+
+/* Grid index of a coordinate, clamped to [-1, N] (i.e. just outside the grid) */
+static inline int GridIndex(const real_t Coord, const real_t Min,
+        const real_t BoxSize, const int N) {
+    return (int) fmin(fmax(floor((Coord - Min) / BoxSize * N), -1.0), N);
+}
+
+void TraverseCBPRays(cbp_ray_batch_t * Batch, cbp_map_t * Map,
+        cbp_rays_t * Rays, const real_t ArenaCenterX,
+        const real_t ArenaCenterY, const real_t ArenaSize) {
+
+    int r;
+    int N = Map->Resolution;
+    real_t MinX = ArenaCenterX - ArenaSize;
+    real_t MinY = ArenaCenterY - ArenaSize;
+    real_t BoxSize = 2 * ArenaSize;
+    real_t VoxelSize = BoxSize / N;
+
+    /* Setting up the traversal of every ray (branch-free, vectorisable) */
+    for (r = 0; r < Rays->Count; r++) {
+        real_t DirX = Rays->BX[r] - Rays->AX[r];
+        real_t DirY = Rays->BY[r] - Rays->AY[r];
+
+        Rays->X[r] = GridIndex(Rays->AX[r], MinX, BoxSize, N);
+        Rays->Y[r] = GridIndex(Rays->AY[r], MinY, BoxSize, N);
+        Rays->TargetX[r] = GridIndex(Rays->BX[r], MinX, BoxSize, N);
+        Rays->TargetY[r] = GridIndex(Rays->BY[r], MinY, BoxSize, N);
+        Rays->StepX[r] = (DirX > 0) - (DirX < 0);
+        Rays->StepY[r] = (DirY > 0) - (DirY < 0);
+
+        /* Parameter of the first crossing of a voxel boundary and the distance between two */
+        Rays->tMaxX[r] = (DirX != 0 ?
+                (MinX + (Rays->X[r] + (DirX > 0)) * VoxelSize - Rays->AX[r]) / DirX : INFINITY);
+        Rays->tMaxY[r] = (DirY != 0 ?
+                (MinY + (Rays->Y[r] + (DirY > 0)) * VoxelSize - Rays->AY[r]) / DirY : INFINITY);
+        Rays->tDeltaX[r] = (DirX != 0 ? VoxelSize / fabs(DirX) : INFINITY);
+        Rays->tDeltaY[r] = (DirY != 0 ? VoxelSize / fabs(DirY) : INFINITY);
+    }
+
+    /* Stepping through the voxels (the cell of the target agent is excluded) */
+    for (r = 0; r < Rays->Count; r++) {
+        int x = Rays->X[r];
+        int y = Rays->Y[r];
+        real_t tMaxX = Rays->tMaxX[r];
+        real_t tMaxY = Rays->tMaxY[r];
+
+        while (x < N && x >= 0 && y < N && y >= 0) {
+            if (x == Rays->TargetX[r] && y == Rays->TargetY[r]) {
+                break;
+            }
+            /* Rows of the map are ordered from north to south */
+            AddCellToCBPRayBatch(Batch, CBPIndex(Map, Rays->Agent[r], x, N - (y + 1)));
+            if (tMaxX < tMaxY) {
+                x += Rays->StepX[r];
+                tMaxX += Rays->tDeltaX[r];
+            } else {
+                y += Rays->StepY[r];
+                tMaxY += Rays->tDeltaY[r];
+            }
+        }
+    }
+
+    Rays->Count = 0;
+
+}
@@ -0,0 +1,140 @@
+//MIT License
+//Copyright (c) 2018 Eotvos Lorand University, Budapest
+
+/* vim:set ts=4 sw=4 sts=4 et: */
+
+/*
+ * Storage and fusion of the cooperative belief map (CBP) of the agents.
+ * Every agent has its own "Resolution x Resolution" occupancy grid; the grids are
+ * stored in one contiguous block, and there is only one live instance of it
+ * (it is not part of the phase timeline).
+ *
+ * Cells hold log-odds values, therefore a measurement is a single addition.
+ * Updates are order-independent, and the fused map of the swarm is simply
+ * the sum of the agents' maps.
+ */
+
+#ifndef CBP_H
+#define CBP_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "precision.h"
+
+/* Log-odds increments of a measurement (1 - free/visited, 0 - occupied) */
+#define CBP_LOGODDS_FREE 0.85f
+#define CBP_LOGODDS_OCCUPIED -0.85f
+/* Log-odds are saturated at this magnitude when converted into probability */
+#define CBP_LOGODDS_MAX 6.0f
+/* Size of the tiles of the fused map (in cells) used for tracking changes */
+#define CBP_TILE_SIZE 16
+
+/* One cell of the map of an agent */
+typedef struct {
+    float LogOdds;              /* log-odds of being free (presence of agents) */
+    float LogOddsObst;          /* log-odds of being free (obstacle measurements) */
+    uint32_t Count;             /* number of presence measurements */
+    uint32_t CountObst;         /* number of obstacle measurements */
+} cbp_cell_t;
+
+/* Maps of all agents and the fused map of the swarm */
+typedef struct {
+    int NumberOfAgents;
+    int Resolution;
+    /* "NumberOfAgents x Resolution x Resolution" cells, row-major */
+    cbp_cell_t *Cells;
+
+    /* Fused map ("Resolution x Resolution"): sum of log-odds of every agent and channel */
+    float *FusedLogOdds;
+    uint32_t *FusedCount;
+    /* Probabilities of the fused map, refreshed in dirty tiles only */
+    float *FusedProbability;
+    /* Tiles changed since the last refresh of "FusedProbability" */
+    int TilesPerRow;
+    unsigned char *DirtyTiles;
+} cbp_map_t;
+
+enum MTYPES_ENUM {
+    MTYPE_OBST,
+    MTYPE_TRAIL
+};
+
+typedef enum MTYPES_ENUM MeasurementType;
+
+/* List of cells (indices into "Cells") collected by ray casting, applied in one pass */
+typedef struct {
+    int Count;
+    int Capacity;
+    size_t *Cells;
+} cbp_ray_batch_t;
+
+/* Rays (segments) to be traversed in the maps of the agents, stored as arrays
+ * so that the setup of the traversal runs in one vectorisable loop */
+typedef struct {
+    int Count;
+    int Capacity;
+    int *Agent;
+    real_t *AX, *AY;
+    real_t *BX, *BY;
+    /* Working arrays of the traversal */
+    int *X, *Y, *TargetX, *TargetY, *StepX, *StepY;
+    real_t *tMaxX, *tMaxY, *tDeltaX, *tDeltaY;
+} cbp_rays_t;
+
+/* Allocating and freeing the maps (every cell is unknown, i.e. p = 0.5) */
+void AllocateCBPMap(cbp_map_t * Map, const int NumberOfAgents,
+        const int Resolution);
+void freeCBPMap(cbp_map_t * Map);
+
+/* Index of cell (x, y) of the map of agent "WhichAgent" (y is the row index) */
+static inline size_t CBPIndex(cbp_map_t * Map, const int WhichAgent,
+        const int x, const int y) {
+    return ((size_t) WhichAgent * Map->Resolution + y) * Map->Resolution + x;
+}
+
+static inline cbp_cell_t *CBPCell(cbp_map_t * Map, const int WhichAgent,
+        const int x, const int y) {
+    return Map->Cells + CBPIndex(Map, WhichAgent, x, y);
+}
+
+/* Probability corresponding to a log-odds value */
+static inline float CBPProbability(const float LogOdds) {
+    float l = fminf(fmaxf(LogOdds, -CBP_LOGODDS_MAX), CBP_LOGODDS_MAX);
+    return 1.0f / (1.0f + expf(-l));
+}
+
+/* Inserting a new measurement (between 0 and 1) into cell (x, y) of agent "WhichAgent" */
+void InsertMeasurementIntoCBP(cbp_map_t * Map, const int WhichAgent,
+        const int x, const int y, const real_t Measurement,
+        const MeasurementType Type);
+
+/* Recalculating probabilities of the fused map in the dirty tiles */
+void RefreshFusedCBP(cbp_map_t * Map);
+
+/* Batches of ray casting results */
+void AllocateCBPRayBatch(cbp_ray_batch_t * Batch, const int Capacity);
+void freeCBPRayBatch(cbp_ray_batch_t * Batch);
+void AddCellToCBPRayBatch(cbp_ray_batch_t * Batch, const size_t Cell);
+
+/* Collecting rays */
+void AllocateCBPRays(cbp_rays_t * Rays, const int Capacity);
+void freeCBPRays(cbp_rays_t * Rays);
+void AddCBPRay(cbp_rays_t * Rays, const int WhichAgent, real_t *CoordsA,
+        real_t *CoordsB);
+
+/* Traversing every collected ray with a DDA (Amanatides-Woo) in the grid of its agent.
+ * Cells crossed by the rays are added to "Batch" and the list of rays is emptied.
+ * The arena is the square of half-size "ArenaSize" around the arena center.
+ */
+void TraverseCBPRays(cbp_ray_batch_t * Batch, cbp_map_t * Map,
+        cbp_rays_t * Rays, const real_t ArenaCenterX,
+        const real_t ArenaCenterY, const real_t ArenaSize);
+
+/* Inserting the same measurement into every cell of the batch, then emptying it */
+void ApplyCBPRayBatch(cbp_map_t * Map, cbp_ray_batch_t * Batch,
+        const real_t Measurement, const MeasurementType Type);
+
+#endif
@@ -25,25 +25,4 @@ double distance (const point_xy*, const point_xy*);
 int    orientation(const point_xy*, const point_xy*, const point_xy*);
 int    compare(const void*, const void*);
 
-typedef struct measurement_bundle {
-    double current;
-    double currentObst;
-    long count;
-    long countObst;
-} measurement_bundle;
-
-measurement_bundle*** allocMeasurementMatrix(int agentCount, int ResolutionX, int ResolutionY, double initValue);
-
-void freeMeasurementMatrix(measurement_bundle ***tmat, int agentCount, int ResolutionX, int ResolutionY);
-
-
-enum MTYPES_ENUM {
-    MTYPE_OBST,
-    MTYPE_TRAIL
-};
-
-typedef enum MTYPES_ENUM MeasurementType;
-
-void insertMeasurementIntoBundle(measurement_bundle ** bundle_mat, int x, int y, double measurement, MeasurementType type);
-
 #endif
@@ -9,6 +9,8 @@
 
 #include "datastructs.h"
 
+_Thread_local unsigned long NumberOfHeapAllocations = 0;
+
 /* Tools for allocating and freeing data structures */
 
 /* Dynamic "boolean" array (1D) */
@@ -16,6 +18,7 @@ bool *BooleanData(int size) {
 
     bool *bools;
     bools = (bool *) calloc(size, sizeof(bool));
+    COUNT_HEAP_ALLOCATIONS(1);
 
     if (bools == NULL) {
         fprintf(stderr, "Boolean vector allocation error!\n");
@@ -31,6 +34,7 @@ int *intData(int size) {
 
     int *ints;
     ints = (int *) calloc(size, sizeof(int));
+    COUNT_HEAP_ALLOCATIONS(1);
 
     if (ints == NULL) {
         fprintf(stderr, "Integer vector allocation error!\n");
@@ -46,6 +50,7 @@ double *doubleVector(int size) {
 
     double *vect;
     vect = (double *) calloc(size, sizeof(double));
+    COUNT_HEAP_ALLOCATIONS(1);
 
     if (vect == NULL) {
         fprintf(stderr, "Vector allocation error!\n");
@@ -62,6 +67,7 @@ double **doubleMatrix(int rows, int cols) {
     double **mat;
 
     mat = (double **) calloc(rows, sizeof(double *));
+    COUNT_HEAP_ALLOCATIONS(rows + 1);
 
     if (mat == NULL) {
         fprintf(stderr, "Matrix allocation error!\n");
@@ -85,21 +91,26 @@ double **doubleMatrix(int rows, int cols) {
 /* Dynamic triple array (3D, depth matrices with rows * cols cells) */ 
 double ***tripleMatrix(int depth, int rows, int cols) {
 
-    double ***tmat = (double ***) calloc(depth, sizeof(double**));
+    if (depth < 0 || rows < 0 || cols < 0) {
+        fprintf(stderr, "Matrix allocation error (negative size)!\n");
+        exit(-1);
+    }
+
+    double ***tmat = (double ***) calloc((size_t) depth, sizeof(double**));
     if (tmat == NULL) {
         fprintf(stderr, "Matrix allocation error!\n");
         exit(-1);
     }
 
     for (int i = 0; i < depth; i++) {
-        tmat[i] = (double **) calloc(cols, sizeof(double*));
+        tmat[i] = (double **) calloc((size_t) cols, sizeof(double*));
         if (tmat[i] == NULL) {
             fprintf(stderr, "Matrix allocation error!\n");
             exit(-1);
         }
 
         for (int j = 0; j < cols; j++) {
-            tmat[i][j] = (double *) calloc(rows, sizeof(double));
+            tmat[i][j] = (double *) calloc((size_t) rows, sizeof(double));
             if (tmat[i][j] == NULL) {
                 fprintf(stderr, "Matrix allocation error!\n");
                 exit(-1);
@@ -113,21 +124,26 @@ double ***tripleMatrix(int depth, int rows, int cols) {
 /* Dynamic int triple array (3D, depth matrices with rows * cols cells) */ 
 int ***tripleIntMatrix(int depth, int rows, int cols) {
 
-    int ***tmat = (int ***) calloc(depth, sizeof(int**));
+    if (depth < 0 || rows < 0 || cols < 0) {
+        fprintf(stderr, "Matrix allocation error (negative size)!\n");
+        exit(-1);
+    }
+
+    int ***tmat = (int ***) calloc((size_t) depth, sizeof(int**));
     if (tmat == NULL) {
         fprintf(stderr, "Matrix allocation error!\n");
         exit(-1);
     }
 
     for (int i = 0; i < depth; i++) {
-        tmat[i] = (int **) calloc(cols, sizeof(int*));
+        tmat[i] = (int **) calloc((size_t) cols, sizeof(int*));
         if (tmat[i] == NULL) {
             fprintf(stderr, "Matrix allocation error!\n");
             exit(-1);
         }
 
         for (int j = 0; j < cols; j++) {
-            tmat[i][j] = (int *) calloc(rows, sizeof(int));
+            tmat[i][j] = (int *) calloc((size_t) rows, sizeof(int));
             if (tmat[i][j] == NULL) {
                 fprintf(stderr, "Matrix allocation error!\n");
                 exit(-1);
@@ -179,6 +195,55 @@ double ***doubleTimeIndexedMatrix(int timesteps, int rows, int cols) {
 
 }
 
+/* Dynamic real_t array (1D, vector) */
+real_t *realVector(int size) {
+
+    real_t *vect;
+    vect = (real_t *) calloc(size, sizeof(real_t));
+    COUNT_HEAP_ALLOCATIONS(1);
+
+    if (vect == NULL) {
+        fprintf(stderr, "Vector allocation error!\n");
+        exit(-1);
+    }
+
+    return vect;
+
+}
+
+/* Dynamic real_t array (2D, matrix with 'rows' rows and 'cols' columns) */
+real_t **realMatrix(int rows, int cols) {
+
+    real_t **mat;
+    int i;
+
+    mat = (real_t **) calloc(rows, sizeof(real_t *));
+    COUNT_HEAP_ALLOCATIONS(rows + 1);
+    if (mat == NULL) {
+        fprintf(stderr, "Matrix allocation error!\n");
+        exit(-1);
+    }
+    for (i = 0; i < rows; i++) {
+        mat[i] = (real_t *) calloc(cols, sizeof(real_t));
+        if (mat[i] == NULL) {
+            fprintf(stderr, "Matrix allocation error!\n");
+            exit(-1);
+        }
+    }
+
+    return mat;
+
+}
+
+void freeRealMatrix(real_t ** Matrix, int rows, int cols) {
+    int i;
+
+    for (i = 0; i < rows; i++) {
+        free(Matrix[i]);
+    }
+    free(Matrix);
+}
+
 /* Free 2D dynamic arrays (matrices) */
 void freeMatrix(double **Matrix, int rows, int cols) {
     int i;
@@ -13,6 +13,8 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include "precision.h"
+
 typedef struct {
 
     double *states;
@@ -20,6 +22,21 @@ typedef struct {
 
 } inner_state_double_t;
 
+/* Number of arrays allocated by the tools below, by the arenas (see
+ * memory_arena.h) and by the arrays of the simulation that grow with
+ * realloc (CBP rays, neighbour lists, mission, statistics). Heap allocations
+ * elsewhere (e.g. in libc or the GUI) are not counted. Counted only in debug
+ * builds, for checking that the steps of the simulation do not allocate.
+ * Every thread has its own counter (the visualization allocates while the
+ * simulation thread is stepping).
+ */
+extern _Thread_local unsigned long NumberOfHeapAllocations;
+#ifdef DEBUG
+#define COUNT_HEAP_ALLOCATIONS(n) (NumberOfHeapAllocations += (n))
+#else
+#define COUNT_HEAP_ALLOCATIONS(n)
+#endif
+
 /* Specific state structures (not position or velocity) */
 
 /* Tools for allocating and freeing data structures */
@@ -46,6 +63,12 @@ double *doubleVector(int size);
  */
 double **doubleMatrix(int rows, int cols);
 
+/* The same allocators for the simulation state (see precision.h)
+ */
+real_t *realVector(int size);
+real_t **realMatrix(int rows, int cols);
+void freeRealMatrix(real_t ** Matrix, int rows, int cols);
+
 /* Dynamic int triple array (3D, depth matrices with rows * cols cells) */ 
 int ***tripleIntMatrix(int depth, int rows, int cols);
 
@@ -9,7 +9,7 @@
 #include "debug_utils.h"
 
 /* Printing out the components of a vector to stdout */
-void PrintVector(double *Vector, const int Dim) {
+void PrintVector(real_t *Vector, const int Dim) {
 
     printf("( ");
 
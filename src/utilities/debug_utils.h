@@ -22,8 +22,8 @@ typedef struct {
 
     /* Sequential number, position and velocity of the actual agent */
     int AgentsSeqNumber;
-    double AgentsRealPosition[3];
-    double AgentsRealVelocity[3];
+    real_t AgentsRealPosition[3];
+    real_t AgentsRealVelocity[3];
 
     /* Real PhaseSpace and Inner States */
     phase_t *RealPhase;
@@ -36,7 +36,7 @@ typedef struct {
 /* Printing out the components of a vector to the console
  * "Dim" is the number of components of the vector "Vector"
  */
-void PrintVector(double *Vector, const int Dim);
+void PrintVector(real_t *Vector, const int Dim);
 
 /* Debug mode utils for detecting segmentation faults */
 void InstallSegfaultHandler();
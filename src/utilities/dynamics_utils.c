@@ -5,27 +5,28 @@
 
 #include "dynamics_utils.h"
 #include "data_struct.h"
+#include "placement.h"
 
-// double LinearLoss = 0.008;
+// real_t LinearLoss = 0.008;
 
 /*
     Tools for manipulating phase space
 */
 
 void AllocatePhase(phase_t * Phase, const int NumberOfAgents,
-        const int NumberOfInnerStates, const int Resolution) {
+        const int NumberOfInnerStates) {
     int i;
 
     Phase->NumberOfAgents = NumberOfAgents;
-    Phase->Coordinates = doubleMatrix(NumberOfAgents, 3);
-    Phase->Velocities = doubleMatrix(NumberOfAgents, 3);
-    Phase->Laplacian = doubleMatrix(NumberOfAgents, NumberOfAgents);
-    Phase->EMA = doubleMatrix(NumberOfAgents, NumberOfAgents);
-    Phase->ReceivedPower = doubleVector(NumberOfAgents);
-    Phase->InnerStates = doubleMatrix(NumberOfAgents, NumberOfInnerStates);
+    Phase->Coordinates = realMatrix(NumberOfAgents, 3);
+    Phase->Velocities = realMatrix(NumberOfAgents, 3);
+    Phase->Laplacian = realMatrix(NumberOfAgents, NumberOfAgents);
+    Phase->EMA = realMatrix(NumberOfAgents, NumberOfAgents);
+    Phase->ReceivedPower = realVector(NumberOfAgents);
+    Phase->InnerStates = realMatrix(NumberOfAgents, NumberOfInnerStates);
     Phase->RealIDs = intData(NumberOfAgents);
     Phase->NumberOfInnerStates = NumberOfInnerStates;
-    Phase->CBP = allocMeasurementMatrix(NumberOfAgents, Resolution, Resolution, 0.5);
+    Phase->CBP = NULL;
 
     /* Initialize RealIDs and ReceivedPower and Laplacian*/
     for (i = 0; i < NumberOfAgents; i++) {
@@ -33,21 +34,20 @@ void AllocatePhase(phase_t * Phase, const int NumberOfAgents,
     }
 }
 
-void freePhase(phase_t * Phase, const int Resolution) {
+void freePhase(phase_t * Phase) {
 
-    freeMatrix(Phase->Coordinates, Phase->NumberOfAgents, 3);
-    freeMatrix(Phase->Velocities, Phase->NumberOfAgents, 3);
-    freeMatrix(Phase->Laplacian, Phase->NumberOfAgents, Phase->NumberOfAgents);
-    freeMatrix(Phase->EMA, Phase->NumberOfAgents, Phase->NumberOfAgents);
-    freeMatrix(Phase->InnerStates, Phase->NumberOfAgents,
+    freeRealMatrix(Phase->Coordinates, Phase->NumberOfAgents, 3);
+    freeRealMatrix(Phase->Velocities, Phase->NumberOfAgents, 3);
+    freeRealMatrix(Phase->Laplacian, Phase->NumberOfAgents, Phase->NumberOfAgents);
+    freeRealMatrix(Phase->EMA, Phase->NumberOfAgents, Phase->NumberOfAgents);
+    freeRealMatrix(Phase->InnerStates, Phase->NumberOfAgents,
             Phase->NumberOfInnerStates);
     free(Phase->RealIDs);
     free(Phase->ReceivedPower);
-    freeMeasurementMatrix(Phase->CBP, Phase->NumberOfAgents, Resolution, Resolution);
 }
 
 /* Inserts the "WhichAgent"th agent's position and velocity into "Phase" */
-void InsertAgentPhase(phase_t * Phase, double *Agent, const int WhichAgent) {
+void InsertAgentPhase(phase_t * Phase, real_t *Agent, const int WhichAgent) {
 
     int i;
     for (i = 0; i < 3; i++) {
@@ -58,7 +58,7 @@ void InsertAgentPhase(phase_t * Phase, double *Agent, const int WhichAgent) {
 }
 
 /* Gets the "WhichAgent"th agent's position and velocity from "Phase" */
-void GetAgentPhase(double *Agent, phase_t * Phase, const int WhichAgent) {
+void GetAgentPhase(real_t *Agent, phase_t * Phase, const int WhichAgent) {
 
     int j;
     for (j = 0; j < 3; j++) {
@@ -69,7 +69,7 @@ void GetAgentPhase(double *Agent, phase_t * Phase, const int WhichAgent) {
 }
 
 /* Gets the "WhichAgent"th agent's velocity from "Phase" */
-void GetAgentsVelocity(double *Velocity, phase_t * Phase, const int WhichAgent) {
+void GetAgentsVelocity(real_t *Velocity, phase_t * Phase, const int WhichAgent) {
 
     int j;
     for (j = 0; j < 3; j++) {
@@ -80,7 +80,7 @@ void GetAgentsVelocity(double *Velocity, phase_t * Phase, const int WhichAgent)
 
 /* Inserts the "WhichAgent"th agent's velocity into "Phase" */
 void
-InsertAgentsVelocity(phase_t * Phase, double *Velocity, const int WhichAgent) {
+InsertAgentsVelocity(phase_t * Phase, real_t *Velocity, const int WhichAgent) {
 
     int j;
     for (j = 0; j < 3; j++) {
@@ -90,7 +90,7 @@ InsertAgentsVelocity(phase_t * Phase, double *Velocity, const int WhichAgent) {
 }
 
 /* Gets the "WhichAgent"th agent's position from "Phase" */
-void GetAgentsCoordinates(double *Coords, phase_t * Phase, const int WhichAgent) {
+void GetAgentsCoordinates(real_t *Coords, phase_t * Phase, const int WhichAgent) {
 
     int j;
     for (j = 0; j < 3; j++) {
@@ -100,9 +100,9 @@ void GetAgentsCoordinates(double *Coords, phase_t * Phase, const int WhichAgent)
 }
 
 /* Gets the "WhichAgent"th agent's extrapolated position from "Phase" */
-void GetAgentsCoordinatesEp(double *Coords, phase_t * Phase,
+void GetAgentsCoordinatesEp(real_t *Coords, phase_t * Phase,
         const int WhichAgent, const double Delay) {
-    double vel[3];
+    real_t vel[3];
     GetAgentsCoordinates(Coords, Phase, WhichAgent);
     // we use linear extrapolation with velocity
     // TODO: calculate acceleration as well for second order extrapolation
@@ -112,7 +112,7 @@ void GetAgentsCoordinatesEp(double *Coords, phase_t * Phase,
 }
 
 /* Inserts the "WhichAgent"th agent's position into "Phase" */
-void InsertAgentsCoordinates(phase_t * Phase, double *Coords,
+void InsertAgentsCoordinates(phase_t * Phase, real_t *Coords,
         const int WhichAgent) {
 
     int j;
@@ -123,13 +123,13 @@ void InsertAgentsCoordinates(phase_t * Phase, double *Coords,
 }
 
 /* Calculates euclidean distance between two agents */
-double DistanceBetweenAgents(phase_t * Phase, const int A1, const int A2,
+real_t DistanceBetweenAgents(phase_t * Phase, const int A1, const int A2,
         const int Dim) {
 
     if ((A1 < Phase->NumberOfAgents) &&
             (A2 < Phase->NumberOfAgents) && (A1 > -1) && (A2 > -1)) {
 
-        static double Dist;
+        static real_t Dist;
         Dist = 0.0;
         int i;
 
@@ -148,13 +148,14 @@ double DistanceBetweenAgents(phase_t * Phase, const int A1, const int A2,
 }
 
 /* Gets centre of mass of the agents with "unit mass" from "Phase" */
-void GetCoM(double *CoMCoord, phase_t * Phase) {
+void GetCoM(real_t *CoMCoord, phase_t * Phase) {
 
     int i, j;
 
     /* Konvektor... :) */
-    double *CacheCoMVector;
+    real_t *CacheCoMVector;
 
+    NullVect(CoMCoord, 3);
     for (j = 0; j < Phase->NumberOfAgents; j++) {
 
         CacheCoMVector = Phase->Coordinates[j];
@@ -177,19 +178,19 @@ void GetCoM(double *CoMCoord, phase_t * Phase) {
 
 /* Gets the number of nearby units */
 int NumberOfNearbyUnits(phase_t * Phase, const int WhichAgent,
-        const double RadiusOfLocalArea) {
+        const real_t RadiusOfLocalArea) {
 
     int i;
 
     static int NumberOfNeighbours;
     NumberOfNeighbours = 0;
 
-    double *Temp1;
+    real_t *Temp1;
     Temp1 = Phase->Coordinates[WhichAgent];
 
     for (i = 0; i < Phase->NumberOfAgents; i++) {
 
-        static double Temp2[3];
+        static real_t Temp2[3];
         GetAgentsCoordinates(Temp2, Phase, i);
         VectDifference(Temp2, Temp2, Temp1);
 
@@ -205,17 +206,17 @@ int NumberOfNearbyUnits(phase_t * Phase, const int WhichAgent,
 
 /* Gets the local centre of mass from the viewpoint of the "WhichAgent"th agent from "Phase"
  * The CoM should be calculated using the positions of the nearby agents */
-void GetLocalCoM(double *CoMCoord, phase_t * Phase, const int WhichAgent,
-        const double RadiusOfLocalArea) {
+void GetLocalCoM(real_t *CoMCoord, phase_t * Phase, const int WhichAgent,
+        const real_t RadiusOfLocalArea) {
 
     NullVect(CoMCoord, 3);
 
     int i, j;
     static int HowManyAgentsNearby;
     HowManyAgentsNearby = 0;
-    static double NeighboursPosition[3];
-    static double ActualAgentsPosition[3];
-    static double DifferenceOfPositions[3];
+    static real_t NeighboursPosition[3];
+    static real_t ActualAgentsPosition[3];
+    static real_t DifferenceOfPositions[3];
 
     GetAgentsCoordinates(ActualAgentsPosition, Phase, WhichAgent);
 
@@ -245,13 +246,13 @@ void GetLocalCoM(double *CoMCoord, phase_t * Phase, const int WhichAgent,
 }
 
 /* Calculates CoM of specific agents */
-void GetAgentSpecificCoM(double *CoMCoord, phase_t * Phase,
+void GetAgentSpecificCoM(real_t *CoMCoord, phase_t * Phase,
         int *ExceptWhichAgents) {
 
     int i, j;
     static int HowManyAgents;
     HowManyAgents = 0;
-    double *CacheVector;
+    real_t *CacheVector;
 
     static bool IsItAnException;
     IsItAnException = false;
@@ -290,7 +291,7 @@ void GetAgentSpecificCoM(double *CoMCoord, phase_t * Phase,
 }
 
 /* Calculates CoM of Neighbourhood */
-void GetNeighbourhoodSpecificCoM(double *CoMCoord, phase_t * Phase,
+void GetNeighbourhoodSpecificCoM(real_t *CoMCoord, phase_t * Phase,
         int SizeNeighbourhood) {
 
     int i, j;
@@ -313,17 +314,17 @@ void GetNeighbourhoodSpecificCoM(double *CoMCoord, phase_t * Phase,
 /* Calculates local CoM.
  * "ExceptWhichAgents" contains and array that determines e.g. target point agents...
  */
-void GetAgentSpecificLocalCoM(double *CoMCoord, phase_t * Phase,
+void GetAgentSpecificLocalCoM(real_t *CoMCoord, phase_t * Phase,
         const int AroundWhichAgent,
-        int *ExceptWhichAgents, const double NeighbourhoodRange) {
+        int *ExceptWhichAgents, const real_t NeighbourhoodRange) {
 
     int i, j;
     static int HowManyAgents;
     HowManyAgents = 0;
 
-    double *ActualAgentsCoordinates;
-    double *NeighboursCoordinates;
-    static double CoordinateDifference[3];
+    real_t *ActualAgentsCoordinates;
+    real_t *NeighboursCoordinates;
+    static real_t CoordinateDifference[3];
     NullVect(CoordinateDifference, 3);
 
     static bool IsItAnException;
@@ -368,10 +369,10 @@ void GetAgentSpecificLocalCoM(double *CoMCoord, phase_t * Phase,
 }
 
 /* Average velocity vector */
-void GetAvgOfVelocity(double *CoMVel, phase_t * Phase) {
+void GetAvgOfVelocity(real_t *CoMVel, phase_t * Phase) {
 
     int i, j;
-    double *CacheVector;
+    real_t *CacheVector;
 
     for (j = 0; j < Phase->NumberOfAgents; j++) {
 
@@ -393,17 +394,17 @@ void GetAvgOfVelocity(double *CoMVel, phase_t * Phase) {
 }
 
 /* Local average velocity vector */
-void GetLocalAverageOfXYVelocity(double *CoMVel, phase_t * Phase,
-        const int WhichAgent, const double AreaRadius) {
+void GetLocalAverageOfXYVelocity(real_t *CoMVel, phase_t * Phase,
+        const int WhichAgent, const real_t AreaRadius) {
 
     int n = 0;
     int i, j;
 
-    double *CacheVelocityVector;
-    double *CacheCoordinateVector;
-    double *CacheActualCoordinateVector;
+    real_t *CacheVelocityVector;
+    real_t *CacheCoordinateVector;
+    real_t *CacheActualCoordinateVector;
     CacheActualCoordinateVector = Phase->Coordinates[WhichAgent];
-    static double CacheDifferenceVector[3];
+    static real_t CacheDifferenceVector[3];
 
     for (j = 0; j < Phase->NumberOfAgents; j++) {
 
@@ -451,21 +452,21 @@ void GetLocalAverageOfXYVelocity(double *CoMVel, phase_t * Phase,
 }
 
 /* Average of tangencial velocity (reference point is "RefPoint", e. g. CoM) in the XY plane */
-void GetAverageOfXYTangentialVelocity(double *OutputLAPVel,
-        phase_t * Phase, double *RefPoint, const int WhichAgent) {
+void GetAverageOfXYTangentialVelocity(real_t *OutputLAPVel,
+        phase_t * Phase, real_t *RefPoint, const int WhichAgent) {
 
     NullVect(OutputLAPVel, 3);
 
-    static double x[3];
+    static real_t x[3];
     GetAgentsCoordinates(x, Phase, WhichAgent);
-    static double v[3];
+    static real_t v[3];
     GetAgentsVelocity(v, Phase, WhichAgent);
 
-    static double ProjectedMagn;
+    static real_t ProjectedMagn;
 
-    static double v_i_LAP[3];
-    static double v_j_LAP[3];
-    static double to_ref[3];
+    static real_t v_i_LAP[3];
+    static real_t v_j_LAP[3];
+    static real_t to_ref[3];
 
     VectDifference(to_ref, x, RefPoint);
 
@@ -496,25 +497,25 @@ void GetAverageOfXYTangentialVelocity(double *OutputLAPVel,
 }
 
 /* Local average of tangencial velocity (reference point is "RefPoint", e. g. CoM) in the XY plane */
-void GetLocalAverageOfXYTangentialVelocity(double *OutputLAPVel,
+void GetLocalAverageOfXYTangentialVelocity(real_t *OutputLAPVel,
         phase_t * Phase,
-        double *RefPoint, const int WhichAgent, const double AreaSize) {
+        real_t *RefPoint, const int WhichAgent, const real_t AreaSize) {
 
     NullVect(OutputLAPVel, 3);
 
     static int n;
     n = 1;
 
-    static double x[3];
+    static real_t x[3];
     GetAgentsCoordinates(x, Phase, WhichAgent);
-    static double v[3];
+    static real_t v[3];
     GetAgentsVelocity(v, Phase, WhichAgent);
 
-    static double ProjectedMagn;
+    static real_t ProjectedMagn;
 
-    static double v_i_LAP[3];
-    static double v_j_LAP[3];
-    static double to_ref[3];
+    static real_t v_i_LAP[3];
+    static real_t v_j_LAP[3];
+    static real_t to_ref[3];
 
     VectDifference(to_ref, x, RefPoint);
 
@@ -529,8 +530,8 @@ void GetLocalAverageOfXYTangentialVelocity(double *OutputLAPVel,
         if (j == WhichAgent)
             continue;
 
-        static double x_neighbour[3];
-        static double DistanceVector[3];
+        static real_t x_neighbour[3];
+        static real_t DistanceVector[3];
 
         GetAgentsCoordinates(x_neighbour, Phase, j);
         VectDifference(DistanceVector, x_neighbour, x);
@@ -554,10 +555,10 @@ void GetLocalAverageOfXYTangentialVelocity(double *OutputLAPVel,
 }
 
 /* Local average of tangencial velocity (reference point is "RefPoint", e. g. CoM) in the XY plane */
-void GetAgentSpecificLocalAverageOfXYTangentialVelocity(double *OutputLAPVel,
+void GetAgentSpecificLocalAverageOfXYTangentialVelocity(real_t *OutputLAPVel,
         phase_t * Phase,
-        double *RefPoint,
-        int *ExceptWhichAgents, const int WhichAgent, const double AreaSize) {
+        real_t *RefPoint,
+        int *ExceptWhichAgents, const int WhichAgent, const real_t AreaSize) {
 
     static bool IsItAnException;
     IsItAnException = false;
@@ -567,16 +568,16 @@ void GetAgentSpecificLocalAverageOfXYTangentialVelocity(double *OutputLAPVel,
     static int n;
     n = 1;
 
-    static double x[3];
+    static real_t x[3];
     GetAgentsCoordinates(x, Phase, WhichAgent);
-    static double v[3];
+    static real_t v[3];
     GetAgentsVelocity(v, Phase, WhichAgent);
 
-    static double ProjectedMagn;
+    static real_t ProjectedMagn;
 
-    static double v_i_LAP[3];
-    static double v_j_LAP[3];
-    static double to_ref[3];
+    static real_t v_i_LAP[3];
+    static real_t v_j_LAP[3];
+    static real_t to_ref[3];
 
     VectDifference(to_ref, x, RefPoint);
 
@@ -591,8 +592,8 @@ void GetAgentSpecificLocalAverageOfXYTangentialVelocity(double *OutputLAPVel,
         if (j == WhichAgent)
             continue;
 
-        static double x_neighbour[3];
-        static double DistanceVector[3];
+        static real_t x_neighbour[3];
+        static real_t DistanceVector[3];
 
         i = 0;
         while (i < Phase->NumberOfAgents && IsItAnException == false) {
@@ -628,26 +629,26 @@ void GetAgentSpecificLocalAverageOfXYTangentialVelocity(double *OutputLAPVel,
 }
 
 /* Local average of tangencial velocity (reference point is "RefPoint", e. g. CoM) */
-void GetLocalAverageOfTangentialVelocity(double *OutputLAPVel,
+void GetLocalAverageOfTangentialVelocity(real_t *OutputLAPVel,
         phase_t * Phase,
-        double *RefPoint,
-        double *Axis, const int WhichAgent, const double AreaSize) {
+        real_t *RefPoint,
+        real_t *Axis, const int WhichAgent, const real_t AreaSize) {
 
     NullVect(OutputLAPVel, 3);
 
     static int n;
     n = 1;
 
-    static double x[3];
+    static real_t x[3];
     GetAgentsCoordinates(x, Phase, WhichAgent);
-    static double v[3];
+    static real_t v[3];
     GetAgentsVelocity(v, Phase, WhichAgent);
 
-    static double ProjectedMagn;
+    static real_t ProjectedMagn;
 
-    static double v_i_LAP[3];
-    static double v_j_LAP[3];
-    static double to_ref[3];
+    static real_t v_i_LAP[3];
+    static real_t v_j_LAP[3];
+    static real_t to_ref[3];
 
     VectDifference(to_ref, x, RefPoint);
 
@@ -662,8 +663,8 @@ void GetLocalAverageOfTangentialVelocity(double *OutputLAPVel,
         if (j == WhichAgent)
             continue;
 
-        static double x_neighbour[3];
-        static double DistanceVector[3];
+        static real_t x_neighbour[3];
+        static real_t DistanceVector[3];
 
         GetAgentsCoordinates(x_neighbour, Phase, j);
         VectDifference(DistanceVector, x_neighbour, x);
@@ -683,12 +684,12 @@ void GetLocalAverageOfTangentialVelocity(double *OutputLAPVel,
 
     FillVect(OutputLAPVel, v_i_LAP[0], v_i_LAP[1], v_i_LAP[2]);
     MultiplicateWithScalar(OutputLAPVel, OutputLAPVel,
-            ProjectedMagn / ((double) n), 3);
+            ProjectedMagn / ((real_t) n), 3);
 
 }
 
 /* Gets the "WhichAgent"th position at the "WhichStep"th timestep from "PhaseData"  */
-void GetAgentsCoordinatesFromTimeLine(double *Coords, phase_t * PhaseData,
+void GetAgentsCoordinatesFromTimeLine(real_t *Coords, phase_t * PhaseData,
         const int WhichAgent, const int WhichStep) {
 
     int j;
@@ -701,7 +702,7 @@ void GetAgentsCoordinatesFromTimeLine(double *Coords, phase_t * PhaseData,
 }
 
 /* Gets the "WhichAgent"th velocity at the "WhichStep"th timestep from "PhaseData"  */
-void GetAgentsVelocityFromTimeLine(double *Velocity, phase_t * PhaseData,
+void GetAgentsVelocityFromTimeLine(real_t *Velocity, phase_t * PhaseData,
         const int WhichAgent, const int WhichStep) {
 
     int j;
@@ -713,9 +714,10 @@ void GetAgentsVelocityFromTimeLine(double *Velocity, phase_t * PhaseData,
 
 }
 
-/* Inserts the actual position, velocity and Laplacian of the agents into "PhaseData" */
+/* Inserts the actual position, velocity and Laplacian of the agents into "PhaseData"
+ * (the CBP is not part of the timeline, it is updated in place) */
 void InsertPhaseToDataLine(phase_t * PhaseData, phase_t * Phase,
-        const int WhichStep, int Resolution) {
+        const int WhichStep) {
 
     int i, j;
     for (j = 0; j < Phase->NumberOfAgents; j++) {
@@ -728,13 +730,6 @@ void InsertPhaseToDataLine(phase_t * PhaseData, phase_t * Phase,
             PhaseData[WhichStep].EMA[j][i] = Phase->EMA[j][i];
         }
     }
-    for (i = 0; i < Phase->NumberOfAgents; i++) {
-        for (j = 0; j < Resolution; j++) {
-            for (int k = 0; k < Resolution; k++) {
-                PhaseData[WhichStep].CBP[i][j][k] = Phase->CBP[i][j][k];
-            }
-        }
-    }
 }
 
 /* Inserting inner states into inner state timeline */
@@ -822,29 +817,31 @@ void Wait(phase_t * PhaseData, const double TimeToWait, const double h) {
 
 void WhereInGrid(phase_t * Phase, const int Resolution, 
         const int WhichAgent,
-        const double ArenaCenterX, 
-        const double ArenaCenterY, 
-        const double ArenaSize) {
+        const real_t ArenaCenterX, 
+        const real_t ArenaCenterY, 
+        const real_t ArenaSize) {
 
         // Get agent's coordinates
-        static double AgentsCoords[3];
+        static real_t AgentsCoords[3];
         for (int k = 0; k < 3; k++) {
             AgentsCoords[k] = Phase->Coordinates[WhichAgent][k];
         }
 
-        double SquareSize = 2 * ArenaSize / Resolution;
+        real_t SquareSize = 2 * ArenaSize / Resolution;
         
         // Compute agent's coordinates in CBP space
-        double x_0 = (AgentsCoords[0] - (ArenaCenterX - ArenaSize));
-        double y_0 = - (AgentsCoords[1] - (ArenaCenterY + ArenaSize)); // TODO check why a minus sign is needed
+        real_t x_0 = (AgentsCoords[0] - (ArenaCenterX - ArenaSize));
+        real_t y_0 = - (AgentsCoords[1] - (ArenaCenterY + ArenaSize)); // TODO check why a minus sign is needed
         int i_x_0 = (int) (x_0 / SquareSize);
         int i_y_0 = (int) (y_0 / SquareSize);
 
         // TODO get GPS's position stdev or compute SNR
-        double SNR = 25;
-        double sigma = 100 * sqrt(10 + 150*150 * pow(10, -SNR/10));
+        real_t SNR = 25;
+        real_t sigma = 100 * sqrt(10 + 150*150 * pow(10, -SNR/10));
 
-        insertMeasurementIntoBundle(Phase->CBP[WhichAgent], i_x_0, i_y_0, 1, MTYPE_TRAIL);
+        if (i_x_0 >= 0 && i_x_0 < Resolution && i_y_0 >= 0 && i_y_0 < Resolution) {
+            InsertMeasurementIntoCBP(Phase->CBP, WhichAgent, i_x_0, i_y_0, 1, MTYPE_TRAIL);
+        }
         for(int xOffset = - 2 * sigma; xOffset < 2 * sigma; xOffset += SquareSize) {
             for(int yOffset = - 2 * sigma; yOffset < 2 * sigma; yOffset += SquareSize) {
 
@@ -855,544 +852,167 @@ void WhereInGrid(phase_t * Phase, const int Resolution,
                 // Avoid out of bounds access when agents are out of the arena
                 if (i_x >= 0 && i_x < Resolution && i_y >= 0 && i_y < Resolution && !(i_x == i_x_0 && i_y == i_y_0)) {
                     // Notify presence of the agent in the cell
-                    insertMeasurementIntoBundle(Phase->CBP[WhichAgent], i_x, i_y, 1, MTYPE_TRAIL);
+                    InsertMeasurementIntoCBP(Phase->CBP, WhichAgent, i_x, i_y, 1, MTYPE_TRAIL);
                 }
             }
         }
 }
 
-/* Randomizing phase of agents (with zero velocities) */
-void RandomizePhase(phase_t * Phase,
-        const double XSize,
-        const double YSize,
-        const double ZSize,
-        const double XCenter,
-        const double YCenter,
-        const double ZCenter,
-        const int fromAgent, const int toAgent, const double RadiusOfCopter) {
-
-    int i, j, StepCount;
-    static int MaxStep;
-    MaxStep = 100 * Phase->NumberOfAgents;
-
-    static double RandomPlaceVector[3];
-    static double ActualAgentsVelocity[3];
-
-    static double AgentjsCoords[3];
-    static double DiffCoords[3];
+/* Placing agents into a region with Poisson-disk sampling
+ * (the seed of the placement is drawn from the global random generator)
+ */
+static void PlaceAgentsIntoRegion(phase_t * Phase,
+        placement_region_t * Region, const int fromAgent, const int toAgent,
+        const real_t MinDistance, real_t *Velocity) {
 
-    static bool isArrangementCorrect;
-    isArrangementCorrect = false;
+    int i;
 
-    for (i = fromAgent; i < toAgent; i++) {
-        FillVect(RandomPlaceVector, 2e22, 2e22, 2e22);
-        InsertAgentsCoordinates(Phase, RandomPlaceVector, i);
-        NullVect(RandomPlaceVector, 3);
-        InsertAgentsVelocity(Phase, RandomPlaceVector, i);
+    if (false == PoissonDiskPlacement(Phase, Region, fromAgent, toAgent,
+                    MinDistance, (unsigned long) rand())) {
+        fprintf(stderr, "Please, increase the initial area sizes!\n");
+        exit(-1);
     }
 
-    NullVect(ActualAgentsVelocity, 3);
-    StepCount = 0;
-
     for (i = fromAgent; i < toAgent; i++) {
-        while (false == isArrangementCorrect) {
-            isArrangementCorrect = true;
-
-            RandomPlaceVector[0] =
-                    randomizeDouble(XCenter - XSize / 2.0,
-                    XCenter + XSize / 2.0);
-            RandomPlaceVector[1] =
-                    randomizeDouble(YCenter - YSize / 2.0,
-                    YCenter + YSize / 2.0);
-            RandomPlaceVector[2] =
-                    randomizeDouble(ZCenter - ZSize / 2.0,
-                    ZCenter + ZSize / 2.0);
+        InsertAgentsVelocity(Phase, Velocity, i);
+    }
 
-            for (j = 0; j < Phase->NumberOfAgents; j++) {
-                /* Skip positions of "unplaced" agents */
-                if (i == j) {
-                    j = toAgent - 1;
-                    continue;
-                };
+}
 
-                GetAgentsCoordinates(AgentjsCoords, Phase, j);
-                VectDifference(DiffCoords, AgentjsCoords, RandomPlaceVector);
-                if (VectAbs(DiffCoords) <= 4 * RadiusOfCopter) {
-                    isArrangementCorrect = false;
-                    break;
-                }
-            }
+/* Randomizing phase of agents (with zero velocities) */
+void RandomizePhase(phase_t * Phase,
+        const real_t XSize,
+        const real_t YSize,
+        const real_t ZSize,
+        const real_t XCenter,
+        const real_t YCenter,
+        const real_t ZCenter,
+        const int fromAgent, const int toAgent, const real_t RadiusOfCopter) {
 
-            StepCount++;
+    static placement_region_t Region;
+    static real_t ActualAgentsVelocity[3];
 
-            if (StepCount > MaxStep) {
-                fprintf(stderr, "Please, increase the initial area sizes!\n");
-                exit(-1);
-            }
-        }
+    NullVect(ActualAgentsVelocity, 3);
+    BoxRegion(&Region, XSize, YSize, ZSize, XCenter, YCenter, ZCenter);
+    PlaceAgentsIntoRegion(Phase, &Region, fromAgent, toAgent,
+            4 * RadiusOfCopter, ActualAgentsVelocity);
 
-        InsertAgentsVelocity(Phase, ActualAgentsVelocity, i);
-        InsertAgentsCoordinates(Phase, RandomPlaceVector, i);
-        isArrangementCorrect = false;
-    }
 }
 
 /* Setting up random positions inside a ring */
-void PlaceAgentsInsideARing(phase_t * Phase, const double SizeOfRing,
+void PlaceAgentsInsideARing(phase_t * Phase, const real_t SizeOfRing,
         const int fromAgent, const int toAgent,
-        const double XCenter, const double YCenter,
-        const double ZCenter, const double ZSize, const double RadiusOfCopter) {
-
-    int i, j, StepCount;
-    static int MaxStep;
-    MaxStep = 100 * Phase->NumberOfAgents;
-
-    static double RandomPlaceVector[3];
-    static double ActualAgentsVelocity[3];
-
-    static double AgentjsCoords[3];
-    static double DiffCoords[3];
-
-    static double temp;
-
-    static bool isArrangementCorrect;
-    isArrangementCorrect = false;
-
-    for (i = fromAgent; i < toAgent; i++) {
+        const real_t XCenter, const real_t YCenter,
+        const real_t ZCenter, const real_t ZSize, const real_t RadiusOfCopter) {
 
-        FillVect(RandomPlaceVector, 2e22, 2e22, 2e22);
-        InsertAgentsCoordinates(Phase, RandomPlaceVector, i);
-        NullVect(RandomPlaceVector, 3);
-        InsertAgentsVelocity(Phase, RandomPlaceVector, i);
+    static placement_region_t Region;
+    static real_t ActualAgentsVelocity[3];
 
-    }
     FillVect(ActualAgentsVelocity, 1000, 3000, 0);
-    //NullVect(ActualAgentsVelocity, 3);
-    StepCount = 0;
-
-    for (i = fromAgent; i < toAgent; i++) {
-
-        while (false == isArrangementCorrect) {
-
-            isArrangementCorrect = true;
-
-            // RandomPlaceVector[0] = randomizeDoubleSeed(0, 2.0 * M_PI, 3*i);
-            // temp = randomizeDoubleSeed(0, SizeOfRing, i + 1);
-            RandomPlaceVector[0] = randomizeDouble(0, 2.0 * M_PI);
-            temp = randomizeDouble(0, SizeOfRing);
-            RandomPlaceVector[1] = YCenter + temp * cos(RandomPlaceVector[0]);
-            RandomPlaceVector[0] = XCenter + temp * sin(RandomPlaceVector[0]);
-            RandomPlaceVector[2] =
-                    randomizeDouble(ZCenter - ZSize / 2.0,
-                    ZCenter + ZSize / 2.0);
-            // RandomPlaceVector[2] =
-            //         randomizeDoubleSeed(ZCenter - ZSize / 2.0,
-            //         ZCenter + ZSize / 2.0, i + 1);
-
-            for (j = 0; j < Phase->NumberOfAgents; j++) {
-
-                /* Skip positions of "unplaced" agents */
-                if (i == j) {
-                    j = toAgent - 1;
-                    continue;
-                };
-
-                GetAgentsCoordinates(AgentjsCoords, Phase, j);
-                VectDifference(DiffCoords, AgentjsCoords, RandomPlaceVector);
-                if (VectAbs(DiffCoords) <= RadiusOfCopter) {
-
-                    isArrangementCorrect = false;
-
-                }
-
-            }
-
-            StepCount++;
-
-            if (StepCount > MaxStep) {
-                fprintf(stderr, "Please, increase the initial area sizes!!\n");
-                exit(-1);
-            }
-
-        }
-
-        InsertAgentsVelocity(Phase, ActualAgentsVelocity, i);
-        InsertAgentsCoordinates(Phase, RandomPlaceVector, i);
-        isArrangementCorrect = false;
-
-    }
+    DiscRegion(&Region, SizeOfRing, ZSize, XCenter, YCenter, ZCenter);
+    PlaceAgentsIntoRegion(Phase, &Region, fromAgent, toAgent,
+            RadiusOfCopter, ActualAgentsVelocity);
 
 }
 
 /* Setting up random positions inside a sphere */
-void PlaceAgentsInsideASphere(phase_t * Phase, const double SizeOfSphere,
+void PlaceAgentsInsideASphere(phase_t * Phase, const real_t SizeOfSphere,
         const int fromAgent, const int toAgent,
-        const double XCenter, const double YCenter,
-        const double ZCenter, const double RadiusOfCopter) {
-
-    int i, j, StepCount;
-    static int MaxStep;
-    MaxStep = 100 * Phase->NumberOfAgents;
+        const real_t XCenter, const real_t YCenter,
+        const real_t ZCenter, const real_t RadiusOfCopter) {
 
-    static double RandomPlaceVector[3];
-    static double ActualAgentsVelocity[3];
-
-    static double AgentjsCoords[3];
-    static double DiffCoords[3];
-
-    static double temp;
-    static double Phi;
-    static double Theta;
-
-    static bool isArrangementCorrect;
-    isArrangementCorrect = false;
-
-    for (i = fromAgent; i < toAgent; i++) {
-
-        FillVect(RandomPlaceVector, 2e22, 2e22, 2e22);
-        InsertAgentsCoordinates(Phase, RandomPlaceVector, i);
-        NullVect(RandomPlaceVector, 3);
-        InsertAgentsVelocity(Phase, RandomPlaceVector, i);
-
-    }
+    static placement_region_t Region;
+    static real_t ActualAgentsVelocity[3];
 
     NullVect(ActualAgentsVelocity, 3);
-    StepCount = 0;
-
-    for (i = fromAgent; i < toAgent; i++) {
-
-        while (false == isArrangementCorrect) {
-
-            isArrangementCorrect = true;
-
-            Phi = randomizeDouble(0, 2.0 * M_PI);
-            Theta = randomizeDouble(0, M_PI);
-            temp = randomizeDouble(0, SizeOfSphere);
-
-            RandomPlaceVector[0] = XCenter + temp * cos(Phi) * sin(Theta);
-            RandomPlaceVector[1] = YCenter + temp * sin(Phi) * sin(Theta);
-            RandomPlaceVector[2] = ZCenter + temp * cos(Theta);
-
-            for (j = 0; j < Phase->NumberOfAgents; j++) {
-
-                /* Skip positions of "unplaced" agents */
-                if (i == j) {
-                    j = toAgent - 1;
-                    continue;
-                }
-
-                GetAgentsCoordinates(AgentjsCoords, Phase, j);
-                VectDifference(DiffCoords, AgentjsCoords, RandomPlaceVector);
-                if (VectAbs(DiffCoords) <= RadiusOfCopter) {
-
-                    isArrangementCorrect = false;
-
-                }
-
-            }
-
-            StepCount++;
-
-            if (StepCount > MaxStep) {
-                fprintf(stderr, "Please, increase the initial area sizes!\n");
-                exit(-1);
-            }
-
-        }
-
-        InsertAgentsVelocity(Phase, ActualAgentsVelocity, i);
-        InsertAgentsCoordinates(Phase, RandomPlaceVector, i);
-        isArrangementCorrect = false;
-
-    }
+    SphereRegion(&Region, SizeOfSphere, XCenter, YCenter, ZCenter);
+    PlaceAgentsIntoRegion(Phase, &Region, fromAgent, toAgent,
+            RadiusOfCopter, ActualAgentsVelocity);
 
 }
 
 /* Setting up random initial conditions on a specific plane given by its normal vector */
 void RandomizePhaseOnPlane(phase_t * Phase,
-        const double XSize,
-        const double YSize,
-        const double XCenter,
-        const double YCenter,
-        const double ZCenter,
-        double *PlaneNormalVect,
-        double *XAxis,
-        const int fromAgent, const int toAgent, const double RadiusOfCopter) {
-
-    static int StepCount;
-    StepCount = 0;
-    static int MaxStep;
-    MaxStep = 100 * Phase->NumberOfAgents;
+        const real_t XSize,
+        const real_t YSize,
+        const real_t XCenter,
+        const real_t YCenter,
+        const real_t ZCenter,
+        real_t *PlaneNormalVect,
+        real_t *XAxis,
+        const int fromAgent, const int toAgent, const real_t RadiusOfCopter) {
+
+    static placement_region_t Region;
+    static real_t ActualAgentsVelocity[3];
 
-    static bool IsArrangementCorrect;
-    IsArrangementCorrect = false;
-
-    /* Equation of this plane is n * (x - x_center) = 0 */
-    static double AgentsCoordinates[3];
-    NullVect(AgentsCoordinates, 3);
-    static double TempCoord[3];
-
-    /* Setting zero initial velocities */
-    static double YAxis[3];
-    VectorialProduct(YAxis, PlaneNormalVect, XAxis);
-
-    int i, j;
-
-    for (i = fromAgent; i < toAgent; i++) {
-
-        while (false == IsArrangementCorrect) {
-
-            IsArrangementCorrect = true;
-
-            /* position = x * XAxis + d * YAxis */
-            static double c, d;
-
-            c = randomizeDouble(-XSize / 2.0, XSize / 2.0);
-            d = randomizeDouble(-YSize / 2.0, YSize / 2.0);
-
-            FillVect(AgentsCoordinates, XCenter + c * XAxis[0] + d * YAxis[0],
-                    YCenter + c * XAxis[1] + d * YAxis[1],
-                    ZCenter + c * XAxis[2] + d * YAxis[2]);
-
-            for (j = 0; j < Phase->NumberOfAgents; j++) {
-
-                if (i == j) {
-                    j = toAgent - 1;
-                    continue;
-                }
-
-                GetAgentsCoordinates(TempCoord, Phase, j);
-                VectDifference(TempCoord, TempCoord, AgentsCoordinates);
-
-                if (VectAbs(TempCoord) <= RadiusOfCopter) {
-                    IsArrangementCorrect = false;
-                }
-
-            }
-
-            StepCount++;
-
-            if (StepCount > MaxStep) {
-                fprintf(stderr, "Please, increase the initial area sizes!\n");
-                exit(-1);
-            }
-
-            InsertAgentsCoordinates(Phase, AgentsCoordinates, i);
-            NullVect(AgentsCoordinates, 3);
-            InsertAgentsVelocity(Phase, AgentsCoordinates, i);
-            IsArrangementCorrect = false;
-        }
-
-    }
+    NullVect(ActualAgentsVelocity, 3);
+    PlaneRegion(&Region, XSize, YSize, XCenter, YCenter, ZCenter,
+            PlaneNormalVect, XAxis);
+    PlaceAgentsIntoRegion(Phase, &Region, fromAgent, toAgent,
+            RadiusOfCopter, ActualAgentsVelocity);
 
 }
 
 /* Placing agents on specific planes (using main XYZ coordinate system) */
 void PlaceAgentsOnXYPlane(phase_t * Phase,
-        const double XSize,
-        const double YSize,
-        const double XCenter,
-        const double YCenter,
-        const double ZCenter,
-        const int fromAgent, const int toAgent, const double RadiusOfCopter) {
-
-    static int StepCount;
-    StepCount = 0;
-    static int MaxStep;
-    MaxStep = 100 * Phase->NumberOfAgents;
-
-    static bool IsArrangementCorrect;
-    IsArrangementCorrect = false;
-
-    static double AgentsCoordinates[3];
-    NullVect(AgentsCoordinates, 3);
-    static double TempCoord[3];
-
-    int i, j;
-
-    for (i = fromAgent; i < toAgent; i++) {
-
-        while (false == IsArrangementCorrect) {
-
-            IsArrangementCorrect = true;
-
-            FillVect(AgentsCoordinates,
-                    XCenter + randomizeDouble(-XSize / 2.0, XSize / 2.0),
-                    YCenter + randomizeDouble(-YSize / 2.0, YSize / 2.0),
-                    ZCenter);
+        const real_t XSize,
+        const real_t YSize,
+        const real_t XCenter,
+        const real_t YCenter,
+        const real_t ZCenter,
+        const int fromAgent, const int toAgent, const real_t RadiusOfCopter) {
 
-            for (j = 0; j < Phase->NumberOfAgents; j++) {
+    static placement_region_t Region;
+    static real_t ActualAgentsVelocity[3];
 
-                if (i == j) {
-                    j = toAgent - 1;
-                    continue;
-                }
-
-                GetAgentsCoordinates(TempCoord, Phase, j);
-                VectDifference(TempCoord, TempCoord, AgentsCoordinates);
-
-                if (VectAbsXY(TempCoord) <= RadiusOfCopter) {
-                    IsArrangementCorrect = false;
-                }
-
-            }
-
-            StepCount++;
-
-            if (StepCount > MaxStep) {
-                fprintf(stderr, "Please, increase the initial area sizes!\n");
-                exit(-1);
-            }
-
-        }
-
-        InsertAgentsCoordinates(Phase, AgentsCoordinates, i);
-        NullVect(AgentsCoordinates, 3);
-        InsertAgentsVelocity(Phase, AgentsCoordinates, i);
-        IsArrangementCorrect = false;
-
-    }
+    NullVect(ActualAgentsVelocity, 3);
+    BoxRegion(&Region, XSize, YSize, 0, XCenter, YCenter, ZCenter);
+    PlaceAgentsIntoRegion(Phase, &Region, fromAgent, toAgent,
+            RadiusOfCopter, ActualAgentsVelocity);
 
 }
 
 void PlaceAgentsOnXZPlane(phase_t * Phase,
-        const double XSize,
-        const double ZSize,
-        const double XCenter,
-        const double YCenter,
-        const double ZCenter,
-        const int fromAgent, const int toAgent, const double RadiusOfCopter) {
-
-    static int StepCount;
-    StepCount = 0;
-    static int MaxStep;
-    MaxStep = 100 * Phase->NumberOfAgents;
-
-    static bool IsArrangementCorrect;
-    IsArrangementCorrect = false;
-
-    static double AgentsCoordinates[3];
-    NullVect(AgentsCoordinates, 3);
-    static double TempCoord[3];
-
-    int i, j;
-
-    for (i = fromAgent; i < toAgent; i++) {
-
-        while (false == IsArrangementCorrect) {
+        const real_t XSize,
+        const real_t ZSize,
+        const real_t XCenter,
+        const real_t YCenter,
+        const real_t ZCenter,
+        const int fromAgent, const int toAgent, const real_t RadiusOfCopter) {
 
-            IsArrangementCorrect = true;
-
-            FillVect(AgentsCoordinates,
-                    XCenter + randomizeDouble(-XSize / 2.0, XSize / 2.0),
-                    YCenter, ZCenter + randomizeDouble(-ZSize / 2.0,
-                            ZSize / 2.0));
+    static placement_region_t Region;
+    static real_t ActualAgentsVelocity[3];
 
-            for (j = 0; j < Phase->NumberOfAgents; j++) {
-
-                if (i == j) {
-                    j = toAgent - 1;
-                    continue;
-                }
-
-                GetAgentsCoordinates(TempCoord, Phase, j);
-                VectDifference(TempCoord, TempCoord, AgentsCoordinates);
-
-                if (VectAbs(TempCoord) <= RadiusOfCopter) {
-                    IsArrangementCorrect = false;
-                }
-
-            }
-
-            StepCount++;
-
-            if (StepCount > MaxStep) {
-                fprintf(stderr, "Please, increase the initial area sizes!\n");
-                exit(-1);
-            }
-
-        }
-
-        InsertAgentsCoordinates(Phase, AgentsCoordinates, i);
-        NullVect(AgentsCoordinates, 3);
-        InsertAgentsVelocity(Phase, AgentsCoordinates, i);
-        IsArrangementCorrect = false;
-
-    }
+    NullVect(ActualAgentsVelocity, 3);
+    BoxRegion(&Region, XSize, 0, ZSize, XCenter, YCenter, ZCenter);
+    PlaceAgentsIntoRegion(Phase, &Region, fromAgent, toAgent,
+            RadiusOfCopter, ActualAgentsVelocity);
 
 }
 
 void PlaceAgentsOnYZPlane(phase_t * Phase,
-        const double YSize,
-        const double ZSize,
-        const double XCenter,
-        const double YCenter,
-        const double ZCenter,
-        const int fromAgent, const int toAgent, const double RadiusOfCopter) {
+        const real_t YSize,
+        const real_t ZSize,
+        const real_t XCenter,
+        const real_t YCenter,
+        const real_t ZCenter,
+        const int fromAgent, const int toAgent, const real_t RadiusOfCopter) {
 
-    static int StepCount;
-    StepCount = 0;
-    static int MaxStep;
-    MaxStep = 100 * Phase->NumberOfAgents;
-
-    static bool IsArrangementCorrect;
-    IsArrangementCorrect = false;
-
-    static double AgentsCoordinates[3];
-    NullVect(AgentsCoordinates, 3);
-    static double TempCoord[3];
-
-    int i, j;
-
-    for (i = fromAgent; i < toAgent; i++) {
-
-        while (false == IsArrangementCorrect) {
-
-            IsArrangementCorrect = true;
-
-            FillVect(AgentsCoordinates, XCenter,
-                    YCenter + randomizeDouble(-YSize / 2.0, YSize / 2.0),
-                    ZCenter + randomizeDouble(-ZSize / 2.0, ZSize / 2.0));
-
-            for (j = 0; j < Phase->NumberOfAgents; j++) {
-
-                if (i == j) {
-                    j = toAgent - 1;
-                    continue;
-                }
+    static placement_region_t Region;
+    static real_t ActualAgentsVelocity[3];
 
-                GetAgentsCoordinates(TempCoord, Phase, j);
-                VectDifference(TempCoord, TempCoord, AgentsCoordinates);
-
-                if (VectAbs(TempCoord) <= RadiusOfCopter) {
-                    IsArrangementCorrect = false;
-                }
-
-            }
-
-            StepCount++;
-
-            if (StepCount > MaxStep) {
-                fprintf(stderr, "Please, increase the initial area sizes!\n");
-                exit(-1);
-            }
-
-        }
-
-        InsertAgentsCoordinates(Phase, AgentsCoordinates, i);
-        NullVect(AgentsCoordinates, 3);
-        InsertAgentsVelocity(Phase, AgentsCoordinates, i);
-        IsArrangementCorrect = false;
-
-    }
+    NullVect(ActualAgentsVelocity, 3);
+    BoxRegion(&Region, 0, YSize, ZSize, XCenter, YCenter, ZCenter);
+    PlaceAgentsIntoRegion(Phase, &Region, fromAgent, toAgent,
+            RadiusOfCopter, ActualAgentsVelocity);
 
 }
 
 /* placing agents onto specific lines */
 void PlaceAgentsOntoALine(phase_t * Phase, const int fromAgent,
-        const int toAgent, double *Tangential, const double XCenter,
-        const double YCenter, const double ZCenter, const double LineLength,
-        const double RadiusOfCopter) {
+        const int toAgent, real_t *Tangential, const real_t XCenter,
+        const real_t YCenter, const real_t ZCenter, const real_t LineLength,
+        const real_t RadiusOfCopter) {
 
     static int StepCount;
     StepCount = 0;
@@ -1402,9 +1022,9 @@ void PlaceAgentsOntoALine(phase_t * Phase, const int fromAgent,
     static bool IsArrangementCorrect;
     IsArrangementCorrect = false;
 
-    static double AgentsCoordinates[3];
+    static real_t AgentsCoordinates[3];
     NullVect(AgentsCoordinates, 3);
-    static double TempCoord[3];
+    static real_t TempCoord[3];
 
     int i, j;
 
@@ -1414,7 +1034,7 @@ void PlaceAgentsOntoALine(phase_t * Phase, const int fromAgent,
 
             IsArrangementCorrect = true;
 
-            static double a;
+            static real_t a;
             a = randomizeDouble(-LineLength / 2.0, LineLength / 2.0);
 
             FillVect(AgentsCoordinates, XCenter + Tangential[0] * a,
@@ -1456,9 +1076,9 @@ void PlaceAgentsOntoALine(phase_t * Phase, const int fromAgent,
 
 /* Setting up random Initial conditions with zero Initial velocity */
 void InitCond(phase_t ** PhaseData,
-        const double InitialSizeX,
-        const double InitialSizeY,
-        const double InitialSizeZ, const double SizeOfCopter) {
+        const real_t InitialSizeX,
+        const real_t InitialSizeY,
+        const real_t InitialSizeZ, const real_t SizeOfCopter) {
 
     RandomizePhase(PhaseData[0], InitialSizeX, InitialSizeY, InitialSizeZ, 0.0,
             0.0, 0.0, 0, PhaseData[0]->NumberOfAgents, SizeOfCopter);
@@ -1468,15 +1088,15 @@ void InitCond(phase_t ** PhaseData,
 /* Counting collisions */
 int HowManyCollisions(phase_t * ActualPhase,
         bool * AgentsInDanger,
-        const bool CountCollisions, const double RadiusOfCopter) {
+        const bool CountCollisions, const real_t RadiusOfCopter) {
 
     int i, j;
     static int Collisions;
     Collisions = 0;
 
-    static double ithAgentsCoordinates[3];
-    static double jthAgentsCoordinates[3];
-    static double RelativeCoordinates[3];
+    static real_t ithAgentsCoordinates[3];
+    static real_t jthAgentsCoordinates[3];
+    static real_t RelativeCoordinates[3];
 
     static bool PreviousSituation;
     PreviousSituation = false;
@@ -1509,19 +1129,21 @@ int HowManyCollisions(phase_t * ActualPhase,
 
 }
 
-int CountCluster(phase_t Phase, bool * Visited, unit_model_params_t * UnitParams) {
+int CountCluster(phase_t Phase, bool * Visited, unit_model_params_t * UnitParams,
+        memory_arena_t * Scratch) {
 
     int i, j, k, incr;
     int NumberOfAgentsInithCluster;
     int NumberOfClusters = 0;
     int Dimension = Phase.NumberOfAgents;
-    double **Adjacency;
+    real_t **Adjacency;
     int Labels[Dimension];
+    const memory_arena_mark_t Mark = ArenaMark(Scratch);
 
-    Adjacency = doubleMatrix(Dimension, Dimension);
-
+    Adjacency = NULL;
 
     if (UnitParams->communication_type.Value == 0) {
+        Adjacency = ArenaRealMatrix(Scratch, Dimension, Dimension);
         ConstructAdjacencyMatrix(Adjacency, &Phase, UnitParams->R_C.Value);
     }
 
@@ -1560,7 +1182,7 @@ int CountCluster(phase_t Phase, bool * Visited, unit_model_params_t * UnitParams
         }
 
         // if (UnitParams->communication_type.Value == 0) {
-        //     freeMatrix(Adjacency, Dimension, Dimension);
+        //     freeRealMatrix(Adjacency, Dimension, Dimension);
         // }
 
         int VisitedIndex[NumberOfAgentsInithCluster];
@@ -1587,19 +1209,19 @@ int CountCluster(phase_t Phase, bool * Visited, unit_model_params_t * UnitParams
 
     }
 
-    freeMatrix(Adjacency, Dimension, Dimension);
+    ArenaRelease(Scratch, Mark);
 
     return NumberOfClusters;
 }
 
 
-void ConstructAdjacencyMatrix(double **OutputAdjacency, phase_t * Phase,
-        const double CommunicationRange) {
+void ConstructAdjacencyMatrix(real_t **OutputAdjacency, phase_t * Phase,
+        const real_t CommunicationRange) {
 
     int i, j;
-    double *AgentsCoordinates;
-    double *NeighboursCoordinates;
-    static double Difference[3];
+    real_t *AgentsCoordinates;
+    real_t *NeighboursCoordinates;
+    static real_t Difference[3];
 
     for (i = 0; i < Phase->NumberOfAgents; i++) {
 
@@ -1624,7 +1246,7 @@ void ConstructAdjacencyMatrix(double **OutputAdjacency, phase_t * Phase,
 
 }
 
-void CreateClusters(const int i, double **InputAdjacency, bool * Visited,
+void CreateClusters(const int i, real_t **InputAdjacency, bool * Visited,
         const int NumberOfAgents, unit_model_params_t * UnitParams) {
 
     int k;
@@ -1651,10 +1273,10 @@ void CreateClusters(const int i, double **InputAdjacency, bool * Visited,
 /* Swaps the states of two agents (ith and jth) */
 void SwapAgents(phase_t * Phase, const int i, const int j, const int TrueAgent) {
 
-    double *temp_pointer;
+    real_t *temp_pointer;
     int id;
-    double power;
-    double ema;
+    real_t power;
+    real_t ema;
 
     /* Positions and velocities */
     temp_pointer = Phase->Coordinates[i];
@@ -1687,13 +1309,13 @@ void SwapAgents(phase_t * Phase, const int i, const int j, const int TrueAgent)
 
 /* Orders agents by distance from a given position */
 /* Warning! Simple insertion sort! */
-void OrderAgentsByDistance(phase_t * Phase, double *ReferencePosition) {
+void OrderAgentsByDistance(phase_t * Phase, real_t *ReferencePosition) {
 
-    static double DistFromRef[3];
+    static real_t DistFromRef[3];
     NullVect(DistFromRef, 3);
 
-    static double Dist1;
-    static double Dist2;
+    static real_t Dist1;
+    static real_t Dist2;
     Dist1 = 2e222;
     Dist2 = 2e222;
 
@@ -1734,8 +1356,8 @@ void OrderAgentsByDistance(phase_t * Phase, double *ReferencePosition) {
 /* Warning! Simple insertion sort! */
 void OrderAgentsByPower(phase_t * Phase, int SizeToSort, int WhichAgent) {
 
-    static double RP1;
-    static double RP2;
+    static real_t RP1;
+    static real_t RP2;
 
     int i, j;
 
@@ -1763,15 +1385,15 @@ void OrderAgentsByPower(phase_t * Phase, int SizeToSort, int WhichAgent) {
 
 /* Packing of nearby agents to the first blocks of the phase space */
 int SelectNearbyVisibleAgents(phase_t * Phase,
-        double *ReferencePosition,
-        double Range, double power_thresh, int communication_mode, 
-        const int TrueAgent, const double packet_loss) {
+        real_t *ReferencePosition,
+        real_t Range, real_t power_thresh, int communication_mode, 
+        const int TrueAgent, const real_t packet_loss) {
 
-    static double DistFromRef[3];
+    static real_t DistFromRef[3];
     NullVect(DistFromRef, 3);
 
-    static double Dist = 0.0;
-    static double Pow;
+    static real_t Dist = 0.0;
+    static real_t Pow;
     bool packet_loss_rand;
     int i;
     int NumberOfNearbyAgents = 1;
@@ -1832,44 +1454,43 @@ int SelectNearbyVisibleAgents(phase_t * Phase,
 
 /* Calculate the received power of an agent depending on which method is used */
 /* The log-distance with varying alpha is chosen here and we have a reference distance */
-double ReceivedPowerLog(double * RefCoords, double * NeighbourCoords,
+real_t ReceivedPowerLog(real_t * RefCoords, real_t * NeighbourCoords,
                     obstacles_t obstacles, 
-                    double **Polygons,
+                    real_t **Polygons,
                     unit_model_params_t * UnitParams,
-                    const double Dist) {
+                    const real_t Dist) {
         
         int j;
-        double Power;
+        real_t Power;
         // bool StopScan = false;
 
+        RefreshPathLoss(&PathLoss, UnitParams);
+
         if (UnitParams->communication_type.Value == 2) {
-            static double dist_obst;
-            static double Loss;
+            static real_t dist_obst;
+            static real_t Loss;
             for (j = 0; j < obstacles.o_count; j++){  // very slow if the number of obstacles is  high
 
-                double CenterObst[3];
+                real_t CenterObst[3];
                 CenterObst[0] = obstacles.o[j].center[0];
                 CenterObst[1] = obstacles.o[j].center[1];
                 CenterObst[2] = 0;
 
                 if (obstacles.o_count > 70) {
-                    double DistObs;
+                    real_t DistObs;
                     DistObs = DistanceOfTwoPoints2D(RefCoords, CenterObst);
                     if (DistObs > 25000){
                         continue;
                     }
                 }
 
-                double **Intersections;
-                Intersections = doubleMatrix(2, 3);
-                // Intersections = malloc(sizeof(double *) * 2);
-                // Intersections[0] = malloc(sizeof(double) * 3);
-                // Intersections[1] = malloc(sizeof(double) * 3);
+                static real_t IntersectionPoints[2][3];
+                real_t *Intersections[2] = { IntersectionPoints[0], IntersectionPoints[1] };
                 
                 int NumberOfIntersections;
-                // double dist_obst;
-                // double Loss;
-                static double DistanceThrough[3];
+                // real_t dist_obst;
+                // real_t Loss;
+                static real_t DistanceThrough[3];
 
                 NumberOfIntersections = IntersectionOfSegmentAndPolygon2D(Intersections,
                 RefCoords, NeighbourCoords, Polygons[j], obstacles.o[j].p_count);
@@ -1877,7 +1498,7 @@ double ReceivedPowerLog(double * RefCoords, double * NeighbourCoords,
                 if (NumberOfIntersections == 2) {
                         VectDifference(DistanceThrough, Intersections[0], Intersections[1]);
                         dist_obst = VectAbs(DistanceThrough);
-                        Loss = 40 * log10(dist_obst);
+                        Loss = PathLossOfObstacle(dist_obst);
                         break;
                 }
                 else {
@@ -1885,150 +1506,28 @@ double ReceivedPowerLog(double * RefCoords, double * NeighbourCoords,
                     Loss = 0;
                 }
                 // printf("%f\n", UnitParams->transmit_power.Value);
-                freeMatrix(Intersections, 2, 3);
-            }
-            if (Dist < UnitParams->ref_distance.Value) {  // Remember that all measured distances are in cm so Ref_dist should be in cm too
-            Power = UnitParams->transmit_power.Value - (10 * UnitParams->alpha.Value * 
-                log10((UnitParams->ref_distance.Value - dist_obst) * 0.01 * UnitParams->freq.Value) + 32.44 + Loss + randomizeGaussDouble(0, 2));
-            // printf("%f\n", Power);
-            }
-            else
-            {
-                Power = UnitParams->transmit_power.Value - (10 * UnitParams->alpha.Value * 
-                    log10((Dist - dist_obst) * 0.01 * UnitParams->freq.Value) + 32.44 + Loss + randomizeGaussDouble(0, 2)); // c en m.GHz, dist in meters, freq in GHz (see Friis model)
             }
+            Power = PathLossPower(&PathLoss, Dist, dist_obst, Loss) -
+                    randomizeGaussDouble(0, PATH_LOSS_SHADOWING_STDEV);
         }
         else {
-            if (Dist < UnitParams->ref_distance.Value) {  // Remember that all measured distances are in cm so Ref_dist should be in cm too
-                Power = UnitParams->transmit_power.Value - (10 * UnitParams->alpha.Value * 
-                    log10(UnitParams->ref_distance.Value * 0.01 * UnitParams->freq.Value) + 32.44 + randomizeGaussDouble(0, 2));
-            }
-            else
-            {
-                Power = UnitParams->transmit_power.Value - (10 * UnitParams->alpha.Value * 
-                    log10(Dist * 0.01 * UnitParams->freq.Value) + 32.44 + randomizeGaussDouble(0, 2)); // c en m.GHz, dist in meters, freq in GHz (see Friis model)
-            }
+            Power = PathLossPower(&PathLoss, Dist, 0, 0) -
+                    randomizeGaussDouble(0, PATH_LOSS_SHADOWING_STDEV);
         }
         return Power;
 }
 
-double DegradedPower(double Dist, double DistObst, double Loss, unit_model_params_t * UnitParams) {
-    
-    double Power = 0;
-    if (UnitParams->communication_type.Value == 2) {
-        if (Dist < UnitParams->ref_distance.Value) {  // Remember that all measured distances are in cm so Ref_dist should be in cm too
-            Power = UnitParams->transmit_power.Value - (10 * UnitParams->alpha.Value * 
-                log10((UnitParams->ref_distance.Value - DistObst) * 0.01 * UnitParams->freq.Value) + 32.44 + Loss + randomizeGaussDouble(0, 2));
-            }
-            else
-            {
-                Power = UnitParams->transmit_power.Value - (10 * UnitParams->alpha.Value * 
-                    log10((Dist - DistObst) * 0.01 * UnitParams->freq.Value) + 32.44 + Loss + randomizeGaussDouble(0, 2)); // c en m.GHz, dist in meters, freq in GHz (see Friis model)
-            }
-    }
-    else {
-            if (Dist < UnitParams->ref_distance.Value) {  // Remember that all measured distances are in cm so Ref_dist should be in cm too
-                Power = UnitParams->transmit_power.Value - (10 * UnitParams->alpha.Value * 
-                    log10(UnitParams->ref_distance.Value * 0.01 * UnitParams->freq.Value) + 32.44 + randomizeGaussDouble(0, 2));
-            }
-            else
-            {
-                Power = UnitParams->transmit_power.Value - (10 * UnitParams->alpha.Value * 
-                    log10(Dist * 0.01 * UnitParams->freq.Value) + 32.44 + randomizeGaussDouble(0, 2)); // c en m.GHz, dist in meters, freq in GHz (see Friis model)
-            }
-    }
-        return Power;
-}
-
-void FastVoxelTraversal(phase_t *Phase, double *CoordsA, double *CoordsB, int WhichAgent,
-                        double ArenaCenterX, double ArenaCenterY, double ArenaSize, int Resolution) {
-
-    int gridN = Resolution;
-
-    double gridMinBoundaries[2] = {ArenaCenterX - ArenaSize, ArenaCenterY - ArenaSize};
-    double gridMaxBoundaries[2] = {ArenaCenterX + ArenaSize, ArenaCenterY + ArenaSize};
-
-    double boxSize[2];
-    VectDifference2D(boxSize, gridMaxBoundaries, gridMinBoundaries);
-
-    double x = floor( ((CoordsA[0] - gridMinBoundaries[0]) / boxSize[0]) * gridN);
-    double y = floor( ((CoordsA[1] - gridMinBoundaries[1]) / boxSize[1]) * gridN);
+/* Received power with the path loss model (see pathloss.h) and Gaussian shadowing */
+real_t DegradedPower(real_t Dist, real_t DistObst, real_t Loss, unit_model_params_t * UnitParams) {
 
-    double TargetX = floor( ((CoordsB[0] - gridMinBoundaries[0]) / boxSize[0]) * gridN);
-    double TargetY = floor( ((CoordsB[1] - gridMinBoundaries[1]) / boxSize[1]) * gridN);
+    RefreshPathLoss(&PathLoss, UnitParams);
 
-    double AB[2];
-    VectDifference2D(AB, CoordsB, CoordsA);
-    double dirX = AB[0];
-    double dirY = AB[1];
-
-    int StepX, StepY;
-    double tVoxelX, tVoxelY;
-
-    if (dirX > 0) {
-        tVoxelX = (x + 1) / gridN;
-        StepX = 1;
-    }
-    else if (dirX < 0) {
-        tVoxelX = x / gridN;
-        StepX = -1;
-    }
-    else {
-        tVoxelX = 0;
-        StepX = 0;
-    }
-    if (dirY > 0) {
-        tVoxelY = (y + 1) / gridN;
-        StepY = 1;
-    }
-    else if (dirY < 0) {
-        tVoxelY = y / gridN;
-        StepY = -1;
+    /* Obstacles attenuate only in the model with obstacles */
+    if (UnitParams->communication_type.Value != 2) {
+        DistObst = 0;
+        Loss = 0;
     }
-    else {
-        tVoxelY = 0;
-        StepY = 0;
-    }
-
-    double VoxelMaxX, VoxelMaxY;
-    VoxelMaxX = gridMinBoundaries[0] + tVoxelX * boxSize[0];
-    VoxelMaxY = gridMinBoundaries[1] + tVoxelY * boxSize[1];
-
-    double tMaxX, tMaxY;
-    tMaxX = (VoxelMaxX - CoordsA[0]) / dirX;
-    tMaxY = (VoxelMaxY - CoordsA[1]) / dirY;
-
-    double VoxelSizeX, VoxelSizeY;
-    VoxelSizeX = boxSize[0] / gridN;
-    VoxelSizeY = boxSize[1] / gridN;
-
-    double tDeltaX, tDeltaY;
-    tDeltaX = VoxelSizeX / fabs(dirX);
-    tDeltaY = VoxelSizeY / fabs(dirY);
 
-    int cnt = 0;
-    // printf("\t\t%f\t%f\n", TargetX, TargetY);
-
-    while ( (x < gridN) && (x >= 0) && (y < gridN) && (y >= 0) ) {
-
-        if (x == TargetX && y == TargetY) { /* printf("break condition\n"); */ break; }
-        
-        int i_y = Resolution - ((int) y + 1);
-        int i_x = (int) x;
-        if (Phase->CBP[WhichAgent][i_y][i_x].current > -1 ) {
-            insertMeasurementIntoBundle(Phase->CBP[WhichAgent], i_x, i_y, 0, MTYPE_OBST);
-        }
-        // printf("%f\t%f\n", x, y);
-
-
-        if (tMaxX < tMaxY) {
-            x = x + StepX;
-            tMaxX = tMaxX + tDeltaX;
-        }
-        else {
-            y = y + StepY;
-            tMaxY = tMaxY + tDeltaY;
-        }
-        cnt += 2;
-    }
-}
\ No newline at end of file
+    return PathLossPower(&PathLoss, Dist, DistObst, Loss) -
+            randomizeGaussDouble(0, PATH_LOSS_SHADOWING_STDEV);
+}
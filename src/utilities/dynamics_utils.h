@@ -14,6 +14,9 @@
 #include "math_utils.h"
 #include "param_utils.h"
 #include "obstacles.h"
+#include "cbp.h"
+#include "pathloss.h"
+#include "memory_arena.h"
 
 /* Array that containts noise boolean variable
  * If Noise[i] is "false", then no output noise will be added to its acceleration
@@ -31,75 +34,76 @@ bool *Noises;
 /* Struct that contains every agents' coordinates, velocities
  * and inner states
  *
- * Note that innner states are always double variables and
+ * Note that innner states are always real_t variables (see precision.h) and
  * the number of them is determined by the "NumberOfInnerStates" variable
  *
  */
 typedef struct {
 
-    double **Coordinates;
-    double **Velocities;
-    double **InnerStates;
-    double **Laplacian;
-    double **EMA;
-    double *ReceivedPower;
+    real_t **Coordinates;
+    real_t **Velocities;
+    real_t **InnerStates;
+    real_t **Laplacian;
+    real_t **EMA;
+    real_t *ReceivedPower;
     int *RealIDs;
     int NumberOfInnerStates;
     int NumberOfAgents;
-    measurement_bundle ***CBP; 
+    /* Cooperative belief map (only the actual phase points to the live instance) */
+    cbp_map_t *CBP;
 } phase_t;
 
 /* Simple tools for allocating phase space and cleaning memory
  */
 void AllocatePhase(phase_t * Phase, const int NumberOfAgents,
-        const int NumberOfInnerStates, const int Resolution);
+        const int NumberOfInnerStates);
         
-void freePhase(phase_t * Phase, const int Resolution);
+void freePhase(phase_t * Phase);
 
 /* Insert specific agent's coordinates and velocity (denoted by "Agent") into
  * an existing phase space denoted by "Phase".
  * "WhichAgent" denotes the ID number of the agent.
  */
-void InsertAgentPhase(phase_t * Phase, double *Agent, const int WhichAgent);
+void InsertAgentPhase(phase_t * Phase, real_t *Agent, const int WhichAgent);
 
 /* Get specific agent's coordinates and velocity (denoted by "Agent") from
  * an existing phase space denoted by "Phase".
  * "WhichAgent" denotes the ID number of the agent.
  */
-void GetAgentPhase(double *Agent, phase_t * Phase, const int WhichAgent);
+void GetAgentPhase(real_t *Agent, phase_t * Phase, const int WhichAgent);
 
 /* Get specific agent's velocity vector (denoted by "Velocity") from
  * an existing phase space denoted by "Phase".
  * "WhichAgent" denotes the ID number of the agent.
  */
-void GetAgentsVelocity(double *Velocity, phase_t * Phase, const int WhichAgent);
+void GetAgentsVelocity(real_t *Velocity, phase_t * Phase, const int WhichAgent);
 
 /* Insert specific agent's velocity vector (denoted by "Velocity") into
  * an existing phase space denoted by "Phase".
  * "WhichAgent" denotes the ID number of the agent.
  */
-void InsertAgentsVelocity(phase_t * Phase, double *Velocity,
+void InsertAgentsVelocity(phase_t * Phase, real_t *Velocity,
         const int WhichAgent);
 
 /* Get specific agent's coordinate vector (denoted by "Coords") from
  * an existing phase space denoted by "Phase".
  * "WhichAgent" denotes the ID number of the agent.
  */
-void GetAgentsCoordinates(double *Coords, phase_t * Phase,
+void GetAgentsCoordinates(real_t *Coords, phase_t * Phase,
         const int WhichAgent);
 
 /* Get specific agent's extrapolated coordinate vector (denoted by "Coords") from
  * an existing phase space denoted by "Phase", the Delay time and velocity
  * "WhichAgent" denotes the ID number of the agent.
  */
-void GetAgentsCoordinatesEp(double *Coords, phase_t * Phase,
+void GetAgentsCoordinatesEp(real_t *Coords, phase_t * Phase,
         const int WhichAgent, const double Delay);
 
  /* Insert specific agent's coordinate vector (denoted by "Coords") into
   * an existing phase space denoted by "Phase".
   * "WhichAgent" denotes the ID number of the agent.
   */
-void InsertAgentsCoordinates(phase_t * Phase, double *Coords,
+void InsertAgentsCoordinates(phase_t * Phase, real_t *Coords,
         const int WhichAgent);
 
 /* Calculate number of agents that are closer than "RadiusOfLocalArea" to a specific agent
@@ -107,27 +111,28 @@ void InsertAgentsCoordinates(phase_t * Phase, double *Coords,
  * With "Phase", the actual phase space is denoted.
  */
 int NumberOfNearbyUnits(phase_t * Phase, const int WhichAgent,
-        const double RadiusOfLocalArea);
+        const real_t RadiusOfLocalArea);
 
 /* Calculates euclidean distance between two agents denoted by their ID number ("A1" and "A2")
  * "Dim" determines the number of spatial dimensions (can be 2 or 3)
  * With "Phase", the actual phase space is denoted.
  */
-double DistanceBetweenAgents(phase_t * Phase, const int A1, const int A2,
+real_t DistanceBetweenAgents(phase_t * Phase, const int A1, const int A2,
         const int Dim);
 
 /* Gets global centre of mass (CoM) from a phase space "Phase"
- * CoM coordinates will be placed into "CoMCoord" vector.
+ * CoM coordinates will be placed into "CoMCoord" vector (its previous content
+ * is overwritten).
  */
-void GetCoM(double *CoMCoord, phase_t * Phase);
+void GetCoM(real_t *CoMCoord, phase_t * Phase);
 
 /* Gets local centre of mass (CoM) from a phase space ("Phase")
  * from a viewpoint of a specific agent denoted by its ID number ("WhichAgent")
  * Vision range of an agent is defined as "RadiusOfLocalArea".
  * CoM coordinates will be placed into "CoMCoord" vector.
  */
-void GetLocalCoM(double *CoMCoord, phase_t * Phase, const int WhichAgent,
-        const double RadiusOfLocalArea);
+void GetLocalCoM(real_t *CoMCoord, phase_t * Phase, const int WhichAgent,
+        const real_t RadiusOfLocalArea);
 
 /* Calculating CoM for specific agents
  *
@@ -136,11 +141,11 @@ void GetLocalCoM(double *CoMCoord, phase_t * Phase, const int WhichAgent,
  * "ExceptWhichAgents" is a set of ID numbers (this agents will not be taken into account)
  *
  */
-void GetAgentSpecificCoM(double *CoMCoord, phase_t * Phase,
+void GetAgentSpecificCoM(real_t *CoMCoord, phase_t * Phase,
         int *ExceptWhichAgents);
 
 /* Calculates CoM of Neighbourhood */
-void GetNeighbourhoodSpecificCoM(double *CoMCoord, phase_t * Phase,
+void GetNeighbourhoodSpecificCoM(real_t *CoMCoord, phase_t * Phase,
         int SizeNeighbourhood);
 
 /* Calculating local CoM for specific agents
@@ -152,27 +157,27 @@ void GetNeighbourhoodSpecificCoM(double *CoMCoord, phase_t * Phase,
  * "NeighbourhoodRange" defines the vision range of "AroundWhichAgent"th agent.
  *
  */
-void GetAgentSpecificLocalCoM(double *CoMCoord, phase_t * Phase,
+void GetAgentSpecificLocalCoM(real_t *CoMCoord, phase_t * Phase,
         const int AroundWhichAgent,
-        int *ExceptWhichAgents, const double NeighbourhoodRange);
+        int *ExceptWhichAgents, const real_t NeighbourhoodRange);
 
 /* Calculates average velocity vector and place it into the "CoMVel" vector.
  * "Phase" is the actual phase space.
  */
-void GetAvgOfVelocity(double *CoMVel, phase_t * Phase);
+void GetAvgOfVelocity(real_t *CoMVel, phase_t * Phase);
 
 /* Calculates local average XY velocity vector
  * from the viewpoint of the "WhichAgent"th unit and place it into the "CoMVel" vector.
  * "Phase" is the actual phase space, "AreaRadius" is the vision range of the "WhichAgent"th agent.
  */
-void GetLocalAverageOfXYVelocity(double *CoMVel, phase_t * Phase,
-        const int WhichAgent, const double AreaRadius);
+void GetLocalAverageOfXYVelocity(real_t *CoMVel, phase_t * Phase,
+        const int WhichAgent, const real_t AreaRadius);
 
 /* Get average of tangential velocities around a centre point denoted by "RefPoint".
  * Final output velocity will be placed in "OutputLAPVel".
  */
-void GetAverageOfXYTangentialVelocity(double *OutputLAPVel, phase_t * Phase,
-        double *RefPoint, const int WhichAgent);
+void GetAverageOfXYTangentialVelocity(real_t *OutputLAPVel, phase_t * Phase,
+        real_t *RefPoint, const int WhichAgent);
 
 /* Get local average of tangential velocities from the viewpoint of the "WhichAgent"th agent,
  * around a centre point denoted by "RefPoint"
@@ -180,9 +185,9 @@ void GetAverageOfXYTangentialVelocity(double *OutputLAPVel, phase_t * Phase,
  * "AreaSize" denotes the vision range of the agent.
  * Final output velocity will be placed in "OutputLAPVel".
  */
-void GetLocalAverageOfXYTangentialVelocity(double *OutputLAPVel,
-        phase_t * Phase, double *RefPoint,
-        const int WhichAgent, const double AreaSize);
+void GetLocalAverageOfXYTangentialVelocity(real_t *OutputLAPVel,
+        phase_t * Phase, real_t *RefPoint,
+        const int WhichAgent, const real_t AreaSize);
 
 /* Get local average of tangential velocities from the viewpoint of the "WhichAgent"th agent,
  * around a centre point denoted by "RefPoint"
@@ -191,38 +196,38 @@ void GetLocalAverageOfXYTangentialVelocity(double *OutputLAPVel,
  * "AreaSize" denotes the vision range of the agent.
  * Final output velocity will be placed in "OutputLAPVel".
  */
-void GetAgentSpecificLocalAverageOfXYTangentialVelocity(double *OutputLAPVel,
-        phase_t * Phase, double *RefPoint, int
-        *ExceptWhichAgents, const int WhichAgent, const double AreaSize);
+void GetAgentSpecificLocalAverageOfXYTangentialVelocity(real_t *OutputLAPVel,
+        phase_t * Phase, real_t *RefPoint, int
+        *ExceptWhichAgents, const int WhichAgent, const real_t AreaSize);
 
 /* Get local average of tangential velocity on a specific plane.
  * The meaning of the other variables are the same as presented above.
  *
  * This plane is defined by its normal vector, "Axis"
  */
-void GetLocalAverageOfTangentialVelocity(double *OutputLAPVel,
+void GetLocalAverageOfTangentialVelocity(real_t *OutputLAPVel,
         phase_t * Phase,
-        double *RefPoint,
-        double *Axis, const int WhichAgent, const double AreaSize);
+        real_t *RefPoint,
+        real_t *Axis, const int WhichAgent, const real_t AreaSize);
 
 /* Get coordinates from a timeline (timeline means a set of phase spaces)
  * "WhichStep" defines the timestep, "WhichAgents" is the ID number of the specific agent,
  * "PhaseData" is the timeline and "Coords" is the output position vector.
  */
-void GetAgentsCoordinatesFromTimeLine(double *Coords, phase_t * PhaseData,
+void GetAgentsCoordinatesFromTimeLine(real_t *Coords, phase_t * PhaseData,
         const int WhichAgent, const int WhichStep);
 
 /* Get velocity vector from a timeline (timeline means a set of phase spaces)
  * "WhichStep" defines the timestep, "WhichAgents" is the ID number of the specific agent,
  * "PhaseData" is the timeline and "Coords" is the output position vector.
  */
-void GetAgentsVelocityFromTimeLine(double *Velocity, phase_t * PhaseData,
+void GetAgentsVelocityFromTimeLine(real_t *Velocity, phase_t * PhaseData,
         const int WhichAgent, const int WhichStep);
 
 /* Inserting positions and velocities into timeline
  */
 void InsertPhaseToDataLine(phase_t * PhaseData, phase_t * Phase,
-        const int WhichStep, int Resolution);
+        const int WhichStep);
 
 /* Inserting inner states into inner state timeline
  */
@@ -242,9 +247,9 @@ void ShiftInnerStateDataLine(phase_t * PhaseData, const int HowManyRows,
 /* Setting up random Initial conditions (with zero velocities and randomly distributed positions.)
  */
 void InitCond(phase_t ** PhaseData,
-        const double InitialSizeX,
-        const double InitialSizeY,
-        const double InitialSizeZ, const double SizeOfCopter);
+        const real_t InitialSizeX,
+        const real_t InitialSizeY,
+        const real_t InitialSizeZ, const real_t SizeOfCopter);
 
 /* Waiting - filling up timelines with initial conditions */
 void Wait(phase_t * PhaseData, const double TimeToWait, const double h);
@@ -252,86 +257,91 @@ void Wait(phase_t * PhaseData, const double TimeToWait, const double h);
 /* Figure out where we are in the grid for the CBP */
 void WhereInGrid(phase_t * Phase, const int Resolution, 
         const int WhichAgent,
-        const double ArenaCenterX, 
-        const double ArenaCenterY, 
-        const double ArenaSize);
+        const real_t ArenaCenterX, 
+        const real_t ArenaCenterY, 
+        const real_t ArenaSize);
 
 /* Setting up random conditions (with zero velocities)
+ * The agents are placed with Poisson-disk sampling (see placement.h),
+ * the seed of the placement is drawn from the global random generator.
  */
-void RandomizePhase(phase_t * Phase, const double XSize, const double YSize,
-        const double ZSize, const double XCenter,
-        const double YCenter, const double ZCenter,
-        const int fromAgent, const int toAgent, const double RadiusOfCopter);
+void RandomizePhase(phase_t * Phase, const real_t XSize, const real_t YSize,
+        const real_t ZSize, const real_t XCenter,
+        const real_t YCenter, const real_t ZCenter,
+        const int fromAgent, const int toAgent, const real_t RadiusOfCopter);
 
 /* Setting up random conditions inside a ring (with zero velocities)
  */
-void PlaceAgentsInsideARing(phase_t * Phase, const double SizeOfRing,
+void PlaceAgentsInsideARing(phase_t * Phase, const real_t SizeOfRing,
         const int fromAgent, const int toAgent,
-        const double XCenter, const double YCenter,
-        const double ZCenter, const double ZSize, const double RadiusOfCopter);
+        const real_t XCenter, const real_t YCenter,
+        const real_t ZCenter, const real_t ZSize, const real_t RadiusOfCopter);
 
 /* Setting up random positions inside a sphere
  */
-void PlaceAgentsInsideASphere(phase_t * Phase, const double SizeOfSphere,
+void PlaceAgentsInsideASphere(phase_t * Phase, const real_t SizeOfSphere,
         const int fromAgent, const int toAgent,
-        const double XCenter, const double YCenter,
-        const double ZCenter, const double RadiusOfCopter);
+        const real_t XCenter, const real_t YCenter,
+        const real_t ZCenter, const real_t RadiusOfCopter);
 
 /* Setting up random initial conditions on a specific plane
  * A local XY coordinate system is given on the plane by "XAxis" and the normalvector of the plane ("PlaneNormalVect")
  */
 void RandomizePhaseOnPlane(phase_t * Phase,
-        const double XSize,
-        const double YSize,
-        const double XCenter,
-        const double YCenter,
-        const double ZCenter,
-        double *PlaneNormalVect,
-        double *XAxis,
-        const int fromAgent, const int toAgent, const double RadiusOfCopter);
+        const real_t XSize,
+        const real_t YSize,
+        const real_t XCenter,
+        const real_t YCenter,
+        const real_t ZCenter,
+        real_t *PlaneNormalVect,
+        real_t *XAxis,
+        const int fromAgent, const int toAgent, const real_t RadiusOfCopter);
 void PlaceAgentsOnXYPlane(phase_t * Phase,
-        const double XSize,
-        const double YSize,
-        const double XCenter,
-        const double YCenter,
-        const double ZCenter,
-        const int fromAgent, const int toAgent, const double RadiusOfCopter);
+        const real_t XSize,
+        const real_t YSize,
+        const real_t XCenter,
+        const real_t YCenter,
+        const real_t ZCenter,
+        const int fromAgent, const int toAgent, const real_t RadiusOfCopter);
 void PlaceAgentsOnXZPlane(phase_t * Phase,
-        const double XSize,
-        const double ZSize,
-        const double XCenter,
-        const double YCenter,
-        const double ZCenter,
-        const int fromAgent, const int toAgent, const double RadiusOfCopter);
+        const real_t XSize,
+        const real_t ZSize,
+        const real_t XCenter,
+        const real_t YCenter,
+        const real_t ZCenter,
+        const int fromAgent, const int toAgent, const real_t RadiusOfCopter);
 void PlaceAgentsOnYZPlane(phase_t * Phase,
-        const double YSize,
-        const double ZSize,
-        const double XCenter,
-        const double YCenter,
-        const double ZCenter,
-        const int fromAgent, const int toAgent, const double RadiusOfCopter);
+        const real_t YSize,
+        const real_t ZSize,
+        const real_t XCenter,
+        const real_t YCenter,
+        const real_t ZCenter,
+        const int fromAgent, const int toAgent, const real_t RadiusOfCopter);
 
 /* Placing agents onto specific lines */
 void PlaceAgentsOntoALine(phase_t * Phase, const int fromAgent,
-        const int toAgent, double *Tangential,
-        const double XCenter, const double YCenter,
-        const double ZCenter, const double LineLength,
-        const double RadiusOfCopter);
+        const int toAgent, real_t *Tangential,
+        const real_t XCenter, const real_t YCenter,
+        const real_t ZCenter, const real_t LineLength,
+        const real_t RadiusOfCopter);
 
 /* Counting collisions (this is for internal use only :) )
  */
 int HowManyCollisions(phase_t * ActualPhase, bool * AgentsInDanger,
-        const bool CountCollisions, const double RadiusOfCopter);
+        const bool CountCollisions, const real_t RadiusOfCopter);
 
 
-/* Count the number of clusters in the simulation */
-int CountCluster(phase_t Phase, bool * Visited, unit_model_params_t * UnitParams);
+/* Count the number of clusters in the simulation
+ * (the adjacency matrix is taken from the arena "Scratch")
+ */
+int CountCluster(phase_t Phase, bool * Visited, unit_model_params_t * UnitParams,
+        memory_arena_t * Scratch);
 
 
-void ConstructAdjacencyMatrix(double **OutputAdjacency, phase_t * Phase,
-        const double CommunicationRange);
+void ConstructAdjacencyMatrix(real_t **OutputAdjacency, phase_t * Phase,
+        const real_t CommunicationRange);
 
-void CreateClusters(const int i, double **InputAdjacency, bool * Visited,
+void CreateClusters(const int i, real_t **InputAdjacency, bool * Visited,
         const int NumberOfAgents, unit_model_params_t * UnitParams);
         
 /* Swaps the states of two agents (ith and jth)
@@ -340,7 +350,7 @@ void SwapAgents(phase_t * Phase, const int i, const int j, const int TrueAgent);
 
 /* Orders agents by distance from a given position
  */
-void OrderAgentsByDistance(phase_t * Phase, double *ReferencePosition);
+void OrderAgentsByDistance(phase_t * Phase, real_t *ReferencePosition);
 
 /* Orders agents by Received Power */
 void OrderAgentsByPower(phase_t * Phase, int SizeToSort, int WhichAgent);
@@ -349,20 +359,18 @@ void OrderAgentsByPower(phase_t * Phase, int SizeToSort, int WhichAgent);
  * Returns the number of agents which are closer than R_C and whose packets
  * are not lost
  */
-int SelectNearbyVisibleAgents(phase_t * Phase, double *ReferencePosition,
-        const double Range, const double power_thresh, const int communication_mode, 
-        const int TrueAgent, const double packet_loss);
+int SelectNearbyVisibleAgents(phase_t * Phase, real_t *ReferencePosition,
+        const real_t Range, const real_t power_thresh, const int communication_mode, 
+        const int TrueAgent, const real_t packet_loss);
 
 /* Calculate the received power of an agent given its interdistance */
-double ReceivedPowerLog(double * RefCoords, double * NeighbourCoords,
+real_t ReceivedPowerLog(real_t * RefCoords, real_t * NeighbourCoords,
                         obstacles_t obstacles,
-                        double **Polygons,
+                        real_t **Polygons,
                         unit_model_params_t * UnitParams,
-                        const double Dist);
+                        const real_t Dist);
 
-double DegradedPower(double Dist, double DistObst, double Loss, unit_model_params_t * UnitParams);
+real_t DegradedPower(real_t Dist, real_t DistObst, real_t Loss, unit_model_params_t * UnitParams);
 
-void FastVoxelTraversal(phase_t *Phase, double *CoordsA, double *CoordsB, int WhichAgent,
-                        double ArenaCenterX, double ArenaCenterY, double ArenaSize, int Resolution);
         
 #endif
@@ -0,0 +1,168 @@
+//MIT License
+//Copyright (c) 2018 Eotvos Lorand University, Budapest
+
+/* vim:set ts=4 sw=4 sts=4 et: */
+
+/*
+ * Convex hull of the swarm on the XY plane.
+ */
+
+#include "hull.h"
+
+/* Coordinates used by the comparator of qsort */
+static real_t **CoordinatesToSort;
+
+/* Lexicographic order of two agents by (x, y) */
+static bool IsBefore(real_t **Coordinates, const int a, const int b) {
+
+    return (Coordinates[a][0] < Coordinates[b][0] ||
+            (Coordinates[a][0] == Coordinates[b][0] &&
+                    Coordinates[a][1] < Coordinates[b][1]));
+
+}
+
+static int CompareByXY(const void *a, const void *b) {
+
+    int i = *(const int *) a;
+    int j = *(const int *) b;
+
+    if (IsBefore(CoordinatesToSort, i, j)) {
+        return -1;
+    } else if (IsBefore(CoordinatesToSort, j, i)) {
+        return 1;
+    }
+    return 0;
+
+}
+
+/* z component of (b - a) x (c - a) */
+static real_t Cross(real_t **Coordinates, const int a, const int b,
+        const int c) {
+
+    return (Coordinates[b][0] - Coordinates[a][0]) *
+            (Coordinates[c][1] - Coordinates[a][1]) -
+            (Coordinates[b][1] - Coordinates[a][1]) *
+            (Coordinates[c][0] - Coordinates[a][0]);
+
+}
+
+void AllocateHull(hull_t * Hull, const int NumberOfPoints) {
+
+    Hull->Capacity = NumberOfPoints;
+    Hull->X = realVector(NumberOfPoints + 1);
+    Hull->Y = realVector(NumberOfPoints + 1);
+    Hull->Polygon = realMatrix(NumberOfPoints + 1, 3);
+    Hull->VertexSet = realVector(2 * NumberOfPoints + 2);
+    Hull->Order = intData(NumberOfPoints);
+    Hull->Chain = intData(2 * NumberOfPoints + 1);
+    Hull->OnlyOnGPSTick = false;
+
+    ResetHull(Hull);
+
+}
+
+void freeHull(hull_t * Hull) {
+
+    free(Hull->X);
+    free(Hull->Y);
+    freeRealMatrix(Hull->Polygon, Hull->Capacity + 1, 3);
+    free(Hull->VertexSet);
+    free(Hull->Order);
+    free(Hull->Chain);
+
+}
+
+void ResetHull(hull_t * Hull) {
+
+    int i;
+
+    for (i = 0; i < Hull->Capacity; i++) {
+        Hull->Order[i] = i;
+    }
+    Hull->NumberOfVertices = 0;
+    Hull->Area = 0.0;
+    Hull->Valid = false;
+
+}
+
+void ConvexHullOfPhase(hull_t * Hull, phase_t * Phase) {
+
+    int i, j, k, t;
+    int n = Phase->NumberOfAgents;
+    int Moves = 0;
+    int ToInsert;
+    real_t **Coordinates = Phase->Coordinates;
+
+    if (n > Hull->Capacity) {
+        fprintf(stderr, "Hull capacity is smaller than the number of agents!\n");
+        exit(-1);
+    }
+
+    /* Agents hardly move between two calls, therefore the previous order is
+     * almost sorted and insertion sort finishes in nearly linear time.
+     * If it is not the case (e.g. after a reset), qsort takes over. */
+    for (i = 1; i < n && Moves <= 8 * n; i++) {
+        ToInsert = Hull->Order[i];
+        for (j = i - 1; j >= 0 && IsBefore(Coordinates, ToInsert, Hull->Order[j]);
+                j--) {
+            Hull->Order[j + 1] = Hull->Order[j];
+            Moves++;
+        }
+        Hull->Order[j + 1] = ToInsert;
+    }
+    if (Moves > 8 * n) {
+        CoordinatesToSort = Coordinates;
+        qsort(Hull->Order, n, sizeof(int), CompareByXY);
+    }
+
+    /* Lower and upper chains */
+    k = 0;
+    for (i = 0; i < n; i++) {
+        while (k >= 2 && Cross(Coordinates, Hull->Chain[k - 2],
+                        Hull->Chain[k - 1], Hull->Order[i]) <= 0.0) {
+            k--;
+        }
+        Hull->Chain[k++] = Hull->Order[i];
+    }
+    for (i = n - 2, t = k + 1; i >= 0; i--) {
+        while (k >= t && Cross(Coordinates, Hull->Chain[k - 2],
+                        Hull->Chain[k - 1], Hull->Order[i]) <= 0.0) {
+            k--;
+        }
+        Hull->Chain[k++] = Hull->Order[i];
+    }
+
+    /* Last point of the chain is the same as the first one */
+    Hull->NumberOfVertices = (n < 3 ? 0 : k - 1);
+
+    Hull->Area = 0.0;
+    Hull->MinX = Hull->MinY = 2e222;
+    Hull->MaxX = Hull->MaxY = -2e222;
+    for (i = 0; i < Hull->NumberOfVertices; i++) {
+        Hull->X[i] = Coordinates[Hull->Chain[i]][0];
+        Hull->Y[i] = Coordinates[Hull->Chain[i]][1];
+        Hull->MinX = fmin(Hull->MinX, Hull->X[i]);
+        Hull->MinY = fmin(Hull->MinY, Hull->Y[i]);
+        Hull->MaxX = fmax(Hull->MaxX, Hull->X[i]);
+        Hull->MaxY = fmax(Hull->MaxY, Hull->Y[i]);
+        Hull->Polygon[i][0] = Hull->X[i];
+        Hull->Polygon[i][1] = Hull->Y[i];
+        Hull->Polygon[i][2] = 0.0;
+        Hull->VertexSet[2 * i] = Hull->X[i];
+        Hull->VertexSet[2 * i + 1] = Hull->Y[i];
+    }
+    if (Hull->NumberOfVertices > 0) {
+        Hull->VertexSet[2 * Hull->NumberOfVertices] = Hull->X[0];
+        Hull->VertexSet[2 * Hull->NumberOfVertices + 1] = Hull->Y[0];
+    }
+
+    /* Shoelace formula */
+    for (i = 0, j = Hull->NumberOfVertices - 1; i < Hull->NumberOfVertices;
+            j = i++) {
+        Hull->Area += (Hull->X[j] + Hull->X[i]) * (Hull->Y[j] - Hull->Y[i]);
+    }
+    Hull->Area = fabs(Hull->Area / 2.0);
+
+    Hull->Valid = true;
+
+}
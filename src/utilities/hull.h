@@ -0,0 +1,65 @@
+//MIT License
+//Copyright (c) 2018 Eotvos Lorand University, Budapest
+
+/* vim:set ts=4 sw=4 sts=4 et: */
+
+/*
+ * Convex hull of the swarm on the XY plane.
+ * Every array is allocated once, and the lexicographic ordering of the agents
+ * is kept between two calls, because it barely changes from step to step.
+ */
+
+#ifndef HULL_H
+#define HULL_H
+
+#include <stdbool.h>
+#include "datastructs.h"
+#include "dynamics_utils.h"
+
+/* Convex hull stored in preallocated arrays
+ */
+typedef struct {
+
+    /* Maximal number of points (number of agents) */
+    int Capacity;
+
+    /* Vertices of the hull in counter-clockwise order (first vertex is not repeated) */
+    int NumberOfVertices;
+    real_t *X;
+    real_t *Y;
+    /* The same vertices as a "NumberOfVertices x 3" matrix (for IntersectingPolygons) */
+    real_t **Polygon;
+    /* The same vertices as a closed {x0, y0, x1, y1, ..., x0, y0} list (for IsInsidePolygon) */
+    real_t *VertexSet;
+
+    /* Area of the hull (cm^2) */
+    real_t Area;
+    /* Bounding box of the hull */
+    real_t MinX, MinY;
+    real_t MaxX, MaxY;
+
+    /* Indices of the agents ordered by (x, y), reused as warm start in the next call */
+    int *Order;
+    /* Working array of the monotone chain (2 x Capacity) */
+    int *Chain;
+
+    /* Recalculate the hull only on GPS ticks */
+    bool OnlyOnGPSTick;
+    /* Hull has been calculated at least once since the last reset */
+    bool Valid;
+
+} hull_t;
+
+/* Allocating and freeing the arrays of a hull with "NumberOfPoints" capacity */
+void AllocateHull(hull_t * Hull, const int NumberOfPoints);
+void freeHull(hull_t * Hull);
+
+/* Forget the stored ordering (e.g. after redistributing the agents) */
+void ResetHull(hull_t * Hull);
+
+/* Calculating the convex hull of the agents' XY coordinates
+ * with Andrew's monotone chain algorithm
+ */
+void ConvexHullOfPhase(hull_t * Hull, phase_t * Phase);
+
+#endif
@@ -13,9 +13,9 @@
 #define MIN(a,b) (((a)<(b))?(a):(b))
 #define MAX(a,b) (((a)>(b))?(a):(b))
 
-void FrictionLinSqrt(double *OutputVelocity, phase_t * Phase,
-        const double C_Frict_l, const double V_Frict_l,
-        const double Acc_l, const double p_l, const double R_0_l,
+void FrictionLinSqrt(real_t *OutputVelocity, phase_t * Phase,
+        const real_t C_Frict_l, const real_t V_Frict_l,
+        const real_t Acc_l, const real_t p_l, const real_t R_0_l,
         const int WhichAgent, const int Dim_l) {
 
     NullVect(OutputVelocity, 3);
@@ -23,18 +23,18 @@ void FrictionLinSqrt(double *OutputVelocity, phase_t * Phase,
     int i;
     int n = 0;
 
-    double *AgentsCoordinates;
-    double *AgentsVelocity;
-    double *NeighboursCoordinates;
-    double *NeighboursVelocity;
+    real_t *AgentsCoordinates;
+    real_t *AgentsVelocity;
+    real_t *NeighboursCoordinates;
+    real_t *NeighboursVelocity;
 
     AgentsCoordinates = Phase->Coordinates[WhichAgent];
     AgentsVelocity = Phase->Velocities[WhichAgent];
 
-    static double DifferenceVector[3];
-    static double DistanceFromNeighbour;
-    static double VelDiff;
-    static double MaxVelDiff;
+    static real_t DifferenceVector[3];
+    static real_t DistanceFromNeighbour;
+    static real_t VelDiff;
+    static real_t MaxVelDiff;
 
     /* Friction-like term */
     for (i = 0; i < Phase->NumberOfAgents; i++) {
@@ -70,9 +70,9 @@ void FrictionLinSqrt(double *OutputVelocity, phase_t * Phase,
     }
 }
 
-void RepulsionLin(double *OutputVelocity,
-        phase_t * Phase, const double V_Rep_l, const double p_l,
-        const double R_0_l, const int WhichAgent, const int Dim_l,
+void RepulsionLin(real_t *OutputVelocity,
+        phase_t * Phase, const real_t V_Rep_l, const real_t p_l,
+        const real_t R_0_l, const int WhichAgent, const int Dim_l,
         const bool normalize) {
 
     NullVect(OutputVelocity, 3);
@@ -80,13 +80,13 @@ void RepulsionLin(double *OutputVelocity,
     int i;
     int n = 0;
 
-    double *AgentsCoordinates;
-    double *NeighboursCoordinates;
+    real_t *AgentsCoordinates;
+    real_t *NeighboursCoordinates;
 
     AgentsCoordinates = Phase->Coordinates[WhichAgent];
 
-    static double DifferenceVector[3];
-    static double DistanceFromNeighbour;
+    static real_t DifferenceVector[3];
+    static real_t DistanceFromNeighbour;
     /* Repulsive interaction term */
     for (i = 0; i < Phase->NumberOfAgents; i++) {
         if (i == WhichAgent)
@@ -112,16 +112,16 @@ void RepulsionLin(double *OutputVelocity,
 
     /* divide result by number of interacting units */
     if (normalize && n > 1) {
-        double length = VectAbs(OutputVelocity) / n;
+        real_t length = VectAbs(OutputVelocity) / n;
         UnitVect(OutputVelocity, OutputVelocity);
         MultiplicateWithScalar(OutputVelocity, OutputVelocity, length, Dim_l);
     }
     //printf("Number of Repulsive neighbours: %d Norm of repulsive term relative to max repulsion velocity: %f\n", n, VectAbs (OutputVelocity)/V_Rep_l);
 }
 
-void AttractionLin(double *OutputVelocity,
-        phase_t * Phase, const double V_Rep_l, const double p_l,
-        const double R_0_l, const int WhichAgent, const int Dim_l,
+void AttractionLin(real_t *OutputVelocity,
+        phase_t * Phase, const real_t V_Rep_l, const real_t p_l,
+        const real_t R_0_l, const int WhichAgent, const int Dim_l,
         const bool normalize) {
 
     NullVect(OutputVelocity, 3);
@@ -129,13 +129,13 @@ void AttractionLin(double *OutputVelocity,
     int i;
     int n = 0;
 
-    double *AgentsCoordinates;
-    double *NeighboursCoordinates;
+    real_t *AgentsCoordinates;
+    real_t *NeighboursCoordinates;
     // printf("nb agents = %d\n", Phase->NumberOfAgents);
     AgentsCoordinates = Phase->Coordinates[WhichAgent];
     
-    static double DifferenceVector[3];
-    static double DistanceFromNeighbour;
+    static real_t DifferenceVector[3];
+    static real_t DistanceFromNeighbour;
     /* Attractive interaction term */
     for (i = 0; i < Phase->NumberOfAgents; i++) {
         if (i == WhichAgent)
@@ -162,16 +162,16 @@ void AttractionLin(double *OutputVelocity,
 
     /* divide result by number of interacting units */
     if (normalize && n > 1) {
-        double length = VectAbs(OutputVelocity) / n;
+        real_t length = VectAbs(OutputVelocity) / n;
         UnitVect(OutputVelocity, OutputVelocity);
         MultiplicateWithScalar(OutputVelocity, OutputVelocity, length, Dim_l);
     }
     //printf("Number of Attractive neighbours: %d Norm of attractive term relative to max repulsion velocity: %f\n", n, VectAbs (OutputVelocity)/V_Rep_l);
 }
 
-void RepulsionPowLin(double *OutputVelocity,
-        phase_t * Phase, const double ActualTime, const double V_Rep_l, const double p_l,
-        const double RP_max, const int WhichAgent, const int Dim_l,
+void RepulsionPowLin(real_t *OutputVelocity,
+        phase_t * Phase, const double ActualTime, const real_t V_Rep_l, const real_t p_l,
+        const real_t RP_max, const int WhichAgent, const int Dim_l,
         const bool normalize) {
 
     NullVect(OutputVelocity, 3);
@@ -179,8 +179,8 @@ void RepulsionPowLin(double *OutputVelocity,
     int i;
     int n = 0;
 
-    double *AgentsCoordinates;
-    double *NeighboursCoordinates;
+    real_t *AgentsCoordinates;
+    real_t *NeighboursCoordinates;
 
     AgentsCoordinates = Phase->Coordinates[WhichAgent];
 
@@ -192,7 +192,7 @@ void RepulsionPowLin(double *OutputVelocity,
     // }
     // printf("\n\n\n\n");
 
-    static double DifferenceVector[3];
+    static real_t DifferenceVector[3];
     // printf("%d\n", Phase->NumberOfAgents);
     /* Repulsive interaction term */
     for (i = 0; i < Phase->NumberOfAgents; i++) {
@@ -218,16 +218,16 @@ void RepulsionPowLin(double *OutputVelocity,
 
     /* divide result by number of interacting units */
     if (normalize && n > 1) {
-        double length = VectAbs(OutputVelocity) / n;
+        real_t length = VectAbs(OutputVelocity) / n;
         UnitVect(OutputVelocity, OutputVelocity);
         MultiplicateWithScalar(OutputVelocity, OutputVelocity, length, Dim_l);
     }
     //printf("Number of Repulsive neighbours: %d Norm of repulsive term relative to max repulsion velocity: %f\n", n, VectAbs (OutputVelocity)/V_Rep_l);
 }
 
-void AttractionPowLin(double *OutputVelocity,
-        phase_t * Phase, const double ActualTime, const double V_Rep_l, const double p_l,
-        const double RP_min, const int WhichAgent, const int Dim_l,
+void AttractionPowLin(real_t *OutputVelocity,
+        phase_t * Phase, const double ActualTime, const real_t V_Rep_l, const real_t p_l,
+        const real_t RP_min, const int WhichAgent, const int Dim_l,
         const bool normalize) {
 
     NullVect(OutputVelocity, 3);
@@ -235,12 +235,12 @@ void AttractionPowLin(double *OutputVelocity,
     int i;
     int n = 0;
 
-    double *AgentsCoordinates;
-    double *NeighboursCoordinates;
+    real_t *AgentsCoordinates;
+    real_t *NeighboursCoordinates;
     // printf("nb agents = %d\n", Phase->NumberOfAgents);
     AgentsCoordinates = Phase->Coordinates[WhichAgent];
 
-    static double DifferenceVector[3];
+    static real_t DifferenceVector[3];
     /* Attractive interaction term */
     for (i = 0; i < Phase->NumberOfAgents; i++) {
         if (i == WhichAgent)
@@ -265,7 +265,7 @@ void AttractionPowLin(double *OutputVelocity,
 
     /* divide result by number of interacting units */
     if (normalize && n > 1) {
-        double length = VectAbs(OutputVelocity) / n;
+        real_t length = VectAbs(OutputVelocity) / n;
         UnitVect(OutputVelocity, OutputVelocity);
         MultiplicateWithScalar(OutputVelocity, OutputVelocity, length, Dim_l);
     }
@@ -273,11 +273,11 @@ void AttractionPowLin(double *OutputVelocity,
 }
 
 /* Smooth pairwise potential without finite cut-off */
-double ActionFunction(double z, double a, double b) {
+real_t ActionFunction(real_t z, real_t a, real_t b) {
 
-    double phi;
-    double sigma;               // directly sigma1(z +c)
-    double c;
+    real_t phi;
+    real_t sigma;               // directly sigma1(z +c)
+    real_t c;
     c = fabs(a - b) / sqrt(4 * a *b);
     sigma = (z + c) / sqrt(1 + pow((z + c), 2));
     phi = .5 * ((a + b) * sigma + (a - b));
@@ -285,23 +285,23 @@ double ActionFunction(double z, double a, double b) {
     return phi;
 }
 
-void GradientBased(double *OutputVelocity,
-        phase_t * Phase, const double epsilon, const double a,
-        const double b, const double h,
-        const double d, const double r,
+void GradientBased(real_t *OutputVelocity,
+        phase_t * Phase, const real_t epsilon, const real_t a,
+        const real_t b, const real_t h,
+        const real_t d, const real_t r,
         const int WhichAgent, const int Dim_l) {
 
         NullVect(OutputVelocity, 3);
 
         int i;
 
-        double *AgentsCoordinates;
-        double *NeighboursCoordinates;
+        real_t *AgentsCoordinates;
+        real_t *NeighboursCoordinates;
 
-        static double SigmaDistance;
-        static double PhiAlpha;
-        static double SigmaR;
-        static double SigmaD;
+        static real_t SigmaDistance;
+        static real_t PhiAlpha;
+        static real_t SigmaR;
+        static real_t SigmaD;
 
         SigmaR = (1 / epsilon) * (sqrt(1 + epsilon * pow(r, 2)) - 1);
         SigmaD = (1 / epsilon) * (sqrt(1 + epsilon * pow(d, 2)) - 1);
@@ -309,8 +309,8 @@ void GradientBased(double *OutputVelocity,
         AgentsCoordinates = Phase->Coordinates[WhichAgent];
         // MultiplicateWithScalar(AgentsCoordinates, AgentsCoordinates, 0.01, Dim_l);
 
-        static double DifferenceVector[3];
-        double GradVector[3];
+        static real_t DifferenceVector[3];
+        real_t GradVector[3];
         
         for (i = 1; i < Phase->NumberOfAgents; i++) {   // i = 0 is the WhichAgent
 
@@ -335,33 +335,33 @@ void GradientBased(double *OutputVelocity,
         // MultiplicateWithScalar(OutputVelocity, OutputVelocity, 8, Dim_l); // x100 to have the speed in cm/s
 }
 
-void AlignmentOlfati(double *OutputVelocity,
-        phase_t * Phase, const double h,
-        const double r, const int WhichAgent, 
-        const int Dim_l, const double epsilon) {
+void AlignmentOlfati(real_t *OutputVelocity,
+        phase_t * Phase, const real_t h,
+        const real_t r, const int WhichAgent, 
+        const int Dim_l, const real_t epsilon) {
 
         NullVect(OutputVelocity, 3);
 
         int i;
 
-        double *AgentsCoordinates;
-        double *NeighboursCoordinates;
+        real_t *AgentsCoordinates;
+        real_t *NeighboursCoordinates;
 
         AgentsCoordinates = Phase->Coordinates[WhichAgent];
 
-        double *AgentsVelocity;
-        double *NeighboursVelocity;
+        real_t *AgentsVelocity;
+        real_t *NeighboursVelocity;
 
         AgentsVelocity = Phase->Velocities[WhichAgent];
 
-        static double SigmaDistance;
-        static double SigmaR;
-        static double aij;
+        static real_t SigmaDistance;
+        static real_t SigmaR;
+        static real_t aij;
 
         SigmaR = (1 / epsilon) * (sqrt(1 + epsilon * pow(r, 2)) - 1);
 
-        static double DifferenceVector[3];
-        static double DifferenceVelocities[3];
+        static real_t DifferenceVector[3];
+        static real_t DifferenceVelocities[3];
 
         for (i = 1; i < Phase->NumberOfAgents; i++) {   // i = 0 is the WhichAgent
 
@@ -390,19 +390,19 @@ void AlignmentOlfati(double *OutputVelocity,
 }
 
 /* Olfati tracking */
-void TrackingOlfati(double *OutputVelocity, double *TargetPosition,
-        double *TargetVelocity, phase_t * Phase, const int WhichAgent, 
+void TrackingOlfati(real_t *OutputVelocity, real_t *TargetPosition,
+        real_t *TargetVelocity, phase_t * Phase, const int WhichAgent, 
         const int Dim_l) {
 
         NullVect(OutputVelocity, 3);
 
-        double *AgentsCoordinates;
-        double *AgentsVelocity;
+        real_t *AgentsCoordinates;
+        real_t *AgentsVelocity;
 
-        double PositionComponent[3];
-        double VelocityComponent[3];
-        double PositionDiff[3];
-        double VelocityDiff[3];
+        real_t PositionComponent[3];
+        real_t VelocityComponent[3];
+        real_t PositionDiff[3];
+        real_t VelocityDiff[3];
 
 
 
@@ -422,27 +422,25 @@ void TrackingOlfati(double *OutputVelocity, double *TargetPosition,
 
 
 /* Target tracking function */
-void TargetTracking(double *OutputVelocity, double *TargetPosition,
-        phase_t * Phase, const double R_CoM, const double d_CoM,
-        const double R_trg, const double d_trg, 
-        const int SizeOfNeighbourhood, const int WhichAgent, 
+void TargetTracking(real_t *OutputVelocity, real_t *TargetPosition,
+        phase_t * Phase, const real_t R_CoM, const real_t d_CoM,
+        const real_t R_trg, const real_t d_trg, 
+        real_t *CoMCoords, const int WhichAgent, 
         const int Dim_l) {
 
 
         NullVect(OutputVelocity, 3);
 
-        double *AgentsCoordinates;
-        double TargetComponent[3];
+        real_t *AgentsCoordinates;
+        real_t TargetComponent[3];
 
         AgentsCoordinates = Phase->Coordinates[WhichAgent];
 
         /* CoM component */
-        static double CoMDifferenceVector[3];
-        double CoMCoef;
-        double CoMCoords[3];
-        double CoMComponent[3];
+        static real_t CoMDifferenceVector[3];
+        real_t CoMCoef;
+        real_t CoMComponent[3];
 
-        GetNeighbourhoodSpecificCoM(CoMCoords, Phase, SizeOfNeighbourhood);
         VectDifference(CoMDifferenceVector, CoMCoords, AgentsCoordinates);
         UnitVect(CoMComponent, CoMDifferenceVector);
 
@@ -451,9 +449,9 @@ void TargetTracking(double *OutputVelocity, double *TargetPosition,
         MultiplicateWithScalar(CoMComponent, CoMComponent, CoMCoef, Dim_l);
 
         /* Trg component */
-        static double TrgDifferenceVector[3];
-        double TrgCoef;
-        double TrgComponent[3];
+        static real_t TrgDifferenceVector[3];
+        real_t TrgCoef;
+        real_t TrgComponent[3];
 
         VectDifference(TrgDifferenceVector, TargetPosition, CoMCoords);
         UnitVect(TrgComponent, TrgDifferenceVector);
@@ -16,61 +16,63 @@
 
 /* friction / alignment */
 
-void FrictionLinSqrt(double *OutputVelocity, phase_t * Phase,
-        const double C_Frict_l, const double V_Frict_l,
-        const double Acc_l, const double p_l,
-        const double R_0_l, const int WhichAgent, const int Dim_l);
+void FrictionLinSqrt(real_t *OutputVelocity, phase_t * Phase,
+        const real_t C_Frict_l, const real_t V_Frict_l,
+        const real_t Acc_l, const real_t p_l,
+        const real_t R_0_l, const int WhichAgent, const int Dim_l);
 
 /* repulsion */
 
-void RepulsionLin(double *OutputVelocity,
-        phase_t * Phase, const double V_Rep_l, const double p_l,
-        const double R_0_l, const int WhichAgent, const int Dim_l,
+void RepulsionLin(real_t *OutputVelocity,
+        phase_t * Phase, const real_t V_Rep_l, const real_t p_l,
+        const real_t R_0_l, const int WhichAgent, const int Dim_l,
         const bool normalize);
 
-void RepulsionPowLin(double *OutputVelocity,
-        phase_t * Phase, const double ActualTime, const double V_Rep_l, const double p_l,
-        const double RP_max, const int WhichAgent, const int Dim_l,
+void RepulsionPowLin(real_t *OutputVelocity,
+        phase_t * Phase, const double ActualTime, const real_t V_Rep_l, const real_t p_l,
+        const real_t RP_max, const int WhichAgent, const int Dim_l,
         const bool normalize);
         
 /* attraction */
 
-void AttractionLin(double *OutputVelocity,
-        phase_t * Phase, const double V_Rep_l, const double p_l,
-        const double R_0_l, const int WhichAgent, const int Dim_l,
+void AttractionLin(real_t *OutputVelocity,
+        phase_t * Phase, const real_t V_Rep_l, const real_t p_l,
+        const real_t R_0_l, const int WhichAgent, const int Dim_l,
         const bool normalize);
 
-void AttractionPowLin(double *OutputVelocity,
-        phase_t * Phase, const double ActualTime, const double V_Rep_l, const double p_l,
-        const double RP_min, const int WhichAgent, const int Dim_l,
+void AttractionPowLin(real_t *OutputVelocity,
+        phase_t * Phase, const double ActualTime, const real_t V_Rep_l, const real_t p_l,
+        const real_t RP_min, const int WhichAgent, const int Dim_l,
         const bool normalize);
 
 
 /* Smooth pairwise potential with finite cut-off  (see Olfati function) */
-double ActionFunction(double z, double a, double b);
+real_t ActionFunction(real_t z, real_t a, real_t b);
 
 /* Gradient based term from Olfati Saber theory */
-void GradientBased(double *OutputVelocity,
-        phase_t * Phase, const double epsilon, const double a,
-        const double b, const double h,
-        const double d, const double r,
+void GradientBased(real_t *OutputVelocity,
+        phase_t * Phase, const real_t epsilon, const real_t a,
+        const real_t b, const real_t h,
+        const real_t d, const real_t r,
         const int WhichAgent, const int Dim_l);
 
-void AlignmentOlfati(double *OutputVelocity,
-        phase_t * Phase, const double h,
-        const double r, const int WhichAgent, 
-        const int Dim_l, const double epsilon);
+void AlignmentOlfati(real_t *OutputVelocity,
+        phase_t * Phase, const real_t h,
+        const real_t r, const int WhichAgent, 
+        const int Dim_l, const real_t epsilon);
 
-void TrackingOlfati(double *OutputVelocity, double *TargetPosition,
-        double *TargetVelocity, phase_t * Phase, const int WhichAgent, 
+void TrackingOlfati(real_t *OutputVelocity, real_t *TargetPosition,
+        real_t *TargetVelocity, phase_t * Phase, const int WhichAgent, 
         const int Dim_l);
 
 
-/* Target tracking function */
-void TargetTracking(double *OutputVelocity, double *TargetPosition,
-        phase_t * Phase, const double R_CoM, const double d_CoM,
-        const double R_trg, const double d_trg, 
-        const int SizeOfNeighbourhood, const int WhichAgent, 
+/* Target tracking function
+ * ("CoMCoords" is the CoM of the agent's neighbourhood, see FlockAggregates)
+ */
+void TargetTracking(real_t *OutputVelocity, real_t *TargetPosition,
+        phase_t * Phase, const real_t R_CoM, const real_t d_CoM,
+        const real_t R_trg, const real_t d_trg, 
+        real_t *CoMCoords, const int WhichAgent, 
         const int Dim_l);
         
 #endif
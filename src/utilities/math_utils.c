@@ -152,8 +152,8 @@ char * fromDeci(char res[], int base, int inputNum)
 /* Linear algebra */
 
 /* Fills a vector with the input values (x, y, z components) */
-void FillVect(double *VectToFill, const double x, const double y,
-        const double z) {
+void FillVect(real_t *VectToFill, const real_t x, const real_t y,
+        const real_t z) {
 
     VectToFill[0] = x;
     VectToFill[1] = y;
@@ -163,11 +163,11 @@ void FillVect(double *VectToFill, const double x, const double y,
 
 
 /* Return a vector with the indexes corresponding to a sorted vector */
-void ArgMaxSort(double *InputVect, int Length, int * IndexVect) {
+void ArgMaxSort(real_t *InputVect, int Length, int * IndexVect) {
 
-    static double a;
-    static double b;
-    double temp;
+    static real_t a;
+    static real_t b;
+    real_t temp;
 
     int i, j;
 
@@ -206,7 +206,7 @@ void ArgMaxSort(double *InputVect, int Length, int * IndexVect) {
 int InnerSum(int *InputVector, int Dim) {
 
     int i;
-    static double Sum;
+    static real_t Sum;
     Sum = 0.0;
 
     for (i = 0; i < Dim; i++) {
@@ -216,33 +216,33 @@ int InnerSum(int *InputVector, int Dim) {
 }
 
 /* Returns the Length of the input vector (3 dimensions) */
-double VectAbs(double *InputVector) {
+real_t VectAbs(real_t *InputVector) {
     return sqrt(InputVector[0] * InputVector[0] +
             InputVector[1] * InputVector[1] + InputVector[2] * InputVector[2]);
 }
 
 /* Returns the XY-projected Length of the input vector */
-double VectAbsXY(double *InputVector) {
+real_t VectAbsXY(real_t *InputVector) {
 
     return hypot(InputVector[0], InputVector[1]);
 
 }
 
 /* Difference of two vectors (3D) */
-void VectDifference(double *ABDiff, double *VectA, double *VectB) {
+void VectDifference(real_t *ABDiff, real_t *VectA, real_t *VectB) {
 
     FillVect(ABDiff, VectA[0] - VectB[0], VectA[1] - VectB[1],
             VectA[2] - VectB[2]);
 
 }
 
-void VectDifference2D(double *ABDiff, double *VectA, double *VectB) {
+void VectDifference2D(real_t *ABDiff, real_t *VectA, real_t *VectB) {
     ABDiff[0] = VectA[0] - VectB[0];
     ABDiff[1] = VectA[1] - VectB[1];
 }
 
 /* Sum of two vectors (3D) */
-void VectSum(double *ABSum, double *VectA, double *VectB) {
+void VectSum(real_t *ABSum, real_t *VectA, real_t *VectB) {
 
     FillVect(ABSum, VectA[0] + VectB[0], VectA[1] + VectB[1],
             VectA[2] + VectB[2]);
@@ -250,22 +250,22 @@ void VectSum(double *ABSum, double *VectA, double *VectB) {
 }
 
 /* Fills up a vector with zero values */
-void NullVect(double *VectorToNull, const int Dim) {
+void NullVect(real_t *VectorToNull, const int Dim) {
 
-    memset(VectorToNull, 0, Dim * sizeof(double));
+    memset(VectorToNull, 0, Dim * sizeof(real_t));
 
 }
 
-void NullMatrix(double **MatrixToNull, const int rows, const int cols) {
+void NullMatrix(real_t **MatrixToNull, const int rows, const int cols) {
     int i;
     for (i = 0; i < rows; i++) {
-        memset(MatrixToNull[i], 0, cols * sizeof(double));
+        memset(MatrixToNull[i], 0, cols * sizeof(real_t));
     }
 }
 
-double MaxMatrix(double **Matrix, const int rows, const int cols){
+real_t MaxMatrix(real_t **Matrix, const int rows, const int cols){
     int i, j;
-    static double max;
+    static real_t max;
     max = -2e22;
     for (i = 0; i < rows; i++){
         for (j = 0; j < cols; j++){
@@ -278,8 +278,8 @@ double MaxMatrix(double **Matrix, const int rows, const int cols){
 }
 
 /* Multiplicates a vector with a scalar value (3D) */
-void MultiplicateWithScalar(double *OutputVector, double *VectorToMultiplicate,
-        const double Scalar, const int Dim) {
+void MultiplicateWithScalar(real_t *OutputVector, real_t *VectorToMultiplicate,
+        const real_t Scalar, const int Dim) {
 
     int i;
 
@@ -292,10 +292,10 @@ void MultiplicateWithScalar(double *OutputVector, double *VectorToMultiplicate,
 }
 
 /* Returns the scalar product of two vectors */
-double ScalarProduct(double *VectA, double *VectB, const int Dim) {
+real_t ScalarProduct(real_t *VectA, real_t *VectB, const int Dim) {
 
     int i;
-    static double Product;
+    static real_t Product;
     Product = 0.0;
 
     for (i = 0; i < Dim; i++) {
@@ -309,13 +309,13 @@ double ScalarProduct(double *VectA, double *VectB, const int Dim) {
 }
 
 /* Outer product of two vectors (3D) */
-void VectorialProduct(double *Result, double *Vector1, double *Vector2) {
+void VectorialProduct(real_t *Result, real_t *Vector1, real_t *Vector2) {
 
-    static double Temp1[3];
-    static double Temp2[3];
+    static real_t Temp1[3];
+    static real_t Temp2[3];
 
-    memcpy(Temp1, Vector1, 3 * sizeof(double));
-    memcpy(Temp2, Vector2, 3 * sizeof(double));
+    memcpy(Temp1, Vector1, 3 * sizeof(real_t));
+    memcpy(Temp2, Vector2, 3 * sizeof(real_t));
 
     Result[0] = Temp1[1] * Temp2[2] - Temp1[2] * Temp2[1];
     Result[1] = Temp1[2] * Temp2[0] - Temp1[0] * Temp2[2];
@@ -324,10 +324,10 @@ void VectorialProduct(double *Result, double *Vector1, double *Vector2) {
 }
 
 /* Creates a unit vector (parallel to the input vector) */
-void UnitVect(double *OutputVector, double *InputVector) {
+void UnitVect(real_t *OutputVector, real_t *InputVector) {
 
     int k;
-    static double Abs;
+    static real_t Abs;
     Abs = VectAbs(InputVector);
 
     /* If input vector is (0, 0, 0), the "unit" vect will be (0, 0, 0) */
@@ -348,31 +348,31 @@ void UnitVect(double *OutputVector, double *InputVector) {
 }
 
 // normalize a vector to a given value
-void NormalizeVector(double *OutputVector, double *InputVector, double value) {
+void NormalizeVector(real_t *OutputVector, real_t *InputVector, real_t value) {
     UnitVect(OutputVector, InputVector);
     MultiplicateWithScalar(OutputVector, OutputVector, value, 3);
     return;
 }
 
 /* Compute the sigma norm of a vector */
-double SigmaNorm(double *InputVector, double epsilon) {
+real_t SigmaNorm(real_t *InputVector, real_t epsilon) {
 
-    static double Abs;
+    static real_t Abs;
     Abs = VectAbs(InputVector);
     return (1 / epsilon) * ((sqrt(1 + epsilon * pow(Abs, 2))) - 1);
 }
 
 /* Compute the sigma gradient */
-void SigmaGrad(double *OuptutVector, double *InputVector, double epsilon, const int Dim) {
+void SigmaGrad(real_t *OuptutVector, real_t *InputVector, real_t epsilon, const int Dim) {
 
-    static double value;
+    static real_t value;
     value = 1 / (1 + epsilon * SigmaNorm(InputVector, epsilon));
     MultiplicateWithScalar(OuptutVector, InputVector, value, Dim);
     // NormalizeVector(OuptutVector, InputVector, value);
 }
 
 /* Bump function */
-double BumpFunction(double z, double h) {
+real_t BumpFunction(real_t z, real_t h) {
 
     if (z >= 0 && z < h) {
         return 1;
@@ -388,13 +388,13 @@ double BumpFunction(double z, double h) {
 }
 
 /* Rotates vector around Z axis */
-void RotateVectXY(double *OutputVector, double *InputVector, const double Angle) {
+void RotateVectXY(real_t *OutputVector, real_t *InputVector, const real_t Angle) {
 
-    static double Temp[3];
+    static real_t Temp[3];
     FillVect(Temp, InputVector[0], InputVector[1], InputVector[2]);
 
-    static double cosAngle;
-    static double sinAngle;
+    static real_t cosAngle;
+    static real_t sinAngle;
     cosAngle = cos(Angle);
     sinAngle = sin(Angle);
 
@@ -405,13 +405,13 @@ void RotateVectXY(double *OutputVector, double *InputVector, const double Angle)
 }
 
 /* Rotates vector around X axis */
-void RotateVectZY(double *OutputVector, double *InputVector, const double Angle) {
+void RotateVectZY(real_t *OutputVector, real_t *InputVector, const real_t Angle) {
 
-    static double Temp[3];
+    static real_t Temp[3];
     FillVect(Temp, InputVector[0], InputVector[1], InputVector[2]);
 
-    static double cosAngle;
-    static double sinAngle;
+    static real_t cosAngle;
+    static real_t sinAngle;
     cosAngle = cos(Angle);
     sinAngle = sin(Angle);
 
@@ -422,13 +422,13 @@ void RotateVectZY(double *OutputVector, double *InputVector, const double Angle)
 }
 
 /* Rotates vector around Y axis */
-void RotateVectZX(double *OutputVector, double *InputVector, const double Angle) {
+void RotateVectZX(real_t *OutputVector, real_t *InputVector, const real_t Angle) {
 
-    static double Temp[3];
+    static real_t Temp[3];
     FillVect(Temp, InputVector[0], InputVector[1], InputVector[2]);
 
-    static double cosAngle;
-    static double sinAngle;
+    static real_t cosAngle;
+    static real_t sinAngle;
     cosAngle = cos(Angle);
     sinAngle = sin(Angle);
 
@@ -440,15 +440,15 @@ void RotateVectZX(double *OutputVector, double *InputVector, const double Angle)
 
 /* Rodrigues formula (for rotating vectors around a specific axis) */
 /* See http://aries.ektf.hu/~hz/pdf-tamop/pdf-01/html/ch05.html#id677681 (in Hungarian) */
-void RotateVectAroundSpecificAxis(double *OutputVector, double *InputVector,
-        double *Axis, const double Angle) {
+void RotateVectAroundSpecificAxis(real_t *OutputVector, real_t *InputVector,
+        real_t *Axis, const real_t Angle) {
 
-    static double Temp[3];
+    static real_t Temp[3];
     FillVect(Temp, InputVector[0], InputVector[1], InputVector[2]);
 
-    static double cosAngle;
-    static double sinAngle;
-    static double AxisUnitVect[3];
+    static real_t cosAngle;
+    static real_t sinAngle;
+    static real_t AxisUnitVect[3];
     UnitVect(AxisUnitVect, Axis);
 
     sinAngle = sin(Angle);
@@ -479,32 +479,32 @@ void RotateVectAroundSpecificAxis(double *OutputVector, double *InputVector,
 }
 
 /* Gives the angle of two vectors in radian*/
-double AngleOfTwoVectors(double *V, double *W, int dim) {
-    double V_1[3];
+real_t AngleOfTwoVectors(real_t *V, real_t *W, int dim) {
+    real_t V_1[3];
     UnitVect(V_1, V);
-    double W_1[3];
+    real_t W_1[3];
     UnitVect(W_1, W);
     return acos(ScalarProduct(V_1, W_1, dim));
 }
 
-double DistanceOfTwoPoints2D(double *P1, double *P2) {
-    double DifferenceVector[3];
+real_t DistanceOfTwoPoints2D(real_t *P1, real_t *P2) {
+    real_t DifferenceVector[3];
     VectDifference(DifferenceVector, P1, P2);
     return VectAbsXY(DifferenceVector);
 }
 
 /* Projects vector orthogonally onto a specific line in 3D */
-void ProjectVectOntoLine(double *OutputVector, double *InputVector,
-        double *LineDirectionVector) {
+void ProjectVectOntoLine(real_t *OutputVector, real_t *InputVector,
+        real_t *LineDirectionVector) {
 
     /* "u" is the unit vector of the line,
      * multiplication with P = u * u^T is a projection onto that line
      */
 
-    static double Temp[3];
+    static real_t Temp[3];
     FillVect(Temp, InputVector[0], InputVector[1], InputVector[2]);
 
-    static double u[3];
+    static real_t u[3];
     UnitVect(u, LineDirectionVector);
 
     OutputVector[0] =
@@ -519,27 +519,27 @@ void ProjectVectOntoLine(double *OutputVector, double *InputVector,
 }
 
 /* Projects vectors into a specific plane in 3D */
-void ProjectVectOntoPlane(double *OutputVector, double *InputVector,
-        double *PlaneNormalVector) {
+void ProjectVectOntoPlane(real_t *OutputVector, real_t *InputVector,
+        real_t *PlaneNormalVector) {
 
-    static double Temp[3];
+    static real_t Temp[3];
     NullVect(Temp, 3);
     ProjectVectOntoLine(Temp, InputVector, PlaneNormalVector);
     VectDifference(OutputVector, InputVector, Temp);
 }
 
 /* Distance from line in 3D */
-double DistanceFromLine(double *Point, double *SegmentEndPoint1,
-        double *SegmentEndPoint2) {
+real_t DistanceFromLine(real_t *Point, real_t *SegmentEndPoint1,
+        real_t *SegmentEndPoint2) {
 
-    static double Temp1[3];
+    static real_t Temp1[3];
     VectDifference(Temp1, SegmentEndPoint1, SegmentEndPoint2);
     UnitVect(Temp1, Temp1);
 
-    static double Temp2[3];
+    static real_t Temp2[3];
     VectDifference(Temp2, SegmentEndPoint1, Point);
 
-    static double Temp3[3];
+    static real_t Temp3[3];
     MultiplicateWithScalar(Temp3, Temp1, ScalarProduct(Temp2, Temp1, 3), 3);
     VectDifference(Temp3, Temp2, Temp3);
 
@@ -548,19 +548,19 @@ double DistanceFromLine(double *Point, double *SegmentEndPoint1,
 }
 
 /* Distance from line on the xy plane */
-double DistanceFromLineXY(double *Point, double *SegmentEndPoint1,
-        double *SegmentEndPoint2) {
+real_t DistanceFromLineXY(real_t *Point, real_t *SegmentEndPoint1,
+        real_t *SegmentEndPoint2) {
 
-    static double Temp1[3];
+    static real_t Temp1[3];
     VectDifference(Temp1, SegmentEndPoint1, SegmentEndPoint2);
     Temp1[2] = 0.0;
     UnitVect(Temp1, Temp1);
 
-    static double Temp2[3];
+    static real_t Temp2[3];
     VectDifference(Temp2, SegmentEndPoint1, Point);
     Temp2[2] = 0.0;
 
-    static double Temp3[3];
+    static real_t Temp3[3];
     MultiplicateWithScalar(Temp3, Temp1, ScalarProduct(Temp2, Temp1, 3), 3);
     VectDifference(Temp3, Temp2, Temp3);
 
@@ -579,12 +579,12 @@ double DistanceFromLineXY(double *Point, double *SegmentEndPoint1,
 shadow |           | shadow
 
 */
-int AtShadow(double *x1, double *x2, double *WhichPoint) {
+int AtShadow(real_t *x1, real_t *x2, real_t *WhichPoint) {
 
-    static double Temp1[3];
-    static double Temp2[3];
-    static double Temp3[3];
-    static double Temp4[3];
+    static real_t Temp1[3];
+    static real_t Temp2[3];
+    static real_t Temp3[3];
+    static real_t Temp4[3];
 
     VectDifference(Temp1, WhichPoint, x1);
     VectDifference(Temp2, WhichPoint, x2);
@@ -612,7 +612,7 @@ int AtShadow(double *x1, double *x2, double *WhichPoint) {
 }
 
 /* Checking that the position of "WhichPoint" is inside a polygon given by the vertex-set "Polygon" */
-bool IsInsidePolygon(double *WhichPoint, double *Polygon,
+bool IsInsidePolygon(real_t *WhichPoint, real_t *Polygon,
         const int NumberOfVertices) {
 
     if (NumberOfVertices < 3)
@@ -623,18 +623,18 @@ bool IsInsidePolygon(double *WhichPoint, double *Polygon,
     static bool Inside;
     Inside = false;
 
-    static double p1x;
+    static real_t p1x;
     p1x = Polygon[0];
-    static double p1y;
+    static real_t p1y;
     p1y = Polygon[1];
 
-    static double p2x;
-    static double p2y;
+    static real_t p2x;
+    static real_t p2y;
 
-    static double max;
-    static double min;
+    static real_t max;
+    static real_t min;
 
-    static double xints;
+    static real_t xints;
     xints = 0.0;
 
     for (i = 0; i <= NumberOfVertices; i++) {
@@ -679,15 +679,15 @@ bool IsInsidePolygon(double *WhichPoint, double *Polygon,
 }
 
 /* Multiplicate two N-dimensional square matrices */
-void MultiplicateSquareMatrices(double **Res, double **Mat1, double **Mat2,
+void MultiplicateSquareMatrices(real_t **Res, real_t **Mat1, real_t **Mat2,
         const int N) {
 
     int c, d, k;
-    static double sum;
+    static real_t sum;
     sum = 0.0;
 
-    double **Temp;
-    Temp = doubleMatrix(N, N);
+    real_t **Temp;
+    Temp = realMatrix(N, N);
 
     for (c = 0; c < N; c++) {
         for (d = 0; d < N; d++) {
@@ -706,13 +706,13 @@ void MultiplicateSquareMatrices(double **Res, double **Mat1, double **Mat2,
         }
     }
 
-    freeMatrix(Temp, N, N);
+    freeRealMatrix(Temp, N, N);
 
 }
 
 /* Calculates a power of an N-dimensional square matrix
  */
-void PowerFuncMatrix(double **Res, double **Mat, const int N,
+void PowerFuncMatrix(real_t **Res, real_t **Mat, const int N,
         const int Exponent) {
 
     int i, j;
@@ -733,13 +733,13 @@ void PowerFuncMatrix(double **Res, double **Mat, const int N,
 
 /* Other useful tools */
 
-double EMA(double x_current, double x_previous, double smoothing, int width) {
-    double multiplier = smoothing / (1 + width);
+real_t EMA(real_t x_current, real_t x_previous, real_t smoothing, int width) {
+    real_t multiplier = smoothing / (1 + width);
     return x_current * multiplier + x_previous * (1 - multiplier);
 }
 
 
-double ClampScalar(const double x, const double x_min, const double x_max) {
+real_t ClampScalar(const real_t x, const real_t x_min, const real_t x_max) {
     if (x <= x_min)
         return x_min;
     if (x >= x_max)
@@ -748,7 +748,7 @@ double ClampScalar(const double x, const double x_min, const double x_max) {
 }
 
 /* Sinusoidal sigmoid curve */
-double Sigmoid(const double x, const double gamma, const double r0) {
+real_t Sigmoid(const real_t x, const real_t gamma, const real_t r0) {
     if (x > r0) {
         return 0.0;
     } else if (x > r0 - gamma) {
@@ -758,7 +758,7 @@ double Sigmoid(const double x, const double gamma, const double r0) {
     }
 }
 
-double SigmoidLike(const double x, const double R, const double d) {
+real_t SigmoidLike(const real_t x, const real_t R, const real_t d) {
     if (x < R) {
         return 0.0;
     } else if (x < R + d) {
@@ -769,9 +769,9 @@ double SigmoidLike(const double x, const double R, const double d) {
 }
 
 /* linear "sigmoid" v(x) curve */
-double SigmoidLin(const double x, const double p, const double v_max,
-        const double r0) {
-    static double vel;
+real_t SigmoidLin(const real_t x, const real_t p, const real_t v_max,
+        const real_t r0) {
+    static real_t vel;
     vel = (r0 - x) * p;
     //if (p <= 0 || vel <= 0)
     if (p <= 0)
@@ -782,10 +782,10 @@ double SigmoidLin(const double x, const double p, const double v_max,
 }
 
 /* Square root - linear combined vel decay (-Sigmoid) curve */
-double VelDecayLinSqrt(const double x, const double p, const double acc,
-        const double v_max, const double r0) {
+real_t VelDecayLinSqrt(const real_t x, const real_t p, const real_t acc,
+        const real_t v_max, const real_t r0) {
     //v_max could be named v_diff
-    static double vel;
+    static real_t vel;
     /* linear v(x) phase */
     vel = (x - r0) * p;
     if (acc <= 0 || p <= 0 || vel <= 0)
@@ -802,17 +802,17 @@ double VelDecayLinSqrt(const double x, const double p, const double acc,
     return vel;
 }
 
-double StoppingDistanceLinSqrt(double v, double a, double p) {
+real_t StoppingDistanceLinSqrt(real_t v, real_t a, real_t p) {
     if (v < a / p)
         return v / p;
     return (v * v / a + a / p / p) / 2;
 }
 
 /* Calculating size of an arena for "NumberOfAgents" agents (up to N = 20) */
-double RadiusOfWayPointAreaFromNumberOfAgents(const int NumberOfAgents,
-        const double SizeOfAgent, const double Gamma) {
+real_t RadiusOfWayPointAreaFromNumberOfAgents(const int NumberOfAgents,
+        const real_t SizeOfAgent, const real_t Gamma) {
 
-    static const double Cinc[] = {
+    static const real_t Cinc[] = {
         1,                      /* 0 */
         1,                      /* 1 */
         2,                      /* 2 */
@@ -850,23 +850,23 @@ double RadiusOfWayPointAreaFromNumberOfAgents(const int NumberOfAgents,
 }
 
 /* Returns the tangent points and number of tangent points of a circle relative to "Point". */
-int TangentsOfCircle(double *TangentPoint1, double *TangentPoint2,
-        double *Point, double *CentreOfCircle, const double Radius) {
+int TangentsOfCircle(real_t *TangentPoint1, real_t *TangentPoint2,
+        real_t *Point, real_t *CentreOfCircle, const real_t Radius) {
 
-    static double TempVect[3];
+    static real_t TempVect[3];
     VectDifference(TempVect, CentreOfCircle, Point);
-    static double d;
+    static real_t d;
     d = VectAbsXY(TempVect);
 
     if (d < Radius) {           // What if "Point" is inside the circle?
         return 0;
     } else if (d > Radius) {
         UnitVect(TempVect, TempVect);
-        static double h;
+        static real_t h;
         h = sqrt(d * d - Radius * Radius);
         MultiplicateWithScalar(TempVect, TempVect, h, 2);
 
-        static double angle;
+        static real_t angle;
         angle = asin(Radius / d);
 
         RotateVectXY(TangentPoint1, TempVect, angle);
@@ -881,13 +881,13 @@ int TangentsOfCircle(double *TangentPoint1, double *TangentPoint2,
 
 }
 
-int TangentsOfSphereSlice(double *TangentPoint1, double *TangentPoint2,
-        double *Point, double *CentreOfCircle,
-        double *NormalVect, const double Radius) {
+int TangentsOfSphereSlice(real_t *TangentPoint1, real_t *TangentPoint2,
+        real_t *Point, real_t *CentreOfCircle,
+        real_t *NormalVect, const real_t Radius) {
 
     /* Check if Point is far enough from the centre */
 
-    static double FromCentre[3];
+    static real_t FromCentre[3];
     VectDifference(FromCentre, CentreOfCircle, Point);
 
     /* NormalVect should be perpendicular with "Centre" minus "Point" */
@@ -896,22 +896,22 @@ int TangentsOfSphereSlice(double *TangentPoint1, double *TangentPoint2,
 
     }
 
-    static double d;
+    static real_t d;
     d = VectAbs(FromCentre);
 
     if (d > Radius) {
 
         UnitVect(FromCentre, FromCentre);
-        static double YAxis[3];
+        static real_t YAxis[3];
         VectorialProduct(YAxis, FromCentre, NormalVect);
 
         // Now FromCentre, YAxis and NormalVect give us a Descartes system
 
-        static double h;
+        static real_t h;
         h = sqrt(d * d - Radius * Radius);
         MultiplicateWithScalar(FromCentre, FromCentre, h, 2);
 
-        static double angle;
+        static real_t angle;
         angle = asin(Radius / d);
 
         RotateVectAroundSpecificAxis(TangentPoint1, FromCentre, NormalVect,
@@ -932,13 +932,13 @@ int TangentsOfSphereSlice(double *TangentPoint1, double *TangentPoint2,
 }
 
 /* Intersection of a line segment and a half-line */
-bool IntersectionOfLineSegmentAndHalfLine(double *Intersection, double *A1,
-        double *A2, double *B, double *VB) {
+bool IntersectionOfLineSegmentAndHalfLine(real_t *Intersection, real_t *A1,
+        real_t *A2, real_t *B, real_t *VB) {
 
-    static double SA[3];
+    static real_t SA[3];
     VectDifference(SA, A2, A1);
 
-    static double t;
+    static real_t t;
     t = (SA[0] * VB[1] - SA[1] * VB[0]);
 
     if (fabs(t) < 0.0000000001) {
@@ -947,7 +947,7 @@ bool IntersectionOfLineSegmentAndHalfLine(double *Intersection, double *A1,
 
     }
 
-    static double s;
+    static real_t s;
     s = (-SA[1] * (A1[0] - B[0]) + SA[0] * (A1[1] - B[1])) / t;
     t = (VB[0] * (A1[1] - B[1]) - VB[1] * (A1[0] - B[0])) / t;
 
@@ -963,14 +963,14 @@ bool IntersectionOfLineSegmentAndHalfLine(double *Intersection, double *A1,
 }
 
 /* Intersection of two line segments */
-bool IntersectionOfLineSegments(double *Intersection, double *A1, double *A2,
-        double *B1, double *B2) {
-    static double SA[3];
+bool IntersectionOfLineSegments(real_t *Intersection, real_t *A1, real_t *A2,
+        real_t *B1, real_t *B2) {
+    static real_t SA[3];
     VectDifference(SA, A2, A1);
-    static double SB[3];
+    static real_t SB[3];
     VectDifference(SB, B2, B1);
 
-    static double t;
+    static real_t t;
     t = (SA[0] * SB[1] - SA[1] * SB[0]);
 
     if (fabs(t) < 0.0000000001) {
@@ -979,7 +979,7 @@ bool IntersectionOfLineSegments(double *Intersection, double *A1, double *A2,
 
     }
 
-    static double s;
+    static real_t s;
     s = (-SA[1] * (A1[0] - B1[0]) + SA[0] * (A1[1] - B1[1])) / t;
     t = (SB[0] * (A1[1] - B1[1]) - SB[1] * (A1[0] - B1[0])) / t;
 
@@ -995,10 +995,10 @@ bool IntersectionOfLineSegments(double *Intersection, double *A1, double *A2,
 }
 
 /* Intersection of two lines (2D) */
-double IntersectionOfLines2D(double *Intersection, double *RefPointA1,
-        double *RefPointA2, double *RefPointB1, double *RefPointB2) {
+real_t IntersectionOfLines2D(real_t *Intersection, real_t *RefPointA1,
+        real_t *RefPointA2, real_t *RefPointB1, real_t *RefPointB2) {
 
-    static double det;          // If det = 0, the lines are parallel
+    static real_t det;          // If det = 0, the lines are parallel
 
     det = (RefPointA1[0] - RefPointA2[0]) * (RefPointB1[1] - RefPointB2[1]) -
             (RefPointA1[1] - RefPointA2[1]) * (RefPointB1[0] - RefPointB2[0]);
@@ -1006,7 +1006,7 @@ double IntersectionOfLines2D(double *Intersection, double *RefPointA1,
     if (fabs(det) < 0.0000000001) {
         return -1.0;
     } else {
-        static double temp_coeff1, temp_coeff2;
+        static real_t temp_coeff1, temp_coeff2;
         temp_coeff1 =
                 RefPointA1[0] * RefPointA2[1] - RefPointA1[1] * RefPointA2[0];
         temp_coeff2 =
@@ -1022,10 +1022,10 @@ double IntersectionOfLines2D(double *Intersection, double *RefPointA1,
 
 }
 
-double IntersectionOfLines2D_Dir(double *Intersection, double *RefPointA,
-        double *DirectionA, double *RefPointB, double *DirectionB) {
+real_t IntersectionOfLines2D_Dir(real_t *Intersection, real_t *RefPointA,
+        real_t *DirectionA, real_t *RefPointB, real_t *DirectionB) {
 
-    double OtherPointOnA[3], OtherPointOnB[3];
+    real_t OtherPointOnA[3], OtherPointOnB[3];
     VectSum(OtherPointOnA, RefPointA, DirectionA);
     VectSum(OtherPointOnB, RefPointB, DirectionB);
     return IntersectionOfLines2D(Intersection, RefPointA, OtherPointOnA,
@@ -1033,9 +1033,9 @@ double IntersectionOfLines2D_Dir(double *Intersection, double *RefPointA,
 }
 
 /* Intersection of a line segment and a line (2D) */
-double IntersectionOfLineSegmentAndLine2D(double *Intersection,
-        double *RefPointOfLine1,
-        double *RefPointOfLine2, double *EndPoint1, double *EndPoint2) {
+real_t IntersectionOfLineSegmentAndLine2D(real_t *Intersection,
+        real_t *RefPointOfLine1,
+        real_t *RefPointOfLine2, real_t *EndPoint1, real_t *EndPoint2) {
 
     if (-1.0 ==
             IntersectionOfLines2D(Intersection, RefPointOfLine1,
@@ -1059,13 +1059,13 @@ double IntersectionOfLineSegmentAndLine2D(double *Intersection,
 /* Also returns the number of valid points, and two NULLs if no intersection */
 /* The two output vectors come in the order: the further in the direction of "DirectionOfLine", and the other */
 /* You don't have to create an empty vector for the intersection you don't care about, just simply give a NULL instead */
-int PointsOnLineAtAGivenDistanceFromOrigo3D(double *intersection1,
-        double *intersection2, double radius,
-        double *PointOnLine, double *DirectionOfLine) {
+int PointsOnLineAtAGivenDistanceFromOrigo3D(real_t *intersection1,
+        real_t *intersection2, real_t radius,
+        real_t *PointOnLine, real_t *DirectionOfLine) {
 
-    double n_dir[3];
+    real_t n_dir[3];
     UnitVect(n_dir, DirectionOfLine);
-    double b, c, lambda1, lambda2;
+    real_t b, c, lambda1, lambda2;
     b = 2 * ScalarProduct(PointOnLine, n_dir, 3);
     c = VectAbs(PointOnLine) * VectAbs(PointOnLine) - radius * radius;
     if (b * b - 4 * c < 0) {
@@ -1092,29 +1092,29 @@ int PointsOnLineAtAGivenDistanceFromOrigo3D(double *intersection1,
 
 /* Gives back the coordinates of two points on a line segment that are exactly "Distance" cm far from a reference point */
 /* Also returns the number of valid points */
-int PointsOnLineSegmentAtAGivenDistance3D(double *Point1, double *Point2,
-        double *EndPoint1, double *EndPoint2,
-        double *RefPoint, const double Distance) {
+int PointsOnLineSegmentAtAGivenDistance3D(real_t *Point1, real_t *Point2,
+        real_t *EndPoint1, real_t *EndPoint2,
+        real_t *RefPoint, const real_t Distance) {
 
     /* Calculating direction of line */
-    static double DirectionOfLine[3];
+    static real_t DirectionOfLine[3];
     VectDifference(DirectionOfLine, EndPoint2, EndPoint1);
     UnitVect(DirectionOfLine, DirectionOfLine);
 
-    static double Temp[3];
+    static real_t Temp[3];
     VectDifference(Temp, RefPoint, EndPoint1);
 
-    static double ProjDistOfEndPointFromRef;
+    static real_t ProjDistOfEndPointFromRef;
     ProjDistOfEndPointFromRef = ScalarProduct(DirectionOfLine, Temp, 3);
 
-    static double Temp2[3];
-    static double Temp3[3];
+    static real_t Temp2[3];
+    static real_t Temp3[3];
     MultiplicateWithScalar(Temp2, DirectionOfLine, ProjDistOfEndPointFromRef,
             3);
     VectSum(Temp2, Temp2, EndPoint1);
     VectDifference(Temp3, Temp2, RefPoint);
 
-    static double DistanceFromLine;
+    static real_t DistanceFromLine;
     DistanceFromLine = VectAbs(Temp3);
 
     if (DistanceFromLine > Distance) {
@@ -1126,7 +1126,7 @@ int PointsOnLineSegmentAtAGivenDistance3D(double *Point1, double *Point2,
         return 1;
     } else {
         /* There are two intersection points */
-        static double AdditiveTerm;
+        static real_t AdditiveTerm;
         AdditiveTerm =
                 sqrt(Distance * Distance - DistanceFromLine * DistanceFromLine);
 
@@ -1140,10 +1140,10 @@ int PointsOnLineSegmentAtAGivenDistance3D(double *Point1, double *Point2,
     }
 }
 
-bool ClosestPointOfLines3D(double *P0, double *u, double *Q0, double *v,
-        double *s, double *t) {
-    double w0[3];
-    double a, b, c, d, e;
+bool ClosestPointOfLines3D(real_t *P0, real_t *u, real_t *Q0, real_t *v,
+        real_t *s, real_t *t) {
+    real_t w0[3];
+    real_t a, b, c, d, e;
     bool is_parallel = false;
     // initialize variables
     VectDifference(w0, P0, Q0);
@@ -1168,21 +1168,21 @@ bool ClosestPointOfLines3D(double *P0, double *u, double *Q0, double *v,
 
 /* Generates a random vector on a unit halph-sphere
  * Coordination of the halph-sphere is given by an axis, which is the normal vector of the base circle */
-void GenerateVectOnHalfSphere(double *OutputVector, double *Axis) {
+void GenerateVectOnHalfSphere(real_t *OutputVector, real_t *Axis) {
 
     //Setting up a random vector on a sphere.
     UnitVect(Axis, Axis);
-    static double Temp[3];
+    static real_t Temp[3];
     NullVect(Temp, 3);
     Temp[0] = 1.0;
     RotateVectZX(Temp, Temp, randomizeDouble(-M_PI, M_PI));
     RotateVectXY(Temp, Temp, randomizeDouble(-M_PI, M_PI));
 
     //Setting up its reflection, if it is necessary
-    static double Product;
+    static real_t Product;
     Product = ScalarProduct(Axis, Temp, 3);
     if (Product < 0.0) {
-        static double MirroredTemp[3];
+        static real_t MirroredTemp[3];
         NullVect(MirroredTemp, 3);
         VectSum(MirroredTemp, MirroredTemp, Axis);
         MultiplicateWithScalar(MirroredTemp, MirroredTemp, 2 * Product, 3);
@@ -1199,11 +1199,11 @@ void GenerateVectOnHalfSphere(double *OutputVector, double *Axis) {
 /* Tools for cell decomposition (these can be useful for path planning) */
 
 /* Is there any intersection of two polygons? */
-bool IntersectingPolygons(double **Polygon1, const int NumberOfVertices1,
-        double **Polygon2, const int NumberOfVertices2) {
+bool IntersectingPolygons(real_t **Polygon1, const int NumberOfVertices1,
+        real_t **Polygon2, const int NumberOfVertices2) {
 
     int i, j;
-    static double TempIntersection[3];
+    static real_t TempIntersection[3];
 
     for (i = 0; i < NumberOfVertices1; i++) {
 
@@ -1228,7 +1228,7 @@ bool IntersectingPolygons(double **Polygon1, const int NumberOfVertices1,
 }
 
 /* Calculating the CoM of polygon points in 2D */
-void CentreOfPolygon2D(double *CentrePoint, double *Polygon,
+void CentreOfPolygon2D(real_t *CentrePoint, real_t *Polygon,
         const int NumberOfVertices) {
 
     NullVect(CentrePoint, 3);
@@ -1249,16 +1249,16 @@ void CentreOfPolygon2D(double *CentrePoint, double *Polygon,
 
 }
 
-void CentroidOfPolygon2D(double *CentroidPoint, double *Polygon,
+void CentroidOfPolygon2D(real_t *CentroidPoint, real_t *Polygon,
         const int NumberOfVertices) {
     CentroidPoint[0] = 0;
     CentroidPoint[1] = 0;
-    double signedArea = 0.0;
-    double x0 = 0.0;            // Current vertex X
-    double y0 = 0.0;            // Current vertex Y
-    double x1 = 0.0;            // Next vertex X
-    double y1 = 0.0;            // Next vertex Y
-    double a = 0.0;             // Partial signed area
+    real_t signedArea = 0.0;
+    real_t x0 = 0.0;            // Current vertex X
+    real_t y0 = 0.0;            // Current vertex Y
+    real_t x1 = 0.0;            // Next vertex X
+    real_t y1 = 0.0;            // Next vertex Y
+    real_t a = 0.0;             // Partial signed area
 
     // For all vertices except last
     int i = 0;
@@ -1288,16 +1288,16 @@ void CentroidOfPolygon2D(double *CentroidPoint, double *Polygon,
 }
 
 /* Returns the intersection points of a polygon and a segment */
-int IntersectionOfSegmentAndPolygon2D(double ** IntersectionPoints,
-        double *RefPoint1, double *RefPoint2, 
-        double *Polygon, const int NumberOfVertices) {
+int IntersectionOfSegmentAndPolygon2D(real_t ** IntersectionPoints,
+        real_t *RefPoint1, real_t *RefPoint2, 
+        real_t *Polygon, const int NumberOfVertices) {
 
     int i;
     int NumberOfIntersections = 0;
 
-    static double TempVect1[3];
-    static double TempVect2[3];
-    static double TempIntersect[3];
+    static real_t TempVect1[3];
+    static real_t TempVect2[3];
+    static real_t TempIntersect[3];
 
     for (i = 0; i < NumberOfVertices * 2; i += 2) {
         FillVect(TempVect1, Polygon[i], Polygon[i + 1], 0.0);
@@ -1315,18 +1315,18 @@ int IntersectionOfSegmentAndPolygon2D(double ** IntersectionPoints,
 
 /* Creating envelope polygon around set of polygons (in 2D, XY coordinate system) */
 /* The envelope square contains all of the polygons */
-void CreateEnvelopeSquareAroundPolygons(double **EnvelopeSquareCoords,
-        double **Polygons, int *NumberOfVertices, const int NumberOfPolygons) {
+void CreateEnvelopeSquareAroundPolygons(real_t **EnvelopeSquareCoords,
+        real_t **Polygons, int *NumberOfVertices, const int NumberOfPolygons) {
 
     /* Searching for largest and smallest XY coordinates */
     int i, j;
-    static double smallestx;
+    static real_t smallestx;
     smallestx = 2e222;
-    static double largestx;
+    static real_t largestx;
     largestx = -2e222;
-    static double smallesty;
+    static real_t smallesty;
     smallesty = 2e222;
-    static double largesty;
+    static real_t largesty;
     largesty = -2e222;
 
     for (i = 0; i < NumberOfPolygons; i++) {
@@ -1352,9 +1352,9 @@ void CreateEnvelopeSquareAroundPolygons(double **EnvelopeSquareCoords,
     }
 
     /* Craeting envelope square */// Cutting trees, sorry!
-    static double plussize_x;
+    static real_t plussize_x;
     plussize_x = fabs(largestx - smallestx) * 0.5;
-    static double plussize_y;
+    static real_t plussize_y;
     plussize_y = fabs(largesty - smallesty) * 0.5;
 
     EnvelopeSquareCoords[0][0] = smallestx - plussize_x;
@@ -1372,15 +1372,15 @@ void CreateEnvelopeSquareAroundPolygons(double **EnvelopeSquareCoords,
 }
 
 /* Creating set of convex polygons for simple cell decomposition */
-int CreateCellDecompositionPolygons(double **OutputConvexPolygonSet,
-        double **EnvelopeSquare, double **Polygons,
+int CreateCellDecompositionPolygons(real_t **OutputConvexPolygonSet,
+        real_t **EnvelopeSquare, real_t **Polygons,
         int *NumberOfVertices, const int NumberOfPolygons) {
 
     int i, j, k;
     int n = 0;
 
-    static double TempCoord_1[3];
-    static double TempCoord_2[3];
+    static real_t TempCoord_1[3];
+    static real_t TempCoord_2[3];
 
     for (i = 0; i < NumberOfPolygons; i++) {
 
@@ -1420,19 +1420,19 @@ x-1      |             and not if              |
          x-Ref                              x-1
 */
 
-bool TwoPointsOnSameSideOfAPoint(double *Point1, double *Point2,
-        double *ReferencePoint) {
-    double Temp1[3];
-    double Temp2[3];
+bool TwoPointsOnSameSideOfAPoint(real_t *Point1, real_t *Point2,
+        real_t *ReferencePoint) {
+    real_t Temp1[3];
+    real_t Temp2[3];
     VectDifference(Temp1, Point1, ReferencePoint);
     VectDifference(Temp2, Point2, ReferencePoint);
     return (ScalarProduct(Temp1, Temp2, 3) >= 0);
 }
 
-double polygonArea(double *X, double *Y, int n)
+real_t polygonArea(real_t *X, real_t *Y, int n)
 {
     // Initialze area
-    double area = 0.0;
+    real_t area = 0.0;
  
     // Calculate value of shoelace formula
     int j = n - 1;
@@ -1466,12 +1466,13 @@ node *convex_hull(point_xy *points, int n)
 
     // Find the coordinate with the smallest y-value. Ties are broken
     // by comparing the x-value.
-    int ymin, min;
+    real_t ymin;
+    int min;
     ymin = points[0].y;
     min = 0;
     for(i = 1; i < n; ++i)
     {
-        int y = points[i].y;
+        real_t y = points[i].y;
         if ((y < ymin) || (ymin == y && points[i].x < points[min].x))
         {
             ymin = points[i].y;
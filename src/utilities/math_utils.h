@@ -16,6 +16,7 @@
 #include <stdbool.h>
 #include <ctype.h>
 #include "stack.h"
+#include "precision.h"
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -63,172 +64,172 @@ char * fromDeci(char res[], int base, int inputNum);
  * VectToFill is the output vector
  * x, y and z are the 0th, 1st and 2nd components of the output vector, respectively
  */
-void FillVect(double *VectToFill, const double x, const double y,
-        const double z);
+void FillVect(real_t *VectToFill, const real_t x, const real_t y,
+        const real_t z);
 
 /* Return a vector with the indexes corresponding to a sorted vector */
-void ArgMaxSort(double *InputVect, int Length, int * IndexVect);
+void ArgMaxSort(real_t *InputVect, int Length, int * IndexVect);
 
 /* Returns the sum of all components of a vector */
 int InnerSum(int *InputVector, int Dim);
 
 /* Returns the Magnitude of the input vector (3 dimensions)
  */
-double VectAbs(double *InputVector);
+real_t VectAbs(real_t *InputVector);
 
 /* Returns the XY-projected Magnitude of the input vector
  * Useful for calculating pair-potentials of 2 dimensional models
  */
-double VectAbsXY(double *InputVector);
+real_t VectAbsXY(real_t *InputVector);
 
-void VectDifference2D(double *ABDiff, double *VectA, double *VectB);
+void VectDifference2D(real_t *ABDiff, real_t *VectA, real_t *VectB);
 
 /* Difference of two vectors (3D)
  * "ABDiff" is the difference of the vectors "VectA" and "VectB"
  * ABDiff = VectA - VectB
  */
-void VectDifference(double *ABDiff, double *VectA, double *VectB);
+void VectDifference(real_t *ABDiff, real_t *VectA, real_t *VectB);
 
 /* Sum of two vectors (3D)
  * "ABSum" is the sum of "VectA" and "VectB"
  * ABSum = VectA + VectB
  */
-void VectSum(double *ABSum, double *VectA, double *VectB);
+void VectSum(real_t *ABSum, real_t *VectA, real_t *VectB);
 
 /* Fills up a vector with zero values
  * "VectorToNull" will be a vector filled with zeroes
  * "Dim" defines the number of components
  */
-void NullVect(double *VectorToNull, const int Dim);
+void NullVect(real_t *VectorToNull, const int Dim);
 
 /* Fills up a matrix with zero values
  * "MatrixToNull" will be a matrix filled with zeroes
  * "rows" and "cols" define the number of components in 2D
  */
-void NullMatrix(double **MatrixToNull, const int rows, const int cols);
+void NullMatrix(real_t **MatrixToNull, const int rows, const int cols);
 
 /* Find maximum value of a matrix except on diagonal */
-double MaxMatrix(double **Matrix, const int rows, const int cols);
+real_t MaxMatrix(real_t **Matrix, const int rows, const int cols);
 
 /* Multiplicates a vector with a scalar value (3D)
  * "OutputVector" will be "VectorToMultiplicate" Multiplicated by "Scalar"
  * "Dim" defines the number of components
  */
-void MultiplicateWithScalar(double *OutputVector,
-        double *VectorToMultiplicate, const double Scalar, const int Dim);
+void MultiplicateWithScalar(real_t *OutputVector,
+        real_t *VectorToMultiplicate, const real_t Scalar, const int Dim);
 
 /* Returns the scalar product of two vectors
  * The return value will be the inner product of the vectors "A" and "B"
  * "Dim" defines the number of components
  */
-double ScalarProduct(double *A, double *B, const int Dim);
+real_t ScalarProduct(real_t *A, real_t *B, const int Dim);
 
 /* Outer product of two vectors (3D)
  * "Result" will be the vectorial product of the vectors "Vector1" and "Vector2"
  * Only works fine in 3 dimensions
  */
-void VectorialProduct(double *Result, double *Vector1, double *Vector2);
+void VectorialProduct(real_t *Result, real_t *Vector1, real_t *Vector2);
 
 /* Creates a unit vector (parallel with the input vector)
  * "OutputVector" will be "InputVector" divided by the Length of "InputVector"
  * If the Length of "InputVector" is 0, then OutputVector will be filled with zeroes
  * Works fine in 3 dimensions
  */
-void UnitVect(double *OutputVector, double *InputVector);
+void UnitVect(real_t *OutputVector, real_t *InputVector);
 
 /* Same as UnitVect, but it doesn't give back a 1 long vector, but a value long one
 */
-void NormalizeVector(double *OutputVector, double *InputVector, double value);
+void NormalizeVector(real_t *OutputVector, real_t *InputVector, real_t value);
 
 /* Sigma norm calculation (related to Olfati Saber method) */
-double SigmaNorm(double *InputVector, double epsilon);
+real_t SigmaNorm(real_t *InputVector, real_t epsilon);
 
 /* Compute the sigma gradient */
-void SigmaGrad(double *OuptutVector, double *InputVector, double epsilon, const int Dim);
+void SigmaGrad(real_t *OuptutVector, real_t *InputVector, real_t epsilon, const int Dim);
 
 /* Bump function which is a function that smoothly varies between 0 and 1 */
-double BumpFunction(double Input, double h);
+real_t BumpFunction(real_t Input, real_t h);
 
 /* Rotates vector around Z axis
  * "OutputVector" will be the "InputVector" rotated with "Angle" around Z axis
  * "Angle" should be in radians
  */
-void RotateVectXY(double *OutputVector, double *InputVector,
-        const double Angle);
+void RotateVectXY(real_t *OutputVector, real_t *InputVector,
+        const real_t Angle);
 
 /* Rotates vector around X axis
  * "OutputVector" will be the "InputVector" rotated with "Angle" around x axis
  * "Angle" should be in radians
  */
-void RotateVectZY(double *OutputVector, double *InputVector,
-        const double Angle);
+void RotateVectZY(real_t *OutputVector, real_t *InputVector,
+        const real_t Angle);
 
 /* Rotates vector around Y axis
  * "OutputVector" will be the "InputVector" rotated with "Angle" around Y axis
  * "Angle" should be in radians
  */
-void RotateVectZX(double *OutputVector, double *InputVector,
-        const double Angle);
+void RotateVectZX(real_t *OutputVector, real_t *InputVector,
+        const real_t Angle);
 
 /* Rodrigues formula (for rotating vectors around a specific axis)
  * "OutputVector will be the "InputVector" rotated around a specific axis defined by "Axis"
  * angle determines the angle of the rotation.
  */
-void RotateVectAroundSpecificAxis(double *OutputVector, double *InputVector,
-        double *Axis, const double Angle);
+void RotateVectAroundSpecificAxis(real_t *OutputVector, real_t *InputVector,
+        real_t *Axis, const real_t Angle);
 
 /* Gives the angle of two 3D vectors in
 */
-double AngleOfTwoVectors(double *V, double *W, int dim);
+real_t AngleOfTwoVectors(real_t *V, real_t *W, int dim);
 // Gives the distance of two points in 2D;
-double DistanceOfTwoPoints2D(double *P1, double *P2);
+real_t DistanceOfTwoPoints2D(real_t *P1, real_t *P2);
 
 /* Projects vectors onto a specific line
  * "LineDirectionVector" defines the orientation of the line
  */
 
-void ProjectVectOntoLine(double *OutputVector, double *InputVector,
-        double *LineDirectionVector);
+void ProjectVectOntoLine(real_t *OutputVector, real_t *InputVector,
+        real_t *LineDirectionVector);
 
 /* Projects vectors onto a specific plane
  * "PlaneDirectionVector" is a normal vector which gives the direction perpendicular to the plane.
  */
-void ProjectVectOntoPlane(double *OutputVector, double *InputVector,
-        double *PlaneNormalVector);
+void ProjectVectOntoPlane(real_t *OutputVector, real_t *InputVector,
+        real_t *PlaneNormalVector);
 
 /* Calculating distance between a point and a line
  * SegmentEndPoint1 and SegmentEndPoint2 are two vectors defining the line
  */
-double DistanceFromLine(double *Point, double *SegmentEndpoint1,
-        double *SegmentEndPoint2);
-double DistanceFromLineXY(double *Point, double *SegmentEndPoint1,
-        double *SegmentEndPoint2);
+real_t DistanceFromLine(real_t *Point, real_t *SegmentEndpoint1,
+        real_t *SegmentEndPoint2);
+real_t DistanceFromLineXY(real_t *Point, real_t *SegmentEndPoint1,
+        real_t *SegmentEndPoint2);
 
 /* Checking that the position of "WhichPoint" is inside the "shadow" of x_1 and x_2 (in 2D)
  * Returns 1 if CW-outside, -1 if CW-inside and 0 if not in shadow at all.
  */
-int AtShadow(double *x1, double *x2, double *WhichPoint);
+int AtShadow(real_t *x1, real_t *x2, real_t *WhichPoint);
 
 /* Checking that the position of "WhichPoint" is inside a polygon given by the vertex-set "Polygon"
  */
-bool IsInsidePolygon(double *WhichPoint, double *Polygon,
+bool IsInsidePolygon(real_t *WhichPoint, real_t *Polygon,
         const int NumberOfVertices);
 
 /* Multiplicate two N-dimensional square matrices
  */
-void MultiplicateSquareMatrices(double **Res, double **Mat1, double **Mat2,
+void MultiplicateSquareMatrices(real_t **Res, real_t **Mat1, real_t **Mat2,
         const int N);
 
 /* Calculates a power of an N-dimensional square matrix
  */
-void PowerFuncMatrix(double **Res, double **Mat, const int N,
+void PowerFuncMatrix(real_t **Res, real_t **Mat, const int N,
         const int Exponent);
 
 /* Other useful tools */
 
-double EMA(double x_current, double x_previous, double smoothing, int width);
+real_t EMA(real_t x_current, real_t x_previous, real_t smoothing, int width);
 
-double ClampScalar(const double x, const double x_min, const double x_max);
+real_t ClampScalar(const real_t x, const real_t x_min, const real_t x_max);
 
 /*
  * Sinusoidal sigmoid curve
@@ -237,7 +238,7 @@ double ClampScalar(const double x, const double x_min, const double x_max);
  *     g \
  *       r0---> x
  */
-double Sigmoid(const double x, const double gamma, const double r0);
+real_t Sigmoid(const real_t x, const real_t gamma, const real_t r0);
 
 
 /*
@@ -247,7 +248,7 @@ double Sigmoid(const double x, const double gamma, const double r0);
  *        /
  * 0 ----     
  */
-double SigmoidLike(const double x, const double R, const double d);
+real_t SigmoidLike(const real_t x, const real_t R, const real_t d);
 
 /*
  * Linear-gain thresholded sigmoid v(x) curve
@@ -256,8 +257,8 @@ double SigmoidLike(const double x, const double R, const double d);
  *         p \
  *           r0---> x
  */
-double SigmoidLin(const double x, const double p, const double v_max,
-        const double r0);
+real_t SigmoidLin(const real_t x, const real_t p, const real_t v_max,
+        const real_t r0);
 
 /*
  * Square root - linear combined velocity decay curve
@@ -269,18 +270,18 @@ double SigmoidLin(const double x, const double p, const double v_max,
  *  |        / p,a
  *  |------r0-----------> x
  */
-double VelDecayLinSqrt(const double x, const double p, const double acc,
-        const double v_max, const double r0);
+real_t VelDecayLinSqrt(const real_t x, const real_t p, const real_t acc,
+        const real_t v_max, const real_t r0);
 
 /*
  * The inverse of the VelDecayLinSqrt function
  */
-double StoppingDistanceLinSqrt(double v, double a, double p);
+real_t StoppingDistanceLinSqrt(real_t v, real_t a, real_t p);
 
 /* Calculating optimal size of an arena for "NumberOfAgents" agents
  */
-double RadiusOfWayPointAreaFromNumberOfAgents(const int NumberOfAgents,
-        const double SizeOfAgent, const double Gamma);
+real_t RadiusOfWayPointAreaFromNumberOfAgents(const int NumberOfAgents,
+        const real_t SizeOfAgent, const real_t Gamma);
 
 /* Returns the tangent points ("TangentPoint1" and "TangentPoint2")
  * and number of target points (return value)
@@ -292,11 +293,11 @@ double RadiusOfWayPointAreaFromNumberOfAgents(const int NumberOfAgents,
  *                              \__/
  *
  */
-int TangentsOfCircle(double *TangentPoint1, double *TangentPoint2,
-        double *Point, double *CentreOfCircle, const double Radius);
-int TangentsOfSphereSlice(double *TangentPoint1, double *TangentPoint2,
-        double *Point, double *CentreOfCircle,
-        double *NormalVect, const double Radius);
+int TangentsOfCircle(real_t *TangentPoint1, real_t *TangentPoint2,
+        real_t *Point, real_t *CentreOfCircle, const real_t Radius);
+int TangentsOfSphereSlice(real_t *TangentPoint1, real_t *TangentPoint2,
+        real_t *Point, real_t *CentreOfCircle,
+        real_t *NormalVect, const real_t Radius);
 
 /* Intersection of the line segments A and B.
  * Line segment A is given by its two endpoints (A1, A2)
@@ -305,84 +306,84 @@ int TangentsOfSphereSlice(double *TangentPoint1, double *TangentPoint2,
  * If the return value is "-1", then the intersection point doesn't exist.
  */
 // !!! TODO: What if a line segment contains the other line segment?
-bool IntersectionOfLineSegmentAndHalfLine(double *Intersection, double *A1,
-        double *A2, double *B, double *VB);
-bool IntersectionOfLineSegments(double *Intersection, double *A1, double *A2,
-        double *B1, double *B2);
-double IntersectionOfLines2D(double *Intersection, double *RefPointA1,
-        double *RefPointA2, double *RefPointB1, double *RefpointB2);
-double IntersectionOfLines2D_Dir(double *Intersection, double *RefPointA,
-        double *DirectionA, double *RefPointB, double *DirectionB);
-double IntersectionOfLineSegmentAndLine2D(double *Intersection,
-        double *RefPointOfLine1,
-        double *RefPoinrOfLine2, double *EndPoint1, double *EndPoint2);
+bool IntersectionOfLineSegmentAndHalfLine(real_t *Intersection, real_t *A1,
+        real_t *A2, real_t *B, real_t *VB);
+bool IntersectionOfLineSegments(real_t *Intersection, real_t *A1, real_t *A2,
+        real_t *B1, real_t *B2);
+real_t IntersectionOfLines2D(real_t *Intersection, real_t *RefPointA1,
+        real_t *RefPointA2, real_t *RefPointB1, real_t *RefpointB2);
+real_t IntersectionOfLines2D_Dir(real_t *Intersection, real_t *RefPointA,
+        real_t *DirectionA, real_t *RefPointB, real_t *DirectionB);
+real_t IntersectionOfLineSegmentAndLine2D(real_t *Intersection,
+        real_t *RefPointOfLine1,
+        real_t *RefPoinrOfLine2, real_t *EndPoint1, real_t *EndPoint2);
 
 /* Gives back the coordinates of two points on a line that are exactly "radius" far from the origo */
 /* Also returns the number of valid points, and two NULLs if no intersection */
 /* The two output vectors come in the order: the further in the direction of "DirectionOfLine", and the other */
 /* You don't have to create an empty vector for the intersection you don't care about, just simply give a NULL instead */
 
-int PointsOnLineAtAGivenDistanceFromOrigo3D(double *intersection1,
-        double *intersection2,
-        double radius, double *PointOnLine, double *DirectionOfLine);
+int PointsOnLineAtAGivenDistanceFromOrigo3D(real_t *intersection1,
+        real_t *intersection2,
+        real_t radius, real_t *PointOnLine, real_t *DirectionOfLine);
 
 /* Gives back the coordinates of two points ("Point1" and "Point2") on a line segment (defined by "EndPoint1" and "EndPoint2")
  * that are exactly "Distance" cm far from a reference point ("RefPoint"). Returns the number of valid points (0, 1 or 2)
  * This function also can be interpreted as the intersection points of a sphere and a line
  */
-int PointsOnLineSegmentAtAGivenDistance3D(double *Point1, double *Point2,
-        double *EndPoint1,
-        double *EndPoint2, double *RefPoint, const double Distance);
+int PointsOnLineSegmentAtAGivenDistance3D(real_t *Point1, real_t *Point2,
+        real_t *EndPoint1,
+        real_t *EndPoint2, real_t *RefPoint, const real_t Distance);
 
 /* Calculates the closest points on two lines
  * For algo details see: http://geomalgorithms.com/a07-_distance.html#dist3D_Segment_to_Segment
  * Line A is P0 + s*u, line B is Q0 + tv, s and t are calculated as scalars for closest point.
  * return value is true if lines are parallel
  */
-bool ClosestPointOfLines3D(double *P0, double *u, double *Q0, double *v,
-        double *s, double *t);
+bool ClosestPointOfLines3D(real_t *P0, real_t *u, real_t *Q0, real_t *v,
+        real_t *s, real_t *t);
 
 /* Generates a random vector on a unit halph-sphere
  * Coordination of the halph-sphere is given by an axis ("Axis"), which is the normal vector of the base circle
  * Result vector will be placed into "OutputVector".
  */
-void GenerateVectOnHalfSphere(double *OutputVector, double *Axis);
+void GenerateVectOnHalfSphere(real_t *OutputVector, real_t *Axis);
 
 /* Is there any intersection between two polygons?
  * "Polygon1" and "Polygon2" are 2D arrays with NumberOfVertices(1/2) * 2 components.
  */
-bool IntersectingPolygons(double **Polygon1, const int NumberOfVertices1,
-        double **Polygon2, const int NumberOfVertices2);
+bool IntersectingPolygons(real_t **Polygon1, const int NumberOfVertices1,
+        real_t **Polygon2, const int NumberOfVertices2);
 
 /* Calculating the CoM of polygon points in 2D
  * "Polygon" is the set of vertices, it has "NumberOfVertices*2" components.
  * "CentrePoint" will contain the output centre of mass
  */
-void CentreOfPolygon2D(double *CentrePoint, double *Polygon,
+void CentreOfPolygon2D(real_t *CentrePoint, real_t *Polygon,
         const int NumberOfVertices);
 
 /* Calculating the CoM (centroid) of a polygon in 2D
  * "Polygon" is the set of vertices, it has "NumberOfVertices*2" components.
  * "CentroidPoint" will contain the centroid point of the polygon
  */
-void CentroidOfPolygon2D(double *CentroidPoint, double *Polygon,
+void CentroidOfPolygon2D(real_t *CentroidPoint, real_t *Polygon,
         const int NumberOfVertices);
 
 /* Calculating the intersection points of a polygon and a segment.
  * Also returns the number of intersections.
  * segment is given by the reference points "RefPoint1" and "RefPoint2"
  */
-int IntersectionOfSegmentAndPolygon2D(double **IntersectionPoints,
-        double *RefPoint1, double *RefPoint2, 
-        double *Polygon, const int NumberOfVertices);
+int IntersectionOfSegmentAndPolygon2D(real_t **IntersectionPoints,
+        real_t *RefPoint1, real_t *RefPoint2, 
+        real_t *Polygon, const int NumberOfVertices);
 
 /* Creating envelope polygon around set of polygons (in 2D, XY coordinate system)
  * "EnvelopeSquareCoords" is a 4*2 matrix, contains the output coordinates of the envelope square
  * "Polygons" contains the coordinates of all polygons. It has "NumberOfPolygons" rows,
  * and "NumberOfVertices[i]*2" columns at the ith row (for XY coordinates placed).
  */
-void CreateEnvelopeSquareAroundPolygons(double **EnvelopeSquareCoords,
-        double **Polygons, int *NumberOfVertices, const int NumberOfPolygons);
+void CreateEnvelopeSquareAroundPolygons(real_t **EnvelopeSquareCoords,
+        real_t **Polygons, int *NumberOfVertices, const int NumberOfPolygons);
 
 /*
 Point1 and Point2 are on the same side of ReferencePoint if:
@@ -393,11 +394,11 @@ x-1      |             and not if              |
       \_ |                                   _/
          x-Ref                              x-1
 */
-bool TwoPointsOnSameSideOfAPoint(double *Point1, double *Point2,
-        double *ReferencePoint);
+bool TwoPointsOnSameSideOfAPoint(real_t *Point1, real_t *Point2,
+        real_t *ReferencePoint);
 
 /* Return the area of a polygon */
-double polygonArea(double *X, double *Y, int n);
+real_t polygonArea(real_t *X, real_t *Y, int n);
 
 // Returns a node pointer to the first node in a stack containing
 // the list of points in the convex hull
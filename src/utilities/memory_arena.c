@@ -0,0 +1,161 @@
+//MIT License
+//Copyright (c) 2018 Eotvos Lorand University, Budapest
+
+/* vim:set ts=4 sw=4 sts=4 et: */
+
+/*
+ * Arena allocator.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "memory_arena.h"
+
+memory_arena_t StepArena;
+memory_arena_t FrameArena;
+
+/* Size of the overflow header, keeping the arrays aligned */
+#define ARENA_OVERFLOW_HEADER \
+    ((sizeof(memory_arena_overflow_t) + ARENA_ALIGNMENT - 1) & ~((size_t) ARENA_ALIGNMENT - 1))
+
+void AllocateArena(memory_arena_t * Arena, const size_t Size) {
+
+    Arena->Block = NULL;
+    if (Size > 0) {
+        Arena->Block = (char *) aligned_alloc(ARENA_ALIGNMENT,
+                (Size + ARENA_ALIGNMENT - 1) & ~((size_t) ARENA_ALIGNMENT - 1));
+        if (!Arena->Block) {
+            fprintf(stderr, "Arena allocation error!\n");
+            exit(-1);
+        }
+        COUNT_HEAP_ALLOCATIONS(1);
+    }
+    Arena->Size = Size;
+    Arena->Used = 0;
+    Arena->Overflows = NULL;
+    Arena->OverflowSize = 0;
+    Arena->HighWater = 0;
+
+}
+
+static void freeOverflows(memory_arena_t * Arena) {
+
+    memory_arena_overflow_t *Overflow;
+
+    while (Arena->Overflows) {
+        Overflow = Arena->Overflows;
+        Arena->Overflows = Overflow->Next;
+        free(Overflow);
+    }
+
+}
+
+void freeArena(memory_arena_t * Arena) {
+
+    freeOverflows(Arena);
+    free(Arena->Block);
+    Arena->Block = NULL;
+    Arena->Size = 0;
+    Arena->Used = 0;
+    Arena->OverflowSize = 0;
+
+}
+
+void ResetArena(memory_arena_t * Arena) {
+
+    size_t NewSize;
+
+    if (Arena->Overflows) {
+        /* Everything needed since the last reset fits into the new block */
+        NewSize = Arena->HighWater + Arena->OverflowSize;
+        NewSize += NewSize / 2;
+        freeOverflows(Arena);
+        freeArena(Arena);
+        AllocateArena(Arena, NewSize);
+    }
+    Arena->Used = 0;
+
+}
+
+memory_arena_mark_t ArenaMark(memory_arena_t * Arena) {
+
+    return Arena->Used;
+
+}
+
+void ArenaRelease(memory_arena_t * Arena, const memory_arena_mark_t Mark) {
+
+    /* Overflow arrays are kept until the next reset */
+    if (Mark <= Arena->Used) {
+        Arena->Used = Mark;
+    }
+
+}
+
+void *ArenaAlloc(memory_arena_t * Arena, const size_t Bytes) {
+
+    size_t Aligned = (Bytes + ARENA_ALIGNMENT - 1) & ~((size_t) ARENA_ALIGNMENT - 1);
+    memory_arena_overflow_t *Overflow;
+    void *Array;
+
+    if (Arena->Used + Aligned <= Arena->Size) {
+        Array = Arena->Block + Arena->Used;
+        Arena->Used += Aligned;
+        if (Arena->Used > Arena->HighWater) {
+            Arena->HighWater = Arena->Used;
+        }
+        return Array;
+    }
+
+    Overflow = (memory_arena_overflow_t *) aligned_alloc(ARENA_ALIGNMENT,
+            ARENA_OVERFLOW_HEADER + Aligned);
+    if (!Overflow) {
+        fprintf(stderr, "Arena overflow allocation error!\n");
+        exit(-1);
+    }
+    COUNT_HEAP_ALLOCATIONS(1);
+    Overflow->Next = Arena->Overflows;
+    Arena->Overflows = Overflow;
+    Arena->OverflowSize += Aligned;
+
+    return (char *) Overflow + ARENA_OVERFLOW_HEADER;
+
+}
+
+bool *ArenaBooleanData(memory_arena_t * Arena, const int size) {
+
+    bool *bools = (bool *) ArenaAlloc(Arena, size * sizeof(bool));
+    memset(bools, 0, size * sizeof(bool));
+    return bools;
+
+}
+
+int *ArenaIntData(memory_arena_t * Arena, const int size) {
+
+    int *ints = (int *) ArenaAlloc(Arena, size * sizeof(int));
+    memset(ints, 0, size * sizeof(int));
+    return ints;
+
+}
+
+real_t *ArenaRealVector(memory_arena_t * Arena, const int size) {
+
+    real_t *vect = (real_t *) ArenaAlloc(Arena, size * sizeof(real_t));
+    memset(vect, 0, size * sizeof(real_t));
+    return vect;
+
+}
+
+real_t **ArenaRealMatrix(memory_arena_t * Arena, const int rows, const int cols) {
+
+    real_t **mat = (real_t **) ArenaAlloc(Arena, rows * sizeof(real_t *));
+    real_t *cells = ArenaRealVector(Arena, rows * cols);
+    int i;
+
+    for (i = 0; i < rows; i++) {
+        mat[i] = cells + (size_t) i * cols;
+    }
+    return mat;
+
+}
@@ -0,0 +1,101 @@
+//MIT License
+//Copyright (c) 2018 Eotvos Lorand University, Budapest
+
+/* vim:set ts=4 sw=4 sts=4 et: */
+
+/*
+ * Arena (bump) allocator for scratch arrays of the steps and of the frames.
+ * Arrays are taken from one large block by increasing an offset, and are
+ * released together by resetting the offset (or by going back to a mark),
+ * so the steps need no heap allocation once the block is large enough.
+ * If the block is full, the array is allocated on the heap and the block is
+ * enlarged at the next reset, to hold everything that was needed.
+ *
+ * Every arena belongs to a single thread: "StepArena" to the simulation,
+ * "FrameArena" to the visualization.
+ */
+
+#ifndef MEMORY_ARENA_H
+#define MEMORY_ARENA_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "datastructs.h"
+
+/* Size of the arenas before their first reset (bytes) */
+#define ARENA_INITIAL_SIZE (1 << 20)
+/* Alignment of the arrays (bytes) */
+#define ARENA_ALIGNMENT 16
+/* Number of steps before the steady state (the arenas grow during these) */
+#define ARENA_WARMUP_STEPS 10
+
+/* Array allocated on the heap when the block was full */
+typedef struct memory_arena_overflow_t {
+    struct memory_arena_overflow_t *Next;
+} memory_arena_overflow_t;
+
+typedef struct {
+
+    char *Block;
+    size_t Size;
+    size_t Used;
+
+    /* Arrays that did not fit into the block and their total size */
+    memory_arena_overflow_t *Overflows;
+    size_t OverflowSize;
+
+    /* Largest usage since the block was allocated */
+    size_t HighWater;
+
+} memory_arena_t;
+
+/* Position of an arena that can be restored (releasing the later arrays) */
+typedef size_t memory_arena_mark_t;
+
+/* Scratch arenas of the simulation and the visualization */
+extern memory_arena_t StepArena;
+extern memory_arena_t FrameArena;
+
+/* Allocating and freeing the block of an arena */
+void AllocateArena(memory_arena_t * Arena, const size_t Size);
+void freeArena(memory_arena_t * Arena);
+
+/* Releasing every array of the arena in O(1)
+ * (the block is enlarged if arrays did not fit into it since the last reset)
+ */
+void ResetArena(memory_arena_t * Arena);
+
+/* Releasing the arrays allocated after "Mark" */
+memory_arena_mark_t ArenaMark(memory_arena_t * Arena);
+void ArenaRelease(memory_arena_t * Arena, const memory_arena_mark_t Mark);
+
+/* Uninitialised array of "Bytes" bytes */
+void *ArenaAlloc(memory_arena_t * Arena, const size_t Bytes);
+
+/* Zero-initialised arrays (like the tools of datastructs.h) */
+bool *ArenaBooleanData(memory_arena_t * Arena, const int size);
+int *ArenaIntData(memory_arena_t * Arena, const int size);
+real_t *ArenaRealVector(memory_arena_t * Arena, const int size);
+real_t **ArenaRealMatrix(memory_arena_t * Arena, const int rows, const int cols);
+
+/* Checking that a step of the simulation does not allocate on the heap
+ * (debug builds only, after the warm-up steps). Only the allocations counted
+ * by NumberOfHeapAllocations are seen (see datastructs.h); a new realloc or
+ * malloc in the step has to be counted with COUNT_HEAP_ALLOCATIONS as well.
+ */
+#ifdef DEBUG
+#include <assert.h>
+#define HEAP_CHECK_BEGIN() \
+    const unsigned long HeapAllocationsBeforeStep = NumberOfHeapAllocations;
+#define HEAP_CHECK_END(SteadyState) \
+    if ((SteadyState) && NumberOfHeapAllocations != HeapAllocationsBeforeStep) { \
+        fprintf(stderr, "%lu counted heap allocations in a step!\n", \
+                NumberOfHeapAllocations - HeapAllocationsBeforeStep); \
+        assert(NumberOfHeapAllocations == HeapAllocationsBeforeStep); \
+    }
+#else
+#define HEAP_CHECK_BEGIN()
+#define HEAP_CHECK_END(SteadyState)
+#endif
+
+#endif
@@ -0,0 +1,448 @@
+//MIT License
+//Copyright (c) 2018 Eotvos Lorand University, Budapest
+
+/* vim:set ts=4 sw=4 sts=4 et: */
+
+/*
+ * Target missions of the flock.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "mission.h"
+
+mission_t Mission;
+
+void AllocateMission(mission_t * Mission, const int NumberOfAgents,
+        const mission_type_t Type, const double AssignmentPeriod,
+        const double DwellTime) {
+
+    int i;
+
+    Mission->Type = Type;
+    Mission->AssignmentPeriod = AssignmentPeriod;
+    Mission->DwellTime = DwellTime;
+    Mission->NumberOfAgents = NumberOfAgents;
+    Mission->NumberOfTargets = 0;
+    Mission->TargetCapacity = 0;
+    Mission->CurrentTarget = 0;
+    Mission->DwellTimes = NULL;
+    Mission->Quotas = NULL;
+    Mission->Assigned = NULL;
+    Mission->LastAssignment = 0.0;
+    Mission->AssignmentNeeded = true;
+
+    Mission->Assignments = intData(NumberOfAgents);
+    Mission->AgentCells = intData(NumberOfAgents);
+    Mission->CellAgents = intData(NumberOfAgents);
+    for (i = 0; i < NumberOfAgents; i++) {
+        Mission->Assignments[i] = -1;
+    }
+
+    /* Grids have at most 3N + 1 cells (see BuildMissionGrid) */
+    Mission->CellCapacity = 3 * NumberOfAgents + 2;
+    Mission->CellStarts = intData(Mission->CellCapacity + 1);
+
+    Mission->PairCapacity = NumberOfAgents;
+    Mission->Pairs = (mission_pair_t *) malloc(Mission->PairCapacity *
+            sizeof(mission_pair_t));
+    if (!Mission->Pairs) {
+        fprintf(stderr, "Mission allocation error!\n");
+        exit(-1);
+    }
+
+}
+
+void freeMission(mission_t * Mission) {
+
+    free(Mission->DwellTimes);
+    free(Mission->Quotas);
+    free(Mission->Assigned);
+    free(Mission->Assignments);
+    free(Mission->AgentCells);
+    free(Mission->CellAgents);
+    free(Mission->CellStarts);
+    free(Mission->Pairs);
+    Mission->TargetCapacity = 0;
+    Mission->NumberOfTargets = 0;
+
+}
+
+/* Following the number of targets (targets are added one by one, or
+ * every target is removed at once) */
+static void SetNumberOfMissionTargets(mission_t * Mission,
+        const int NumberOfTargets) {
+
+    int i;
+
+    if (NumberOfTargets == Mission->NumberOfTargets) {
+        return;
+    }
+
+    if (NumberOfTargets > Mission->TargetCapacity) {
+        Mission->TargetCapacity = 2 * NumberOfTargets;
+        Mission->DwellTimes = (double *) realloc(Mission->DwellTimes,
+                Mission->TargetCapacity * sizeof(double));
+        Mission->Quotas = (int *) realloc(Mission->Quotas,
+                Mission->TargetCapacity * sizeof(int));
+        Mission->Assigned = (int *) realloc(Mission->Assigned,
+                Mission->TargetCapacity * sizeof(int));
+        COUNT_HEAP_ALLOCATIONS(3);
+        if (!Mission->DwellTimes || !Mission->Quotas || !Mission->Assigned) {
+            fprintf(stderr, "Mission allocation error!\n");
+            exit(-1);
+        }
+    }
+
+    if (NumberOfTargets < Mission->NumberOfTargets) {
+        /* Targets have been removed, the mission starts again */
+        Mission->CurrentTarget = 0;
+        for (i = 0; i < Mission->NumberOfAgents; i++) {
+            Mission->Assignments[i] = -1;
+        }
+        for (i = 0; i < NumberOfTargets; i++) {
+            Mission->DwellTimes[i] = 0.0;
+            Mission->Quotas[i] = 0;
+            Mission->Assigned[i] = 0;
+        }
+    } else {
+        /* New targets have no sub-swarm until the next assignment */
+        for (i = Mission->NumberOfTargets; i < NumberOfTargets; i++) {
+            Mission->DwellTimes[i] = 0.0;
+            Mission->Quotas[i] = 0;
+            Mission->Assigned[i] = 0;
+        }
+    }
+
+    Mission->NumberOfTargets = NumberOfTargets;
+    Mission->AssignmentNeeded = true;
+
+}
+
+static int CompareMissionPairs(const void *a, const void *b) {
+
+    const mission_pair_t *PairA = (const mission_pair_t *) a;
+    const mission_pair_t *PairB = (const mission_pair_t *) b;
+
+    if (PairA->Distance2 < PairB->Distance2) {
+        return -1;
+    } else if (PairA->Distance2 > PairB->Distance2) {
+        return 1;
+    }
+    return PairA->Agent - PairB->Agent;
+
+}
+
+static void AddMissionPair(mission_t * Mission, int *NumberOfPairs,
+        const double Distance2, const int Agent, const int Target) {
+
+    if (*NumberOfPairs == Mission->PairCapacity) {
+        Mission->PairCapacity *= 2;
+        Mission->Pairs = (mission_pair_t *) realloc(Mission->Pairs,
+                Mission->PairCapacity * sizeof(mission_pair_t));
+        COUNT_HEAP_ALLOCATIONS(1);
+        if (!Mission->Pairs) {
+            fprintf(stderr, "Mission allocation error!\n");
+            exit(-1);
+        }
+    }
+    Mission->Pairs[*NumberOfPairs].Distance2 = Distance2;
+    Mission->Pairs[*NumberOfPairs].Agent = Agent;
+    Mission->Pairs[*NumberOfPairs].Target = Target;
+    (*NumberOfPairs)++;
+
+}
+
+/* Sorting the agents into a uniform grid of about one agent per cell */
+static void BuildMissionGrid(mission_t * Mission, phase_t * Phase) {
+
+    int i, Cell, CellX, CellY;
+    double MaxX, MaxY, Width, Height;
+    const int N = Mission->NumberOfAgents;
+
+    Mission->MinX = MaxX = Phase->Coordinates[0][0];
+    Mission->MinY = MaxY = Phase->Coordinates[0][1];
+    for (i = 1; i < N; i++) {
+        Mission->MinX = fmin(Mission->MinX, Phase->Coordinates[i][0]);
+        Mission->MinY = fmin(Mission->MinY, Phase->Coordinates[i][1]);
+        MaxX = fmax(MaxX, Phase->Coordinates[i][0]);
+        MaxY = fmax(MaxY, Phase->Coordinates[i][1]);
+    }
+    Width = MaxX - Mission->MinX;
+    Height = MaxY - Mission->MinY;
+
+    /* With CellSize >= sqrt(Width * Height / N) and CellSize >= max(Width, Height) / N
+     * the grid has at most 3N + 1 cells */
+    Mission->CellSize = fmax(sqrt(Width * Height / N),
+            fmax(fmax(Width, Height) / N, 1.0));
+    Mission->NX = (int) (Width / Mission->CellSize) + 1;
+    Mission->NY = (int) (Height / Mission->CellSize) + 1;
+
+    /* Counts, then ends of the cells, then the agents are placed backwards,
+     * so CellStarts[c] becomes the first agent of cell c */
+    memset(Mission->CellStarts, 0, (Mission->NX * Mission->NY + 1) * sizeof(int));
+    for (i = 0; i < N; i++) {
+        CellX = (int) ((Phase->Coordinates[i][0] - Mission->MinX) / Mission->CellSize);
+        CellY = (int) ((Phase->Coordinates[i][1] - Mission->MinY) / Mission->CellSize);
+        CellX = (CellX < Mission->NX ? CellX : Mission->NX - 1);
+        CellY = (CellY < Mission->NY ? CellY : Mission->NY - 1);
+        Cell = CellY * Mission->NX + CellX;
+        Mission->AgentCells[i] = Cell;
+        Mission->CellStarts[Cell]++;
+    }
+    for (Cell = 1; Cell < Mission->NX * Mission->NY; Cell++) {
+        Mission->CellStarts[Cell] += Mission->CellStarts[Cell - 1];
+    }
+    Mission->CellStarts[Mission->NX * Mission->NY] = N;
+    for (i = N - 1; i >= 0; i--) {
+        Mission->CellAgents[--Mission->CellStarts[Mission->AgentCells[i]]] = i;
+    }
+
+}
+
+/* Collecting the "Needed" nearest agents of target "WhichTarget" (and some more)
+ * ring by ring around its cell. Agents of ring r + 1 are at least r cells
+ * away from the target, so the search stops when "Needed" agents closer than
+ * that have been found.
+ */
+static void CollectCandidates(mission_t * Mission, phase_t * Phase,
+        real_t *Target, const int WhichTarget, const int Needed,
+        int *NumberOfPairs) {
+
+    int Ring, CellX, CellY, x, y, k, Agent, Closer;
+    int Found = 0;
+    const int FirstPair = *NumberOfPairs;
+    int MaxRing;
+    double dx, dy, Bound2;
+
+    CellX = (int) floor((Target[0] - Mission->MinX) / Mission->CellSize);
+    CellY = (int) floor((Target[1] - Mission->MinY) / Mission->CellSize);
+    CellX = (CellX < 0 ? 0 : (CellX >= Mission->NX ? Mission->NX - 1 : CellX));
+    CellY = (CellY < 0 ? 0 : (CellY >= Mission->NY ? Mission->NY - 1 : CellY));
+    MaxRing = (Mission->NX > Mission->NY ? Mission->NX : Mission->NY);
+
+    for (Ring = 0; Ring <= MaxRing; Ring++) {
+        for (y = CellY - Ring; y <= CellY + Ring; y++) {
+            if (y < 0 || y >= Mission->NY) {
+                continue;
+            }
+            for (x = CellX - Ring; x <= CellX + Ring; x++) {
+                if (x < 0 || x >= Mission->NX) {
+                    continue;
+                }
+                /* Only the border of the ring */
+                if (y != CellY - Ring && y != CellY + Ring &&
+                        x != CellX - Ring && x != CellX + Ring) {
+                    continue;
+                }
+                for (k = Mission->CellStarts[y * Mission->NX + x];
+                        k < Mission->CellStarts[y * Mission->NX + x + 1]; k++) {
+                    Agent = Mission->CellAgents[k];
+                    dx = Phase->Coordinates[Agent][0] - Target[0];
+                    dy = Phase->Coordinates[Agent][1] - Target[1];
+                    AddMissionPair(Mission, NumberOfPairs, dx * dx + dy * dy,
+                            Agent, WhichTarget);
+                    Found++;
+                }
+            }
+        }
+        if (Found < Needed) {
+            continue;
+        }
+        /* Targets outside the grid are even farther from the next rings
+         * (their cell is the nearest one inside the grid) */
+        Bound2 = Ring * Mission->CellSize;
+        Bound2 *= Bound2;
+        Closer = 0;
+        for (k = FirstPair; k < *NumberOfPairs; k++) {
+            if (Mission->Pairs[k].Distance2 <= Bound2) {
+                Closer++;
+            }
+        }
+        if (Closer >= Needed) {
+            break;
+        }
+    }
+
+}
+
+/* Greedy assignment of balanced sub-swarms to the active targets */
+static void AssignTargets(mission_t * Mission, phase_t * Phase,
+        real_t ** TargetsArray) {
+
+    int i, t, Best;
+    int NumberOfPairs = 0;
+    int NumberOfActive = 0;
+    int Index = 0;
+    double dx, dy, Distance2, BestDistance2;
+    const int N = Mission->NumberOfAgents;
+
+    for (t = 0; t < Mission->NumberOfTargets; t++) {
+        Mission->Quotas[t] = 0;
+        Mission->Assigned[t] = 0;
+        if (TargetsArray[t][3] != 0) {
+            NumberOfActive++;
+        }
+    }
+    for (i = 0; i < N; i++) {
+        Mission->Assignments[i] = -1;
+    }
+    if (NumberOfActive == 0) {
+        return;
+    }
+
+    /* Balanced sub-swarms */
+    for (t = 0; t < Mission->NumberOfTargets; t++) {
+        if (TargetsArray[t][3] != 0) {
+            Mission->Quotas[t] = N / NumberOfActive + (Index < N % NumberOfActive ? 1 : 0);
+            Index++;
+        }
+    }
+
+    /* Candidate pairs from the grid, taken in order of distance */
+    BuildMissionGrid(Mission, Phase);
+    for (t = 0; t < Mission->NumberOfTargets; t++) {
+        if (Mission->Quotas[t] > 0) {
+            CollectCandidates(Mission, Phase, TargetsArray[t], t,
+                    MISSION_CANDIDATES_PER_PLACE * Mission->Quotas[t],
+                    &NumberOfPairs);
+        }
+    }
+    qsort(Mission->Pairs, NumberOfPairs, sizeof(mission_pair_t),
+            CompareMissionPairs);
+    for (i = 0; i < NumberOfPairs; i++) {
+        t = Mission->Pairs[i].Target;
+        if (Mission->Assignments[Mission->Pairs[i].Agent] == -1 &&
+                Mission->Assigned[t] < Mission->Quotas[t]) {
+            Mission->Assignments[Mission->Pairs[i].Agent] = t;
+            Mission->Assigned[t]++;
+        }
+    }
+
+    /* Agents that were not candidates of any target with free places */
+    for (i = 0; i < N; i++) {
+        if (Mission->Assignments[i] != -1) {
+            continue;
+        }
+        Best = -1;
+        BestDistance2 = 0.0;
+        for (t = 0; t < Mission->NumberOfTargets; t++) {
+            if (Mission->Assigned[t] >= Mission->Quotas[t]) {
+                continue;
+            }
+            dx = Phase->Coordinates[i][0] - TargetsArray[t][0];
+            dy = Phase->Coordinates[i][1] - TargetsArray[t][1];
+            Distance2 = dx * dx + dy * dy;
+            if (Best == -1 || Distance2 < BestDistance2) {
+                Best = t;
+                BestDistance2 = Distance2;
+            }
+        }
+        Mission->Assignments[i] = Best;
+        if (Best != -1) {
+            Mission->Assigned[Best]++;
+        }
+    }
+
+}
+
+void UpdateMission(mission_t * Mission, flock_aggregates_t * Aggregates,
+        phase_t * Phase, real_t ** TargetsArray, const int NumberOfTargets,
+        const double ActualTime, const double TickLength) {
+
+    int t, Needed;
+
+    SetNumberOfTargets(Aggregates, NumberOfTargets);
+    SetNumberOfMissionTargets(Mission, NumberOfTargets);
+    if (NumberOfTargets == 0) {
+        return;
+    }
+
+    /* Skipping the visited targets */
+    while (Mission->CurrentTarget < NumberOfTargets &&
+            TargetsArray[Mission->CurrentTarget][3] == 0) {
+        Mission->CurrentTarget++;
+    }
+
+    /* Dwell times and completion of the targets */
+    for (t = 0; t < NumberOfTargets; t++) {
+        if (TargetsArray[t][3] == 0 || (Mission->Type == MISSION_SEQUENTIAL &&
+                    t != Mission->CurrentTarget)) {
+            continue;
+        }
+        Needed = MISSION_MIN_ARRIVALS;
+        if (Mission->Type == MISSION_ASSIGNMENT && Mission->Quotas[t] < Needed) {
+            Needed = Mission->Quotas[t];
+        }
+        if (Needed > Mission->NumberOfAgents) {
+            Needed = Mission->NumberOfAgents;
+        }
+        if (Needed > 0 && ArrivalsAtTarget(Aggregates, t) >= Needed) {
+            Mission->DwellTimes[t] += TickLength;
+            if (Mission->DwellTimes[t] >= Mission->DwellTime) {
+                TargetsArray[t][3] = 0;
+                Mission->AssignmentNeeded = true;
+                if (t == Mission->CurrentTarget) {
+                    Mission->CurrentTarget++;
+                }
+            }
+        }
+    }
+
+    if (Mission->Type == MISSION_ASSIGNMENT && (Mission->AssignmentNeeded ||
+                ActualTime - Mission->LastAssignment >= Mission->AssignmentPeriod)) {
+        AssignTargets(Mission, Phase, TargetsArray);
+        Mission->LastAssignment = ActualTime;
+        Mission->AssignmentNeeded = false;
+    }
+
+}
+
+int TargetOfAgent(mission_t * Mission, const int WhichAgent) {
+
+    if (Mission->Type == MISSION_ASSIGNMENT) {
+        return Mission->Assignments[WhichAgent];
+    }
+    return (Mission->CurrentTarget < Mission->NumberOfTargets ?
+            Mission->CurrentTarget : -1);
+
+}
+
+int LoadTargetsFromFile(real_t *** TargetsArray, const char *FileName) {
+
+    FILE *TargetsFile;
+    char Line[256];
+    double x, y;
+    int NumberOfTargets = 0;
+
+    TargetsFile = fopen(FileName, "r");
+    if (!TargetsFile) {
+        fprintf(stderr, "Cannot open targets file: %s\n", FileName);
+        exit(-1);
+    }
+
+    *TargetsArray = NULL;
+    while (fgets(Line, sizeof(Line), TargetsFile) != NULL) {
+        if (Line[0] == '#' || sscanf(Line, "%lf %lf", &x, &y) != 2) {
+            continue;
+        }
+        *TargetsArray = realloc(*TargetsArray,
+                sizeof **TargetsArray * (NumberOfTargets + 1));
+        (*TargetsArray)[NumberOfTargets] = malloc(sizeof ***TargetsArray * 4);
+        if (!*TargetsArray || !(*TargetsArray)[NumberOfTargets]) {
+            fprintf(stderr, "Targets allocation error!\n");
+            exit(-1);
+        }
+        (*TargetsArray)[NumberOfTargets][0] = x;
+        (*TargetsArray)[NumberOfTargets][1] = y;
+        (*TargetsArray)[NumberOfTargets][2] = 0;
+        (*TargetsArray)[NumberOfTargets][3] = 1;
+        NumberOfTargets++;
+    }
+
+    fclose(TargetsFile);
+    return NumberOfTargets;
+
+}
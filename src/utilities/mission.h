@@ -0,0 +1,121 @@
+//MIT License
+//Copyright (c) 2018 Eotvos Lorand University, Budapest
+
+/* vim:set ts=4 sw=4 sts=4 et: */
+
+/*
+ * Target missions of the flock (Flocking_type 2).
+ * The targets are the rows of "TargetsArray" ({x, y, z, active}); a target is
+ * deactivated after enough agents have stayed at it for the dwell time.
+ *
+ * Sequential missions: the whole flock visits the active targets one after
+ * the other (in the order they were added).
+ * Assignment missions: every active target gets a sub-swarm of balanced size.
+ * The agents are assigned periodically by a central planner with a greedy
+ * algorithm: the MISSION_CANDIDATES_PER_PLACE * (size of its sub-swarm)
+ * nearest agents of every target are collected from a uniform grid (exactly,
+ * see CollectCandidates), the candidate pairs are taken in order of distance,
+ * and the remaining agents go to the nearest target with free places. The
+ * result is not an optimal assignment (the sum of the distances is not
+ * minimal), but every agent is assigned and the sub-swarms are balanced.
+ *
+ * The target of each agent is sent to the agent, which keeps it in its inner
+ * states (see CalculatePreferredVelocity), arrivals are counted by
+ * FlockAggregates.
+ */
+
+#ifndef MISSION_H
+#define MISSION_H
+
+#include <stdbool.h>
+#include "dynamics_utils.h"
+#include "aggregates.h"
+
+/* Agents closer than this to a target have arrived at it (cm) */
+#define MISSION_ARRIVAL_RADIUS 10000.0
+/* Number of arrived agents needed to count the dwell time of a target
+ * (or the size of its sub-swarm, if that is smaller) */
+#define MISSION_MIN_ARRIVALS 4
+/* Number of nearest agents collected for a target (times the size of its sub-swarm) */
+#define MISSION_CANDIDATES_PER_PLACE 2
+
+typedef enum {
+    MISSION_SEQUENTIAL = 0,
+    MISSION_ASSIGNMENT = 1
+} mission_type_t;
+
+/* Candidate (agent, target) pair of the assignment */
+typedef struct {
+    double Distance2;
+    int Agent;
+    int Target;
+} mission_pair_t;
+
+typedef struct {
+
+    mission_type_t Type;
+    /* Time between two assignments (s) */
+    double AssignmentPeriod;
+    /* Time the arrived agents have to stay at a target (s) */
+    double DwellTime;
+
+    int NumberOfAgents;
+    int NumberOfTargets;
+    int TargetCapacity;
+
+    /* Target of the flock in sequential missions
+     * (NumberOfTargets if every target has been visited) */
+    int CurrentTarget;
+
+    /* Time spent at each target with enough arrived agents (s) */
+    double *DwellTimes;
+    /* Size of the sub-swarm of each target and the number of agents assigned to it */
+    int *Quotas;
+    int *Assigned;
+    /* Target of each agent in assignment missions (-1 if none) */
+    int *Assignments;
+    double LastAssignment;
+    bool AssignmentNeeded;
+
+    /* Uniform grid of the agents (counting sort of the agents by cells) */
+    double CellSize;
+    double MinX, MinY;
+    int NX, NY;
+    int CellCapacity;
+    int *CellStarts;
+    int *CellAgents;
+    int *AgentCells;
+
+    /* Candidate pairs of the greedy assignment */
+    int PairCapacity;
+    mission_pair_t *Pairs;
+
+} mission_t;
+
+/* Mission of the simulated flock */
+extern mission_t Mission;
+
+/* Allocating and freeing the arrays of a mission of "NumberOfAgents" agents */
+void AllocateMission(mission_t * Mission, const int NumberOfAgents,
+        const mission_type_t Type, const double AssignmentPeriod,
+        const double DwellTime);
+void freeMission(mission_t * Mission);
+
+/* Following the targets (added or removed targets, completed targets)
+ * and assigning the agents if needed.
+ * Should be called on every GPS tick ("TickLength" is the time since the last call).
+ */
+void UpdateMission(mission_t * Mission, flock_aggregates_t * Aggregates,
+        phase_t * Phase, real_t ** TargetsArray, const int NumberOfTargets,
+        const double ActualTime, const double TickLength);
+
+/* Target of agent "WhichAgent" (-1 if it has none) */
+int TargetOfAgent(mission_t * Mission, const int WhichAgent);
+
+/* Reading targets ("x y" lines in cm) from a file into a "TargetsArray"
+ * (rows are allocated one by one, like targets added with the mouse).
+ * Returns the number of targets.
+ */
+int LoadTargetsFromFile(real_t *** TargetsArray, const char *FileName);
+
+#endif
@@ -118,12 +118,18 @@ int ParseObstacleFile(const char *name, obstacles_t * obstacles, int Verbose) {
         printf("Parsed %d obstacles.\n", obstacles->o_count);
     }    
 
-    /* calculate center of obstacles */
+    /* calculate center and bounding box of obstacles */
     for (i = 0; i < obstacles->o_count; i++) {
         x = y = 0;
+        obstacles->o[i].bb_min[0] = obstacles->o[i].bb_min[1] = 2e222;
+        obstacles->o[i].bb_max[0] = obstacles->o[i].bb_max[1] = -2e222;
         for (j = 0; j < obstacles->o[i].p_count; j++) {
             x += obstacles->o[i].p[j][0];
             y += obstacles->o[i].p[j][1];
+            obstacles->o[i].bb_min[0] = fmin(obstacles->o[i].bb_min[0], obstacles->o[i].p[j][0]);
+            obstacles->o[i].bb_min[1] = fmin(obstacles->o[i].bb_min[1], obstacles->o[i].p[j][1]);
+            obstacles->o[i].bb_max[0] = fmax(obstacles->o[i].bb_max[0], obstacles->o[i].p[j][0]);
+            obstacles->o[i].bb_max[1] = fmax(obstacles->o[i].bb_max[1], obstacles->o[i].p[j][1]);
         }
         if (j == 0) {
             obstacles->o[i].center[0] = 0;
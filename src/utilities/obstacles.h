@@ -6,6 +6,8 @@
 #ifndef OBSTACLES_H
 #define OBSTACLES_H
 
+#include "precision.h"
+
 #define MAX_OBSTACLES 500
 #define MAX_OBSTACLE_POINTS 10
 #define MAX_OBSTACLE_NAME_LENGTH 32
@@ -15,8 +17,10 @@
  */
 typedef struct {
     char name[MAX_OBSTACLE_NAME_LENGTH];        /* name of the obstacle */
-    double p[MAX_OBSTACLE_POINTS][3];   /* list of polygon points */
-    double center[2];           /* center of the obstacle polygon */
+    real_t p[MAX_OBSTACLE_POINTS][3];   /* list of polygon points */
+    real_t center[2];           /* center of the obstacle polygon */
+    real_t bb_min[2];           /* lower left corner of the bounding box */
+    real_t bb_max[2];           /* upper right corner of the bounding box */
     int p_count;                /* number of points in the obstacle polygon */
 } obstacle_t;
 
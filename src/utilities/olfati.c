@@ -0,0 +1,207 @@
+//MIT License
+//Copyright (c) 2018 Eotvos Lorand University, Budapest
+
+/* vim:set ts=4 sw=4 sts=4 et: */
+
+/*
+ * Olfati-Saber flocking kernel.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "olfati.h"
+
+/* Larger and smaller of two numbers without branches
+ * (a conditional on doubles prevents the vectorisation of the weights)
+ */
+static inline double OlfatiMax(const double a, const double b) {
+
+    return 0.5 * (a + b + fabs(a - b));
+
+}
+
+static inline double OlfatiMin(const double a, const double b) {
+
+    return 0.5 * (a + b - fabs(a - b));
+
+}
+
+/* Bump function of the sigma norm ratio "z" (see BumpFunction):
+ * 1 below h, 0.5 * (1 + cos(pi * t)) = cos^2(pi * t / 2) with
+ * t = (z - h) / (1 - h) between h and 1, and 0 above 1.
+ * The cosine is summed up to the 16th power on [0, pi / 2] (error < 1e-12).
+ */
+static inline double OlfatiBump(const double z, const double H,
+        const double InvOneMinusH) {
+
+    double t, v2, c;
+
+    t = OlfatiMin(OlfatiMax((z - H) * InvOneMinusH, 0.0), 1.0);
+    v2 = 0.25 * M_PI * M_PI * t * t;
+
+    c = 1.0 + v2 * (-1.0 / 2.0 + v2 * (1.0 / 24.0 + v2 * (-1.0 / 720.0 +
+                        v2 * (1.0 / 40320.0 + v2 * (-1.0 / 3628800.0 +
+                                v2 * (1.0 / 479001600.0 +
+                                    v2 * (-1.0 / 87178291200.0 +
+                                        v2 * (1.0 / 20922789888000.0))))))));
+
+    return c * c;
+
+}
+
+void AllocateOlfati(olfati_t * Olfati, const int NumberOfAgents) {
+
+    Olfati->Capacity = NumberOfAgents;
+    Olfati->Valid = false;
+
+    Olfati->Dx = (real_t *) calloc(NumberOfAgents, sizeof(real_t));
+    Olfati->Dy = (real_t *) calloc(NumberOfAgents, sizeof(real_t));
+    Olfati->Dz = (real_t *) calloc(NumberOfAgents, sizeof(real_t));
+    Olfati->D2 = (real_t *) calloc(NumberOfAgents, sizeof(real_t));
+    Olfati->GradientWeights = (real_t *) calloc(NumberOfAgents, sizeof(real_t));
+    Olfati->AlignmentWeights = (real_t *) calloc(NumberOfAgents, sizeof(real_t));
+    Olfati->Neighbours = (int *) calloc(NumberOfAgents, sizeof(int));
+
+    if (!Olfati->Dx || !Olfati->Dy || !Olfati->Dz || !Olfati->D2 ||
+            !Olfati->GradientWeights || !Olfati->AlignmentWeights ||
+            !Olfati->Neighbours) {
+        fprintf(stderr, "Olfati kernel allocation error!\n");
+        exit(-1);
+    }
+
+}
+
+void freeOlfati(olfati_t * Olfati) {
+
+    free(Olfati->Dx);
+    free(Olfati->Dy);
+    free(Olfati->Dz);
+    free(Olfati->D2);
+    free(Olfati->GradientWeights);
+    free(Olfati->AlignmentWeights);
+    free(Olfati->Neighbours);
+    Olfati->Capacity = 0;
+
+}
+
+void RefreshOlfati(olfati_t * Olfati, const double Epsilon, const double A,
+        const double B, const double H, const double D,
+        const double RGradient, const double RAlignment) {
+
+    double R;
+
+    if (Olfati->Valid && Olfati->Epsilon == Epsilon && Olfati->A == A &&
+            Olfati->B == B && Olfati->H == H && Olfati->D == D &&
+            Olfati->RGradient == RGradient && Olfati->RAlignment == RAlignment) {
+        return;
+    }
+
+    Olfati->Epsilon = Epsilon;
+    Olfati->A = A;
+    Olfati->B = B;
+    Olfati->H = H;
+    Olfati->D = D;
+    Olfati->RGradient = RGradient;
+    Olfati->RAlignment = RAlignment;
+    Olfati->Valid = true;
+
+    /* Sigma norm: (sqrt(1 + epsilon * |x|^2) - 1) / epsilon */
+    Olfati->InvEpsilon = 1.0 / Epsilon;
+    Olfati->SigmaD = Olfati->InvEpsilon * (sqrt(1.0 + Epsilon * D * D) - 1.0);
+    Olfati->InvSigmaRGradient = 1.0 /
+            (Olfati->InvEpsilon * (sqrt(1.0 + Epsilon * RGradient * RGradient) - 1.0));
+    Olfati->InvSigmaRAlignment = 1.0 /
+            (Olfati->InvEpsilon * (sqrt(1.0 + Epsilon * RAlignment * RAlignment) - 1.0));
+
+    /* h = 1 would be a step function */
+    Olfati->InvOneMinusH = (H < 1.0 ? 1.0 / (1.0 - H) : 0.0);
+
+    Olfati->C = fabs(A - B) / sqrt(4.0 * A * B);
+    Olfati->HalfSum = 0.5 * (A + B);
+    Olfati->HalfDifference = 0.5 * (A - B);
+
+    /* The sigma norm is monotonic, therefore the bump functions vanish
+     * beyond the larger radius */
+    R = (RGradient > RAlignment ? RGradient : RAlignment);
+    Olfati->CutOff2 = R * R;
+
+}
+
+int OlfatiInteractions(real_t *GradientOutput, real_t *AlignmentOutput,
+        olfati_t * Olfati, phase_t * Phase, const int WhichAgent,
+        const int Dim_l) {
+
+    int i, k;
+    int n = 0;
+    real_t *AgentsCoordinates = Phase->Coordinates[WhichAgent];
+    real_t *AgentsVelocity = Phase->Velocities[WhichAgent];
+    real_t *Velocity;
+    double Dx, Dy, Dz, D2, q, Sigma, z;
+
+    /* Local copies, so the weights can be vectorised */
+    const double Epsilon = Olfati->Epsilon;
+    const double InvEpsilon = Olfati->InvEpsilon;
+    const double SigmaD = Olfati->SigmaD;
+    const double InvSigmaRGradient = Olfati->InvSigmaRGradient;
+    const double InvSigmaRAlignment = Olfati->InvSigmaRAlignment;
+    const double H = Olfati->H;
+    const double InvOneMinusH = Olfati->InvOneMinusH;
+    const double C = Olfati->C;
+    const double HalfSum = Olfati->HalfSum;
+    const double HalfDifference = Olfati->HalfDifference;
+    const double CutOff2 = Olfati->CutOff2;
+    real_t *restrict DxArray = Olfati->Dx;
+    real_t *restrict DyArray = Olfati->Dy;
+    real_t *restrict DzArray = Olfati->Dz;
+    real_t *restrict D2Array = Olfati->D2;
+    real_t *restrict GradientWeights = Olfati->GradientWeights;
+    real_t *restrict AlignmentWeights = Olfati->AlignmentWeights;
+
+    NullVect(GradientOutput, 3);
+    NullVect(AlignmentOutput, 3);
+
+    /* Neighbours inside the cut-off radius (i = 0 is the WhichAgent) */
+    for (i = 1; i < Phase->NumberOfAgents; i++) {
+        Dx = Phase->Coordinates[i][0] - AgentsCoordinates[0];
+        Dy = Phase->Coordinates[i][1] - AgentsCoordinates[1];
+        Dz = (2 == Dim_l ? 0.0 : Phase->Coordinates[i][2] - AgentsCoordinates[2]);
+        D2 = Dx * Dx + Dy * Dy + Dz * Dz;
+        if (D2 < CutOff2) {
+            DxArray[n] = Dx;
+            DyArray[n] = Dy;
+            DzArray[n] = Dz;
+            D2Array[n] = D2;
+            Olfati->Neighbours[n] = i;
+            n++;
+        }
+    }
+
+    /* Weights of the neighbours:
+     * gradient: phi_alpha(sigma) / sqrt(1 + epsilon * |x|^2) (see SigmaGrad),
+     * alignment: bump(sigma / sigma_r)
+     */
+    for (k = 0; k < n; k++) {
+        q = sqrt(1.0 + Epsilon * D2Array[k]);
+        Sigma = InvEpsilon * (q - 1.0);
+        z = Sigma - SigmaD + C;
+        GradientWeights[k] = OlfatiBump(Sigma * InvSigmaRGradient, H, InvOneMinusH) *
+                (HalfSum * z / sqrt(1.0 + z * z) + HalfDifference) / q;
+        AlignmentWeights[k] = OlfatiBump(Sigma * InvSigmaRAlignment, H, InvOneMinusH);
+    }
+
+    for (k = 0; k < n; k++) {
+        GradientOutput[0] += GradientWeights[k] * DxArray[k];
+        GradientOutput[1] += GradientWeights[k] * DyArray[k];
+        GradientOutput[2] += GradientWeights[k] * DzArray[k];
+        Velocity = Phase->Velocities[Olfati->Neighbours[k]];
+        AlignmentOutput[0] += AlignmentWeights[k] * (Velocity[0] - AgentsVelocity[0]);
+        AlignmentOutput[1] += AlignmentWeights[k] * (Velocity[1] - AgentsVelocity[1]);
+        if (3 == Dim_l) {
+            AlignmentOutput[2] += AlignmentWeights[k] * (Velocity[2] - AgentsVelocity[2]);
+        }
+    }
+
+    return n;
+
+}
@@ -0,0 +1,85 @@
+//MIT License
+//Copyright (c) 2018 Eotvos Lorand University, Budapest
+
+/* vim:set ts=4 sw=4 sts=4 et: */
+
+/*
+ * Olfati-Saber flocking kernel (gradient based term and alignment in one pass).
+ * Same model as GradientBased and AlignmentOlfati in interactions.c, but the
+ * constants of the sigma norm, the bump and the action function are
+ * precomputed from the parameters, neighbours beyond the cut-off radius are
+ * skipped without any square root, and the weights of the remaining
+ * neighbours are calculated in a branch-free loop, which can be vectorised
+ * by the compiler.
+ */
+
+#ifndef OLFATI_H
+#define OLFATI_H
+
+#include <stdbool.h>
+#include "precision.h"
+#include "dynamics_utils.h"
+
+/* Precomputed constants and working arrays of the Olfati-Saber kernel
+ */
+typedef struct {
+
+    /* Parameters the constants were calculated from */
+    double Epsilon;
+    double A;
+    double B;
+    double H;
+    double D;
+    double RGradient;
+    double RAlignment;
+    bool Valid;
+
+    /* 1 / epsilon */
+    double InvEpsilon;
+    /* Sigma norm of the equilibrium distance */
+    double SigmaD;
+    /* 1 / sigma norm of the interaction radii */
+    double InvSigmaRGradient;
+    double InvSigmaRAlignment;
+    /* Bump function: z -> (z - h) / (1 - h) */
+    double InvOneMinusH;
+    /* Action function: 0.5 * (a + b) * sigma1(z + c) + 0.5 * (a - b) */
+    double C;
+    double HalfSum;
+    double HalfDifference;
+    /* Square of the larger cut-off radius (cm^2) */
+    double CutOff2;
+
+    /* Working arrays of the neighbours inside the cut-off radius */
+    int Capacity;
+    real_t *Dx;
+    real_t *Dy;
+    real_t *Dz;
+    real_t *D2;
+    real_t *GradientWeights;
+    real_t *AlignmentWeights;
+    int *Neighbours;
+
+} olfati_t;
+
+/* Allocating and freeing the working arrays for "NumberOfAgents" agents */
+void AllocateOlfati(olfati_t * Olfati, const int NumberOfAgents);
+void freeOlfati(olfati_t * Olfati);
+
+/* Recalculating the constants if any of the parameters changed
+ * (they can be changed from the menu or by the model during the simulation)
+ */
+void RefreshOlfati(olfati_t * Olfati, const double Epsilon, const double A,
+        const double B, const double H, const double D,
+        const double RGradient, const double RAlignment);
+
+/* Gradient based term and alignment term of agent "WhichAgent"
+ * (same as GradientBased and AlignmentOlfati with radii
+ * "RGradient" and "RAlignment").
+ * Returns the number of neighbours inside the cut-off radius.
+ */
+int OlfatiInteractions(real_t *GradientOutput, real_t *AlignmentOutput,
+        olfati_t * Olfati, phase_t * Phase, const int WhichAgent,
+        const int Dim_l);
+
+#endif
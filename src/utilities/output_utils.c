@@ -72,8 +72,8 @@ void ReadOutputModes(output_modes_t * OutputModes, FILE * InputFile) {
 
     char *start, *end;
 
-    char *ReadedName;
-    char *ReadedValue;
+    char *ReadedName = "";
+    char *ReadedValue = "";
 
     int lineno = 0;
 
@@ -280,8 +280,8 @@ void GetUnitModelParamsFromFile(unit_model_params_t * UnitParams,
 
     char *start, *end;
 
-    char *ReadedName;
-    char *ReadedValue;
+    char *ReadedName = "";
+    char *ReadedValue = "";
     int NumberOfReadedNames = 0;
 
     int lineno = 0;
@@ -488,12 +488,21 @@ sit_parameters_t GetSituationParamsFromFile(FILE * InputFile) {
 
     char *start, *end;
 
-    char *ReadedName;
-    char *ReadedValue;
+    char *ReadedName = "";
+    char *ReadedValue = "";
     int NumberOfReadedNames = 0;
 
     int lineno = 0;
 
+    /* Default values of optional parameters */
+    temp_sit_parameters.HullOnGPSTick = 0;
+    temp_sit_parameters.MaxNearObstacles = 9;
+    temp_sit_parameters.CBPEnabled = 1;
+    temp_sit_parameters.PerceptionOnGPSTick = 0;
+    temp_sit_parameters.MissionType = 0;
+    temp_sit_parameters.AssignmentPeriod = 1.0;
+    temp_sit_parameters.TargetDwellTime = 20.0;
+
     while (fgets(line, sizeof(line), InputFile) != NULL) {
 
         start = LSkip(RStrip(line));
@@ -543,6 +552,20 @@ sit_parameters_t GetSituationParamsFromFile(FILE * InputFile) {
             } else if (strcmp(ReadedName, "Resolution") == 0) {
                 temp_sit_parameters.Resolution = atof(ReadedValue);
                 NumberOfReadedNames++;
+            } else if (strcmp(ReadedName, "HullOnGPSTick") == 0) {
+                temp_sit_parameters.HullOnGPSTick = atoi(ReadedValue);
+            } else if (strcmp(ReadedName, "MaxNearObstacles") == 0) {
+                temp_sit_parameters.MaxNearObstacles = atoi(ReadedValue);
+            } else if (strcmp(ReadedName, "CBPEnabled") == 0) {
+                temp_sit_parameters.CBPEnabled = atoi(ReadedValue);
+            } else if (strcmp(ReadedName, "PerceptionOnGPSTick") == 0) {
+                temp_sit_parameters.PerceptionOnGPSTick = atoi(ReadedValue);
+            } else if (strcmp(ReadedName, "MissionType") == 0) {
+                temp_sit_parameters.MissionType = atoi(ReadedValue);
+            } else if (strcmp(ReadedName, "AssignmentPeriod") == 0) {
+                temp_sit_parameters.AssignmentPeriod = atof(ReadedValue);
+            } else if (strcmp(ReadedName, "TargetDwellTime") == 0) {
+                temp_sit_parameters.TargetDwellTime = atof(ReadedValue);
             }
 
         }
@@ -662,8 +685,8 @@ void GetFlockingModelParamsFromFile(flocking_model_params_t * FlockingParams,
 
     char *start, *end;
 
-    char *ReadedName;
-    char *ReadedValue;
+    char *ReadedName = "";
+    char *ReadedValue = "";
     int NumberOfReadedNames = 0;
 
     int lineno = 0;
@@ -282,6 +282,32 @@ typedef struct {
     /* Resolution for the CBP */
     int Resolution;
 
+    /* Recalculate convex hull only on GPS ticks (optional, 0 by default) */
+    int HullOnGPSTick;
+
+    /* Max. number of obstacles near the swarm taken into account
+     * in the attenuation model (optional, 9 by default, 0 means no limit) */
+    int MaxNearObstacles;
+
+    /* Building the CBP maps (optional, 1 by default) */
+    int CBPEnabled;
+
+    /* Running the perception of the agents (neighbour selection, power model,
+     * Laplacian) only on GPS ticks and holding its results in between. Faster,
+     * but the statistics of the steps between the ticks change (optional, 0 by
+     * default: every step). It stays off, because the steady state velocity
+     * order and correlation of 30 agents differ from the every-step results by
+     * more than the tolerances of tools/validate_precision.py (0.08 vs 0.05) */
+    int PerceptionOnGPSTick;
+
+    /* Target missions (Flocking_type 2, optional): 0 - the flock visits the targets
+     * one after the other, 1 - every target gets a sub-swarm (0 by default) */
+    int MissionType;
+    /* Time between two assignments of the agents to the targets (optional, 1 s by default) */
+    double AssignmentPeriod;
+    /* Time the arrived agents stay at a target (optional, 20 s by default) */
+    double TargetDwellTime;
+
 } sit_parameters_t;
 
 /* Functions for setting parameters */
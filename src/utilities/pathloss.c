@@ -0,0 +1,97 @@
+//MIT License
+//Copyright (c) 2018 Eotvos Lorand University, Budapest
+
+/* vim:set ts=4 sw=4 sts=4 et: */
+
+/*
+ * Path loss model of the received power.
+ */
+
+#include <math.h>
+#include "pathloss.h"
+
+path_loss_t PathLoss;
+
+/* Max. error of FastLog10 measured on log-spaced samples between 1 cm and 1000 km */
+static double MeasureFastLog10Error() {
+
+    int i;
+    double x, Error;
+    double MaxError = 0.0;
+
+    for (i = 0; i <= 100000; i++) {
+        x = pow(10.0, 8.0 * i / 100000.0);
+        Error = fabs(FastLog10(x) - log10(x));
+        if (Error > MaxError) {
+            MaxError = Error;
+        }
+    }
+
+    return MaxError;
+
+}
+
+void RefreshPathLoss(path_loss_t * PathLoss, unit_model_params_t * UnitParams) {
+
+    static double MeasuredLogError = -1.0;
+    double MaxS;
+
+    if (PathLoss->Valid &&
+            PathLoss->TransmitPower == UnitParams->transmit_power.Value &&
+            PathLoss->Alpha == UnitParams->alpha.Value &&
+            PathLoss->Freq == UnitParams->freq.Value &&
+            PathLoss->RefDistance == UnitParams->ref_distance.Value &&
+            PathLoss->SensitivityThresh == UnitParams->sensitivity_thresh.Value) {
+        return;
+    }
+
+    PathLoss->TransmitPower = UnitParams->transmit_power.Value;
+    PathLoss->Alpha = UnitParams->alpha.Value;
+    PathLoss->Freq = UnitParams->freq.Value;
+    PathLoss->RefDistance = UnitParams->ref_distance.Value;
+    PathLoss->SensitivityThresh = UnitParams->sensitivity_thresh.Value;
+    PathLoss->Valid = true;
+
+    /* Distances are in cm, the frequency is in GHz (Friis model) */
+    PathLoss->Slope = 10.0 * PathLoss->Alpha;
+    PathLoss->Offset = PathLoss->TransmitPower - 32.44 -
+            PathLoss->Slope * log10(0.01 * PathLoss->Freq);
+
+    if (PathLoss->Slope > 0.0) {
+        PathLoss->CullDistance = pow(10.0, (PathLoss->Offset -
+                        PathLoss->SensitivityThresh +
+                        PATH_LOSS_CULL_MARGIN) / PathLoss->Slope);
+    } else {
+        PathLoss->CullDistance = INFINITY;
+    }
+
+    /* First omitted term of the series: 2 s^11 / 11 / (1 - s^2) with s = (sqrt(2) - 1) / (sqrt(2) + 1) */
+    MaxS = (PATH_LOSS_SQRT2 - 1.0) / (PATH_LOSS_SQRT2 + 1.0);
+    PathLoss->AnalyticError = fabs(PathLoss->Slope) * PATH_LOSS_LOG10_E *
+            2.0 * pow(MaxS, 11) / 11.0 / (1.0 - MaxS * MaxS);
+    if (MeasuredLogError < 0.0) {
+        MeasuredLogError = MeasureFastLog10Error();
+    }
+    PathLoss->MeasuredError = fabs(PathLoss->Slope) * MeasuredLogError;
+
+}
+
+void PathLossBatch(const path_loss_t * PathLoss, const real_t *Distances,
+        const real_t *DistancesInObstacles, const real_t *Losses,
+        real_t *Powers, const int n) {
+
+    int i;
+    double x;
+
+    /* Local copies, so the loop can be vectorised (Powers may alias PathLoss) */
+    const double Offset = PathLoss->Offset;
+    const double Slope = PathLoss->Slope;
+    const double RefDistance = PathLoss->RefDistance;
+
+    for (i = 0; i < n; i++) {
+        x = PathLossMax(Distances[i], RefDistance) - DistancesInObstacles[i];
+        x = PathLossMax(x, PATH_LOSS_MIN_DISTANCE);
+        Powers[i] = Offset - Slope * FastLog10(x) - Losses[i];
+    }
+
+}
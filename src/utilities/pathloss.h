@@ -0,0 +1,134 @@
+//MIT License
+//Copyright (c) 2018 Eotvos Lorand University, Budapest
+
+/* vim:set ts=4 sw=4 sts=4 et: */
+
+/*
+ * Path loss model of the received power (log-distance model with a reference
+ * distance, see DegradedPower).
+ * The constants are precomputed from the unit model parameters, the logarithm
+ * is evaluated with a branch-free polynomial, therefore batches of distances
+ * can be vectorised by the compiler.
+ */
+
+#ifndef PATHLOSS_H
+#define PATHLOSS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include "precision.h"
+#include "param_utils.h"
+
+/* Standard deviation of the Gaussian shadowing term (dB) */
+#define PATH_LOSS_SHADOWING_STDEV 2.0
+/* Attenuation inside an obstacle is 40 * log10(distance inside the obstacle) (dB) */
+#define PATH_LOSS_OBSTACLE_SLOPE 40.0
+/* Pairs are culled if their power is below the sensitivity threshold
+ * even with this much shadowing (5 sigma, dB) */
+#define PATH_LOSS_CULL_MARGIN (5.0 * PATH_LOSS_SHADOWING_STDEV)
+/* Distances are clamped to this value before taking the logarithm (cm) */
+#define PATH_LOSS_MIN_DISTANCE 1.0
+
+#define PATH_LOSS_LOG10_2 0.30102999566398119521
+#define PATH_LOSS_LOG10_E 0.43429448190325182765
+#define PATH_LOSS_SQRT2 1.41421356237309504880
+
+/* Precomputed constants of the path loss model
+ * Power(d) = Offset - Slope * log10(max(d, RefDistance) - DistanceInObstacle) - Loss
+ */
+typedef struct {
+
+    /* Unit model parameters the constants were calculated from */
+    double TransmitPower;
+    double Alpha;
+    double Freq;
+    double RefDistance;
+    double SensitivityThresh;
+    bool Valid;
+
+    double Offset;
+    double Slope;
+
+    /* Beyond this distance the received power cannot reach the sensitivity
+     * threshold (obstacles only decrease it further) */
+    double CullDistance;
+
+    /* Error bounds of FastLog10 multiplied by the slope (dB) */
+    double AnalyticError;
+    double MeasuredError;
+
+} path_loss_t;
+
+/* Path loss constants of the simulation (refreshed from the unit model parameters) */
+extern path_loss_t PathLoss;
+
+/* Logarithm of positive normal numbers.
+ * x = m * 2^e with m in [sqrt(2)/2, sqrt(2)), ln(m) = 2 atanh((m - 1) / (m + 1))
+ * is summed up to the 9th power (relative error < 1e-9).
+ */
+static inline double FastLog10(const double x) {
+
+    uint64_t Bits;
+    double m, e, s, s2;
+
+    memcpy(&Bits, &x, sizeof(Bits));
+    e = (double) ((int64_t) ((Bits >> 52) & 0x7ff) - 1023);
+    Bits = (Bits & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL;
+    memcpy(&m, &Bits, sizeof(m));
+
+    e = (m > PATH_LOSS_SQRT2 ? e + 1.0 : e);
+    m = (m > PATH_LOSS_SQRT2 ? 0.5 * m : m);
+
+    s = (m - 1.0) / (m + 1.0);
+    s2 = s * s;
+
+    return PATH_LOSS_LOG10_2 * e + PATH_LOSS_LOG10_E * 2.0 * s *
+            (1.0 + s2 * (1.0 / 3.0 + s2 * (1.0 / 5.0 + s2 * (1.0 / 7.0 +
+                                    s2 * (1.0 / 9.0)))));
+
+}
+
+/* Recalculating the constants if any of the parameters changed
+ * (they can be changed from the menu during the simulation)
+ */
+void RefreshPathLoss(path_loss_t * PathLoss, unit_model_params_t * UnitParams);
+
+/* Larger of two non-negative numbers without branches
+ * (a conditional on doubles prevents the vectorisation of the batches)
+ */
+static inline double PathLossMax(const double a, const double b) {
+
+    return 0.5 * (a + b + fabs(a - b));
+
+}
+
+/* Received power without shadowing (dBm).
+ * "DistanceInObstacle" and "Loss" are the length of the segment inside the
+ * obstacle and its attenuation (0 if there is no obstacle in between).
+ */
+static inline real_t PathLossPower(const path_loss_t * PathLoss,
+        const real_t Distance, const real_t DistanceInObstacle,
+        const real_t Loss) {
+
+    double x = PathLossMax(Distance, PathLoss->RefDistance) - DistanceInObstacle;
+    x = PathLossMax(x, PATH_LOSS_MIN_DISTANCE);
+
+    return PathLoss->Offset - PathLoss->Slope * FastLog10(x) - Loss;
+
+}
+
+/* Attenuation of an obstacle with "DistanceInObstacle" long segment inside it */
+static inline real_t PathLossOfObstacle(const real_t DistanceInObstacle) {
+
+    return PATH_LOSS_OBSTACLE_SLOPE * FastLog10(DistanceInObstacle);
+
+}
+
+/* Received powers of "n" pairs without shadowing (dBm) */
+void PathLossBatch(const path_loss_t * PathLoss, const real_t *Distances,
+        const real_t *DistancesInObstacles, const real_t *Losses,
+        real_t *Powers, const int n);
+
+#endif
@@ -0,0 +1,409 @@
+//MIT License
+//Copyright (c) 2018 Eotvos Lorand University, Budapest
+
+/* vim:set ts=4 sw=4 sts=4 et: */
+
+/*
+ * Poisson-disk placement of agents.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "placement.h"
+
+/* Random generator of the placement (xorshift64*) */
+static unsigned long long PlacementState;
+
+static void SeedPlacement(const unsigned long Seed) {
+
+    /* splitmix64 of the seed, so that close seeds give different sequences */
+    unsigned long long z = (unsigned long long) Seed + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    PlacementState = z ^ (z >> 31);
+    if (0 == PlacementState) {
+        PlacementState = 0x9E3779B97F4A7C15ULL;
+    }
+
+}
+
+/* Uniform random number in [0, 1) */
+static double PlacementRandom(void) {
+
+    PlacementState ^= PlacementState >> 12;
+    PlacementState ^= PlacementState << 25;
+    PlacementState ^= PlacementState >> 27;
+    return ((PlacementState * 2685821657736338717ULL) >> 11) *
+            (1.0 / 9007199254740992.0);
+
+}
+
+/* Hashed uniform grid of the placed points (in local coordinates) */
+typedef struct {
+
+    double CellSize;
+    unsigned long Mask;
+    int *Heads;
+    int *Next;
+    double (*Points)[3];
+    int NumberOfPoints;
+
+} placement_grid_t;
+
+static long long PlacementCell(const double x, const double CellSize) {
+
+    return (long long) floor(x / CellSize);
+
+}
+
+static unsigned long PlacementHash(const long long cx, const long long cy,
+        const long long cz, const unsigned long Mask) {
+
+    return ((unsigned long) (cx * 73856093LL) ^
+            (unsigned long) (cy * 19349663LL) ^
+            (unsigned long) (cz * 83492791LL)) & Mask;
+
+}
+
+static void InsertIntoPlacementGrid(placement_grid_t * Grid, double *Point) {
+
+    int n = Grid->NumberOfPoints;
+    unsigned long h;
+
+    Grid->Points[n][0] = Point[0];
+    Grid->Points[n][1] = Point[1];
+    Grid->Points[n][2] = Point[2];
+    h = PlacementHash(PlacementCell(Point[0], Grid->CellSize),
+            PlacementCell(Point[1], Grid->CellSize),
+            PlacementCell(Point[2], Grid->CellSize), Grid->Mask);
+    Grid->Next[n] = Grid->Heads[h];
+    Grid->Heads[h] = n;
+    Grid->NumberOfPoints++;
+
+}
+
+/* Is there a point closer than (or exactly at) "MinDistance"?
+ * The cells are not smaller than "MinDistance", so only the neighbouring
+ * cells have to be checked.
+ */
+static bool IsTooClose(placement_grid_t * Grid, double *Point,
+        const double MinDistance) {
+
+    long long cx = PlacementCell(Point[0], Grid->CellSize);
+    long long cy = PlacementCell(Point[1], Grid->CellSize);
+    long long cz = PlacementCell(Point[2], Grid->CellSize);
+    long long i, j, k;
+    int n;
+    double dx, dy, dz;
+    const double MinDistance2 = MinDistance * MinDistance;
+
+    for (i = cx - 1; i <= cx + 1; i++) {
+        for (j = cy - 1; j <= cy + 1; j++) {
+            for (k = cz - 1; k <= cz + 1; k++) {
+                for (n = Grid->Heads[PlacementHash(i, j, k, Grid->Mask)];
+                        n >= 0; n = Grid->Next[n]) {
+                    dx = Grid->Points[n][0] - Point[0];
+                    dy = Grid->Points[n][1] - Point[1];
+                    dz = Grid->Points[n][2] - Point[2];
+                    if (dx * dx + dy * dy + dz * dz <= MinDistance2) {
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+
+    return false;
+
+}
+
+static bool IsInsideRegion(placement_region_t * Region, double *Point) {
+
+    const double *H = Region->HalfSizes;
+
+    switch (Region->Shape) {
+    case PLACEMENT_CYLINDER:
+        return Point[0] * Point[0] + Point[1] * Point[1] <= H[0] * H[0] &&
+                fabs(Point[2]) <= H[2];
+    case PLACEMENT_BALL:
+        return Point[0] * Point[0] + Point[1] * Point[1] +
+                Point[2] * Point[2] <= H[0] * H[0];
+    default:
+        return fabs(Point[0]) <= H[0] && fabs(Point[1]) <= H[1] &&
+                fabs(Point[2]) <= H[2];
+    }
+
+}
+
+/* Random point of the region (uniform, or with uniform radius) */
+static void RandomPointOfRegion(double *Point, placement_region_t * Region) {
+
+    int k;
+    double Radius, Phi, Theta;
+
+    if (Region->UniformRadius && Region->Shape == PLACEMENT_CYLINDER) {
+        Radius = Region->HalfSizes[0] * PlacementRandom();
+        Phi = 2.0 * M_PI * PlacementRandom();
+        Point[0] = Radius * cos(Phi);
+        Point[1] = Radius * sin(Phi);
+        Point[2] = Region->HalfSizes[2] * (2.0 * PlacementRandom() - 1.0);
+        return;
+    }
+    if (Region->UniformRadius && Region->Shape == PLACEMENT_BALL) {
+        Radius = Region->HalfSizes[0] * PlacementRandom();
+        Phi = 2.0 * M_PI * PlacementRandom();
+        Theta = M_PI * PlacementRandom();
+        Point[0] = Radius * cos(Phi) * sin(Theta);
+        Point[1] = Radius * sin(Phi) * sin(Theta);
+        Point[2] = Radius * cos(Theta);
+        return;
+    }
+
+    do {
+        for (k = 0; k < 3; k++) {
+            Point[k] = Region->HalfSizes[k] * (2.0 * PlacementRandom() - 1.0);
+        }
+    } while (!IsInsideRegion(Region, Point));
+
+}
+
+/* Random point at a distance between "MinDistance" and 2 * "MinDistance"
+ * from "Center" (only along the axes of the region with non-zero size)
+ */
+static void RandomPointAround(double *Point, double *Center,
+        placement_region_t * Region, const double MinDistance) {
+
+    double Direction[3];
+    double Length2, Radius;
+    int k;
+
+    do {
+        Length2 = 0.0;
+        for (k = 0; k < 3; k++) {
+            Direction[k] = (Region->HalfSizes[k] > 0.0 ?
+                    2.0 * PlacementRandom() - 1.0 : 0.0);
+            Length2 += Direction[k] * Direction[k];
+        }
+    } while (Length2 > 1.0 || Length2 < 1e-6);
+
+    Radius = MinDistance * (2.0 - PlacementRandom()) / sqrt(Length2);
+    for (k = 0; k < 3; k++) {
+        Point[k] = Center[k] + Radius * Direction[k];
+    }
+
+}
+
+void BoxRegion(placement_region_t * Region, const real_t XSize,
+        const real_t YSize, const real_t ZSize, const real_t XCenter,
+        const real_t YCenter, const real_t ZCenter) {
+
+    int k, l;
+
+    Region->Shape = PLACEMENT_BOX;
+    Region->Center[0] = XCenter;
+    Region->Center[1] = YCenter;
+    Region->Center[2] = ZCenter;
+    for (k = 0; k < 3; k++) {
+        for (l = 0; l < 3; l++) {
+            Region->Axes[k][l] = (k == l ? 1.0 : 0.0);
+        }
+    }
+    Region->HalfSizes[0] = 0.5 * fabs(XSize);
+    Region->HalfSizes[1] = 0.5 * fabs(YSize);
+    Region->HalfSizes[2] = 0.5 * fabs(ZSize);
+    Region->UniformRadius = false;
+
+}
+
+void DiscRegion(placement_region_t * Region, const real_t Radius,
+        const real_t ZSize, const real_t XCenter, const real_t YCenter,
+        const real_t ZCenter) {
+
+    BoxRegion(Region, 2.0 * Radius, 2.0 * Radius, ZSize, XCenter, YCenter,
+            ZCenter);
+    Region->Shape = PLACEMENT_CYLINDER;
+    Region->UniformRadius = true;
+
+}
+
+void SphereRegion(placement_region_t * Region, const real_t Radius,
+        const real_t XCenter, const real_t YCenter, const real_t ZCenter) {
+
+    BoxRegion(Region, 2.0 * Radius, 2.0 * Radius, 2.0 * Radius, XCenter,
+            YCenter, ZCenter);
+    Region->Shape = PLACEMENT_BALL;
+    Region->UniformRadius = true;
+
+}
+
+void PlaneRegion(placement_region_t * Region, const real_t XSize,
+        const real_t YSize, const real_t XCenter, const real_t YCenter,
+        const real_t ZCenter, real_t *PlaneNormalVect, real_t *XAxis) {
+
+    int k;
+
+    BoxRegion(Region, XSize, YSize, 0.0, XCenter, YCenter, ZCenter);
+
+    /* Local axes: XAxis, normal x XAxis and the normal */
+    for (k = 0; k < 3; k++) {
+        Region->Axes[0][k] = XAxis[k];
+        Region->Axes[2][k] = PlaneNormalVect[k];
+    }
+    Region->Axes[1][0] = PlaneNormalVect[1] * XAxis[2] - PlaneNormalVect[2] * XAxis[1];
+    Region->Axes[1][1] = PlaneNormalVect[2] * XAxis[0] - PlaneNormalVect[0] * XAxis[2];
+    Region->Axes[1][2] = PlaneNormalVect[0] * XAxis[1] - PlaneNormalVect[1] * XAxis[0];
+
+}
+
+bool PoissonDiskPlacement(phase_t * Phase, placement_region_t * Region,
+        const int fromAgent, const int toAgent, const real_t MinDistance,
+        const unsigned long Seed) {
+
+    placement_grid_t Grid;
+    unsigned long HashSize;
+    int *Active;
+    int *Placed;
+    int NumberOfActive = 0;
+    int NumberOfPlaced = 0;
+    int NumberToPlace = toAgent - fromAgent;
+    int FailedDarts = 0;
+    long Darts = 0;
+    int i, k, l, a;
+    double Point[3];
+    double Relative[3];
+    double Reach;
+    bool Success = true;
+
+    if (NumberToPlace <= 0) {
+        return true;
+    }
+
+    SeedPlacement(Seed);
+
+    /* Cells are not smaller than the minimal distance (1 cm at least) */
+    Grid.CellSize = (MinDistance > 1.0 ? MinDistance : 1.0);
+    HashSize = 1;
+    while (HashSize < 2UL * Phase->NumberOfAgents) {
+        HashSize <<= 1;
+    }
+    Grid.Mask = HashSize - 1;
+    Grid.Heads = (int *) malloc(HashSize * sizeof(int));
+    Grid.Next = (int *) malloc(Phase->NumberOfAgents * sizeof(int));
+    Grid.Points = malloc(Phase->NumberOfAgents * sizeof(*Grid.Points));
+    Grid.NumberOfPoints = 0;
+    Active = (int *) malloc(NumberToPlace * sizeof(int));
+    Placed = (int *) malloc(NumberToPlace * sizeof(int));
+    if (!Grid.Heads || !Grid.Next || !Grid.Points || !Active || !Placed) {
+        fprintf(stderr, "Placement grid allocation error!\n");
+        exit(-1);
+    }
+    for (i = 0; i < (int) HashSize; i++) {
+        Grid.Heads[i] = -1;
+    }
+
+    /* The other agents of the phase have to be avoided
+     * (if they can be close to the region) */
+    Reach = Region->HalfSizes[0] + Region->HalfSizes[1] +
+            Region->HalfSizes[2] + MinDistance;
+    for (i = 0; i < Phase->NumberOfAgents; i++) {
+        if (i >= fromAgent && i < toAgent) {
+            continue;
+        }
+        for (k = 0; k < 3; k++) {
+            Point[k] = 0.0;
+            for (l = 0; l < 3; l++) {
+                Point[k] += (Phase->Coordinates[i][l] - Region->Center[l]) *
+                        Region->Axes[k][l];
+            }
+        }
+        if (fabs(Point[0]) <= Reach && fabs(Point[1]) <= Reach &&
+                fabs(Point[2]) <= Reach) {
+            InsertIntoPlacementGrid(&Grid, Point);
+        }
+    }
+
+    /* Random darts while the region is sparse
+     * (with uniform radius every agent is placed by darts) */
+    while (NumberOfPlaced < NumberToPlace &&
+            FailedDarts < PLACEMENT_MAX_FAILED_DARTS) {
+        RandomPointOfRegion(Point, Region);
+        Darts++;
+        if (Region->UniformRadius &&
+                Darts > PLACEMENT_DARTS_PER_AGENT * Phase->NumberOfAgents) {
+            break;
+        }
+        if (IsTooClose(&Grid, Point, MinDistance)) {
+            FailedDarts += (Region->UniformRadius ? 0 : 1);
+            continue;
+        }
+        FailedDarts = 0;
+        Placed[NumberOfPlaced] = Active[NumberOfActive] = Grid.NumberOfPoints;
+        InsertIntoPlacementGrid(&Grid, Point);
+        NumberOfPlaced++;
+        NumberOfActive++;
+    }
+
+    /* A single point has no space around it */
+    if (Region->HalfSizes[0] <= 0.0 && Region->HalfSizes[1] <= 0.0 &&
+            Region->HalfSizes[2] <= 0.0) {
+        NumberOfActive = 0;
+    }
+    /* Bridson's algorithm would change the density of uniform radius */
+    if (Region->UniformRadius) {
+        NumberOfActive = 0;
+    }
+
+    /* Bridson's algorithm: candidates around the placed points;
+     * points without free space around them are removed from the active list */
+    while (NumberOfPlaced < NumberToPlace) {
+
+        if (0 == NumberOfActive) {
+            Success = false;
+            break;
+        }
+
+        a = (int) (PlacementRandom() * NumberOfActive);
+        for (k = 0; k < PLACEMENT_CANDIDATES; k++) {
+            RandomPointAround(Point, Grid.Points[Active[a]], Region,
+                    MinDistance);
+            if (IsInsideRegion(Region, Point) &&
+                    !IsTooClose(&Grid, Point, MinDistance)) {
+                break;
+            }
+        }
+
+        if (k < PLACEMENT_CANDIDATES) {
+            Placed[NumberOfPlaced] = Active[NumberOfActive] = Grid.NumberOfPoints;
+            InsertIntoPlacementGrid(&Grid, Point);
+            NumberOfPlaced++;
+            NumberOfActive++;
+        } else {
+            Active[a] = Active[--NumberOfActive];
+        }
+
+    }
+
+    if (Success) {
+        for (i = 0; i < NumberToPlace; i++) {
+            for (k = 0; k < 3; k++) {
+                Relative[k] = Grid.Points[Placed[i]][k];
+            }
+            for (l = 0; l < 3; l++) {
+                Phase->Coordinates[fromAgent + i][l] = Region->Center[l] +
+                        Relative[0] * Region->Axes[0][l] +
+                        Relative[1] * Region->Axes[1][l] +
+                        Relative[2] * Region->Axes[2][l];
+            }
+        }
+    }
+
+    free(Grid.Heads);
+    free(Grid.Next);
+    free(Grid.Points);
+    free(Active);
+    free(Placed);
+
+    return Success;
+
+}
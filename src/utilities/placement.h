@@ -0,0 +1,88 @@
+//MIT License
+//Copyright (c) 2018 Eotvos Lorand University, Budapest
+
+/* vim:set ts=4 sw=4 sts=4 et: */
+
+/*
+ * Random initial placement of agents with a minimal distance between them
+ * (Poisson-disk sampling).
+ * Random positions are tried first (darts); when the region gets crowded and
+ * the darts keep failing, the remaining agents are placed around the already
+ * placed ones (Bridson's algorithm), so dense placements fill the region
+ * instead of failing. Close agents are searched in a hashed uniform grid,
+ * therefore placing N agents takes O(N) time.
+ * The placement has its own random generator, the result depends only on
+ * the seed.
+ * Discs and balls keep the density of the original samplers: the distance
+ * from the centre is uniform (the agents are denser at the centre). Bridson's
+ * algorithm would even this out, so these regions use darts only (at most
+ * PLACEMENT_DARTS_PER_AGENT per agent of the phase, as before).
+ */
+
+#ifndef PLACEMENT_H
+#define PLACEMENT_H
+
+#include <stdbool.h>
+#include "dynamics_utils.h"
+
+/* Number of failed darts in a row before switching to Bridson's algorithm */
+#define PLACEMENT_MAX_FAILED_DARTS 32
+/* Number of candidates around a placed agent (Bridson's algorithm) */
+#define PLACEMENT_CANDIDATES 30
+/* Number of darts per agent of the phase in regions with uniform radius */
+#define PLACEMENT_DARTS_PER_AGENT 100
+
+typedef enum {
+    PLACEMENT_BOX = 0,
+    PLACEMENT_CYLINDER = 1,
+    PLACEMENT_BALL = 2
+} placement_shape_t;
+
+/* Region of the placement.
+ * Points are sampled in a local coordinate system given by its centre and
+ * orthonormal axes; "HalfSizes" are the half sizes of the box along the axes,
+ * the radius (first two) and the half height of the cylinder, or the radius
+ * of the ball. Axes with zero size are left out (e.g. planes).
+ * With "UniformRadius" the distance from the axis of the cylinder or from the
+ * centre of the ball is uniform, instead of the points.
+ */
+typedef struct {
+
+    placement_shape_t Shape;
+    double Center[3];
+    double Axes[3][3];
+    double HalfSizes[3];
+    bool UniformRadius;
+
+} placement_region_t;
+
+/* Axis-aligned box (rectangle if one of the sizes is zero) */
+void BoxRegion(placement_region_t * Region, const real_t XSize,
+        const real_t YSize, const real_t ZSize, const real_t XCenter,
+        const real_t YCenter, const real_t ZCenter);
+
+/* Disc of radius "Radius" in the XY plane (cylinder if "ZSize" is not zero),
+ * with uniform radius */
+void DiscRegion(placement_region_t * Region, const real_t Radius,
+        const real_t ZSize, const real_t XCenter, const real_t YCenter,
+        const real_t ZCenter);
+
+/* Ball of radius "Radius", with uniform radius and polar angle */
+void SphereRegion(placement_region_t * Region, const real_t Radius,
+        const real_t XCenter, const real_t YCenter, const real_t ZCenter);
+
+/* Rectangle on the plane given by its normal vector and its local X axis */
+void PlaneRegion(placement_region_t * Region, const real_t XSize,
+        const real_t YSize, const real_t XCenter, const real_t YCenter,
+        const real_t ZCenter, real_t *PlaneNormalVect, real_t *XAxis);
+
+/* Placing agents "fromAgent" ... "toAgent" - 1 inside "Region" farther than
+ * "MinDistance" from each other and from the other agents of the phase.
+ * Only the coordinates are changed.
+ * Returns false if the region is too small for the agents.
+ */
+bool PoissonDiskPlacement(phase_t * Phase, placement_region_t * Region,
+        const int fromAgent, const int toAgent, const real_t MinDistance,
+        const unsigned long Seed);
+
+#endif
@@ -0,0 +1,27 @@
+//MIT License
+//Copyright (c) 2018 Eotvos Lorand University, Budapest
+
+/* vim:set ts=4 sw=4 sts=4 et: */
+
+/*
+ * Floating point type of the simulation state and of the interaction math.
+ * The default is double, compiling with -DSINGLE_PRECISION
+ * (make ... precision=single) switches to float. Parameters, time and the
+ * accumulators of the statistics remain double in both cases.
+ *
+ * Positions are not shifted to a local origin: the arenas, the obstacle files
+ * and the initial area are centred at (0, 0) and stay within +-62500 cm, where
+ * the spacing of float values is below 0.01 cm. Scenarios far from the origin
+ * (e.g. ArenaCenterX of 10^6 cm) should use the double build.
+ */
+
+#ifndef PRECISION_H
+#define PRECISION_H
+
+#ifdef SINGLE_PRECISION
+typedef float real_t;
+#else
+typedef double real_t;
+#endif
+
+#endif
@@ -0,0 +1,192 @@
+//MIT License
+//Copyright (c) 2018 Eotvos Lorand University, Budapest
+
+/* vim:set ts=4 sw=4 sts=4 et: */
+
+/*
+ * Timers and counters of the stages of the simulation step.
+ */
+
+#include <stdlib.h>
+#include "profiler.h"
+
+_Thread_local bool ProfilerEnabled = false;
+_Thread_local int64_t ProfileStarts[NUMBER_OF_PROFILE_STAGES];
+static bool ProfilerInitialized = false;
+uint64_t ProfileCounters[NUMBER_OF_PROFILE_COUNTERS];
+
+static const char *StageNames[NUMBER_OF_PROFILE_STAGES] = {
+    "step",
+    "collisions",
+    "hull",
+    "mission",
+    "pair_geometry",
+    "create_phase",
+    "preferred_velocity",
+    "term_repulsion",
+    "term_attraction",
+    "term_olfati",
+    "term_target_tracking",
+    "term_friction",
+    "term_walls",
+    "term_obstacles",
+    "cbp",
+    "acceleration",
+    "noise",
+    "outer_variables",
+    "dataline",
+    "statistics",
+    "output"
+};
+
+static const char *CounterNames[NUMBER_OF_PROFILE_COUNTERS] = {
+    "pairs",
+    "obstacle_tests",
+    "rays"
+};
+
+/* Accumulated time of the stages (ns) */
+static uint64_t Calls[NUMBER_OF_PROFILE_STAGES];
+static int64_t TotalTime[NUMBER_OF_PROFILE_STAGES];
+static int64_t MaxTime[NUMBER_OF_PROFILE_STAGES];
+static int64_t StartOfProfiling;
+
+/* Stored intervals of the trace file */
+typedef struct {
+    int Stage;
+    int64_t Start;
+    int64_t Duration;
+} trace_event_t;
+
+static const char *TraceFile = NULL;
+static trace_event_t *TraceEvents = NULL;
+static int NumberOfTraceEvents = 0;
+static uint64_t DroppedTraceEvents = 0;
+
+static void WriteTrace() {
+
+    int i;
+    FILE *f_Trace = fopen(TraceFile, "w");
+
+    if (f_Trace == NULL) {
+        fprintf(stderr, "Unable to open trace file \"%s\"!\n", TraceFile);
+        return;
+    }
+
+    fprintf(f_Trace, "{\"traceEvents\":[\n");
+    for (i = 0; i < NumberOfTraceEvents; i++) {
+        fprintf(f_Trace,
+                "{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":1}%s\n",
+                StageNames[TraceEvents[i].Stage],
+                (TraceEvents[i].Start - StartOfProfiling) / 1000.0,
+                TraceEvents[i].Duration / 1000.0,
+                (i < NumberOfTraceEvents - 1 ? "," : ""));
+    }
+    fprintf(f_Trace, "],\"displayTimeUnit\":\"ms\"}\n");
+    fclose(f_Trace);
+
+    if (DroppedTraceEvents > 0) {
+        fprintf(stderr, "Trace buffer is full, %llu events were not saved!\n",
+                (unsigned long long) DroppedTraceEvents);
+    }
+
+}
+
+static void FinishProfiling() {
+
+    PrintProfile(stderr);
+    if (TraceFile != NULL) {
+        WriteTrace();
+        free(TraceEvents);
+    }
+
+}
+
+void InitializeProfiler(const char *TraceFileName) {
+
+    int i;
+
+    for (i = 0; i < NUMBER_OF_PROFILE_STAGES; i++) {
+        Calls[i] = 0;
+        TotalTime[i] = 0;
+        MaxTime[i] = 0;
+    }
+    for (i = 0; i < NUMBER_OF_PROFILE_COUNTERS; i++) {
+        ProfileCounters[i] = 0;
+    }
+
+    if (TraceFileName != NULL) {
+        TraceFile = TraceFileName;
+        TraceEvents = malloc(PROFILE_MAX_TRACE_EVENTS * sizeof(trace_event_t));
+        if (!TraceEvents) {
+            fprintf(stderr, "Trace events allocation error!\n");
+            exit(-1);
+        }
+    }
+
+    StartOfProfiling = ProfilerNow();
+    ProfilerInitialized = true;
+    ProfilerEnabled = true;
+    atexit(FinishProfiling);
+
+}
+
+void ProfileThisThread(const bool Enabled) {
+    ProfilerEnabled = (Enabled && ProfilerInitialized);
+}
+
+void ProfilerRecord(const profile_stage_t Stage, const int64_t Start) {
+
+    int64_t Duration = ProfilerNow() - Start;
+
+    Calls[Stage]++;
+    TotalTime[Stage] += Duration;
+    if (Duration > MaxTime[Stage]) {
+        MaxTime[Stage] = Duration;
+    }
+
+    if (TraceEvents != NULL) {
+        if (NumberOfTraceEvents < PROFILE_MAX_TRACE_EVENTS) {
+            TraceEvents[NumberOfTraceEvents].Stage = Stage;
+            TraceEvents[NumberOfTraceEvents].Start = Start;
+            TraceEvents[NumberOfTraceEvents].Duration = Duration;
+            NumberOfTraceEvents++;
+        } else {
+            DroppedTraceEvents++;
+        }
+    }
+
+}
+
+void PrintProfile(FILE * Output) {
+
+    int i;
+    double Elapsed = (ProfilerNow() - StartOfProfiling) / 1e6;
+
+    fprintf(Output, "\n# Profile (total time: %.3f ms)\n", Elapsed);
+    fprintf(Output, "%-24s%12s%14s%10s%12s%12s\n", "stage", "calls",
+            "total_ms", "share_%", "mean_us", "max_us");
+    for (i = 0; i < NUMBER_OF_PROFILE_STAGES; i++) {
+        if (Calls[i] == 0) {
+            continue;
+        }
+        fprintf(Output, "%-24s%12llu%14.3f%10.2f%12.3f%12.3f\n",
+                StageNames[i], (unsigned long long) Calls[i],
+                TotalTime[i] / 1e6, 100.0 * TotalTime[i] / 1e6 / Elapsed,
+                TotalTime[i] / 1e3 / Calls[i], MaxTime[i] / 1e3);
+    }
+    fprintf(Output, "%-24s%12s\n", "counter", "value");
+    for (i = 0; i < NUMBER_OF_PROFILE_COUNTERS; i++) {
+        fprintf(Output, "%-24s%12llu\n", CounterNames[i],
+                (unsigned long long) ProfileCounters[i]);
+    }
+
+}
+
+const char *ProfileStageName(const profile_stage_t Stage) {
+    return StageNames[Stage];
+}
+
+int64_t ProfiledTime(const profile_stage_t Stage) {
+    return TotalTime[Stage];
+}
@@ -0,0 +1,109 @@
+//MIT License
+//Copyright (c) 2018 Eotvos Lorand University, Budapest
+
+/* vim:set ts=4 sw=4 sts=4 et: */
+
+/*
+ * Timers and counters of the stages of the simulation step.
+ * Profiling is switched on with the "-profile" command line option, otherwise
+ * every timer costs a single branch. Compiling with -DNO_PROFILER removes
+ * the timers and the counters completely.
+ *
+ * The timers and the counters are not synchronised: only one thread, the one
+ * that calculates the steps, is profiled (see ProfileThisThread).
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+/* Measured stages (top level stages first, then the parts of them) */
+typedef enum {
+    PROFILE_STEP,
+    PROFILE_COLLISIONS,
+    PROFILE_HULL,
+    PROFILE_MISSION,
+    PROFILE_PAIR_GEOMETRY,
+    PROFILE_CREATE_PHASE,
+    PROFILE_PREFERRED_VELOCITY,
+    PROFILE_TERM_REPULSION,
+    PROFILE_TERM_ATTRACTION,
+    PROFILE_TERM_OLFATI,
+    PROFILE_TERM_TARGET_TRACKING,
+    PROFILE_TERM_FRICTION,
+    PROFILE_TERM_WALLS,
+    PROFILE_TERM_OBSTACLES,
+    PROFILE_CBP,
+    PROFILE_ACCELERATION,
+    PROFILE_NOISE,
+    PROFILE_OUTER_VARIABLES,
+    PROFILE_DATALINE,
+    PROFILE_STATISTICS,
+    PROFILE_OUTPUT,
+    NUMBER_OF_PROFILE_STAGES
+} profile_stage_t;
+
+/* Event counters */
+typedef enum {
+    PROFILE_PAIRS,
+    PROFILE_OBSTACLE_TESTS,
+    PROFILE_RAYS,
+    NUMBER_OF_PROFILE_COUNTERS
+} profile_counter_t;
+
+/* Max. number of events stored for the trace file */
+#define PROFILE_MAX_TRACE_EVENTS (1 << 20)
+
+extern _Thread_local bool ProfilerEnabled;
+extern _Thread_local int64_t ProfileStarts[NUMBER_OF_PROFILE_STAGES];
+extern uint64_t ProfileCounters[NUMBER_OF_PROFILE_COUNTERS];
+
+/* Monotonic time in nanoseconds */
+static inline int64_t ProfilerNow() {
+
+    struct timespec Now;
+    clock_gettime(CLOCK_MONOTONIC, &Now);
+    return (int64_t) Now.tv_sec * 1000000000 + Now.tv_nsec;
+
+}
+
+/* Switching on the profiler. If "TraceFileName" is not NULL, every measured
+ * interval is stored and written out in Chrome trace event format at exit.
+ * The breakdown table is printed to stderr at exit.
+ */
+void InitializeProfiler(const char *TraceFileName);
+
+/* Switching the profiling of the calling thread on or off. Only the thread
+ * calling InitializeProfiler is profiled at first; the other threads are
+ * never profiled while this one is.
+ */
+void ProfileThisThread(const bool Enabled);
+
+/* Adding the interval from "Start" until now to "Stage" */
+void ProfilerRecord(const profile_stage_t Stage, const int64_t Start);
+
+/* Printing the breakdown table of the stages and the counters */
+void PrintProfile(FILE * Output);
+
+/* Name of a stage and the time spent in it since the start of profiling (ns) */
+const char *ProfileStageName(const profile_stage_t Stage);
+int64_t ProfiledTime(const profile_stage_t Stage);
+
+#ifndef NO_PROFILER
+#define PROFILE_BEGIN(Stage) \
+    do { if (ProfilerEnabled) ProfileStarts[Stage] = ProfilerNow(); } while (0)
+#define PROFILE_END(Stage) \
+    do { if (ProfilerEnabled) ProfilerRecord(Stage, ProfileStarts[Stage]); } while (0)
+#define PROFILE_COUNT(Counter, Value) \
+    do { if (ProfilerEnabled) ProfileCounters[Counter] += (Value); } while (0)
+#else
+#define PROFILE_BEGIN(Stage) do { } while (0)
+#define PROFILE_END(Stage) do { } while (0)
+#define PROFILE_COUNT(Counter, Value) do { } while (0)
+#endif
+
+#endif
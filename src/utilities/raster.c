@@ -0,0 +1,161 @@
+//MIT License
+//Copyright (c) 2018 Eotvos Lorand University, Budapest
+
+/* vim:set ts=4 sw=4 sts=4 et: */
+
+/*
+ * Software rasterisation of simple 2D shapes.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "raster.h"
+
+void AllocateRasterImage(raster_image_t * Image, const int Width,
+        const int Height) {
+
+    Image->Width = Width;
+    Image->Height = Height;
+    Image->Pixels = (unsigned char *) malloc((size_t) Width * Height * 3);
+    if (!Image->Pixels) {
+        fprintf(stderr, "Raster image allocation error!\n");
+        exit(-1);
+    }
+
+}
+
+void freeRasterImage(raster_image_t * Image) {
+
+    free(Image->Pixels);
+    Image->Pixels = NULL;
+
+}
+
+/* Writing a pixel (the coordinates are checked by the callers) */
+static inline void SetPixel(raster_image_t * Image, const int x, const int y,
+        const unsigned char *RGB) {
+
+    unsigned char *Pixel = Image->Pixels + 3 * ((size_t) y * Image->Width + x);
+    Pixel[0] = RGB[0];
+    Pixel[1] = RGB[1];
+    Pixel[2] = RGB[2];
+
+}
+
+static void ColorToRGB(unsigned char *RGB, const float *color) {
+
+    int k;
+    for (k = 0; k < 3; k++) {
+        RGB[k] = (unsigned char) (255.0f * fminf(fmaxf(color[k], 0.0f), 1.0f)
+                + 0.5f);
+    }
+
+}
+
+/* Clipping a bounding box to the image (false if it is outside) */
+static int ClipBox(raster_image_t * Image, const double MinX, const double MinY,
+        const double MaxX, const double MaxY, int *x1, int *y1, int *x2,
+        int *y2) {
+
+    if (MaxX < 0 || MaxY < 0 || MinX >= Image->Width || MinY >= Image->Height) {
+        return 0;
+    }
+    *x1 = (MinX < 0 ? 0 : (int) floor(MinX));
+    *y1 = (MinY < 0 ? 0 : (int) floor(MinY));
+    *x2 = (MaxX >= Image->Width ? Image->Width - 1 : (int) floor(MaxX));
+    *y2 = (MaxY >= Image->Height ? Image->Height - 1 : (int) floor(MaxY));
+    return 1;
+
+}
+
+void ClearRasterImage(raster_image_t * Image, const float *color) {
+
+    size_t i;
+    unsigned char RGB[3];
+    const size_t NumberOfPixels = (size_t) Image->Width * Image->Height;
+
+    ColorToRGB(RGB, color);
+    for (i = 0; i < NumberOfPixels; i++) {
+        memcpy(Image->Pixels + 3 * i, RGB, 3);
+    }
+
+}
+
+void CopyRasterImage(raster_image_t * Destination, raster_image_t * Source) {
+    memcpy(Destination->Pixels, Source->Pixels,
+            (size_t) Source->Width * Source->Height * 3);
+}
+
+void FillRasterDisc(raster_image_t * Image, const double CenterX,
+        const double CenterY, const double Radius, const float *color) {
+    FillRasterRing(Image, CenterX, CenterY, -1.0, Radius, color);
+}
+
+void FillRasterRing(raster_image_t * Image, const double CenterX,
+        const double CenterY, const double InnerRadius,
+        const double OuterRadius, const float *color) {
+
+    int x, y, x1, y1, x2, y2;
+    double dx, dy, r2;
+    unsigned char RGB[3];
+    const double Inner2 = (InnerRadius > 0 ? InnerRadius * InnerRadius : -1.0);
+    const double Outer2 = OuterRadius * OuterRadius;
+
+    if (!ClipBox(Image, CenterX - OuterRadius, CenterY - OuterRadius,
+                    CenterX + OuterRadius, CenterY + OuterRadius, &x1, &y1,
+                    &x2, &y2)) {
+        return;
+    }
+    ColorToRGB(RGB, color);
+
+    /* Pixels are tested at their centers */
+    for (y = y1; y <= y2; y++) {
+        dy = y + 0.5 - CenterY;
+        for (x = x1; x <= x2; x++) {
+            dx = x + 0.5 - CenterX;
+            r2 = dx * dx + dy * dy;
+            if (r2 <= Outer2 && r2 >= Inner2) {
+                SetPixel(Image, x, y, RGB);
+            }
+        }
+    }
+
+}
+
+void DrawRasterLine(raster_image_t * Image, const double x1, const double y1,
+        const double x2, const double y2, const double Width,
+        const float *color) {
+
+    int x, y, bx1, by1, bx2, by2;
+    double px, py, t, dx, dy;
+    unsigned char RGB[3];
+    const double HalfWidth = fmax(Width, 1.0) * 0.5;
+    const double ux = x2 - x1;
+    const double uy = y2 - y1;
+    const double Length2 = ux * ux + uy * uy;
+
+    if (!ClipBox(Image, fmin(x1, x2) - HalfWidth, fmin(y1, y2) - HalfWidth,
+                    fmax(x1, x2) + HalfWidth, fmax(y1, y2) + HalfWidth, &bx1,
+                    &by1, &bx2, &by2)) {
+        return;
+    }
+    ColorToRGB(RGB, color);
+
+    /* Pixels closer to the segment than half of the width */
+    for (y = by1; y <= by2; y++) {
+        py = y + 0.5 - y1;
+        for (x = bx1; x <= bx2; x++) {
+            px = x + 0.5 - x1;
+            t = (Length2 > 0 ? (px * ux + py * uy) / Length2 : 0.0);
+            t = (t < 0 ? 0 : (t > 1 ? 1 : t));
+            dx = px - t * ux;
+            dy = py - t * uy;
+            if (dx * dx + dy * dy <= HalfWidth * HalfWidth) {
+                SetPixel(Image, x, y, RGB);
+            }
+        }
+    }
+
+}
@@ -0,0 +1,50 @@
+//MIT License
+//Copyright (c) 2018 Eotvos Lorand University, Budapest
+
+/* vim:set ts=4 sw=4 sts=4 et: */
+
+/*
+ * Software rasterisation of simple 2D shapes into RGB images.
+ * It is used for drawing frames without a display or OpenGL (see video_out.h).
+ * Coordinates are in pixels, (0, 0) is the top left corner of the image,
+ * colors are RGB arrays in [0, 1] like everywhere in the visualization.
+ */
+
+#ifndef RASTER_H
+#define RASTER_H
+
+typedef struct {
+
+    int Width;
+    int Height;
+    /* "Width x Height" RGB pixels, row by row from the top */
+    unsigned char *Pixels;
+
+} raster_image_t;
+
+/* Allocating and freeing an image */
+void AllocateRasterImage(raster_image_t * Image, const int Width,
+        const int Height);
+void freeRasterImage(raster_image_t * Image);
+
+/* Filling the whole image with "color" */
+void ClearRasterImage(raster_image_t * Image, const float *color);
+
+/* Copying an image of the same size */
+void CopyRasterImage(raster_image_t * Destination, raster_image_t * Source);
+
+/* Filled disc */
+void FillRasterDisc(raster_image_t * Image, const double CenterX,
+        const double CenterY, const double Radius, const float *color);
+
+/* Ring between radii "InnerRadius" and "OuterRadius" */
+void FillRasterRing(raster_image_t * Image, const double CenterX,
+        const double CenterY, const double InnerRadius,
+        const double OuterRadius, const float *color);
+
+/* Line segment of width "Width" (at least one pixel is covered across) */
+void DrawRasterLine(raster_image_t * Image, const double x1, const double y1,
+        const double x2, const double y2, const double Width,
+        const float *color);
+
+#endif
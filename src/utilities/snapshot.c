@@ -0,0 +1,228 @@
+//MIT License
+//Copyright (c) 2018 Eotvos Lorand University, Budapest
+
+/* vim:set ts=4 sw=4 sts=4 et: */
+
+/*
+ * Triple buffer of the snapshots of the simulation.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "snapshot.h"
+
+void AllocateSnapshotBuffer(snapshot_buffer_t * Buffer,
+        const int NumberOfAgents, const int Resolution) {
+
+    int i;
+    simulation_snapshot_t *Snapshot;
+
+    for (i = 0; i < 3; i++) {
+        Snapshot = &Buffer->Slots[i];
+        AllocatePhase(&Snapshot->Phase, NumberOfAgents, 0);
+        Snapshot->HasLaplacian = false;
+        Snapshot->NeighbourListCapacity = 0;
+        Snapshot->NeighbourLists = NULL;
+        Snapshot->NumberOfNeighbours = intData(NumberOfAgents);
+        Snapshot->GPSCoordinates = realMatrix(NumberOfAgents, 3);
+        Snapshot->AgentsInDanger = BooleanData(NumberOfAgents);
+        Snapshot->NumberOfTailPoints = 0;
+        Snapshot->TailDecimation = 1;
+        Snapshot->LengthOfTail = 0;
+        Snapshot->TailCapacity = 0;
+        Snapshot->Tails = NULL;
+        Snapshot->NumberOfHullVertices = 0;
+        Snapshot->HullVertexSet = realVector(2 * NumberOfAgents + 2);
+        Snapshot->HasCBP = false;
+        Snapshot->Resolution = Resolution;
+        Snapshot->CBP = (float *) calloc((size_t) Resolution * Resolution + 1,
+                sizeof(float));
+        if (Snapshot->CBP == NULL) {
+            fprintf(stderr, "Snapshot allocation error!\n");
+            exit(-1);
+        }
+        Snapshot->Now = 0;
+        Snapshot->TimeStep = 0;
+        Snapshot->Collisions = 0;
+        Snapshot->NumberOfClusters = 0;
+    }
+
+    /* The simulation writes slot 0, the visualization reads slot 2 */
+    Buffer->Back = 0;
+    atomic_init(&Buffer->Middle, 1);
+    Buffer->Front = 2;
+
+}
+
+void freeSnapshotBuffer(snapshot_buffer_t * Buffer) {
+
+    int i;
+    simulation_snapshot_t *Snapshot;
+
+    for (i = 0; i < 3; i++) {
+        Snapshot = &Buffer->Slots[i];
+        freeRealMatrix(Snapshot->GPSCoordinates, Snapshot->Phase.NumberOfAgents, 3);
+        freePhase(&Snapshot->Phase);
+        free(Snapshot->AgentsInDanger);
+        free(Snapshot->NeighbourLists);
+        free(Snapshot->NumberOfNeighbours);
+        free(Snapshot->HullVertexSet);
+        free(Snapshot->Tails);
+        free(Snapshot->CBP);
+    }
+
+}
+
+simulation_snapshot_t *SnapshotToFill(snapshot_buffer_t * Buffer) {
+    return &Buffer->Slots[Buffer->Back];
+}
+
+void PublishSnapshot(snapshot_buffer_t * Buffer) {
+
+    /* The filled slot becomes the middle one, the previous middle slot is
+     * the next one to fill (release: the content is visible with the index)
+     */
+    const int Previous = atomic_exchange_explicit(&Buffer->Middle,
+            Buffer->Back | SNAPSHOT_FRESH, memory_order_acq_rel);
+    Buffer->Back = Previous & ~SNAPSHOT_FRESH;
+
+}
+
+bool SnapshotNeeded(snapshot_buffer_t * Buffer) {
+    return (atomic_load_explicit(&Buffer->Middle,
+                    memory_order_relaxed) & SNAPSHOT_FRESH) == 0;
+}
+
+simulation_snapshot_t *LatestSnapshot(snapshot_buffer_t * Buffer) {
+
+    if ((atomic_load_explicit(&Buffer->Middle,
+                            memory_order_relaxed) & SNAPSHOT_FRESH) != 0) {
+        /* Taking the newest slot and giving back the displayed one
+         * (acquire: the content of the new slot is visible)
+         */
+        const int Previous = atomic_exchange_explicit(&Buffer->Middle,
+                Buffer->Front, memory_order_acq_rel);
+        Buffer->Front = Previous & ~SNAPSHOT_FRESH;
+    }
+
+    return &Buffer->Slots[Buffer->Front];
+
+}
+
+void FillSnapshot(simulation_snapshot_t * Snapshot, phase_t * Phase,
+        phase_t * GPSPhase, bool *AgentsInDanger, hull_t * Hull,
+        flock_aggregates_t * Aggregates, cbp_map_t * CBPMap,
+        const int WhichAgentOfCBP, const bool CopyLaplacian) {
+
+    int i, j;
+    const int NumberOfAgents = Phase->NumberOfAgents;
+    const int Resolution = Snapshot->Resolution;
+    cbp_cell_t *Cell;
+
+    for (i = 0; i < NumberOfAgents; i++) {
+        memcpy(Snapshot->Phase.Coordinates[i], Phase->Coordinates[i],
+                3 * sizeof(real_t));
+        memcpy(Snapshot->Phase.Velocities[i], Phase->Velocities[i],
+                3 * sizeof(real_t));
+        memcpy(Snapshot->GPSCoordinates[i], GPSPhase->Coordinates[i],
+                3 * sizeof(real_t));
+    }
+    memcpy(Snapshot->AgentsInDanger, AgentsInDanger,
+            NumberOfAgents * sizeof(bool));
+
+    /* Neighbour lists (reallocated if the size of the neighbourhood grows) */
+    if (Snapshot->NeighbourListCapacity != Aggregates->NeighbourListCapacity) {
+        Snapshot->NeighbourLists = (int *) realloc(Snapshot->NeighbourLists,
+                (size_t) NumberOfAgents * Aggregates->NeighbourListCapacity *
+                sizeof(int));
+        if (Snapshot->NeighbourLists == NULL
+                && Aggregates->NeighbourListCapacity > 0) {
+            fprintf(stderr, "Snapshot allocation error!\n");
+            exit(-1);
+        }
+        Snapshot->NeighbourListCapacity = Aggregates->NeighbourListCapacity;
+    }
+    memcpy(Snapshot->NumberOfNeighbours, Aggregates->NumberOfNeighbours,
+            NumberOfAgents * sizeof(int));
+    if (Aggregates->NeighbourListCapacity > 0) {
+        memcpy(Snapshot->NeighbourLists, Aggregates->NeighbourLists,
+                (size_t) NumberOfAgents * Aggregates->NeighbourListCapacity *
+                sizeof(int));
+    }
+
+    /* The Laplacian is the only O(N^2) part, needed only by the network */
+    Snapshot->HasLaplacian = CopyLaplacian;
+    if (true == CopyLaplacian) {
+        for (i = 0; i < NumberOfAgents; i++) {
+            memcpy(Snapshot->Phase.Laplacian[i], Phase->Laplacian[i],
+                    NumberOfAgents * sizeof(real_t));
+        }
+    }
+
+    Snapshot->NumberOfHullVertices = Hull->NumberOfVertices;
+    if (Hull->NumberOfVertices > 0) {
+        memcpy(Snapshot->HullVertexSet, Hull->VertexSet,
+                (2 * Hull->NumberOfVertices + 2) * sizeof(real_t));
+    }
+
+    Snapshot->HasCBP = (CBPMap != NULL);
+    if (NULL == CBPMap) {
+        return;
+    }
+    if (WhichAgentOfCBP == NumberOfAgents) {
+        /* The fused map of the swarm is refreshed only where it has changed */
+        RefreshFusedCBP(CBPMap);
+        for (i = 0; i < Resolution * Resolution; i++) {
+            Snapshot->CBP[i] = (CBPMap->FusedCount[i] > 0 ?
+                    CBPMap->FusedProbability[i] : 0.0f);
+        }
+    } else {
+        for (i = 0; i < Resolution; i++) {
+            for (j = 0; j < Resolution; j++) {
+                Cell = CBPCell(CBPMap, WhichAgentOfCBP, j, i);
+                Snapshot->CBP[i * Resolution + j] =
+                        (Cell->Count + Cell->CountObst > 0 ?
+                        CBPProbability(Cell->LogOdds + Cell->LogOddsObst) : 0.0f);
+            }
+        }
+    }
+
+}
+
+void FillSnapshotTails(simulation_snapshot_t * Snapshot, phase_t * PhaseData,
+        const int Now, const int LengthOfTail, const int Decimation) {
+
+    int i, k;
+    size_t Size;
+    const int NumberOfAgents = Snapshot->Phase.NumberOfAgents;
+
+    Snapshot->NumberOfTailPoints = 0;
+    Snapshot->TailDecimation = Decimation;
+    Snapshot->LengthOfTail = LengthOfTail;
+    if (LengthOfTail >= Now || LengthOfTail < 2) {
+        return;
+    }
+
+    /* Points 1, 1 + Decimation, ... steps before "Now" (below LengthOfTail) */
+    Snapshot->NumberOfTailPoints = (LengthOfTail - 2) / Decimation + 1;
+    Size = (size_t) 3 * NumberOfAgents * Snapshot->NumberOfTailPoints;
+    if (Size > Snapshot->TailCapacity) {
+        Snapshot->Tails = (real_t *) realloc(Snapshot->Tails,
+                Size * sizeof(real_t));
+        if (Snapshot->Tails == NULL) {
+            fprintf(stderr, "Snapshot allocation error!\n");
+            exit(-1);
+        }
+        Snapshot->TailCapacity = Size;
+    }
+
+    for (i = 0; i < NumberOfAgents; i++) {
+        for (k = 0; k < Snapshot->NumberOfTailPoints; k++) {
+            memcpy(&Snapshot->Tails[3 * (i * Snapshot->NumberOfTailPoints + k)],
+                    PhaseData[Now - 1 - k * Decimation].Coordinates[i],
+                    3 * sizeof(real_t));
+        }
+    }
+
+}
@@ -0,0 +1,124 @@
+//MIT License
+//Copyright (c) 2018 Eotvos Lorand University, Budapest
+
+/* vim:set ts=4 sw=4 sts=4 et: */
+
+/*
+ * Snapshots of the simulation for the visualization.
+ * The simulation runs on its own thread and publishes copies of the displayed
+ * state through a lock-free triple buffer: the simulation fills the back slot
+ * and swaps it with the middle one, the visualization swaps its front slot
+ * with the middle one if that is newer. Neither side waits for the other,
+ * and a published snapshot is never changed while it is being drawn.
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "dynamics_utils.h"
+#include "hull.h"
+#include "cbp.h"
+#include "aggregates.h"
+
+/* Flag of the shared index: the middle slot has not been taken yet */
+#define SNAPSHOT_FRESH 4
+
+typedef struct {
+
+    /* Positions, velocities and (if "HasLaplacian") the Laplacian of the agents.
+     * It can be drawn like a timeline of one step (at index 0).
+     */
+    phase_t Phase;
+    bool HasLaplacian;
+
+    /* Neighbour lists of the perception (see flock_aggregates_t), the list
+     * of agent i starts at "i * NeighbourListCapacity"
+     */
+    int NeighbourListCapacity;
+    int *NeighbourLists;
+    int *NumberOfNeighbours;
+
+    /* Transformation terms of the GPS noises (GPS ghosts) */
+    real_t **GPSCoordinates;
+    bool *AgentsInDanger;
+
+    /* Tails from the stored timeline: "NumberOfTailPoints" positions of every
+     * agent, point k is "1 + k * TailDecimation" steps before "Now"
+     * (the points of agent i start at "3 * i * NumberOfTailPoints")
+     */
+    int NumberOfTailPoints;
+    int TailDecimation;
+    int LengthOfTail;
+    size_t TailCapacity;
+    real_t *Tails;
+
+    /* Convex hull as a closed {x0, y0, x1, y1, ..., x0, y0} list */
+    int NumberOfHullVertices;
+    real_t *HullVertexSet;
+
+    /* Probability of being free in the displayed CBP map
+     * ("Resolution x Resolution", zero for unexplored cells)
+     */
+    bool HasCBP;
+    int Resolution;
+    float *CBP;
+
+    /* Time of the snapshot and the counters displayed with it */
+    int Now;
+    int TimeStep;
+    int Collisions;
+    int NumberOfClusters;
+
+} simulation_snapshot_t;
+
+typedef struct {
+
+    simulation_snapshot_t Slots[3];
+    /* Index of the middle slot (with SNAPSHOT_FRESH if it is newer than the front) */
+    atomic_int Middle;
+    /* Slot of the simulation and of the visualization */
+    int Back;
+    int Front;
+
+} snapshot_buffer_t;
+
+/* Allocating and freeing the slots of the buffer */
+void AllocateSnapshotBuffer(snapshot_buffer_t * Buffer,
+        const int NumberOfAgents, const int Resolution);
+void freeSnapshotBuffer(snapshot_buffer_t * Buffer);
+
+/* Simulation side: the slot to fill and publishing it as the newest snapshot */
+simulation_snapshot_t *SnapshotToFill(snapshot_buffer_t * Buffer);
+void PublishSnapshot(snapshot_buffer_t * Buffer);
+
+/* True if the last published snapshot has already been taken
+ * (there is no reason to copy the state more often than it is displayed)
+ */
+bool SnapshotNeeded(snapshot_buffer_t * Buffer);
+
+/* Visualization side: the newest published snapshot
+ * (valid until the next call)
+ */
+simulation_snapshot_t *LatestSnapshot(snapshot_buffer_t * Buffer);
+
+/* Copying the state into a snapshot.
+ * The neighbour lists are always copied from "Aggregates", the Laplacian
+ * only if "CopyLaplacian" is true (network displayed in 3D),
+ * the CBP map of agent "WhichAgentOfCBP" (or the fused map of the swarm if it
+ * is the number of agents) only if "CBPMap" is not NULL.
+ */
+void FillSnapshot(simulation_snapshot_t * Snapshot, phase_t * Phase,
+        phase_t * GPSPhase, bool *AgentsInDanger, hull_t * Hull,
+        flock_aggregates_t * Aggregates, cbp_map_t * CBPMap,
+        const int WhichAgentOfCBP, const bool CopyLaplacian);
+
+/* Copying the tails of the agents into a snapshot: every "Decimation"th
+ * position of the last "LengthOfTail" steps of the timeline "PhaseData"
+ * (no tail until "Now" exceeds "LengthOfTail")
+ */
+void FillSnapshotTails(simulation_snapshot_t * Snapshot, phase_t * PhaseData,
+        const int Now, const int LengthOfTail, const int Decimation);
+
+#endif
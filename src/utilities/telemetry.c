@@ -0,0 +1,147 @@
+//MIT License
+//Copyright (c) 2018 Eotvos Lorand University, Budapest
+
+/* vim:set ts=4 sw=4 sts=4 et: */
+
+/*
+ * Live telemetry of headless runs.
+ */
+
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+#include "telemetry.h"
+#include "datastructs.h"
+
+void StartTelemetry(telemetry_t * Telemetry, const int NumberOfAgents,
+        const double Length, const double DeltaT) {
+
+    int i;
+    int Descriptor;
+    telemetry_region_t *Region;
+
+    Telemetry->Enabled = false;
+    Telemetry->Region = NULL;
+    sprintf(Telemetry->Name, "/robotsim_%d", (int) getpid());
+
+    Descriptor = shm_open(Telemetry->Name, O_CREAT | O_RDWR | O_TRUNC, 0644);
+    if (Descriptor < 0) {
+        fprintf(stderr, "Telemetry: cannot create shared memory %s!\n",
+                Telemetry->Name);
+        return;
+    }
+    if (ftruncate(Descriptor, sizeof(telemetry_region_t)) != 0) {
+        fprintf(stderr, "Telemetry: cannot resize shared memory %s!\n",
+                Telemetry->Name);
+        close(Descriptor);
+        shm_unlink(Telemetry->Name);
+        return;
+    }
+    Region = (telemetry_region_t *) mmap(NULL, sizeof(telemetry_region_t),
+            PROT_READ | PROT_WRITE, MAP_SHARED, Descriptor, 0);
+    close(Descriptor);
+    if (Region == MAP_FAILED) {
+        fprintf(stderr, "Telemetry: cannot map shared memory %s!\n",
+                Telemetry->Name);
+        shm_unlink(Telemetry->Name);
+        return;
+    }
+
+    /* The new region is filled with zeros */
+    Region->Version = TELEMETRY_VERSION;
+    Region->HeaderSize = offsetof(telemetry_region_t, Ring);
+    Region->SampleSize = sizeof(telemetry_sample_t);
+    Region->RingLength = TELEMETRY_RING_LENGTH;
+    Region->Pid = (int32_t) getpid();
+    Region->NumberOfAgents = NumberOfAgents;
+    Region->NumberOfStages = NUMBER_OF_PROFILE_STAGES;
+    Region->ProfilerEnabled = (ProfilerEnabled ? 1 : 0);
+    Region->Length = Length;
+    Region->DeltaT = DeltaT;
+    for (i = 0; i < NUMBER_OF_PROFILE_STAGES; i++) {
+        strncpy(Region->StageNames[i], ProfileStageName((profile_stage_t) i),
+                TELEMETRY_STAGE_NAME_LENGTH - 1);
+    }
+    atomic_store_explicit(&Region->NumberOfSamples, 0, memory_order_relaxed);
+    atomic_store_explicit(&Region->ReaderHeartbeat, 0, memory_order_relaxed);
+    /* Readers check the magic number last */
+    atomic_thread_fence(memory_order_release);
+    Region->Magic = TELEMETRY_MAGIC;
+
+    Telemetry->Region = Region;
+    Telemetry->Steps = 0;
+    Telemetry->StepsOfLastSample = 0;
+    Telemetry->StartTime = ProfilerNow();
+    Telemetry->TimeOfLastSample = Telemetry->StartTime;
+    Telemetry->Visited = BooleanData(NumberOfAgents);
+    Telemetry->Enabled = true;
+
+}
+
+void StopTelemetry(telemetry_t * Telemetry) {
+
+    if (false == Telemetry->Enabled) {
+        return;
+    }
+    munmap(Telemetry->Region, sizeof(telemetry_region_t));
+    shm_unlink(Telemetry->Name);
+    free(Telemetry->Visited);
+    Telemetry->Region = NULL;
+    Telemetry->Enabled = false;
+
+}
+
+bool TelemetryHasReader(telemetry_t * Telemetry) {
+
+    struct timespec Now;
+    int64_t Heartbeat = atomic_load_explicit(&Telemetry->Region->ReaderHeartbeat,
+            memory_order_relaxed);
+
+    clock_gettime(CLOCK_REALTIME, &Now);
+    return (int64_t) Now.tv_sec * 1000000000 + Now.tv_nsec - Heartbeat <
+            TELEMETRY_READER_TIMEOUT;
+
+}
+
+void PublishTelemetry(telemetry_t * Telemetry, const double SimulatedTime,
+        const int Collisions, const int NumberOfClusters,
+        const double HullArea) {
+
+    int i;
+    telemetry_region_t *Region = Telemetry->Region;
+    const int64_t Now = ProfilerNow();
+    const uint64_t Index = atomic_load_explicit(&Region->NumberOfSamples,
+            memory_order_relaxed);
+    telemetry_sample_t *Sample = &Region->Ring[Index % TELEMETRY_RING_LENGTH];
+
+    /* Odd sequence number: the slot is being written */
+    atomic_store_explicit(&Sample->Sequence, 2 * Index + 1,
+            memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    Sample->Steps = Telemetry->Steps;
+    Sample->WallTime = (Now - Telemetry->StartTime) / 1e9;
+    Sample->SimulatedTime = SimulatedTime;
+    Sample->StepRate = (Telemetry->Steps - Telemetry->StepsOfLastSample) /
+            ((Now - Telemetry->TimeOfLastSample) / 1e9);
+    Sample->HullArea = HullArea / 10000.0;
+    Sample->Collisions = Collisions;
+    Sample->NumberOfClusters = NumberOfClusters;
+    for (i = 0; i < NUMBER_OF_PROFILE_STAGES; i++) {
+        Sample->StageTimes[i] = ProfiledTime((profile_stage_t) i) / 1e6;
+    }
+
+    atomic_store_explicit(&Sample->Sequence, 2 * Index + 2,
+            memory_order_release);
+    atomic_store_explicit(&Region->NumberOfSamples, Index + 1,
+            memory_order_release);
+
+    Telemetry->StepsOfLastSample = Telemetry->Steps;
+    Telemetry->TimeOfLastSample = Now;
+
+}
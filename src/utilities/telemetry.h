@@ -0,0 +1,131 @@
+//MIT License
+//Copyright (c) 2018 Eotvos Lorand University, Budapest
+
+/* vim:set ts=4 sw=4 sts=4 et: */
+
+/*
+ * Live telemetry of headless runs ("-telemetry" option).
+ * Samples of the state of the run (step rate, simulated time, collisions,
+ * clusters, hull area and the times of the stages) are written a few times
+ * per second into a ring in POSIX shared memory ("/robotsim_PID", i.e.
+ * /dev/shm/robotsim_PID on Linux), which is read by tools/telemetry_monitor.py.
+ *
+ * Publishing never waits: every slot of the ring is guarded by a sequence
+ * number (odd while it is written), readers retry if it has changed while
+ * they were copying. Readers write the time of their last read into the
+ * header; the number of clusters (which costs O(N^2)) is counted only if a
+ * reader has been active recently, otherwise it is published as -1.
+ *
+ * The layout is fixed (little-endian, no padding): header, then
+ * "RingLength" samples of "SampleSize" bytes from offset "HeaderSize".
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "profiler.h"
+
+/* "ROBOTEL1" */
+#define TELEMETRY_MAGIC 0x314c45544f424f52ULL
+#define TELEMETRY_VERSION 1
+#define TELEMETRY_RING_LENGTH 64
+#define TELEMETRY_STAGE_NAME_LENGTH 32
+
+/* Time between two samples (ns) */
+#define TELEMETRY_INTERVAL 250000000LL
+/* A reader is active if it has read in this time (ns) */
+#define TELEMETRY_READER_TIMEOUT 3000000000LL
+
+typedef struct {
+
+    /* 2 * index + 2 of the sample when it is complete, odd while it is written */
+    _Atomic uint64_t Sequence;
+    int64_t Steps;
+    /* Wall clock time since the start (s) and simulated time (s) */
+    double WallTime;
+    double SimulatedTime;
+    /* Steps per second since the previous sample */
+    double StepRate;
+    /* Area of the convex hull (m^2) */
+    double HullArea;
+    int32_t Collisions;
+    /* -1 if it has not been counted (no active reader) */
+    int32_t NumberOfClusters;
+    /* Time spent in each stage since the start (ms, zero without "-profile") */
+    double StageTimes[NUMBER_OF_PROFILE_STAGES];
+
+} telemetry_sample_t;
+
+typedef struct {
+
+    uint64_t Magic;
+    uint32_t Version;
+    uint32_t HeaderSize;
+    uint32_t SampleSize;
+    uint32_t RingLength;
+    int32_t Pid;
+    int32_t NumberOfAgents;
+    int32_t NumberOfStages;
+    int32_t ProfilerEnabled;
+    /* Length of the measurement and the time step (s) */
+    double Length;
+    double DeltaT;
+    char StageNames[NUMBER_OF_PROFILE_STAGES][TELEMETRY_STAGE_NAME_LENGTH];
+
+    /* Number of published samples (the last one is at index - 1) */
+    _Atomic uint64_t NumberOfSamples;
+    /* Time of the last read of a reader (CLOCK_REALTIME, ns) */
+    _Atomic int64_t ReaderHeartbeat;
+
+    telemetry_sample_t Ring[TELEMETRY_RING_LENGTH];
+
+} telemetry_region_t;
+
+typedef struct {
+
+    bool Enabled;
+    char Name[64];
+    telemetry_region_t *Region;
+
+    /* Steps since the start, and the steps and the time of the last sample */
+    int64_t Steps;
+    int64_t StepsOfLastSample;
+    int64_t TimeOfLastSample;
+    int64_t StartTime;
+
+    /* Scratch array of counting clusters */
+    bool *Visited;
+
+} telemetry_t;
+
+/* Creating the shared memory of the run and switching on the telemetry
+ * (it stays switched off if the shared memory cannot be created)
+ */
+void StartTelemetry(telemetry_t * Telemetry, const int NumberOfAgents,
+        const double Length, const double DeltaT);
+
+/* Removing the shared memory */
+void StopTelemetry(telemetry_t * Telemetry);
+
+/* Counting a step. True if a sample should be published now. */
+static inline bool TelemetrySampleDue(telemetry_t * Telemetry) {
+
+    Telemetry->Steps++;
+    return ProfilerNow() - Telemetry->TimeOfLastSample >= TELEMETRY_INTERVAL;
+
+}
+
+/* True if a reader has read the telemetry recently */
+bool TelemetryHasReader(telemetry_t * Telemetry);
+
+/* Publishing a sample ("NumberOfClusters" is -1 if it has not been counted,
+ * "HullArea" is in cm^2)
+ */
+void PublishTelemetry(telemetry_t * Telemetry, const double SimulatedTime,
+        const int Collisions, const int NumberOfClusters,
+        const double HullArea);
+
+#endif
@@ -0,0 +1,377 @@
+//MIT License
+//Copyright (c) 2018 Eotvos Lorand University, Budapest
+
+/* vim:set ts=4 sw=4 sts=4 et: */
+
+/*
+ * Headless video output.
+ */
+
+#include <errno.h>
+#include <math.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "video_out.h"
+
+/* Colors of the frames (the defaults of the 2D visualization) */
+static const float BackgroundColor[3] = { 1.0, 1.0, 1.0 };
+static const float WallColor[3] = { 0.0, 0.0, 0.0 };
+static const float ObstacleColor[3] = { 1.0, 0.0, 0.0 };
+static const float AgentColor[3] = { 0.0, 0.0, 0.0 };
+static const float AgentInDangerColor[3] = { 1.0, 0.0, 0.0 };
+
+/* Radius of the body of the agents (cm, the same as in DrawCopter_2D) */
+#define VIDEO_BODY_RADIUS 40.0
+
+/* Transformation of real coordinates into pixels */
+static inline double PixelX(video_frame_t * Frame, raster_image_t * Image,
+        const double x) {
+    return (x - Frame->CenterX) / Frame->MapSizeXY * Image->Width * 0.5 +
+            Image->Width * 0.5;
+}
+
+static inline double PixelY(video_frame_t * Frame, raster_image_t * Image,
+        const double y) {
+    return Image->Height * 0.5 -
+            (y - Frame->CenterY) / Frame->MapSizeXY * Image->Height * 0.5;
+}
+
+/* Drawing the arena and the obstacles */
+static void DrawBackground(video_output_t * Video, video_frame_t * Frame) {
+
+    int i, j, k;
+    raster_image_t *Image = &Video->Background;
+    obstacles_t *Obstacles = Video->Obstacles;
+    const double Scale = Image->Width * 0.5 / Frame->MapSizeXY;
+    const double Wall = Frame->WallWidth * Scale;
+    double x1, y1, x2, y2;
+
+    ClearRasterImage(Image, BackgroundColor);
+
+    if (Frame->ArenaRadius > 0) {
+        if (0.0 == Frame->ArenaShape) {
+            FillRasterRing(Image, PixelX(Frame, Image, Frame->ArenaCenterX),
+                    PixelY(Frame, Image, Frame->ArenaCenterY),
+                    Frame->ArenaRadius * Scale - Wall,
+                    Frame->ArenaRadius * Scale, WallColor);
+        } else {
+            /* Walls inside the square of side 2 * radius */
+            const double Half = Frame->ArenaRadius - Frame->WallWidth / 2.0;
+            const double Corners[5][2] = { {1, 1}, {-1, 1}, {-1, -1}, {1, -1},
+            {1, 1}
+            };
+            for (k = 0; k < 4; k++) {
+                DrawRasterLine(Image,
+                        PixelX(Frame, Image,
+                                Frame->ArenaCenterX + Half * Corners[k][0]),
+                        PixelY(Frame, Image,
+                                Frame->ArenaCenterY + Half * Corners[k][1]),
+                        PixelX(Frame, Image,
+                                Frame->ArenaCenterX + Half * Corners[k + 1][0]),
+                        PixelY(Frame, Image,
+                                Frame->ArenaCenterY + Half * Corners[k + 1][1]),
+                        Wall, WallColor);
+            }
+        }
+    }
+
+    for (i = 0; i < Obstacles->o_count; i++) {
+        for (j = 0; j < Obstacles->o[i].p_count; j++) {
+            k = (j + 1) % Obstacles->o[i].p_count;
+            x1 = PixelX(Frame, Image, Obstacles->o[i].p[j][0]);
+            y1 = PixelY(Frame, Image, Obstacles->o[i].p[j][1]);
+            x2 = PixelX(Frame, Image, Obstacles->o[i].p[k][0]);
+            y2 = PixelY(Frame, Image, Obstacles->o[i].p[k][1]);
+            DrawRasterLine(Image, x1, y1, x2, y2, Wall, ObstacleColor);
+        }
+    }
+
+    Video->BackgroundScene = *Frame;
+    Video->HasBackground = true;
+
+}
+
+/* Drawing a frame into "Video->Image" */
+static void DrawVideoFrame(video_output_t * Video, video_frame_t * Frame) {
+
+    int i;
+    double x, y;
+    raster_image_t *Image = &Video->Image;
+    const double Scale = Image->Width * 0.5 / Frame->MapSizeXY;
+    video_frame_t *Drawn = &Video->BackgroundScene;
+
+    if (false == Video->HasBackground
+            || Drawn->ArenaShape != Frame->ArenaShape
+            || Drawn->ArenaCenterX != Frame->ArenaCenterX
+            || Drawn->ArenaCenterY != Frame->ArenaCenterY
+            || Drawn->ArenaRadius != Frame->ArenaRadius
+            || Drawn->WallWidth != Frame->WallWidth
+            || Drawn->CenterX != Frame->CenterX
+            || Drawn->CenterY != Frame->CenterY
+            || Drawn->MapSizeXY != Frame->MapSizeXY) {
+        DrawBackground(Video, Frame);
+    }
+    CopyRasterImage(Image, &Video->Background);
+
+    /* Agents: the circle of the dangerous zone and the body (at least a few pixels) */
+    for (i = 0; i < Frame->NumberOfAgents; i++) {
+        x = PixelX(Frame, Image, Frame->Coordinates[2 * i]);
+        y = PixelY(Frame, Image, Frame->Coordinates[2 * i + 1]);
+        const float *color = (Frame->AgentsInDanger[i] ?
+                AgentInDangerColor : AgentColor);
+        if (Video->Radius * 0.5 * Scale > 4.0) {
+            FillRasterRing(Image, x, y, Video->Radius * 0.5 * Scale - 1.0,
+                    Video->Radius * 0.5 * Scale, color);
+        }
+        FillRasterDisc(Image, x, y, fmax(VIDEO_BODY_RADIUS * Scale, 2.5),
+                color);
+    }
+
+}
+
+/* Writing "Video->Image" into the output, false (with the error reported)
+ * if it failed */
+static bool WriteVideoFrame(video_output_t * Video) {
+
+    FILE *f;
+    char FileName[600];
+    raster_image_t *Image = &Video->Image;
+    const size_t Size = (size_t) Image->Width * Image->Height * 3;
+    const int Chunk = Video->NumberOfWrittenFrames / VIDEO_FRAMES_PER_CHUNK;
+    bool Written;
+
+    if (Video->Pipe != NULL) {
+        if (fwrite(Image->Pixels, 1, Size, Video->Pipe) != Size) {
+            fprintf(stderr, "Video output: writing into the pipe failed (%s), "
+                    "no more frames are written!\n", strerror(errno));
+            return false;
+        }
+    } else {
+        /* New directory at the start of every chunk */
+        if (Video->NumberOfWrittenFrames % VIDEO_FRAMES_PER_CHUNK == 0) {
+            sprintf(FileName, "%s/chunk_%04d", Video->Directory, Chunk);
+            if (mkdir(FileName, 0700) != 0 && errno != EEXIST) {
+                fprintf(stderr, "Video output: cannot create %s (%s), "
+                        "no more frames are written!\n", FileName,
+                        strerror(errno));
+                return false;
+            }
+        }
+        sprintf(FileName, "%s/chunk_%04d/frame_%06d.ppm", Video->Directory,
+                Chunk, Video->NumberOfWrittenFrames);
+        f = fopen(FileName, "wb");
+        if (f == NULL) {
+            fprintf(stderr, "Video output: cannot open %s (%s), "
+                    "no more frames are written!\n", FileName,
+                    strerror(errno));
+            return false;
+        }
+        /* Buffered errors (e.g. of a full disk) are reported by fclose */
+        Written = (fprintf(f, "P6\n%d %d\n255\n", Image->Width,
+                        Image->Height) > 0
+                && fwrite(Image->Pixels, 1, Size, f) == Size);
+        if (fclose(f) != 0) {
+            Written = false;
+        }
+        if (false == Written) {
+            fprintf(stderr, "Video output: writing %s failed (%s), "
+                    "no more frames are written!\n", FileName,
+                    strerror(errno));
+            remove(FileName);
+            return false;
+        }
+    }
+    Video->NumberOfWrittenFrames++;
+
+    return true;
+
+}
+
+/* Writer thread: drawing and writing the queued frames in order */
+static void *VideoWriterThread(void *Arg) {
+
+    video_output_t *Video = (video_output_t *) Arg;
+    video_frame_t *Frame;
+    bool Written;
+
+    for (;;) {
+
+        pthread_mutex_lock(&Video->Lock);
+        while (Video->NumberOfQueuedFrames == 0 && false == Video->Finished) {
+            pthread_cond_wait(&Video->FrameQueued, &Video->Lock);
+        }
+        if (Video->NumberOfQueuedFrames == 0) {
+            pthread_mutex_unlock(&Video->Lock);
+            break;
+        }
+        Frame = &Video->Frames[Video->First];
+        pthread_mutex_unlock(&Video->Lock);
+
+        /* The frame is not touched by the simulation until it is released
+         * (after a failure the frames queued meanwhile are dropped) */
+        Written = false;
+        if (false == Video->Failed) {
+            DrawVideoFrame(Video, Frame);
+            Written = WriteVideoFrame(Video);
+        }
+
+        pthread_mutex_lock(&Video->Lock);
+        if (false == Written) {
+            Video->Failed = true;
+        }
+        Video->First = (Video->First + 1) % VIDEO_QUEUE_LENGTH;
+        Video->NumberOfQueuedFrames--;
+        pthread_cond_signal(&Video->FrameWritten);
+        pthread_mutex_unlock(&Video->Lock);
+
+    }
+
+    return NULL;
+
+}
+
+void StartVideoOutput(video_output_t * Video, const char *Target,
+        const int Resolution, const int NumberOfAgents, const double Radius,
+        obstacles_t * Obstacles) {
+
+    int i;
+
+    Video->Radius = Radius;
+    Video->Obstacles = Obstacles;
+    Video->Pipe = NULL;
+    Video->Directory[0] = '\0';
+    Video->NumberOfWrittenFrames = 0;
+    Video->Failed = false;
+
+    if (Target[0] == '|') {
+        /* A closed pipe is reported by fwrite instead of killing the process */
+        signal(SIGPIPE, SIG_IGN);
+        Video->Pipe = popen(Target + 1, "w");
+        if (Video->Pipe == NULL) {
+            fprintf(stderr, "Video output: cannot start \"%s\"!\n", Target + 1);
+            exit(-1);
+        }
+    } else {
+        strncpy(Video->Directory, Target, sizeof(Video->Directory) - 1);
+        Video->Directory[sizeof(Video->Directory) - 1] = '\0';
+        if (mkdir(Video->Directory, 0700) != 0 && errno != EEXIST) {
+            fprintf(stderr, "Video output: cannot create %s!\n",
+                    Video->Directory);
+            exit(-1);
+        }
+    }
+
+    AllocateRasterImage(&Video->Image, Resolution, Resolution);
+    AllocateRasterImage(&Video->Background, Resolution, Resolution);
+    Video->HasBackground = false;
+
+    for (i = 0; i < VIDEO_QUEUE_LENGTH; i++) {
+        Video->Frames[i].NumberOfAgents = NumberOfAgents;
+        Video->Frames[i].Coordinates =
+                (float *) malloc(2 * NumberOfAgents * sizeof(float));
+        Video->Frames[i].AgentsInDanger = BooleanData(NumberOfAgents);
+        if (!Video->Frames[i].Coordinates) {
+            fprintf(stderr, "Video frame allocation error!\n");
+            exit(-1);
+        }
+    }
+    Video->First = 0;
+    Video->NumberOfQueuedFrames = 0;
+    Video->Finished = false;
+    pthread_mutex_init(&Video->Lock, NULL);
+    pthread_cond_init(&Video->FrameQueued, NULL);
+    pthread_cond_init(&Video->FrameWritten, NULL);
+
+    if (pthread_create(&Video->Thread, NULL, VideoWriterThread, Video) != 0) {
+        fprintf(stderr, "Video writer thread creation error!\n");
+        exit(-1);
+    }
+
+}
+
+void StopVideoOutput(video_output_t * Video) {
+
+    int i;
+    int ExitStatus;
+
+    pthread_mutex_lock(&Video->Lock);
+    Video->Finished = true;
+    pthread_cond_signal(&Video->FrameQueued);
+    pthread_mutex_unlock(&Video->Lock);
+    pthread_join(Video->Thread, NULL);
+
+    if (Video->Pipe != NULL) {
+        /* Frames still in the buffer of the pipe can fail here as well */
+        ExitStatus = pclose(Video->Pipe);
+        if (ExitStatus != 0 && false == Video->Failed) {
+            fprintf(stderr, "Video output: the command of the pipe failed "
+                    "(status %d), the video may be incomplete!\n", ExitStatus);
+            Video->Failed = true;
+        }
+        Video->Pipe = NULL;
+    }
+
+    pthread_mutex_destroy(&Video->Lock);
+    pthread_cond_destroy(&Video->FrameQueued);
+    pthread_cond_destroy(&Video->FrameWritten);
+    for (i = 0; i < VIDEO_QUEUE_LENGTH; i++) {
+        free(Video->Frames[i].Coordinates);
+        free(Video->Frames[i].AgentsInDanger);
+    }
+    freeRasterImage(&Video->Image);
+    freeRasterImage(&Video->Background);
+
+}
+
+bool IsVideoRecording(video_output_t * Video) {
+
+    bool Recording;
+
+    pthread_mutex_lock(&Video->Lock);
+    Recording = (false == Video->Failed);
+    pthread_mutex_unlock(&Video->Lock);
+
+    return Recording;
+
+}
+
+video_frame_t *VideoFrameToFill(video_output_t * Video) {
+
+    video_frame_t *Frame;
+
+    pthread_mutex_lock(&Video->Lock);
+    while (Video->NumberOfQueuedFrames == VIDEO_QUEUE_LENGTH) {
+        pthread_cond_wait(&Video->FrameWritten, &Video->Lock);
+    }
+    Frame = &Video->Frames[(Video->First + Video->NumberOfQueuedFrames) %
+            VIDEO_QUEUE_LENGTH];
+    pthread_mutex_unlock(&Video->Lock);
+
+    return Frame;
+
+}
+
+void FillVideoFrame(video_frame_t * Frame, phase_t * Phase,
+        bool *AgentsInDanger) {
+
+    int i;
+
+    for (i = 0; i < Frame->NumberOfAgents; i++) {
+        Frame->Coordinates[2 * i] = Phase->Coordinates[i][0];
+        Frame->Coordinates[2 * i + 1] = Phase->Coordinates[i][1];
+    }
+    memcpy(Frame->AgentsInDanger, AgentsInDanger,
+            Frame->NumberOfAgents * sizeof(bool));
+
+}
+
+void QueueVideoFrame(video_output_t * Video) {
+
+    pthread_mutex_lock(&Video->Lock);
+    Video->NumberOfQueuedFrames++;
+    pthread_cond_signal(&Video->FrameQueued);
+    pthread_mutex_unlock(&Video->Lock);
+
+}
@@ -0,0 +1,115 @@
+//MIT License
+//Copyright (c) 2018 Eotvos Lorand University, Budapest
+
+/* vim:set ts=4 sw=4 sts=4 et: */
+
+/*
+ * Headless video output ("-video" option).
+ * The 2D scene (arena, obstacles and agents) is drawn by software
+ * rasterisation, so it works without a display or OpenGL (e.g. in "-novis"
+ * runs on a cluster). The simulation only copies the positions into a queue
+ * of frames, a writer thread draws them and streams them
+ * - as raw RGB24 frames into the standard input of a command
+ *   (target "|command", e.g. "|ffmpeg -f rawvideo -pix_fmt rgb24 -s 750x750
+ *   -r 30 -i - video.mp4", the frames of robotsim_main have the resolution of
+ *   the visualization, which is printed when the output starts), or
+ * - as a sequence of binary PPM images in chunks of VIDEO_FRAMES_PER_CHUNK
+ *   frames (target "directory", into "directory/chunk_N/frame_M.ppm").
+ * The simulation waits only if the writer is more than VIDEO_QUEUE_LENGTH
+ * frames behind.
+ */
+
+#ifndef VIDEO_OUT_H
+#define VIDEO_OUT_H
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <pthread.h>
+#include "dynamics_utils.h"
+#include "raster.h"
+#include "obstacles.h"
+
+#define VIDEO_QUEUE_LENGTH 8
+#define VIDEO_FRAMES_PER_CHUNK 1000
+/* Frames per second of simulated time if "-videoevery" is not given */
+#define VIDEO_FRAME_RATE 30.0
+
+/* Scene of one frame (real coordinates, cm) */
+typedef struct {
+
+    int NumberOfAgents;
+    /* x, y of the agents */
+    float *Coordinates;
+    bool *AgentsInDanger;
+
+    /* Arena (shape 0 is a circle, otherwise a square) and the width of its wall */
+    double ArenaShape;
+    double ArenaCenterX;
+    double ArenaCenterY;
+    double ArenaRadius;
+    double WallWidth;
+
+    /* View: center and half size of the displayed area */
+    double CenterX;
+    double CenterY;
+    double MapSizeXY;
+
+} video_frame_t;
+
+typedef struct {
+
+    /* Radius of the dangerous zone of the agents (cm) and the obstacles
+     * (they are not changed during the simulation) */
+    double Radius;
+    obstacles_t *Obstacles;
+
+    /* Output: pipe of the command or directory of the images */
+    FILE *Pipe;
+    char Directory[512];
+    int NumberOfWrittenFrames;
+    bool Failed;
+
+    /* Image of the frame and of the static objects it starts from
+     * (redrawn if the arena or the view changes) */
+    raster_image_t Image;
+    raster_image_t Background;
+    video_frame_t BackgroundScene;
+    bool HasBackground;
+
+    /* Queue of the frames waiting for the writer thread */
+    video_frame_t Frames[VIDEO_QUEUE_LENGTH];
+    int First;
+    int NumberOfQueuedFrames;
+    bool Finished;
+    pthread_mutex_t Lock;
+    pthread_cond_t FrameQueued;
+    pthread_cond_t FrameWritten;
+    pthread_t Thread;
+
+} video_output_t;
+
+/* Opening "Target" (see above) and starting the writer thread.
+ * Frames are "Resolution x Resolution" pixels.
+ */
+void StartVideoOutput(video_output_t * Video, const char *Target,
+        const int Resolution, const int NumberOfAgents, const double Radius,
+        obstacles_t * Obstacles);
+
+/* Writing the queued frames, closing the output and freeing the buffers
+ * ("Failed" tells if the video is incomplete) */
+void StopVideoOutput(video_output_t * Video);
+
+/* False after a write error (reported on stderr): no more frames are
+ * written, the simulation should stop queueing them */
+bool IsVideoRecording(video_output_t * Video);
+
+/* Simulation side: the next free frame of the queue (it waits if the queue is
+ * full), filling it with the agents of "Phase", and queueing it. The arena and
+ * the view are set by the caller between these calls.
+ */
+video_frame_t *VideoFrameToFill(video_output_t * Video);
+void FillVideoFrame(video_frame_t * Frame, phase_t * Phase,
+        bool *AgentsInDanger);
+void QueueVideoFrame(video_output_t * Video);
+
+#endif
@@ -39,6 +39,8 @@ typedef struct {
     bool DisplayAgentLabels;
     /* Display Communication network */
     bool DisplayCommNetwork;
+    /* Display the details of the network (in-range pairs, obstacle crossings) */
+    bool DisplayNetworkDetails;
     /* Display Convex Hull */
     bool DisplayHull;
     /* Length of displayed tail */
@@ -0,0 +1,360 @@
+//MIT License
+//Copyright (c) 2018 Eotvos Lorand University, Budapest
+
+/* vim:set ts=4 sw=4 sts=4 et: */
+
+/* Batched drawing in 2D visualization
+ */
+
+/* Buffer objects and point sprites are declared by glext.h */
+#define GL_GLEXT_PROTOTYPES
+#include "batch_2d.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Sprite texture of the copters, the ratio of the dangerous zone and the
+ * half width of its circle (texels) it was made for */
+static GLuint CopterSpriteTexture = 0;
+static double CopterSpriteZoneRatio = -1.0;
+static double CopterSpriteLineWidth = -1.0;
+
+void AllocateVertexBatch(vertex_batch_t * Batch, const GLenum Mode,
+        const int Capacity) {
+
+    Batch->Mode = Mode;
+    Batch->NumberOfVertices = 0;
+    Batch->Capacity = (Capacity > 0 ? Capacity : 1);
+    Batch->Vertices =
+            (batch_vertex_t *) malloc(Batch->Capacity * sizeof(batch_vertex_t));
+    if (!Batch->Vertices) {
+        fprintf(stderr, "Vertex batch allocation error!\n");
+        exit(-1);
+    }
+    Batch->Buffer = 0;
+    Batch->NumberOfUploadedVertices = 0;
+
+}
+
+void freeVertexBatch(vertex_batch_t * Batch) {
+
+    if (Batch->Buffer != 0) {
+        glDeleteBuffers(1, &Batch->Buffer);
+        Batch->Buffer = 0;
+    }
+    free(Batch->Vertices);
+    Batch->Vertices = NULL;
+    Batch->NumberOfVertices = 0;
+    Batch->Capacity = 0;
+
+}
+
+void ClearVertexBatch(vertex_batch_t * Batch) {
+    Batch->NumberOfVertices = 0;
+}
+
+void AddVertexToBatch(vertex_batch_t * Batch, const double x, const double y,
+        const float *color) {
+
+    batch_vertex_t *Vertex;
+
+    if (Batch->NumberOfVertices == Batch->Capacity) {
+        Batch->Capacity *= 2;
+        Batch->Vertices = (batch_vertex_t *) realloc(Batch->Vertices,
+                Batch->Capacity * sizeof(batch_vertex_t));
+        if (!Batch->Vertices) {
+            fprintf(stderr, "Vertex batch allocation error!\n");
+            exit(-1);
+        }
+    }
+
+    Vertex = &Batch->Vertices[Batch->NumberOfVertices++];
+    Vertex->x = x;
+    Vertex->y = y;
+    Vertex->r = color[0];
+    Vertex->g = color[1];
+    Vertex->b = color[2];
+
+}
+
+/* The same corners as in DrawShape, as two triangles */
+void AddShapeToBatch(vertex_batch_t * Batch, const double CenterX,
+        const double CenterY, const double width, const double height,
+        const double angle, const float *color) {
+
+    const double c = cos(angle);
+    const double s = sin(angle);
+    double Corners[4][2];
+    int Order[6] = { 0, 1, 2, 0, 2, 3 };
+    int i;
+
+    Corners[0][0] = CenterX + c * width / 2.0 + s * height / 2.0;
+    Corners[0][1] = CenterY - s * width / 2.0 + c * height / 2.0;
+    Corners[1][0] = CenterX - c * width / 2.0 + s * height / 2.0;
+    Corners[1][1] = CenterY + s * width / 2.0 + c * height / 2.0;
+    Corners[2][0] = CenterX - c * width / 2.0 - s * height / 2.0;
+    Corners[2][1] = CenterY + s * width / 2.0 - c * height / 2.0;
+    Corners[3][0] = CenterX + c * width / 2.0 - s * height / 2.0;
+    Corners[3][1] = CenterY - s * width / 2.0 - c * height / 2.0;
+
+    for (i = 0; i < 6; i++) {
+        AddVertexToBatch(Batch, Corners[Order[i]][0], Corners[Order[i]][1],
+                color);
+    }
+
+}
+
+void AddLineToBatch(vertex_batch_t * Batch, const double x1, const double y1,
+        const double x2, const double y2, const double width,
+        const float *color) {
+
+    /* Line is a thin shape */
+    AddShapeToBatch(Batch, 0.5 * (x1 + x2), 0.5 * (y1 + y2), width,
+            sqrt((x2 - x1) * (x2 - x1) + (y2 - y1) * (y2 - y1)),
+            atan2(x2 - x1, y2 - y1), color);
+
+}
+
+void AddTriangleToBatch(vertex_batch_t * Batch, const double CenterX,
+        const double CenterY, const double LengthOfEdge, const double Angle,
+        const float *color) {
+
+    const double m = LengthOfEdge / (2 * sqrt(3));
+    const double b = 2.0 * m;
+
+    AddVertexToBatch(Batch,
+            CenterX - cos(Angle) * m + sin(Angle) * LengthOfEdge / 2,
+            CenterY + sin(Angle) * m + cos(Angle) * LengthOfEdge / 2, color);
+    AddVertexToBatch(Batch, CenterX + cos(Angle) * b,
+            CenterY - sin(Angle) * b, color);
+    AddVertexToBatch(Batch,
+            CenterX - cos(Angle) * m - sin(Angle) * LengthOfEdge / 2,
+            CenterY + sin(Angle) * b - cos(Angle) * LengthOfEdge / 2, color);
+
+}
+
+void AddArrowToBatch(vertex_batch_t * Batch, const double x, const double y,
+        const double Length, const double angle, const float *color) {
+
+    /* An arrow is a shape with a triangle on one of its end */
+    AddTriangleToBatch(Batch, x + cos(angle) * Length / 2.0,
+            y - sin(angle) * Length / 2.0, Length, angle, color);
+    AddShapeToBatch(Batch, x, y, Length, Length / 4.0, angle, color);
+
+}
+
+/* Empty circle as DrawCircle, into a batch of lines */
+void AddCircleToBatch(vertex_batch_t * Batch, const double Centerx,
+        const double Centery, const double radius, const float *color) {
+
+    int i;
+    const int Segments = 64;
+
+    for (i = 0; i < Segments; i++) {
+        AddVertexToBatch(Batch, Centerx + radius * cos(2.0 * M_PI * i / Segments),
+                Centery + radius * sin(2.0 * M_PI * i / Segments), color);
+        AddVertexToBatch(Batch,
+                Centerx + radius * cos(2.0 * M_PI * (i + 1) / Segments),
+                Centery + radius * sin(2.0 * M_PI * (i + 1) / Segments), color);
+    }
+
+}
+
+void AddFullCircleToBatch(vertex_batch_t * Batch, const double Centerx,
+        const double Centery, const double radius, const float *color) {
+
+    int i;
+    const int Segments = 32;
+
+    /* Fan of triangles */
+    for (i = 0; i < Segments; i++) {
+        AddVertexToBatch(Batch, Centerx, Centery, color);
+        AddVertexToBatch(Batch, Centerx + radius * cos(2.0 * M_PI * i / Segments),
+                Centery + radius * sin(2.0 * M_PI * i / Segments), color);
+        AddVertexToBatch(Batch,
+                Centerx + radius * cos(2.0 * M_PI * (i + 1) / Segments),
+                Centery + radius * sin(2.0 * M_PI * (i + 1) / Segments), color);
+    }
+
+}
+
+/* The same shapes as in DrawThickEdgedCircle */
+void AddThickEdgedCircleToBatch(vertex_batch_t * Batch, const double Centerx,
+        const double Centery, const double radius,
+        const double EdgeThickness, const float *color) {
+
+    double i;
+
+    for (i = 0; i < 2 * M_PI; i += 0.1) {
+        AddShapeToBatch(Batch, Centerx + radius * cos(i),
+                -(-Centery + radius * sin(i)), EdgeThickness, 0.1 * radius, i,
+                color);
+    }
+
+}
+
+/* The same objects as in DrawThickEdgedPolygon ("Vertices" are {x, y, z} triples) */
+void AddThickEdgedPolygonToBatch(vertex_batch_t * Batch, const double *Vertices,
+        const int NumberOfVertices, const double EdgeThickness,
+        const float *color) {
+
+    int i;
+
+    for (i = 0; i < NumberOfVertices; i++) {
+        AddLineToBatch(Batch, Vertices[i * 3], Vertices[i * 3 + 1],
+                Vertices[((i + 1) % NumberOfVertices) * 3],
+                Vertices[((i + 1) % NumberOfVertices) * 3 + 1], EdgeThickness,
+                color);
+        AddFullCircleToBatch(Batch, Vertices[i * 3], Vertices[i * 3 + 1],
+                EdgeThickness / 2.0, color);
+    }
+
+}
+
+void UploadVertexBatch(vertex_batch_t * Batch, const GLenum Usage) {
+
+    if (Batch->Buffer == 0) {
+        glGenBuffers(1, &Batch->Buffer);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, Batch->Buffer);
+    /* A new store every time, the previous one may still be drawn */
+    glBufferData(GL_ARRAY_BUFFER,
+            Batch->NumberOfVertices * sizeof(batch_vertex_t), Batch->Vertices,
+            Usage);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    Batch->NumberOfUploadedVertices = Batch->NumberOfVertices;
+
+}
+
+/* Setting up the vertex arrays and the view of a batch */
+static void BeginBatch(vertex_batch_t * Batch, const double CenterX,
+        const double CenterY, const double MapSizexy) {
+
+    glPushMatrix();
+    glScaled(1.0 / MapSizexy, 1.0 / MapSizexy, 1.0);
+    glTranslated(-CenterX, -CenterY, 0.0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, Batch->Buffer);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(2, GL_FLOAT, sizeof(batch_vertex_t), (void *) 0);
+    glColorPointer(3, GL_FLOAT, sizeof(batch_vertex_t),
+            (void *) (2 * sizeof(GLfloat)));
+
+}
+
+static void EndBatch() {
+
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glPopMatrix();
+
+}
+
+void DrawVertexBatch(vertex_batch_t * Batch, const double CenterX,
+        const double CenterY, const double MapSizexy) {
+
+    if (Batch->Buffer == 0 || Batch->NumberOfUploadedVertices == 0) {
+        return;
+    }
+
+    BeginBatch(Batch, CenterX, CenterY, MapSizexy);
+    glDrawArrays(Batch->Mode, 0, Batch->NumberOfUploadedVertices);
+    EndBatch();
+
+}
+
+/* White texture of a filled body and a thin circle around it
+ * ("ZoneRatio" is the radius of the circle / radius of the sprite,
+ * "LineWidth" is the half width of the circle in texels),
+ * its color is given by the vertices
+ */
+static void CreateCopterSpriteTexture(const double BodyRatio,
+        const double ZoneRatio, const double LineWidth) {
+
+    static GLubyte Texels[COPTER_SPRITE_TEXTURE_SIZE][COPTER_SPRITE_TEXTURE_SIZE][2];
+    const double Half = 0.5 * COPTER_SPRITE_TEXTURE_SIZE;
+    double r;
+    int i, j;
+
+    for (i = 0; i < COPTER_SPRITE_TEXTURE_SIZE; i++) {
+        for (j = 0; j < COPTER_SPRITE_TEXTURE_SIZE; j++) {
+            r = hypot(i + 0.5 - Half, j + 0.5 - Half);
+            Texels[i][j][0] = 255;
+            Texels[i][j][1] = (r <= BodyRatio * Half
+                    || fabs(r - ZoneRatio * Half) <= LineWidth ? 255 : 0);
+        }
+    }
+
+    if (CopterSpriteTexture == 0) {
+        glGenTextures(1, &CopterSpriteTexture);
+    }
+    glBindTexture(GL_TEXTURE_2D, CopterSpriteTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE_ALPHA,
+            COPTER_SPRITE_TEXTURE_SIZE, COPTER_SPRITE_TEXTURE_SIZE, 0,
+            GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE, Texels);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+}
+
+bool DrawCopterSprites(vertex_batch_t * Batch, const double CenterX,
+        const double CenterY, const double MapSizexy, const double Radius) {
+
+    GLfloat PointSizeRange[2];
+    GLint Viewport[4];
+    /* Radius of the sprites in real coordinates */
+    const double SpriteRadius = fmax(COPTER_BODY_RADIUS, Radius / 2.0) * 1.02;
+    double PointSize, LineWidth;
+
+    if (Batch->Buffer == 0 || Batch->NumberOfUploadedVertices == 0) {
+        return true;
+    }
+
+    /* Size of the sprites in pixels (the map is 2 * "MapSizexy" wide) */
+    glGetIntegerv(GL_VIEWPORT, Viewport);
+    glGetFloatv(GL_ALIASED_POINT_SIZE_RANGE, PointSizeRange);
+    PointSize = 2.0 * SpriteRadius / MapSizexy * 0.5 * Viewport[2];
+    if (PointSize > PointSizeRange[1]) {
+        return false;
+    }
+
+    /* The circle of the zone should be about one pixel wide on the screen,
+     * the texture is made again if the size of the sprites changes a lot */
+    LineWidth = fmax(1.0, 0.75 * COPTER_SPRITE_TEXTURE_SIZE / fmax(PointSize, 1.0));
+    if (CopterSpriteTexture == 0
+            || fabs(CopterSpriteZoneRatio - Radius / 2.0 / SpriteRadius) > 1e-6
+            || fabs(CopterSpriteLineWidth - LineWidth) > 0.25 * LineWidth) {
+        CopterSpriteZoneRatio = Radius / 2.0 / SpriteRadius;
+        CopterSpriteLineWidth = LineWidth;
+        CreateCopterSpriteTexture(COPTER_BODY_RADIUS / SpriteRadius,
+                CopterSpriteZoneRatio, CopterSpriteLineWidth);
+    }
+
+    glEnable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, CopterSpriteTexture);
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+    glEnable(GL_POINT_SPRITE);
+    glTexEnvi(GL_POINT_SPRITE, GL_COORD_REPLACE, GL_TRUE);
+    glEnable(GL_ALPHA_TEST);
+    glAlphaFunc(GL_GREATER, 0.5f);
+    glPointSize(fmax(PointSize, 1.0));
+
+    BeginBatch(Batch, CenterX, CenterY, MapSizexy);
+    glDrawArrays(GL_POINTS, 0, Batch->NumberOfUploadedVertices);
+    EndBatch();
+
+    glPointSize(1.0);
+    glDisable(GL_ALPHA_TEST);
+    glTexEnvi(GL_POINT_SPRITE, GL_COORD_REPLACE, GL_FALSE);
+    glDisable(GL_POINT_SPRITE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDisable(GL_TEXTURE_2D);
+
+    return true;
+
+}
@@ -0,0 +1,105 @@
+//MIT License
+//Copyright (c) 2018 Eotvos Lorand University, Budapest
+
+/* vim:set ts=4 sw=4 sts=4 et: */
+
+/* Batched drawing in 2D visualization.
+ * Objects are collected into vertex batches in real coordinates (cm) and
+ * every batch is drawn with one call from a vertex buffer object. Static
+ * objects (arena, obstacles) are uploaded once, the batches of the agents
+ * are refilled and uploaded once per frame. The view (center and size of the
+ * map) is applied as a transformation, so moving or zooming the map does not
+ * change the batches.
+ */
+
+#ifndef BATCH_2D_H
+#define BATCH_2D_H
+
+#include <stdbool.h>
+#include "objects_2d.h"
+
+/* Size of the texture of the copter sprites (texels) */
+#define COPTER_SPRITE_TEXTURE_SIZE 256
+/* Radius of the body of a copter (cm, the same as in DrawCopter_2D) */
+#define COPTER_BODY_RADIUS 40.0
+
+/* Vertex of a batch: position in real coordinates and color */
+typedef struct {
+    GLfloat x, y;
+    GLfloat r, g, b;
+} batch_vertex_t;
+
+/* Growing array of vertices and its vertex buffer object */
+typedef struct {
+
+    /* GL_POINTS, GL_LINES or GL_TRIANGLES */
+    GLenum Mode;
+    batch_vertex_t *Vertices;
+    int NumberOfVertices;
+    int Capacity;
+
+    /* Buffer object (0 before the first upload) and the number of uploaded vertices */
+    GLuint Buffer;
+    int NumberOfUploadedVertices;
+
+} vertex_batch_t;
+
+/* Allocating and freeing a batch (the buffer object belongs to the GL
+ * context of the window that uploaded it)
+ */
+void AllocateVertexBatch(vertex_batch_t * Batch, const GLenum Mode,
+        const int Capacity);
+void freeVertexBatch(vertex_batch_t * Batch);
+
+/* Removing every vertex (the uploaded buffer is kept until the next upload) */
+void ClearVertexBatch(vertex_batch_t * Batch);
+
+/* Adding objects to a batch, in real coordinates
+ * (shapes, triangles and arrows in the same way as in objects_2d.h)
+ */
+void AddVertexToBatch(vertex_batch_t * Batch, const double x, const double y,
+        const float *color);
+void AddShapeToBatch(vertex_batch_t * Batch, const double CenterX,
+        const double CenterY, const double width, const double height,
+        const double angle, const float *color);
+void AddLineToBatch(vertex_batch_t * Batch, const double x1, const double y1,
+        const double x2, const double y2, const double width,
+        const float *color);
+void AddTriangleToBatch(vertex_batch_t * Batch, const double CenterX,
+        const double CenterY, const double LengthOfEdge, const double Angle,
+        const float *color);
+void AddArrowToBatch(vertex_batch_t * Batch, const double x, const double y,
+        const double Length, const double angle, const float *color);
+void AddCircleToBatch(vertex_batch_t * Batch, const double Centerx,
+        const double Centery, const double radius, const float *color);
+void AddFullCircleToBatch(vertex_batch_t * Batch, const double Centerx,
+        const double Centery, const double radius, const float *color);
+void AddThickEdgedCircleToBatch(vertex_batch_t * Batch, const double Centerx,
+        const double Centery, const double radius,
+        const double EdgeThickness, const float *color);
+void AddThickEdgedPolygonToBatch(vertex_batch_t * Batch, const double *Vertices,
+        const int NumberOfVertices, const double EdgeThickness,
+        const float *color);
+
+/* Copying the vertices into the buffer object of the batch
+ * ("Usage" is GL_STATIC_DRAW for static objects, GL_STREAM_DRAW for the
+ * batches refilled in every frame)
+ */
+void UploadVertexBatch(vertex_batch_t * Batch, const GLenum Usage);
+
+/* Drawing the uploaded vertices with the view given by the center and the
+ * size of the map (real coordinates)
+ */
+void DrawVertexBatch(vertex_batch_t * Batch, const double CenterX,
+        const double CenterY, const double MapSizexy);
+
+/* Drawing the points of an uploaded GL_POINTS batch as copters (filled body
+ * and the circle of the dangerous zone with radius "Radius" / 2, like
+ * DrawCopter_2D) with point sprites.
+ * Returns false without drawing if the sprites would be larger than the
+ * largest point size of the GL implementation (zoomed in too much).
+ */
+bool DrawCopterSprites(vertex_batch_t * Batch, const double CenterX,
+        const double CenterY, const double MapSizexy, const double Radius);
+
+#endif
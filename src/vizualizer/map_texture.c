@@ -0,0 +1,158 @@
+//MIT License
+//Copyright (c) 2018 Eotvos Lorand University, Budapest
+
+/* vim:set ts=4 sw=4 sts=4 et: */
+
+/* Grid maps drawn as one texture
+ */
+
+#include "map_texture.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void AllocateMapTexture(map_texture_t * Map, const int Resolution) {
+
+    int i;
+
+    Map->Resolution = Resolution;
+    Map->Values = (float *) malloc((size_t) Resolution * Resolution *
+            sizeof(float));
+    Map->Pixels = (GLubyte *) calloc((size_t) Resolution * Resolution * 4,
+            sizeof(GLubyte));
+    if (!Map->Values || !Map->Pixels) {
+        fprintf(stderr, "Map texture allocation error!\n");
+        exit(-1);
+    }
+
+    /* No value is negative, so every cell is colored at the first update */
+    for (i = 0; i < Resolution * Resolution; i++) {
+        Map->Values[i] = -1.0f;
+    }
+    for (i = 0; i < 3; i++) {
+        Map->UnexploredColor[i] = -1.0f;
+        Map->ZeroColor[i] = -1.0f;
+        Map->OneColor[i] = -1.0f;
+    }
+    Map->FirstDirtyRow = Resolution;
+    Map->LastDirtyRow = -1;
+    Map->Texture = 0;
+
+}
+
+void freeMapTexture(map_texture_t * Map) {
+
+    if (Map->Texture != 0) {
+        glDeleteTextures(1, &Map->Texture);
+        Map->Texture = 0;
+    }
+    free(Map->Values);
+    free(Map->Pixels);
+    Map->Values = NULL;
+    Map->Pixels = NULL;
+
+}
+
+void UpdateMapTexture(map_texture_t * Map, const float *Values,
+        const float *UnexploredColor, const float *ZeroColor,
+        const float *OneColor) {
+
+    int i, j, k;
+    float Value;
+    GLubyte *Pixel;
+    const int Resolution = Map->Resolution;
+
+    /* New colors invalidate every cell */
+    if (memcmp(Map->UnexploredColor, UnexploredColor, 3 * sizeof(float)) != 0
+            || memcmp(Map->ZeroColor, ZeroColor, 3 * sizeof(float)) != 0
+            || memcmp(Map->OneColor, OneColor, 3 * sizeof(float)) != 0) {
+        memcpy(Map->UnexploredColor, UnexploredColor, 3 * sizeof(float));
+        memcpy(Map->ZeroColor, ZeroColor, 3 * sizeof(float));
+        memcpy(Map->OneColor, OneColor, 3 * sizeof(float));
+        for (i = 0; i < Resolution * Resolution; i++) {
+            Map->Values[i] = -1.0f;
+        }
+    }
+
+    for (i = 0; i < Resolution; i++) {
+        for (j = 0; j < Resolution; j++) {
+
+            Value = Values[i * Resolution + j];
+            if (Value == Map->Values[i * Resolution + j]) {
+                continue;
+            }
+            Map->Values[i * Resolution + j] = Value;
+
+            Pixel = Map->Pixels + 4 * ((size_t) i * Resolution + j);
+            if (Value > 0) {
+                if (Value > 1) {
+                    Value = 1;
+                }
+                for (k = 0; k < 3; k++) {
+                    Pixel[k] = (GLubyte) (255.0f * (ZeroColor[k] +
+                                    (OneColor[k] - ZeroColor[k]) * Value) + 0.5f);
+                }
+            } else {
+                for (k = 0; k < 3; k++) {
+                    Pixel[k] = (GLubyte) (255.0f * UnexploredColor[k] + 0.5f);
+                }
+            }
+            Pixel[3] = 255;
+
+            if (i < Map->FirstDirtyRow) {
+                Map->FirstDirtyRow = i;
+            }
+            if (i > Map->LastDirtyRow) {
+                Map->LastDirtyRow = i;
+            }
+
+        }
+    }
+
+}
+
+void DrawMapTexture(map_texture_t * Map) {
+
+    const int Resolution = Map->Resolution;
+
+    if (Map->Texture == 0) {
+        glGenTextures(1, &Map->Texture);
+        glBindTexture(GL_TEXTURE_2D, Map->Texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, Resolution, Resolution, 0,
+                GL_RGBA, GL_UNSIGNED_BYTE, Map->Pixels);
+    } else {
+        glBindTexture(GL_TEXTURE_2D, Map->Texture);
+        if (Map->FirstDirtyRow <= Map->LastDirtyRow) {
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, Map->FirstDirtyRow,
+                    Resolution, Map->LastDirtyRow - Map->FirstDirtyRow + 1,
+                    GL_RGBA, GL_UNSIGNED_BYTE,
+                    Map->Pixels + 4 * (size_t) Map->FirstDirtyRow * Resolution);
+        }
+    }
+    Map->FirstDirtyRow = Resolution;
+    Map->LastDirtyRow = -1;
+
+    /* Row 0 of the texture is the top of the map */
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    glEnable(GL_TEXTURE_2D);
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+    glBegin(GL_QUADS);
+    glTexCoord2f(0.0f, 1.0f);
+    glVertex2f(-1.0f, -1.0f);
+    glTexCoord2f(1.0f, 1.0f);
+    glVertex2f(1.0f, -1.0f);
+    glTexCoord2f(1.0f, 0.0f);
+    glVertex2f(1.0f, 1.0f);
+    glTexCoord2f(0.0f, 0.0f);
+    glVertex2f(-1.0f, 1.0f);
+    glEnd();
+    glDisable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+}
@@ -0,0 +1,57 @@
+//MIT License
+//Copyright (c) 2018 Eotvos Lorand University, Budapest
+
+/* vim:set ts=4 sw=4 sts=4 et: */
+
+/* Grid maps (e.g. the CBP map) drawn as one texture.
+ * The colors of the cells are kept in an RGBA buffer. When the map is
+ * updated, only the cells whose value has changed are recolored, and only
+ * the rows containing them are uploaded into the texture.
+ */
+
+#ifndef MAP_TEXTURE_H
+#define MAP_TEXTURE_H
+
+#include <GL/gl.h>
+
+typedef struct {
+
+    int Resolution;
+
+    /* Values of the cells in the buffer (row 0 is the top of the map) */
+    float *Values;
+    GLubyte *Pixels;
+
+    /* Colors the buffer was made with */
+    float UnexploredColor[3];
+    float ZeroColor[3];
+    float OneColor[3];
+
+    /* Rows changed since the last upload (none if First > Last) */
+    int FirstDirtyRow;
+    int LastDirtyRow;
+
+    /* Texture (0 before the first upload) */
+    GLuint Texture;
+
+} map_texture_t;
+
+/* Allocating and freeing a map of "Resolution x Resolution" cells
+ * (the texture belongs to the GL context of the window that drew it)
+ */
+void AllocateMapTexture(map_texture_t * Map, const int Resolution);
+void freeMapTexture(map_texture_t * Map);
+
+/* Updating the buffer from "Values" (Resolution x Resolution, row by row).
+ * Cells with a value of zero get "UnexploredColor", others are interpolated
+ * between "ZeroColor" and "OneColor" (values are clamped to 1).
+ * Every cell is recolored if the colors have changed.
+ */
+void UpdateMapTexture(map_texture_t * Map, const float *Values,
+        const float *UnexploredColor, const float *ZeroColor,
+        const float *OneColor);
+
+/* Uploading the changed rows and drawing the map onto the [-1, 1] square */
+void DrawMapTexture(map_texture_t * Map);
+
+#endif
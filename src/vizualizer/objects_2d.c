@@ -71,31 +71,20 @@ void DrawLine(double x1, double y1, double x2, double y2, double width,
 
 void DrawSquare(int Resolution) {
 
-    glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-
     double step = 2.0 / Resolution;
 
     glColor3f(1.0, 0.0, 0.0);
 
-    for (int i = -1; i < Resolution; i+=2) {
-
-        glBegin(GL_POLYGON);
-            glVertex2f(-1.0, -1.0 + step * i);
-            glVertex2f(+1.0, -1.0 + step * i);
-            glVertex2f(+1.0, -1.0 + step * (1 + i));
-            glVertex2f(-1.0, -1.0 + step * (1 + i));
-        glEnd();
+    /* Lines of the grid in one pass */
+    glBegin(GL_LINES);
+    for (int i = 0; i <= Resolution; i++) {
+        glVertex2f(-1.0, -1.0 + step * i);
+        glVertex2f(+1.0, -1.0 + step * i);
+        glVertex2f(-1.0 + step * i, -1.0);
+        glVertex2f(-1.0 + step * i, +1.0);
     }
+    glEnd();
 
-    for (int i = -1; i < Resolution; i+=2) {
-
-        glBegin(GL_POLYGON);
-            glVertex2f(-1.0 + step * i, -1.0);
-            glVertex2f(-1.0 + step * i, +1.0);
-            glVertex2f(-1.0 + step * (1 + i), +1.0);
-            glVertex2f(-1.0 + step * (1 + i), -1.0);
-        glEnd();
-    }
 }
 
 /* Draws a dashed line with given endpoint coordinates (in GL coords) */
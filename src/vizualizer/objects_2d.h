@@ -45,6 +45,7 @@ void DrawShape(double CenterX, double CenterY, double width, double height,
 void DrawLine(double x1, double y1, double x2, double y2, double width,
         const float *color);
 
+/* Draws a "Resolution x Resolution" grid onto the [-1, 1] square */
 void DrawSquare(int Resolution);
 
 void DrawDashedLine(double x1, double y1, double x2, double y2,
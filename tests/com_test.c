@@ -0,0 +1,74 @@
+//MIT License
+//Copyright (c) 2018 Eotvos Lorand University, Budapest
+
+/* vim:set ts=4 sw=4 sts=4 et: */
+
+/*
+ * Regression test of the centre of mass ("make check"): GetCoM has to give
+ * the mean of the positions, whatever its output vector contained before
+ * (CoM.dat used to be written from an uninitialized vector).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../src/utilities/dynamics_utils.h"
+
+#ifdef SINGLE_PRECISION
+#define TOLERANCE 1e-2
+#else
+#define TOLERANCE 1e-9
+#endif
+
+/* Random positions in a box of "Size" around ("X", "Y", 0),
+ * "Garbage" is the initial content of the output vector */
+static int CheckCase(const char *Name, const int N, const double X,
+        const double Y, const double Size, const real_t Garbage) {
+
+    int i, k;
+    int Failed = 0;
+    double Expected[3] = { 0.0, 0.0, 0.0 };
+    real_t Actual[3] = { Garbage, Garbage, Garbage };
+    phase_t Phase;
+
+    AllocatePhase(&Phase, N, 0);
+    for (i = 0; i < N; i++) {
+        Phase.Coordinates[i][0] = X + Size * (rand() / (double) RAND_MAX - 0.5);
+        Phase.Coordinates[i][1] = Y + Size * (rand() / (double) RAND_MAX - 0.5);
+        Phase.Coordinates[i][2] = Size * (rand() / (double) RAND_MAX - 0.5);
+        for (k = 0; k < 3; k++) {
+            Expected[k] += Phase.Coordinates[i][k] / N;
+        }
+    }
+
+    /* Twice, the second call gets the result of the first one */
+    GetCoM(Actual, &Phase);
+    GetCoM(Actual, &Phase);
+    for (k = 0; k < 3; k++) {
+        if (!isfinite(Actual[k]) || fabs(Actual[k] - Expected[k]) > TOLERANCE) {
+            fprintf(stderr, "%s: coordinate %d is %g instead of %g\n", Name, k,
+                    (double) Actual[k], Expected[k]);
+            Failed = 1;
+        }
+    }
+
+    freePhase(&Phase);
+    return Failed;
+
+}
+
+int main(void) {
+
+    int Failed = 0;
+
+    srand(1);
+    Failed |= CheckCase("flock at the origin", 100, 0.0, 0.0, 10000.0, 0.0);
+    Failed |= CheckCase("output vector of garbage", 5, 3000.0, -2000.0,
+            1000.0, 1e30);
+    Failed |= CheckCase("output vector of NaN", 5, -500.0, 700.0, 1000.0, NAN);
+    Failed |= CheckCase("single agent", 1, 1234.5, 678.9, 0.0, NAN);
+
+    printf("com_test: %s\n", Failed ? "FAILED" : "passed");
+    return Failed;
+
+}
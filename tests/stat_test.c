@@ -0,0 +1,114 @@
+//MIT License
+//Copyright (c) 2018 Eotvos Lorand University, Budapest
+
+/* vim:set ts=4 sw=4 sts=4 et: */
+
+/*
+ * Regression test of the velocity correlation statistics ("make check"):
+ * StatOfCorrelation is compared with the pair-by-pair calculation
+ * (agents at rest have zero correlation with every other agent).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../src/stat.h"
+
+#ifdef SINGLE_PRECISION
+#define TOLERANCE 1e-5
+#else
+#define TOLERANCE 1e-9
+#endif
+
+/* Average, deviation, minimum and maximum of the correlations, pair by pair */
+static void BruteForceCorrelation(double *Expected, phase_t * Phase) {
+
+    int i, j;
+    double Corr, Length1, Length2;
+    double Sum = 0.0, Sum2 = 0.0;
+    const int N = Phase->NumberOfAgents;
+
+    Expected[2] = 2e222;
+    Expected[3] = 0.0;
+    for (i = 0; i < N - 1; i++) {
+        for (j = i + 1; j < N; j++) {
+            Length1 = VectAbs(Phase->Velocities[i]);
+            Length2 = VectAbs(Phase->Velocities[j]);
+            Corr = 0.0;
+            if (Length1 != 0 && Length2 != 0) {
+                Corr = ScalarProduct(Phase->Velocities[i],
+                        Phase->Velocities[j], 3) / (Length1 * Length2);
+            }
+            Expected[2] = fmin(Expected[2], Corr);
+            Expected[3] = fmax(Expected[3], Corr);
+            Sum += Corr;
+            Sum2 += Corr * Corr;
+        }
+    }
+    Sum *= 2.0 / (N * (N - 1));
+    Sum2 *= 2.0 / (N * (N - 1));
+    Expected[0] = Sum;
+    Expected[1] = sqrt(fmax(Sum2 - Sum * Sum, 0.0));
+
+}
+
+/* Random velocities, "Moving" agents are moving (the others are at rest) */
+static int CheckCase(const char *Name, const int N, const int Moving,
+        const int Planar) {
+
+    int i, k;
+    int Failed = 0;
+    double Expected[4];
+    double *Actual;
+    phase_t Phase;
+
+    AllocatePhase(&Phase, N, 0);
+    for (i = 0; i < N; i++) {
+        for (k = 0; k < 3; k++) {
+            Phase.Velocities[i][k] = 0.0;
+        }
+        if (i < Moving) {
+            Phase.Velocities[i][0] = rand() / (double) RAND_MAX - 0.5;
+            Phase.Velocities[i][1] = rand() / (double) RAND_MAX - 0.5;
+            if (!Planar) {
+                Phase.Velocities[i][2] = rand() / (double) RAND_MAX - 0.5;
+            }
+        }
+    }
+
+    BruteForceCorrelation(Expected, &Phase);
+    Actual = StatOfCorrelation(&Phase);
+    /* The deviation is compared by its square (the aggregated sums leave
+     * rounding errors of about 1e-16 in the variance) */
+    Actual[1] *= Actual[1];
+    Expected[1] *= Expected[1];
+    for (k = 0; k < 4; k++) {
+        if (fabs(Actual[k] - Expected[k]) > TOLERANCE) {
+            fprintf(stderr, "%s: value %d is %g instead of %g\n", Name, k,
+                    Actual[k], Expected[k]);
+            Failed = 1;
+        }
+    }
+
+    freePhase(&Phase);
+    return Failed;
+
+}
+
+int main(void) {
+
+    int Failed = 0;
+
+    srand(1);
+    Failed |= CheckCase("planar", 50, 50, 1);
+    Failed |= CheckCase("3D", 50, 50, 0);
+    Failed |= CheckCase("some agents at rest", 20, 12, 1);
+    Failed |= CheckCase("two moving agents", 10, 2, 1);
+    Failed |= CheckCase("one moving agent", 10, 1, 1);
+    Failed |= CheckCase("one moving agent in 3D", 10, 1, 0);
+    Failed |= CheckCase("every agent at rest", 10, 0, 1);
+
+    printf("stat_test: %s\n", Failed ? "FAILED" : "passed");
+    return Failed;
+
+}
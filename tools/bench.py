@@ -0,0 +1,266 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Benchmark driver of the headless simulator.
+
+Runs every combination of the canned scenarios (number of agents,
+communication type, flocking type, obstacles, CBP on / off) with
+robotflocksim_main_server -novis -profile, and reports steps/s, ns per
+agent-step, peak RSS and the time spent in each stage of the step as JSON or
+CSV. The rates are calculated from the time of the simulation loop (the
+top-level stages of the profile), so reading the parameters and allocating
+the stored phases is not counted; the whole run is reported as wall_s.
+
+The number of agents is capped at about 400 by the model itself: the agents
+start inside a ring of 120 m radius at least 2 * V_Flock (8 m) apart, larger
+flocks stop with "Please, increase the initial area sizes!". The memory sets
+the same cap: every run stores at least 30 s of phases (LengthToStore is at
+least 10 s) and each stored phase holds two N x N matrices, about 48 kB per
+agent pair with DeltaT=0.01, that is 400 agents under the default 8 GB limit.
+Scenarios that would not fit into --memory-limit are reported as "skipped".
+
+Parameter files are generated from the default ones in parameters/, only the
+varied values are overwritten. InitialX and InitialY grow with the number of
+agents (the ring of the model above does not).
+
+Usage (from the root of the repository, after "make release server=true"):
+    python3 tools/bench.py --agents 10,100 --format csv --output bench.csv
+or simply "make bench".
+"""
+import argparse
+import csv
+import itertools
+import json
+import math
+import os
+import platform
+import resource
+import subprocess
+import sys
+import tempfile
+import time
+from os import path
+
+REPO = path.dirname(path.dirname(path.abspath(__file__)))
+
+
+def read_params(file_name):
+    """Reads "Name=Value" lines of a parameter file (comments are kept)"""
+    with open(file_name) as f:
+        return f.read().splitlines()
+
+
+def write_params(lines, values, file_name):
+    """Writes a parameter file with some of the values overwritten"""
+    missing = dict(values)
+    with open(file_name, "w") as f:
+        for line in lines:
+            name = line.split("=")[0].strip()
+            if not line.startswith("#") and name in missing:
+                line = "%s=%s" % (name, missing.pop(name))
+            f.write(line + "\n")
+        for name, value in missing.items():
+            f.write("%s=%s\n" % (name, value))
+
+
+def parse_profile(text):
+    """Total time of each stage (ms) from the table printed by -profile"""
+    stages = {}
+    in_table = False
+    for line in text.splitlines():
+        fields = line.split()
+        if not fields:
+            continue
+        if fields[0] == "stage":
+            in_table = True
+        elif fields[0] == "counter":
+            in_table = False
+        elif in_table and len(fields) == 6:
+            stages[fields[0]] = float(fields[2])
+    return stages
+
+
+# Top-level stages of the profile, together they are the simulation loop
+LOOP_STAGES = ["step", "dataline", "statistics", "output"]
+
+
+def estimated_memory(args, agents):
+    """Size of the stored phases and of the CBP obstacle matrix (bytes)"""
+    phases = int((20.0 + max(args.store, 10.0)) / args.delta_t)
+    return agents * agents * (phases * 2 * 8 + 84 * 4)
+
+
+def limit_memory(args):
+    """Large scenarios fail instead of swapping the machine to death"""
+    limit = int(args.memory_limit * 1024 ** 3)
+    resource.setrlimit(resource.RLIMIT_AS, (limit, limit))
+
+
+def run_scenario(args, scenario, work_dir):
+    """Runs one scenario and returns its results as a dictionary"""
+    agents, comm, flocking, obstacles, cbp = scenario
+    scale = math.sqrt(agents / 10.0)
+
+    init_file = path.join(work_dir, "initparams.dat")
+    unit_file = path.join(work_dir, "unitparams.dat")
+    out_dir = path.join(work_dir, "output")
+    os.makedirs(out_dir, exist_ok=True)
+
+    write_params(read_params(path.join(REPO, "parameters/initparams.dat")), {
+        "NumberOfAgents": agents,
+        "Length": args.length,
+        "LengthToStore": args.store,
+        "InitialX": 50000.0 * scale,
+        "InitialY": 50000.0 * scale,
+        "CBPEnabled": cbp,
+        "DeltaT": args.delta_t,
+    }, init_file)
+    write_params(read_params(path.join(REPO, "parameters/unitparams.dat")), {
+        "Communication_type": "%f" % comm,
+        "Flocking_type": "%f" % flocking,
+    }, unit_file)
+
+    command = [args.binary, "-novis", "-verb", "0", "-profile",
+               "-i", init_file,
+               "-u", unit_file,
+               "-f", path.join(REPO, "parameters/flockingparams.dat"),
+               "-o", out_dir]
+    if obstacles != "none":
+        command += ["-obst", path.join(REPO, "obstacles", obstacles)]
+
+    result = {"agents": agents, "communication_type": comm,
+              "flocking_type": flocking, "obstacles": obstacles, "cbp": cbp}
+    steps = int(round(args.length / args.delta_t))
+
+    memory = estimated_memory(args, agents)
+    if memory > args.memory_limit * 1024 ** 3:
+        result.update({
+            "status": "skipped", "steps": steps, "stages_ms": {},
+            "message": "needs about %.1f GB (--memory-limit %g)" % (
+                memory / 1024.0 ** 3, args.memory_limit)})
+        return result
+
+    # wait4 gives the peak RSS of this very child
+    start = time.perf_counter()
+    with open(path.join(work_dir, "stderr.txt"), "w+") as stderr:
+        process = subprocess.Popen(command, cwd=REPO,
+                                   stdout=subprocess.DEVNULL, stderr=stderr,
+                                   preexec_fn=lambda: limit_memory(args))
+        while True:
+            pid, exit_status, usage = os.wait4(process.pid, os.WNOHANG)
+            if pid != 0:
+                break
+            if time.perf_counter() - start > args.timeout:
+                process.kill()
+                pid, exit_status, usage = os.wait4(process.pid, 0)
+                break
+            time.sleep(0.01)
+        wall = time.perf_counter() - start
+        process.returncode = 0  # already reaped by wait4
+        stderr.seek(0)
+        text = stderr.read()
+        message = text.strip()[-200:]
+
+    if wall > args.timeout:
+        status = "timeout"
+    elif os.WIFEXITED(exit_status) and os.WEXITSTATUS(exit_status) == 0:
+        status = "ok"
+    else:
+        status = "error"
+
+    stages = parse_profile(text)
+    loop = sum(stages.get(stage, 0.0) for stage in LOOP_STAGES) / 1000.0
+    timed = status == "ok" and loop > 0.0
+    result.update({
+        "status": status,
+        "wall_s": wall,
+        "loop_s": loop if timed else None,
+        "steps": steps,
+        "steps_per_s": steps / loop if timed else None,
+        "ms_per_step": loop * 1000.0 / steps if timed else None,
+        "ns_per_agent_step": loop * 1e9 / (steps * agents)
+        if timed else None,
+        "peak_rss_kb": usage.ru_maxrss,
+        "stages_ms": stages,
+    })
+    if status == "error":
+        result["message"] = message
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    parser.add_argument("--binary", default=path.join(
+        REPO, "robotflocksim_main_server"))
+    parser.add_argument("--agents", default="10,100,300")
+    parser.add_argument("--comm", default="0,1,2",
+                        help="Communication_type values")
+    parser.add_argument("--flocking", default="0,1,2",
+                        help="Flocking_type values")
+    parser.add_argument("--obstacles",
+                        default="none,obst_forest.default,small.default")
+    parser.add_argument("--cbp", default="1,0", help="CBPEnabled values")
+    parser.add_argument("--length", type=float, default=20.0,
+                        help="simulated time of each run (s)")
+    parser.add_argument("--store", type=float, default=1.0,
+                        help="LengthToStore of each run (s)")
+    parser.add_argument("--delta-t", type=float, default=0.01,
+                        help="DeltaT of each run (s)")
+    parser.add_argument("--timeout", type=float, default=600.0,
+                        help="time limit of each run (s)")
+    parser.add_argument("--memory-limit", type=float, default=8.0,
+                        help="address space limit of each run (GB)")
+    parser.add_argument("--format", choices=["json", "csv"], default="json")
+    parser.add_argument("--output", default="-")
+    args = parser.parse_args()
+
+    if not path.isfile(args.binary):
+        sys.exit("%s not found, build it with \"make release server=true\""
+                 % args.binary)
+
+    scenarios = list(itertools.product(
+        [int(a) for a in args.agents.split(",")],
+        [int(c) for c in args.comm.split(",")],
+        [int(f) for f in args.flocking.split(",")],
+        args.obstacles.split(","),
+        [int(c) for c in args.cbp.split(",")]))
+
+    results = []
+    for i, scenario in enumerate(scenarios):
+        with tempfile.TemporaryDirectory(prefix="robotsim_bench_") as work_dir:
+            result = run_scenario(args, scenario, work_dir)
+        results.append(result)
+        print("[%d/%d] %s: %s%s" % (
+            i + 1, len(scenarios), scenario, result["status"],
+            " (%s)" % result["message"] if "message" in result else ""),
+            file=sys.stderr)
+
+    output = sys.stdout if args.output == "-" else open(args.output, "w")
+    if args.format == "json":
+        json.dump({"machine": platform.node(), "binary": args.binary,
+                   "length_s": args.length, "delta_t_s": args.delta_t,
+                   "results": results},
+                  output, indent=2)
+        output.write("\n")
+    else:
+        fields = ["agents", "communication_type", "flocking_type",
+                  "obstacles", "cbp", "status", "wall_s", "loop_s", "steps",
+                  "steps_per_s", "ms_per_step", "ns_per_agent_step",
+                  "peak_rss_kb"]
+        stages = sorted(set(stage for result in results
+                            for stage in result["stages_ms"]))
+        writer = csv.DictWriter(output, fields + ["%s_ms" % stage
+                                                  for stage in stages],
+                                extrasaction="ignore")
+        writer.writeheader()
+        for result in results:
+            row = dict(result)
+            for stage, value in result["stages_ms"].items():
+                row["%s_ms" % stage] = value
+            writer.writerow(row)
+    if output is not sys.stdout:
+        output.close()
+
+
+if __name__ == "__main__":
+    main()
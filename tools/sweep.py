@@ -0,0 +1,418 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Parameter sweep driver of the headless simulator.
+
+A sweep spec (JSON) lists the parameters to vary, by the names used in the
+parameter files ("init" - parameters/initparams.dat, "flocking" -
+flocking_model_params_t, parameters/flockingparams.dat, "unit" -
+unit_model_params_t, parameters/unitparams.dat):
+
+    {
+      "sampling": "lhs",
+      "samples": 20,
+      "repeats": 2,
+      "seed": 1,
+      "init": {"Length": 100, "NumberOfAgents": [10, 50]},
+      "flocking": {"V_Flock": {"min": 300, "max": 600}},
+      "unit": {"R_C": {"min": 5000, "max": 50000, "log": true}},
+      "options": ["-obst", "obstacles/obst_forest.default"]
+    }
+
+"sampling" is "grid", "random" or "lhs" (Latin hypercube), "samples" is the
+number of points of the last two, every point is run "repeats" times with
+different seeds (the seed of run i is "seed" + i) and "options" are passed to
+the simulator as they are (paths are relative to the repository).
+
+A number is fixed in every run, a list is a set of values (an axis of the
+grid, or chosen by the random sampling) and {"min", "max"} is a range
+("log": true samples it logarithmically, "integer": true rounds it, "steps"
+is the number of values of the grid).
+
+Every run gets its own directory (run_NNNN/ with the parameter files, the
+output of the simulator and its standard error) and the last line of every
+statistics file is collected into a single table (results.csv). Runs which
+have already finished are skipped when the sweep is started again, unless
+their seed, parameter values or options (or the default parameter files)
+have changed since then.
+
+The runs are executed by a work-stealing pool of one worker per core: the
+runs are dealt to the workers in the order of their estimated cost (length *
+agents^2), every worker takes the most expensive run of its own queue, and an
+idle worker steals the cheapest run of the longest queue. Long and short runs
+are balanced without oversubscribing the cores.
+
+Usage (from the root of the repository, after "make release server=true"):
+    python3 tools/sweep.py parameters/sweep_example.json --output build/sweep
+or simply "make sweep".
+"""
+import argparse
+import collections
+import csv
+import hashlib
+import itertools
+import json
+import math
+import os
+import random
+import subprocess
+import sys
+import threading
+import time
+from os import path
+
+REPO = path.dirname(path.dirname(path.abspath(__file__)))
+sys.path.insert(0, path.dirname(path.abspath(__file__)))
+from bench import read_params, write_params  # noqa: E402
+
+SECTIONS = collections.OrderedDict([
+    ("init", ("-i", "parameters/initparams.dat")),
+    ("flocking", ("-f", "parameters/flockingparams.dat")),
+    ("unit", ("-u", "parameters/unitparams.dat")),
+])
+
+
+def param_names(lines):
+    return set(line.split("=")[0].strip() for line in lines
+               if "=" in line and not line.startswith("#"))
+
+
+def read_spec(file_name):
+    """Reads the spec and checks the names of the parameters"""
+    with open(file_name) as f:
+        spec = json.load(f)
+    sampling = spec.setdefault("sampling", "grid")
+    if sampling not in ("grid", "random", "lhs"):
+        sys.exit("unknown sampling \"%s\"" % sampling)
+    if sampling != "grid" and "samples" not in spec:
+        sys.exit("\"samples\" is needed by %s sampling" % sampling)
+    spec["defaults"] = {}
+    for section, (_, default) in SECTIONS.items():
+        spec.setdefault(section, {})
+        lines = read_params(path.join(REPO, default))
+        unknown = set(spec[section]) - param_names(lines)
+        if unknown:
+            sys.exit("unknown %s parameters: %s (see %s)" % (
+                section, ", ".join(sorted(unknown)), default))
+        spec["defaults"][section] = lines
+    return spec
+
+
+def range_value(value, u):
+    """Value of range "value" at u in [0, 1]"""
+    low, high = float(value["min"]), float(value["max"])
+    if value.get("log", False):
+        x = math.exp(math.log(low) + u * (math.log(high) - math.log(low)))
+    else:
+        x = low + u * (high - low)
+    return int(round(x)) if value.get("integer", False) else x
+
+
+def axis_values(name, value):
+    """Values of one axis of the grid"""
+    if isinstance(value, list):
+        return value
+    if isinstance(value, dict):
+        if "steps" not in value:
+            sys.exit("range of %s needs \"steps\" in a grid" % name)
+        steps = int(value["steps"])
+        return [range_value(value, i / max(steps - 1, 1.0))
+                for i in range(steps)]
+    return [value]
+
+
+def sample_value(value, u):
+    """Value of a list or a range at u in [0, 1)"""
+    if isinstance(value, list):
+        return value[min(int(u * len(value)), len(value) - 1)]
+    if isinstance(value, dict):
+        return range_value(value, u)
+    return value
+
+
+def expand(spec):
+    """Points of the sweep: list of {(section, name): value}"""
+    keys = [(section, name) for section in SECTIONS
+            for name in sorted(spec[section])]
+    values = [spec[section][name] for section, name in keys]
+    if spec["sampling"] == "grid":
+        axes = [axis_values(name, value)
+                for (_, name), value in zip(keys, values)]
+        return [dict(zip(keys, point)) for point in itertools.product(*axes)]
+
+    generator = random.Random(spec.get("seed", 1))
+    samples = int(spec["samples"])
+    if spec["sampling"] == "random":
+        columns = [[generator.random() for _ in range(samples)]
+                   for _ in keys]
+    else:
+        # One sample in every stratum of every dimension
+        columns = []
+        for _ in keys:
+            strata = list(range(samples))
+            generator.shuffle(strata)
+            columns.append([(s + generator.random()) / samples
+                            for s in strata])
+    return [dict((key, sample_value(value, column[i]))
+                 for key, value, column in zip(keys, values, columns))
+            for i in range(samples)]
+
+
+def make_runs(spec, output):
+    """Runs of the sweep (points * repeats) with their estimated cost"""
+    runs = []
+    points = expand(spec)
+    repeats = int(spec.get("repeats", 1))
+    seed = int(spec.get("seed", 1))
+    init = dict(line.split("=", 1) for line in spec["defaults"]["init"]
+                if "=" in line and not line.startswith("#"))
+    for i, point in enumerate(points):
+        for repeat in range(repeats):
+            index = len(runs)
+            agents = float(point.get(("init", "NumberOfAgents"),
+                                     init["NumberOfAgents"]))
+            length = float(point.get(("init", "Length"), init["Length"]))
+            runs.append({
+                "run": index,
+                "point": i,
+                "seed": seed + index,
+                "values": point,
+                "cost": length * agents * agents,
+                "dir": path.join(output, "run_%04d" % index),
+            })
+    return runs
+
+
+def parse_statistics(out_dir):
+    """Last line of every statistics file, as "file.column": value"""
+    results = collections.OrderedDict()
+    for file_name in sorted(os.listdir(out_dir)):
+        if not file_name.endswith(".dat") or file_name.endswith("_stdev.dat"):
+            continue
+        header, last = None, None
+        with open(path.join(out_dir, file_name)) as f:
+            for line in f:
+                if line.startswith("time_(s)"):
+                    header = line.split()
+                elif header is not None and line.strip():
+                    last = line.split()
+        if header is None or last is None:
+            continue
+        for name, value in zip(header[1:], last[1:]):
+            results["%s.%s" % (file_name[:-4], name)] = float(value)
+    return results
+
+
+class Sweep:
+    """Work-stealing pool running the runs of the sweep"""
+
+    def __init__(self, args, spec, runs):
+        self.args = args
+        self.spec = spec
+        self.queues = [collections.deque() for _ in range(args.jobs)]
+        self.locks = [threading.Lock() for _ in range(args.jobs)]
+        self.lock = threading.Lock()
+        self.processes = {}
+        self.stopped = False
+        self.finished = 0
+        self.total = len(runs)
+        self.results = {}
+        # The most expensive runs first, dealt round-robin
+        for i, run in enumerate(sorted(runs, key=lambda r: -r["cost"])):
+            self.queues[i % args.jobs].append(run)
+
+    def next_run(self, worker):
+        """Own most expensive run, or the cheapest one of the longest queue"""
+        with self.locks[worker]:
+            if self.queues[worker]:
+                return self.queues[worker].popleft(), False
+        while True:
+            victim = max(range(len(self.queues)),
+                         key=lambda i: len(self.queues[i]))
+            with self.locks[victim]:
+                if self.queues[victim]:
+                    return self.queues[victim].pop(), True
+                if all(len(q) == 0 for q in self.queues):
+                    return None, False
+
+    def execute(self, run):
+        """Writes the parameter files of the run and runs the simulator"""
+        out_dir = path.join(run["dir"], "output")
+        os.makedirs(out_dir, exist_ok=True)
+        command = [self.args.binary, "-novis", "-verb", "0",
+                   "-seed", str(run["seed"]), "-o", out_dir]
+        for section, (flag, default) in SECTIONS.items():
+            values = dict((name, value)
+                          for (s, name), value in run["values"].items()
+                          if s == section)
+            file_name = path.join(run["dir"], path.basename(default))
+            write_params(self.spec["defaults"][section], values, file_name)
+            command += [flag, file_name]
+        command += self.spec.get("options", []) + self.args.extra
+
+        start = time.perf_counter()
+        with open(path.join(run["dir"], "stderr.txt"), "w") as stderr:
+            process = subprocess.Popen(command, cwd=REPO,
+                                       stdout=subprocess.DEVNULL,
+                                       stderr=stderr)
+            with self.lock:
+                self.processes[run["run"]] = process
+            try:
+                exit_status = process.wait(timeout=self.args.timeout)
+                status = "ok" if exit_status == 0 else "error"
+            except subprocess.TimeoutExpired:
+                process.kill()
+                process.wait()
+                status = "timeout"
+            with self.lock:
+                del self.processes[run["run"]]
+        if self.stopped:
+            status = "stopped"
+
+        result = {"status": status,
+                  "wall_s": time.perf_counter() - start,
+                  "run": self.identity(run),
+                  "statistics": {}}
+        if status == "ok":
+            result["statistics"] = parse_statistics(out_dir)
+        with open(path.join(run["dir"], "result.json"), "w") as f:
+            json.dump(result, f, indent=2)
+        return result
+
+    def identity(self, run):
+        """Everything the results of a run depend on (compared on restarts)"""
+        defaults = hashlib.sha1("\n".join(
+            line for section in SECTIONS
+            for line in self.spec["defaults"][section]).encode()).hexdigest()
+        return {"seed": run["seed"],
+                "values": [[section, name, value] for (section, name), value
+                           in sorted(run["values"].items())],
+                "options": self.spec.get("options", []) + self.args.extra,
+                "defaults": defaults}
+
+    def worker(self, worker):
+        while not self.stopped:
+            run, stolen = self.next_run(worker)
+            if run is None:
+                return
+            result_file = path.join(run["dir"], "result.json")
+            result = None
+            if not self.args.force and path.isfile(result_file):
+                with open(result_file) as f:
+                    result = json.load(f)
+                # The spec may have been changed since the run
+                if (result["status"] != "ok" or
+                        result.get("run") != self.identity(run)):
+                    result = None
+            skipped = result is not None
+            if result is None:
+                result = self.execute(run)
+            with self.lock:
+                self.results[run["run"]] = result
+                self.finished += 1
+                print("[%d/%d] run_%04d: %s" % (
+                    self.finished, self.total, run["run"],
+                    "done before" if skipped else
+                    "%s in %.1f s on worker %d%s" % (
+                        result["status"], result["wall_s"], worker,
+                        " (stolen)" if stolen else "")), file=sys.stderr)
+
+    def start(self):
+        threads = [threading.Thread(target=self.worker, args=(i,))
+                   for i in range(self.args.jobs)]
+        for thread in threads:
+            thread.start()
+        try:
+            while any(thread.is_alive() for thread in threads):
+                time.sleep(0.2)
+        except KeyboardInterrupt:
+            self.stopped = True
+            with self.lock:
+                for process in self.processes.values():
+                    process.kill()
+            for thread in threads:
+                thread.join()
+            raise
+
+
+def write_results(file_name, runs, results):
+    """Consolidated table: one line per run"""
+    varied = sorted(set(key for run in runs for key in run["values"]),
+                    key=lambda k: (list(SECTIONS).index(k[0]), k[1]))
+    statistics = []
+    for run in runs:
+        for name in results.get(run["run"], {}).get("statistics", {}):
+            if name not in statistics:
+                statistics.append(name)
+    with open(file_name, "w") as f:
+        writer = csv.writer(f)
+        writer.writerow(["run", "point", "seed"] +
+                        ["%s.%s" % key for key in varied] +
+                        ["status", "wall_s"] + statistics)
+        for run in runs:
+            result = results.get(run["run"], {"status": "not_run"})
+            writer.writerow(
+                [run["run"], run["point"], run["seed"]] +
+                [run["values"].get(key, "") for key in varied] +
+                [result["status"], "%.3f" % result.get("wall_s", 0.0)] +
+                [result.get("statistics", {}).get(name, "")
+                 for name in statistics])
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    parser.add_argument("spec", help="sweep spec (JSON)")
+    parser.add_argument("--output", default=path.join(REPO, "build/sweep"),
+                        help="directory of the runs and of results.csv")
+    parser.add_argument("--binary", default=path.join(
+        REPO, "robotflocksim_main_server"))
+    parser.add_argument("--jobs", type=int,
+                        default=len(os.sched_getaffinity(0)),
+                        help="number of parallel runs (default: cores)")
+    parser.add_argument("--timeout", type=float, default=None,
+                        help="time limit of each run (s)")
+    parser.add_argument("--force", action="store_true",
+                        help="run again the runs which have already finished")
+    parser.add_argument("--dry-run", action="store_true",
+                        help="list the runs only")
+    # Further options of the simulator can be given after "--"
+    argv = sys.argv[1:]
+    end = argv.index("--") if "--" in argv else len(argv)
+    args = parser.parse_args(argv[:end])
+    args.extra = argv[end + 1:]
+    args.output = path.abspath(args.output)
+
+    if not path.isfile(args.binary):
+        sys.exit("%s not found, build it with \"make release server=true\""
+                 % args.binary)
+    spec = read_spec(args.spec)
+    runs = make_runs(spec, args.output)
+
+    if args.dry_run:
+        for run in runs:
+            print("run_%04d seed %d: %s" % (run["run"], run["seed"], ", ".join(
+                "%s=%s" % (name, value)
+                for (_, name), value in sorted(run["values"].items()))))
+        return
+
+    os.makedirs(args.output, exist_ok=True)
+    with open(path.join(args.output, "spec.json"), "w") as f:
+        json.dump(dict((k, v) for k, v in spec.items() if k != "defaults"),
+                  f, indent=2)
+    print("%d runs on %d workers" % (len(runs), args.jobs), file=sys.stderr)
+
+    sweep = Sweep(args, spec, runs)
+    try:
+        sweep.start()
+    finally:
+        write_results(path.join(args.output, "results.csv"), runs,
+                      sweep.results)
+        print("results: %s" % path.join(args.output, "results.csv"),
+              file=sys.stderr)
+
+
+if __name__ == "__main__":
+    try:
+        main()
+    except KeyboardInterrupt:
+        sys.exit(1)
@@ -0,0 +1,218 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Live monitor of headless runs started with -telemetry.
+
+Every run publishes its telemetry into the shared memory /dev/shm/robotsim_PID
+(see src/utilities/telemetry.h for the layout). Without arguments the monitor
+shows one line per run found on the node: progress, simulated time, steps/s,
+collisions, number of clusters, hull area and the most expensive stage. With
+--job PID the time of each stage per step is listed for one run (the stage
+times need -profile in the run as well).
+
+Reading the telemetry never blocks the runs. While the monitor is reading,
+the runs also count their clusters (O(N^2) per sample); --no-clusters switches
+this off.
+
+Usage:
+    python3 tools/telemetry_monitor.py               # all runs, refreshed every second
+    python3 tools/telemetry_monitor.py --job 12345   # stages of one run
+    python3 tools/telemetry_monitor.py --once --clean
+"""
+import argparse
+import glob
+import mmap
+import os
+import struct
+import sys
+import time
+from os import path
+
+MAGIC = 0x314c45544f424f52
+VERSION = 1
+HEADER = struct.Struct("<QIIIIiiiidd")
+STAGE_NAME_LENGTH = 32
+COUNTERS = struct.Struct("<Qq")
+SAMPLE = struct.Struct("<Qqddddii")
+
+
+class Run:
+    """Telemetry of one run mapped from the shared memory"""
+
+    def __init__(self, file_name):
+        self.file_name = file_name
+        with open(file_name, "r+b") as f:
+            self.memory = mmap.mmap(f.fileno(), 0)
+        (magic, version, self.header_size, self.sample_size, self.ring_length,
+         self.pid, self.agents, self.stages, self.profiled, self.length,
+         self.delta_t) = HEADER.unpack_from(self.memory, 0)
+        if magic != MAGIC or version != VERSION:
+            raise ValueError("not a telemetry file of version %d" % VERSION)
+        offset = HEADER.size
+        self.stage_names = []
+        for i in range(self.stages):
+            name = self.memory[offset:offset + STAGE_NAME_LENGTH]
+            self.stage_names.append(name.split(b"\0")[0].decode())
+            offset += STAGE_NAME_LENGTH
+        self.counters_offset = offset
+        self.sample_format = struct.Struct(
+            SAMPLE.format + "d" * self.stages)
+
+    def alive(self):
+        try:
+            os.kill(self.pid, 0)
+        except ProcessLookupError:
+            return False
+        except PermissionError:
+            pass
+        return True
+
+    def heartbeat(self):
+        """Telling the run that it is watched (clusters are counted)"""
+        struct.pack_into("<q", self.memory, self.counters_offset + 8,
+                         time.time_ns())
+
+    def number_of_samples(self):
+        return COUNTERS.unpack_from(self.memory, self.counters_offset)[0]
+
+    def sample(self, index):
+        """Sample "index" or None if it has been overwritten meanwhile"""
+        offset = (self.header_size +
+                  (index % self.ring_length) * self.sample_size)
+        for _ in range(10):
+            values = self.sample_format.unpack_from(self.memory, offset)
+            sequence = struct.unpack_from("<Q", self.memory, offset)[0]
+            if values[0] == sequence == 2 * index + 2:
+                return {
+                    "steps": values[1],
+                    "wall_time": values[2],
+                    "time": values[3],
+                    "step_rate": values[4],
+                    "hull_area": values[5],
+                    "collisions": values[6],
+                    "clusters": values[7],
+                    "stages": values[8:],
+                }
+            if sequence > 2 * index + 2:
+                return None
+        return None
+
+    def latest(self):
+        """Last two samples (either can be None)"""
+        n = self.number_of_samples()
+        if n == 0:
+            return None, None
+        return self.sample(n - 1), (self.sample(n - 2) if n > 1 else None)
+
+
+def open_runs(directory, pids):
+    runs = []
+    for file_name in sorted(glob.glob(path.join(directory, "robotsim_*"))):
+        try:
+            run = Run(file_name)
+        except (OSError, ValueError, struct.error):
+            continue
+        if not pids or run.pid in pids:
+            runs.append(run)
+    return runs
+
+
+def stage_times(run, last, previous):
+    """Time of each stage per step (ms) between the last two samples"""
+    if last is None or previous is None or last["steps"] == previous["steps"]:
+        return []
+    steps = last["steps"] - previous["steps"]
+    times = [(run.stage_names[i], (last["stages"][i] - previous["stages"][i]) /
+              steps) for i in range(run.stages)]
+    return sorted(times, key=lambda t: -t[1])
+
+
+def summary_table(runs):
+    lines = ["%8s %7s %6s %10s %10s %9s %9s %8s %10s  %s" % (
+        "pid", "agents", "done%", "sim_time_s", "steps/s", "wall_s",
+        "collis.", "clusters", "hull_m2", "slowest stage (ms/step)")]
+    for run in runs:
+        last, previous = run.latest()
+        if last is None:
+            lines.append("%8d %7d  (no samples yet)" % (run.pid, run.agents))
+            continue
+        state = "" if run.alive() else "  [not running]"
+        slowest = "-"
+        # The first stage is the whole step, the slowest part is shown
+        times = [t for t in stage_times(run, last, previous) if t[0] != "step"]
+        if run.profiled and times:
+            slowest = "%s %.3f" % times[0]
+        clusters = last["clusters"] if last["clusters"] >= 0 else "-"
+        lines.append("%8d %7d %6.1f %10.2f %10.1f %9.1f %9d %8s %10.1f  %s%s" % (
+            run.pid, run.agents, 100.0 * last["time"] / run.length,
+            last["time"], last["step_rate"], last["wall_time"],
+            last["collisions"], clusters, last["hull_area"], slowest, state))
+    return lines
+
+
+def job_details(run):
+    last, previous = run.latest()
+    if last is None:
+        return ["pid %d: no samples yet" % run.pid]
+    lines = ["pid %d, %d agents, %.2f / %.2f s simulated, %.1f steps/s%s" % (
+        run.pid, run.agents, last["time"], run.length, last["step_rate"],
+        "" if run.alive() else " [not running]")]
+    lines.append("collisions %d, clusters %s, hull area %.1f m2" % (
+        last["collisions"],
+        last["clusters"] if last["clusters"] >= 0 else "-",
+        last["hull_area"]))
+    if not run.profiled:
+        lines.append("(stage times need -profile)")
+        return lines
+    lines.append("%-24s%12s" % ("stage", "ms/step"))
+    for name, value in stage_times(run, last, previous):
+        lines.append("%-24s%12.4f" % (name, value))
+    return lines
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    parser.add_argument("--dir", default="/dev/shm",
+                        help="directory of the shared memory files")
+    parser.add_argument("--job", type=int, help="stages of run PID")
+    parser.add_argument("--interval", type=float, default=1.0,
+                        help="refresh interval (s)")
+    parser.add_argument("--once", action="store_true",
+                        help="print once and exit")
+    parser.add_argument("--no-clusters", action="store_true",
+                        help="do not make the runs count their clusters")
+    parser.add_argument("--clean", action="store_true",
+                        help="remove the telemetry of runs that are not running")
+    args = parser.parse_args()
+
+    pids = [args.job] if args.job is not None else []
+    while True:
+        runs = open_runs(args.dir, pids)
+        if args.clean:
+            for run in [r for r in runs if not r.alive()]:
+                os.unlink(run.file_name)
+            runs = [r for r in runs if r.alive()]
+        if not args.no_clusters:
+            for run in runs:
+                run.heartbeat()
+
+        if args.job is not None:
+            lines = (job_details(runs[0]) if runs else
+                     ["no telemetry of pid %d in %s" % (args.job, args.dir)])
+        else:
+            lines = summary_table(runs)
+        if not args.once:
+            sys.stdout.write("\033[H\033[J")
+        print("\n".join(lines))
+        sys.stdout.flush()
+
+        if args.once:
+            break
+        time.sleep(args.interval)
+
+
+if __name__ == "__main__":
+    try:
+        main()
+    except KeyboardInterrupt:
+        pass
@@ -0,0 +1,133 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Validation of the single precision (float) build against the double one.
+
+Runs the same scenario with the same seeds with both headless binaries and
+compares the steady state order parameters (velocity order, correlation,
+distance between neighbours, collision ratio, hull area). The trajectories of
+the two builds diverge after a while (the flock is chaotic), therefore only
+the averages over the seeds are compared, with the given tolerances.
+
+Usage (from the root of the repository):
+    make validate_precision
+or, after "make release server=true" and
+"make release server=true precision=single":
+    python3 tools/validate_precision.py --seeds 1,2,3,4 --agents 30
+"""
+import argparse
+import math
+import os
+import subprocess
+import sys
+import tempfile
+from os import path
+
+from bench import REPO, read_params, write_params
+
+# (name, output file, column of the steadystat line, tolerance, relative)
+METRICS = [
+    ("velocity_magnitude", "velocity.dat", 1, 0.05, True),
+    ("velocity_order", "velocity.dat", None, 0.05, False),
+    ("correlation", "correlation.dat", 1, 0.05, False),
+    ("dist_between_neighbours", "dist_between_neighbours.dat", 1, 0.05, True),
+    ("collision_ratio", "collision_ratio.dat", 1, 0.01, False),
+    ("hull_area", "hull_area.dat", 1, 0.10, True),
+]
+
+
+def read_steadystat(file_name):
+    """Values of the (single) data line of a steadystat output file"""
+    with open(file_name) as f:
+        for line in f:
+            fields = line.split()
+            if not fields or line.startswith("#") or fields[0] == "time_(s)":
+                continue
+            return [float(x) for x in fields]
+    raise ValueError("no data in %s" % file_name)
+
+
+def run(binary, seed, init_file, out_dir, args):
+    """Runs one simulation and returns the measured metrics"""
+    os.makedirs(out_dir, exist_ok=True)
+    command = [binary, "-novis", "-verb", "0", "-seed", str(seed),
+               "-i", init_file,
+               "-u", path.join(REPO, "parameters/unitparams.dat"),
+               "-f", path.join(REPO, "parameters/flockingparams.dat"),
+               "-o", out_dir]
+    if args.obstacles != "none":
+        command += ["-obst", path.join(REPO, "obstacles", args.obstacles)]
+    subprocess.run(command, cwd=REPO, check=True,
+                   stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+
+    values = {}
+    for name, file_name, column, _, _ in METRICS:
+        data = read_steadystat(path.join(out_dir, file_name))
+        if column is None:
+            # Length of the average velocity over the average speed
+            values[name] = data[5] / data[1] if data[1] > 0 else 0.0
+        else:
+            values[name] = data[column]
+    return values
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    parser.add_argument("--double-binary", default=path.join(
+        REPO, "build/server-native/robotflocksim_main_server"))
+    parser.add_argument("--single-binary", default=path.join(
+        REPO, "build/server-native-single/robotflocksim_main_server"))
+    parser.add_argument("--seeds", default="1,2,3,4")
+    parser.add_argument("--agents", type=int, default=10)
+    parser.add_argument("--length", type=float, default=120.0,
+                        help="simulated time of each run (s)")
+    parser.add_argument("--obstacles", default="none")
+    parser.add_argument("--tolerance-scale", type=float, default=1.0,
+                        help="multiplier of every tolerance")
+    args = parser.parse_args()
+
+    for binary in (args.double_binary, args.single_binary):
+        if not path.isfile(binary):
+            sys.exit("%s not found, build it with \"make release server=true"
+                     " [precision=single]\"" % binary)
+
+    seeds = [int(s) for s in args.seeds.split(",")]
+    sums = {"double": {}, "single": {}}
+    with tempfile.TemporaryDirectory(prefix="robotsim_precision_") as work_dir:
+        init_file = path.join(work_dir, "initparams.dat")
+        write_params(read_params(path.join(REPO, "parameters/initparams.dat")), {
+            "NumberOfAgents": args.agents,
+            "Length": args.length,
+            "CBPEnabled": 0,
+        }, init_file)
+        for seed in seeds:
+            for mode, binary in (("double", args.double_binary),
+                                 ("single", args.single_binary)):
+                values = run(binary, seed, init_file,
+                             path.join(work_dir, "%s_%d" % (mode, seed)), args)
+                for name, value in values.items():
+                    sums[mode][name] = sums[mode].get(name, 0.0) + value
+            print("seed %d done" % seed, file=sys.stderr)
+
+    failed = False
+    print("%-26s%16s%16s%12s%12s  %s" % ("metric", "double", "single",
+                                          "difference", "tolerance", "result"))
+    for name, _, _, tolerance, relative in METRICS:
+        double = sums["double"][name] / len(seeds)
+        single = sums["single"][name] / len(seeds)
+        difference = abs(single - double)
+        tolerance *= args.tolerance_scale
+        if relative:
+            difference = difference / abs(double) if double != 0 else \
+                (0.0 if single == 0 else math.inf)
+        passed = difference <= tolerance
+        failed = failed or not passed
+        print("%-26s%16.6g%16.6g%12.4g%12.4g  %s" % (
+            name, double, single, difference, tolerance,
+            "ok" if passed else "FAILED"))
+
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()